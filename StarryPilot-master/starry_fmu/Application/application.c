@@ -35,6 +35,7 @@
 #include "logger.h"
 #include "fast_loop.h"
 #include "calibration.h"
+#include "boot.h"
 
 #ifdef RT_USING_LWIP
 #include <lwip/sys.h>
@@ -76,47 +77,27 @@ FATFS FatFs;
 
 void vehicle_main_loop(void *parameter);
 extern rt_err_t rt_hw_mavlink_console_init(void);
-void rt_init_thread_entry(void* parameter)
+
+static rt_err_t _boot_sd(void)
 {
-	rt_err_t res;
+	return fm_init("0:") == 0 ? RT_EOK : RT_EIO;
+}
 
-	rt_hw_mavlink_console_init();
-	statistic_init();
-	
-    /* GDB STUB */
-#ifdef RT_USING_GDB
-    gdb_set_device("uart6");
-    gdb_start();
-#endif
-	
-	//fm_init("0:");
+static rt_err_t _boot_param(void)
+{
 	param_init();
-	device_led_init();
-	device_sensor_init();
-	device_mavproxy_init();
-	
-	//rt_console_set_device(CONSOLE_DEVICE);
-	
-	//Console.print("heap base:%p end:%p\n", STM32_SRAM_BEGIN, STM32_SRAM_END);
-
-    /* LwIP Initialization */
-#ifdef RT_USING_LWIP
-    {
-        extern void lwip_sys_init(void);
-
-        /* register ethernetif device */
-        eth_system_device_init();
+	return RT_EOK;
+}
 
-        rt_hw_stm32_eth_init();
+static rt_err_t _boot_led(void)
+{
+	device_led_init();
+	return RT_EOK;
+}
 
-        /* init lwip system */
-        lwip_sys_init();
-        rt_kprintf("TCP/IP initialized!\n");
-    }
-#endif
-	
-	/* create thread */
-	res = rt_thread_init(&thread_fastloop_handle,
+static rt_err_t _boot_start_fastloop(void)
+{
+	rt_err_t res = rt_thread_init(&thread_fastloop_handle,
 						   "fastloop",
 						   fastloop_entry,
 						   RT_NULL,
@@ -124,8 +105,12 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_fastloop_stack),FASTLOOP_THREAD_PRIORITY,1);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_fastloop_handle);
-	
-	res = rt_thread_init(&thread_copter_handle,
+	return res;
+}
+
+static rt_err_t _boot_start_copter(void)
+{
+	rt_err_t res = rt_thread_init(&thread_copter_handle,
 						   "copter",
 						   copter_entry,
 						   RT_NULL,
@@ -133,8 +118,12 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_copter_stack),COPTER_THREAD_PRIORITY,1);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_copter_handle);
-	
-	res = rt_thread_init(&thread_starryio_handle,
+	return res;
+}
+
+static rt_err_t _boot_start_starryio(void)
+{
+	rt_err_t res = rt_thread_init(&thread_starryio_handle,
 						   "starryio",
 						   starryio_entry,
 						   RT_NULL,
@@ -142,8 +131,12 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_starryio_stack),STARRYIO_THREAD_PRIORITY,1);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_starryio_handle);
-	
-	res = rt_thread_init(&thread_mavlink_handle,
+	return res;
+}
+
+static rt_err_t _boot_start_mavproxy(void)
+{
+	rt_err_t res = rt_thread_init(&thread_mavlink_handle,
 						   "mavproxy",
 						   mavproxy_entry,
 						   RT_NULL,
@@ -151,8 +144,12 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_mavlink_stack),MAVLINK_THREAD_PRIORITY,1);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_mavlink_handle);
-	
-	res = rt_thread_init(&thread_logger_handle,
+	return res;
+}
+
+static rt_err_t _boot_start_logger(void)
+{
+	rt_err_t res = rt_thread_init(&thread_logger_handle,
 						   "logger",
 						   logger_entry,
 						   RT_NULL,
@@ -160,8 +157,12 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_logger_stack),LOGGER_THREAD_PRIORITY,1);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_logger_handle);
-	
-	res = rt_thread_init(&thread_led_handle,
+	return res;
+}
+
+static rt_err_t _boot_start_led(void)
+{
+	rt_err_t res = rt_thread_init(&thread_led_handle,
 						   "led",
 						   led_entry,
 						   RT_NULL,
@@ -169,8 +170,12 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_led_stack),LED_THREAD_PRIORITY,1);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_led_handle);
+	return res;
+}
 
-	res = rt_thread_init(&thread_cali_handle,
+static rt_err_t _boot_start_cali(void)
+{
+	rt_err_t res = rt_thread_init(&thread_cali_handle,
 						   "cali",
 						   rt_cali_thread_entry,
 						   RT_NULL,
@@ -178,6 +183,81 @@ void rt_init_thread_entry(void* parameter)
 						   sizeof(thread_cali_stack),CALI_THREAD_PRIORITY,2);
 	if (res == RT_EOK)
 		rt_thread_startup(&thread_cali_handle);
+	return res;
+}
+
+enum
+{
+	BOOT_SD = 0,
+	BOOT_PARAM,
+	BOOT_SENSOR,
+	BOOT_LED,
+	BOOT_GPS,
+	BOOT_MAVPROXY,
+	BOOT_STARRYIO_THREAD,
+	BOOT_MAVPROXY_THREAD,
+	BOOT_LOGGER_THREAD,
+	BOOT_LED_THREAD,
+	BOOT_FASTLOOP_THREAD,
+	BOOT_COPTER_THREAD,
+	BOOT_CALI_THREAD,
+	BOOT_STAGE_NUM
+};
+
+/* the card, the params, the sensors and the gps come up next to each
+ * other, each thread is started once what it reads at its start is there.
+ * The led waits for the sensors as both set up their bus pins. The stages
+ * without a stack run in this order on the boot thread. */
+static const Boot_Stage _boot_stage[BOOT_STAGE_NUM] =
+{
+	[BOOT_SD]				= {"sd",		_boot_sd,				0,											1024},
+	[BOOT_PARAM]			= {"param",		_boot_param,			BOOT_DEP(BOOT_SD),							2048},
+	[BOOT_SENSOR]			= {"sensor",	device_sensor_init,		0,											2048},
+	[BOOT_LED]				= {"led",		_boot_led,				BOOT_DEP(BOOT_SENSOR),						1024},
+	[BOOT_GPS]				= {"gps",		device_gps_init,		BOOT_DEP(BOOT_SENSOR),						2048},
+	[BOOT_MAVPROXY]			= {"mavproxy",	device_mavproxy_init,	0,											0},
+	[BOOT_STARRYIO_THREAD]	= {"t_starryio",_boot_start_starryio,	0,											0},
+	[BOOT_MAVPROXY_THREAD]	= {"t_mavproxy",_boot_start_mavproxy,	BOOT_DEP(BOOT_PARAM)|BOOT_DEP(BOOT_MAVPROXY),	0},
+	[BOOT_LOGGER_THREAD]	= {"t_logger",	_boot_start_logger,		BOOT_DEP(BOOT_SD)|BOOT_DEP(BOOT_PARAM),		0},
+	[BOOT_LED_THREAD]		= {"t_led",		_boot_start_led,		BOOT_DEP(BOOT_LED),							0},
+	[BOOT_FASTLOOP_THREAD]	= {"t_fastloop",_boot_start_fastloop,	BOOT_DEP(BOOT_SENSOR)|BOOT_DEP(BOOT_PARAM),	0},
+	[BOOT_COPTER_THREAD]	= {"t_copter",	_boot_start_copter,		BOOT_DEP(BOOT_SENSOR)|BOOT_DEP(BOOT_PARAM),	0},
+	[BOOT_CALI_THREAD]		= {"t_cali",	_boot_start_cali,		BOOT_DEP(BOOT_SENSOR)|BOOT_DEP(BOOT_PARAM),	0},
+};
+
+void rt_init_thread_entry(void* parameter)
+{
+	rt_hw_mavlink_console_init();
+	/* counts the idle thread, nothing else may run yet */
+	statistic_init();
+	
+    /* GDB STUB */
+#ifdef RT_USING_GDB
+    gdb_set_device("uart6");
+    gdb_start();
+#endif
+	
+	//rt_console_set_device(CONSOLE_DEVICE);
+	
+	//Console.print("heap base:%p end:%p\n", STM32_SRAM_BEGIN, STM32_SRAM_END);
+
+    /* LwIP Initialization */
+#ifdef RT_USING_LWIP
+    {
+        extern void lwip_sys_init(void);
+
+        /* register ethernetif device */
+        eth_system_device_init();
+
+        rt_hw_stm32_eth_init();
+
+        /* init lwip system */
+        lwip_sys_init();
+        rt_kprintf("TCP/IP initialized!\n");
+    }
+#endif
+	
+	boot_run(_boot_stage, BOOT_STAGE_NUM);
 
 	/* delete itself */
 	rt_thread_delete(tid0);
@@ -186,7 +266,6 @@ void rt_init_thread_entry(void* parameter)
 int rt_application_init()
 {
 	usb_cdc_init();
-	fm_init("0:");
 	console_init(CONSOLE_INTERFACE_SERIAL);
 	rt_console_set_device(CONSOLE_DEVICE);
 	rt_show_version();
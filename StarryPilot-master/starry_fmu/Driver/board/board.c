@@ -87,7 +87,7 @@ void SysTick_Handler(void)
 
     rt_tick_increase();
 	
-	_delay_t.msPeriod += _delay_t.msPerPeriod;
+	time_tick_update();
 
     /* leave interrupt */
     rt_interrupt_leave();
@@ -15,6 +15,8 @@
 #include "delay.h"
 #include "sensor_manager.h"
 #include "uMCN.h"
+#include "global.h"
+#include "ubx_decoder.h"
 
 #define FNV1_32_INIT	((uint32_t)0x811c9dc5)	// init value for FNV1 hash algorithm
 #define FNV1_32_PRIME	((uint32_t)0x01000193)	// magic prime for FNV1 hash algorithm
@@ -22,14 +24,17 @@
 #define M_RAD_TO_DEG_F 		57.2957795130823f
 #define MIN(x,y) (x < y ? x : y)
 
+#define GPS_RX_BLOCK_SIZE	128
+
 static rt_device_t serial_device;
 static struct rt_device gps_device;
+static ubx_decoder_t _decoder;
+static struct rt_semaphore _rx_sem;
+
+static char thread_gps_stack[1024];
+static struct rt_thread thread_gps_handle;
 
-ubx_decode_state_t _decode_state;
 uint16_t _rx_payload_length;
-uint16_t _rx_payload_index;
-uint8_t _rx_ck_a;
-uint8_t _rx_ck_b;
 uint16_t _rx_msg;
 ubx_rxmsg_state_t _rx_state;
 rt_bool_t _configured;
@@ -48,23 +53,6 @@ rt_bool_t _got_svinfo;
 
 MCN_DEFINE(GPS_POSITION, sizeof(struct vehicle_gps_position_s));
 
-void _decode_init(void)
-{
-	_decode_state = UBX_DECODE_SYNC1;
-	_rx_ck_a = 0;
-	_rx_ck_b = 0;
-	_rx_payload_length = 0;
-	_rx_payload_index = 0;
-	
-	//Console.print("_decode_state %d\n" , _decode_state);
-}
-
-void _add_byte_to_checksum(const uint8_t b)
-{
-	_rx_ck_a = _rx_ck_a + b;
-	_rx_ck_b = _rx_ck_b + _rx_ck_a;
-}
-
 rt_err_t _set_baudrate(rt_device_t dev , uint32_t baudrate)
 {
 	rt_err_t err;
@@ -102,94 +90,49 @@ uint32_t fnv1_32_str(uint8_t *str, uint32_t hval)
 	return hval;
 }
 
-int	// -1 = error, 0 = ok, 1 = payload completed
-payload_rx_add_nav_svinfo(const uint8_t b)
+void
+payload_rx_nav_svinfo(const uint8_t* payload, uint16_t len)
 {
-	int ret = 0;
-
-	if (_rx_payload_index < sizeof(ubx_payload_rx_nav_svinfo_part1_t)) {
-		// Fill Part 1 buffer
-		_buf.raw[_rx_payload_index] = b;
-
-	} else {
-		if (_rx_payload_index == sizeof(ubx_payload_rx_nav_svinfo_part1_t)) {
-			// Part 1 complete: decode Part 1 buffer
-			_satellite_info->count = MIN(_buf.payload_rx_nav_svinfo_part1.numCh, SAT_INFO_MAX_SATELLITES);
-//			Console.print("SVINFO len %u  numCh %u\r\n", (unsigned)_rx_payload_length,
-//					 (unsigned)_buf.payload_rx_nav_svinfo_part1.numCh);
-		}
-
-		if (_rx_payload_index < sizeof(ubx_payload_rx_nav_svinfo_part1_t) + _satellite_info->count * sizeof(
-			    ubx_payload_rx_nav_svinfo_part2_t)) {
-			// Still room in _satellite_info: fill Part 2 buffer
-			unsigned buf_index = (_rx_payload_index - sizeof(ubx_payload_rx_nav_svinfo_part1_t)) % sizeof(
-						     ubx_payload_rx_nav_svinfo_part2_t);
-			_buf.raw[buf_index] = b;
-
-			if (buf_index == sizeof(ubx_payload_rx_nav_svinfo_part2_t) - 1) {
-				// Part 2 complete: decode Part 2 buffer
-				unsigned sat_index = (_rx_payload_index - sizeof(ubx_payload_rx_nav_svinfo_part1_t)) / sizeof(
-							     ubx_payload_rx_nav_svinfo_part2_t);
-				_satellite_info->used[sat_index]	= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.flags & 0x01);
-				_satellite_info->snr[sat_index]		= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.cno);
-				_satellite_info->elevation[sat_index]	= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.elev);
-				_satellite_info->azimuth[sat_index]	= (uint8_t)((float)_buf.payload_rx_nav_svinfo_part2.azim * 255.0f / 360.0f);
-				_satellite_info->svid[sat_index]	= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.svid);
-//				Console.print("SVINFO #%02u  used %u  snr %3u  elevation %3u  azimuth %3u  svid %3u\r\n",
-//						 (unsigned)sat_index + 1,
-//						 (unsigned)_satellite_info->used[sat_index],
-//						 (unsigned)_satellite_info->snr[sat_index],
-//						 (unsigned)_satellite_info->elevation[sat_index],
-//						 (unsigned)_satellite_info->azimuth[sat_index],
-//						 (unsigned)_satellite_info->svid[sat_index]
-//						);
-				
-			}
-		}
+	const uint8_t* part2 = payload + sizeof(ubx_payload_rx_nav_svinfo_part1_t);
+	
+	if (len < sizeof(ubx_payload_rx_nav_svinfo_part1_t)) {
+		return;
 	}
-
-	if (++_rx_payload_index >= _rx_payload_length) {
-		ret = 1;	// payload received completely
+	
+	// decode Part 1
+	memcpy(_buf.raw, payload, sizeof(ubx_payload_rx_nav_svinfo_part1_t));
+	_satellite_info->count = MIN(_buf.payload_rx_nav_svinfo_part1.numCh, SAT_INFO_MAX_SATELLITES);
+	
+	// decode Part 2 for each satellite present in the payload
+	for (unsigned sat_index = 0; sat_index < _satellite_info->count; sat_index++) {
+		if (part2 + sizeof(ubx_payload_rx_nav_svinfo_part2_t) > payload + len) {
+			break;
+		}
+		
+		memcpy(_buf.raw, part2, sizeof(ubx_payload_rx_nav_svinfo_part2_t));
+		part2 += sizeof(ubx_payload_rx_nav_svinfo_part2_t);
+		
+		_satellite_info->used[sat_index]	= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.flags & 0x01);
+		_satellite_info->snr[sat_index]		= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.cno);
+		_satellite_info->elevation[sat_index]	= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.elev);
+		_satellite_info->azimuth[sat_index]	= (uint8_t)((float)_buf.payload_rx_nav_svinfo_part2.azim * 255.0f / 360.0f);
+		_satellite_info->svid[sat_index]	= (uint8_t)(_buf.payload_rx_nav_svinfo_part2.svid);
 	}
-
-	return ret;
 }
 
-int	// -1 = error, 0 = ok, 1 = payload completed
-payload_rx_add_mon_ver(const uint8_t b)
+void
+payload_rx_mon_ver(const uint8_t* payload, uint16_t len)
 {
-	int ret = 0;
-
-	if (_rx_payload_index < sizeof(ubx_payload_rx_mon_ver_part1_t)) {
-		// Fill Part 1 buffer
-		_buf.raw[_rx_payload_index] = b;
-
-	} else {
-		if (_rx_payload_index == sizeof(ubx_payload_rx_mon_ver_part1_t)) {
-			// Part 1 complete: decode Part 1 buffer and calculate hash for SW&HW version strings
-			_ubx_version = fnv1_32_str(_buf.payload_rx_mon_ver_part1.swVersion, FNV1_32_INIT);
-			_ubx_version = fnv1_32_str(_buf.payload_rx_mon_ver_part1.hwVersion, _ubx_version);
-//			Console.print("VER hash 0x%08x\r\n", _ubx_version);
-//			Console.print("VER hw  \"%10s\"\r\n", _buf.payload_rx_mon_ver_part1.hwVersion);
-//			Console.print("VER sw  \"%30s\"\r\n", _buf.payload_rx_mon_ver_part1.swVersion);
-		}
-
-		// fill Part 2 buffer
-		unsigned buf_index = (_rx_payload_index - sizeof(ubx_payload_rx_mon_ver_part1_t)) % sizeof(
-					     ubx_payload_rx_mon_ver_part2_t);
-		_buf.raw[buf_index] = b;
-
-		if (buf_index == sizeof(ubx_payload_rx_mon_ver_part2_t) - 1) {
-			// Part 2 complete: decode Part 2 buffer
-			//Console.print("VER ext \" %30s\"\r\n", _buf.payload_rx_mon_ver_part2.extension);
-		}
-	}
-
-	if (++_rx_payload_index >= _rx_payload_length) {
-		ret = 1;	// payload received completely
+	if (len < sizeof(ubx_payload_rx_mon_ver_part1_t)) {
+		return;
 	}
-
-	return ret;
+	
+	// decode Part 1 and calculate hash for SW&HW version strings, extensions (Part 2) are not used
+	memcpy(_buf.raw, payload, sizeof(ubx_payload_rx_mon_ver_part1_t));
+	_buf.payload_rx_mon_ver_part1.swVersion[sizeof(_buf.payload_rx_mon_ver_part1.swVersion) - 1] = '\0';
+	_buf.payload_rx_mon_ver_part1.hwVersion[sizeof(_buf.payload_rx_mon_ver_part1.hwVersion) - 1] = '\0';
+	_ubx_version = fnv1_32_str(_buf.payload_rx_mon_ver_part1.swVersion, FNV1_32_INIT);
+	_ubx_version = fnv1_32_str(_buf.payload_rx_mon_ver_part1.hwVersion, _ubx_version);
 }
 
 int	// 0 = no message handled, 1 = message handled, 2 = sat info message handled
@@ -599,18 +542,57 @@ _payload_rx_init()
 	return ret;
 }
 
-int	// -1 = error, 0 = ok, 1 = payload completed
-_payload_rx_add(const uint8_t b)
+// called by the decoder once the header of a frame is complete
+static int _ubx_accept(void* ctx, uint16_t msg, uint16_t len)
 {
-	int ret = 0;
-
-	_buf.raw[_rx_payload_index] = b;
+	_rx_msg = msg;
+	_rx_payload_length = len;
+	
+	// only frames to be handled are assembled and checksummed
+	return _payload_rx_init() == 0 && _rx_state == UBX_RXMSG_HANDLE;
+}
 
-	if (++_rx_payload_index >= _rx_payload_length) {
-		ret = 1;	// payload received completely
+// called by the decoder with the payload of a frame with valid checksum
+static void _ubx_handle(void* ctx, uint16_t msg, const uint8_t* payload, uint16_t len)
+{
+	_rx_msg = msg;
+	_rx_payload_length = len;
+	
+	switch (msg) {
+		case UBX_MSG_NAV_SVINFO:
+		{
+			payload_rx_nav_svinfo(payload, len);
+		}break;
+		case UBX_MSG_MON_VER:
+		{
+			payload_rx_mon_ver(payload, len);
+		}break;
+		default:
+		{
+			// lengths were checked by _payload_rx_init()
+			memcpy(_buf.raw, payload, MIN(len, sizeof(_buf.raw)));
+		}break;
 	}
+	
+	payload_rx_done();
+}
 
-	return ret;
+// wait up to timeout ticks for rx data and decode everything received
+static void _gps_receive(rt_int32_t timeout)
+{
+	static uint8_t block[GPS_RX_BLOCK_SIZE];
+	rt_size_t bytes;
+	
+	if (rt_sem_take(&_rx_sem, timeout) != RT_EOK) {
+		return;
+	}
+	
+	do {
+		bytes = rt_device_read(serial_device, 0, block, sizeof(block));
+		if (bytes) {
+			ubx_decoder_feed(&_decoder, block, bytes);
+		}
+	} while (bytes == sizeof(block));
 }
 
 int	// -1 = NAK, error or timeout, 0 = ACK
@@ -621,9 +603,13 @@ _wait_for_ack(const uint16_t msg, const uint32_t timeout)
 	_ack_state = UBX_ACK_WAITING;
 	_ack_waiting_msg = msg;	// memorize sent msg class&ID for ACK check
 	
-	uint32_t time_started = time_nowMs();
+	uint32_t time_deadline = time_nowMs() + timeout;
+	uint32_t time_now;
 	
-	while((_ack_state == UBX_ACK_WAITING) && (time_nowMs() < time_started + timeout)){;}
+	// decode in this thread until the ack arrives, the gps thread is not running yet
+	while((_ack_state == UBX_ACK_WAITING) && ((time_now = time_nowMs()) < time_deadline)){
+		_gps_receive(rt_tick_from_millisecond(time_deadline - time_now));
+	}
 		
 	if (_ack_state == UBX_ACK_GOT_ACK){
 		ret = 0;	// ACK received ok
@@ -633,126 +619,6 @@ _wait_for_ack(const uint16_t msg, const uint32_t timeout)
 	return ret;
 }
 
-int	// 0 = decoding, 1 = message handled, 2 = sat info message handled
-_parse_ubx_char(const uint8_t c)
-{	
-	int ret = 0;
-	
-	//Console.print("%x," , c);
-	
-	switch(_decode_state)
-	{
-		case UBX_DECODE_SYNC1:
-		{
-			if(c == UBX_SYNC1){
-				_decode_state = UBX_DECODE_SYNC2;
-			}
-		}break;
-		case UBX_DECODE_SYNC2:
-		{
-			if (c == UBX_SYNC2) {	// Sync2 found --> expecting Class
-			_decode_state = UBX_DECODE_CLASS;
-			} else {		// Sync1 not followed by Sync2: reset parser
-				_decode_init();
-			}
-		}break;
-		case UBX_DECODE_CLASS:
-		{
-			_add_byte_to_checksum(c);  // checksum is calculated for everything except Sync and Checksum bytes
-			_rx_msg = c;
-			_decode_state = UBX_DECODE_ID;
-		}break;
-		case UBX_DECODE_ID:
-		{
-			_add_byte_to_checksum(c);
-			_rx_msg |= c << 8;
-			_decode_state = UBX_DECODE_LENGTH1;
-			
-			//Console.print("msg:%x\r\n" , _rx_msg);
-//			if(_rx_msg == UBX_MSG_NAV_SVINFO && _configured == RT_FALSE)
-//				_decode_init();	//if configuration is not finish, ignore SVINFO
-		}break;
-		case UBX_DECODE_LENGTH1:
-		{
-			_add_byte_to_checksum(c);
-			_rx_payload_length = c;
-			_decode_state = UBX_DECODE_LENGTH2;
-		}break;
-		case UBX_DECODE_LENGTH2:
-		{
-			_add_byte_to_checksum(c);
-			_rx_payload_length |= c << 8;	// calculate payload size
-			
-			//if(_rx_msg == UBX_MSG_NAV_SVINFO)
-			
-			if (_payload_rx_init() != 0) {	// start payload reception
-				// payload will not be handled, discard message
-				_decode_init();
-
-			} else {
-				_decode_state = (_rx_payload_length > 0) ? UBX_DECODE_PAYLOAD : UBX_DECODE_CHKSUM1;
-			}
-			//Console.print("len:%d\r\n" , _rx_payload_length);
-		}break;
-		case UBX_DECODE_PAYLOAD:
-		{
-			_add_byte_to_checksum(c);
-			
-			switch (_rx_msg) {
-				case UBX_MSG_NAV_SVINFO:
-				{
-					ret = payload_rx_add_nav_svinfo(c);	// add a NAV-SVINFO payload byte
-				}break;
-
-				case UBX_MSG_MON_VER:
-				{
-					ret = payload_rx_add_mon_ver(c);	// add a MON-VER payload byte
-				}break;
-
-				default:{
-					ret = _payload_rx_add(c);		// add a payload byte
-				}break;
-			}
-			
-			//Console.print("payload ret:%d\r\n" , ret);
-			if (ret < 0) {
-				// payload not handled, discard message
-				_decode_init();
-			} else if (ret > 0) {
-				// payload complete, expecting checksum
-				_decode_state = UBX_DECODE_CHKSUM1;
-			} else {
-				// expecting more payload, stay in state UBX_DECODE_PAYLOAD
-			}
-
-			ret = 0;
-		}break;
-		case UBX_DECODE_CHKSUM1:
-		{
-			if (_rx_ck_a != c) {
-				//Console.print("ubx checksum err\r\n");
-				_decode_init();
-			} else {
-				_decode_state = UBX_DECODE_CHKSUM2;
-			}
-		}break;
-		case UBX_DECODE_CHKSUM2:
-		{
-			//Console.print("check sum 2\r\n");
-			if (_rx_ck_b != c) {
-				Console.print("ubx checksum err\r\n");
-			} else {
-				ret = payload_rx_done();	// finish payload processing
-			}
-
-			_decode_init();
-		}break;
-	}
-	//Console.print("state:%d %x\r\n" , _decode_state , c);
-	
-	return ret;
-}
-
 void _calc_ubx_checksum(const uint8_t *buffer, const uint16_t length, ubx_checksum_t *checksum)
 {
 	for (uint16_t i = 0; i < length; i++) {
@@ -807,10 +673,15 @@ int _configure_by_ubx(void)
 	for(i = 0 ; i<sizeof(baudrates) / sizeof(baudrates[0]) ; i++){
 		baudrate = baudrates[i];
 		_set_baudrate(serial_device, baudrate);
-		/* flush input and wait for at least 20 ms silence */
-		_decode_init();
-		time_waitMs(20);
-		_decode_init();
+		/* flush input and wait for at least 20 ms silence, sleeping so the
+		 * rest of the boot runs meanwhile */
+		ubx_decoder_reset(&_decoder);
+		rt_thread_delay(rt_tick_from_millisecond(20));
+		while (rt_sem_take(&_rx_sem, RT_WAITING_NO) == RT_EOK) {
+			uint8_t dummy[GPS_RX_BLOCK_SIZE];
+			while (rt_device_read(serial_device, 0, dummy, sizeof(dummy)) == sizeof(dummy));
+		}
+		ubx_decoder_reset(&_decoder);
 		
 		/* Send a CFG-PRT message to set the UBX protocol for in and out
 		 * and leave the baudrate as it is, we just want an ACK-ACK for this */
@@ -953,23 +824,19 @@ int _configure_by_ubx(void)
 //this function will be callback on rt_hw_serial_isr()
 static rt_err_t gps_serial_rx_ind(rt_device_t dev, rt_size_t size)
 {
-	rt_size_t bytes;
-	uint8_t ch[RT_SERIAL_RB_BUFSZ];
-	
-	bytes = rt_device_read(serial_device , 0 , ch , size);
-	
-	if(bytes){
-		for(uint32_t j = 0 ; j<bytes ; j++){
-			//Console.print("%x," , ch[j]);
-			_parse_ubx_char(ch[j]);
-		}
-	}else{
-		Console.print("ubx listen err:%ld\r\n" , bytes);
-	}
+	// data is decoded in thread context, just wake up the reader
+	rt_sem_release(&_rx_sem);
 	
     return RT_EOK;
 }
 
+static void gps_entry(void *parameter)
+{
+	while(1){
+		_gps_receive(RT_WAITING_FOREVER);
+	}
+}
+
 rt_err_t gps_init(rt_device_t dev)
 {	
 	_configured = RT_FALSE;
@@ -980,19 +847,32 @@ rt_err_t gps_init(rt_device_t dev)
 	_got_velned = RT_FALSE;
 	_got_svinfo = RT_FALSE;
 	
+	ubx_decoder_init(&_decoder, _ubx_accept, _ubx_handle, RT_NULL);
+	rt_sem_init(&_rx_sem, "gps_rx", 0, RT_IPC_FLAG_FIFO);
+	
 	rt_device_set_rx_indicate(serial_device, gps_serial_rx_ind);
 	rt_device_open(serial_device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX);
 	
 	for(uint8_t i = 0 ; i<CONFIGURE_RETRY_MAX ; i++){
 		if(_configure_by_ubx() == 0){
 			// gps configuration success
-			return RT_EOK;
+			break;
 		}
 	}
 	
 	// gps configuration fail
 	//return RT_ERROR;
 //	//TODO:
+	
+	/* decode the gps stream in thread context from now on */
+	if(rt_thread_init(&thread_gps_handle,
+						   "gps",
+						   gps_entry,
+						   RT_NULL,
+						   &thread_gps_stack[0],
+						   sizeof(thread_gps_stack),GPS_THREAD_PRIORITY,1) == RT_EOK)
+		rt_thread_startup(&thread_gps_handle);
+	
 	return RT_EOK;
 }
 
@@ -0,0 +1,196 @@
+/*
+ * File      : ubx_decoder.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include "ubx_decoder.h"
+
+#define UBX_SYNC1	0xB5
+#define UBX_SYNC2	0x62
+
+static int _chksum_ok(const uint8_t* frame, uint16_t payload_len)
+{
+	const uint8_t* p = &frame[2];
+	const uint8_t* end = &frame[UBX_DECODER_HEADER_SIZE + payload_len];
+	uint8_t ck_a = 0, ck_b = 0;
+
+	/* checksum covers class, id, length and payload */
+	while (p < end) {
+		ck_a += *p++;
+		ck_b += ck_a;
+	}
+
+	return ck_a == end[0] && ck_b == end[1];
+}
+
+static void _deliver(ubx_decoder_t* dec, const uint8_t* frame, uint16_t payload_len)
+{
+	if (_chksum_ok(frame, payload_len)) {
+		dec->stat.frames++;
+		dec->handle(dec->ctx, frame[2] | frame[3] << 8, &frame[UBX_DECODER_HEADER_SIZE], payload_len);
+	} else {
+		dec->stat.chksum_err++;
+	}
+}
+
+/* decide on a complete header, return the frame size or 0 if it is not wanted */
+static uint16_t _check_header(ubx_decoder_t* dec, const uint8_t* header)
+{
+	uint16_t msg = header[2] | header[3] << 8;
+	uint16_t len = header[4] | header[5] << 8;
+
+	if (!dec->accept(dec->ctx, msg, len)) {
+		dec->stat.skipped++;
+		return 0;
+	}
+
+	if (len > UBX_DECODER_FRAME_MAX - UBX_DECODER_HEADER_SIZE - UBX_DECODER_CHKSUM_SIZE) {
+		dec->stat.oversize++;
+		return 0;
+	}
+
+	return len + UBX_DECODER_HEADER_SIZE + UBX_DECODER_CHKSUM_SIZE;
+}
+
+/* drop leading carry bytes until the carry starts with a possible sync */
+static void _carry_resync(ubx_decoder_t* dec)
+{
+	while (dec->fill) {
+		const uint8_t* p = (const uint8_t*)memchr(&dec->carry[1], UBX_SYNC1, dec->fill - 1);
+
+		if (p == NULL) {
+			dec->fill = 0;
+			break;
+		}
+
+		dec->fill -= p - dec->carry;
+		memmove(dec->carry, p, dec->fill);
+
+		if (dec->fill < 2 || dec->carry[1] == UBX_SYNC2) {
+			break;
+		}
+	}
+}
+
+/* continue a frame kept in the carry buffer, return bytes consumed */
+static uint32_t _feed_carry(ubx_decoder_t* dec, const uint8_t* data, uint32_t len)
+{
+	uint32_t used = 0;
+
+	if (dec->need == 0) {
+		/* header still incomplete */
+		while (dec->fill < UBX_DECODER_HEADER_SIZE && used < len) {
+			dec->carry[dec->fill++] = data[used++];
+
+			if (dec->fill == 2 && dec->carry[1] != UBX_SYNC2) {
+				_carry_resync(dec);
+				if (dec->fill == 0) {
+					/* nothing left to continue, back to scanning */
+					return used;
+				}
+			}
+		}
+
+		if (dec->fill < UBX_DECODER_HEADER_SIZE) {
+			return used;
+		}
+
+		dec->need = _check_header(dec, dec->carry);
+
+		if (dec->need == 0) {
+			/* not wanted, scan on after the sync bytes */
+			_carry_resync(dec);
+			return used;
+		}
+	}
+
+	uint32_t n = dec->need - dec->fill;
+
+	if (n > len - used) {
+		n = len - used;
+	}
+
+	memcpy(&dec->carry[dec->fill], &data[used], n);
+	dec->fill += n;
+	used += n;
+
+	if (dec->fill == dec->need) {
+		_deliver(dec, dec->carry, dec->need - UBX_DECODER_HEADER_SIZE - UBX_DECODER_CHKSUM_SIZE);
+		dec->fill = 0;
+		dec->need = 0;
+	}
+
+	return used;
+}
+
+void ubx_decoder_init(ubx_decoder_t* dec, ubx_accept_fn accept, ubx_frame_fn handle, void* ctx)
+{
+	memset(&dec->stat, 0, sizeof(dec->stat));
+	dec->accept = accept;
+	dec->handle = handle;
+	dec->ctx = ctx;
+	ubx_decoder_reset(dec);
+}
+
+void ubx_decoder_reset(ubx_decoder_t* dec)
+{
+	dec->fill = 0;
+	dec->need = 0;
+}
+
+void ubx_decoder_feed(ubx_decoder_t* dec, const uint8_t* data, uint32_t len)
+{
+	uint32_t pos = 0;
+
+	dec->stat.bytes += len;
+
+	while (pos < len) {
+		if (dec->fill) {
+			pos += _feed_carry(dec, &data[pos], len - pos);
+			continue;
+		}
+
+		const uint8_t* p = (const uint8_t*)memchr(&data[pos], UBX_SYNC1, len - pos);
+
+		if (p == NULL) {
+			break;
+		}
+
+		pos = p - data;
+
+		if (len - pos < UBX_DECODER_HEADER_SIZE) {
+			/* header split across blocks */
+			dec->fill = len - pos;
+			memcpy(dec->carry, p, dec->fill);
+			if (dec->fill >= 2 && dec->carry[1] != UBX_SYNC2) {
+				_carry_resync(dec);
+			}
+			break;
+		}
+
+		if (p[1] != UBX_SYNC2) {
+			pos++;
+			continue;
+		}
+
+		uint16_t size = _check_header(dec, p);
+
+		if (size == 0) {
+			/* not wanted, a real frame may still start inside this header */
+			pos += 2;
+		} else if (len - pos >= size) {
+			/* whole frame inside the block, no copy */
+			_deliver(dec, p, size - UBX_DECODER_HEADER_SIZE - UBX_DECODER_CHKSUM_SIZE);
+			pos += size;
+		} else {
+			dec->need = size;
+			dec->fill = len - pos;
+			memcpy(dec->carry, p, dec->fill);
+			break;
+		}
+	}
+}
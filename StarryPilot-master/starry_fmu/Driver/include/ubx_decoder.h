@@ -0,0 +1,56 @@
+/*
+ * File      : ubx_decoder.h
+ *
+ * Block based UBX frame decoder. It works on whole rx blocks in thread
+ * context: sync bytes are located with memchr, the checksum of a frame is
+ * computed in one pass, and frames are only assembled and verified when
+ * the accept callback wants their message class/id. Frames that lie
+ * completely inside a block are handed out in place without any copy.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __UBX_DECODER_H__
+#define __UBX_DECODER_H__
+
+#include <stdint.h>
+
+#ifndef UBX_DECODER_FRAME_MAX
+#define UBX_DECODER_FRAME_MAX		1024	/* sync + header + payload + checksum */
+#endif
+
+#define UBX_DECODER_HEADER_SIZE		6
+#define UBX_DECODER_CHKSUM_SIZE		2
+
+/* return non-zero if the message should be decoded, called once per header */
+typedef int (*ubx_accept_fn)(void* ctx, uint16_t msg, uint16_t len);
+/* called with the payload of a verified frame, payload is only valid during the call */
+typedef void (*ubx_frame_fn)(void* ctx, uint16_t msg, const uint8_t* payload, uint16_t len);
+
+typedef struct
+{
+	uint32_t bytes;			/* bytes fed */
+	uint32_t frames;		/* frames handed to the frame callback */
+	uint32_t skipped;		/* frames not accepted */
+	uint32_t chksum_err;	/* accepted frames with bad checksum */
+	uint32_t oversize;		/* accepted frames longer than UBX_DECODER_FRAME_MAX */
+}ubx_decoder_stat;
+
+typedef struct
+{
+	uint8_t carry[UBX_DECODER_FRAME_MAX];	/* frame split across blocks */
+	uint16_t fill;							/* bytes in carry */
+	uint16_t need;							/* frame size once the header is known */
+	ubx_accept_fn accept;
+	ubx_frame_fn handle;
+	void* ctx;
+	ubx_decoder_stat stat;
+}ubx_decoder_t;
+
+void ubx_decoder_init(ubx_decoder_t* dec, ubx_accept_fn accept, ubx_frame_fn handle, void* ctx);
+void ubx_decoder_reset(ubx_decoder_t* dec);
+void ubx_decoder_feed(ubx_decoder_t* dec, const uint8_t* data, uint32_t len);
+
+#endif
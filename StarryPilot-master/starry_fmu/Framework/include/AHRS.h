@@ -15,6 +15,8 @@
 
 void AHRS_reset(quaternion * q, const float acc[3],const float mag[3]);
 void AHRS_update(quaternion * q,const float gyr[3],const float acc[3],const float mag[3],float dT);
+void AHRS_get_gyr_bias(float bias[3]);
+void AHRS_set_gyr_bias(const float bias[3]);
 void MahonyAHRS_update(quaternion * q,const float gyr[3],const float acc[3],const float mag[3],float dT);
 void MARG_AHRS_update(quaternion* q, float g_x, float g_y, float g_z, float a_x, float a_y, float a_z, float m_x, float m_y, float m_z, float dT);
 void AHRS_gyr_acc_fusion(quaternion * q, const float gyr[3], const float acc[3], float dT);
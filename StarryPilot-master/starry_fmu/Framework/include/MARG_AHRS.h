@@ -13,6 +13,6 @@
 #include "quaternion.h"
 #include "ap_math.h"
 
-void MARG_AHRS_Update(quaternion* q, float g_x, float g_y, float g_z, float a_x, float a_y, float a_z, float m_x, float m_y, float m_z, float dT);
+void MARG_AHRS_update(quaternion* q, float g_x, float g_y, float g_z, float a_x, float a_y, float a_z, float m_x, float m_y, float m_z, float dT);
 
 #endif
\ No newline at end of file
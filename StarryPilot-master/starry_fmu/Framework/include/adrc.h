@@ -64,6 +64,47 @@ typedef struct
 	float c;
 }ADRC_NLSEF_Def;
 
+/* The same TD, LESO and NLSEF for up to three axes side by side, one array
+ * entry per axis, so that one call updates every axis in a single pass of
+ * branch free code. The axes share their parameters. */
+#define ADRC_AXIS_NUM		3
+
+typedef struct
+{
+	uint8_t axis_num;
+	float h;
+	float r;
+	float h0;
+	float d;		/* h0*h0*r */
+	float inv_d;
+	float v1[ADRC_AXIS_NUM];
+	float v2[ADRC_AXIS_NUM];
+}ADRC_TD3_Def;	/* tracking differentiator, or TD controller */
+
+typedef struct
+{
+	uint8_t axis_num;
+	float h;
+	float beta1;
+	float beta2;
+	float b0[ADRC_AXIS_NUM];
+	float u[ADRC_AXIS_NUM];
+	/* LESO */
+	float z1[ADRC_AXIS_NUM];
+	float z2[ADRC_AXIS_NUM];
+}ADRC_LESO3_Def;
+
+typedef struct
+{
+	uint8_t axis_num;
+	float h;
+	float h1;
+	float r1;
+	float c;
+	float d;		/* h1*h1*r1 */
+	float inv_d;
+}ADRC_NLSEF3_Def;
+
 void adrc_td_init(ADRC_TD_Def* td_t, float h, float r0, float h0);
 void adrc_td(ADRC_TD_Def* td, float v);
 void adrc_td_control_init(TD_Controller_Def* td_controller, float h, float r2, float h2);
@@ -75,5 +116,14 @@ void adrc_leso(ADRC_LESO_Def* leso_t, float y);
 void adrc_nlsef_init(ADRC_NLSEF_Def* nlsef_t, float h, float r1, float h1, float c);
 float adrc_nlsef(ADRC_NLSEF_Def* nlsef_t, float e1, float e2);
 
+void adrc_td3_init(ADRC_TD3_Def* td, uint8_t axis_num, float h, float r0, float h0);
+void adrc_td3(ADRC_TD3_Def* td, const float v[]);
+/* the TD controller of adrc_td_control, the output of each axis is left in v2 */
+void adrc_td3_control(ADRC_TD3_Def* td, const float err[]);
+void adrc_leso3_init(ADRC_LESO3_Def* leso, uint8_t axis_num, float h, float w, float b0);
+void adrc_leso3(ADRC_LESO3_Def* leso, const float y[]);
+void adrc_nlsef3_init(ADRC_NLSEF3_Def* nlsef, uint8_t axis_num, float h, float r1, float h1, float c);
+void adrc_nlsef3(const ADRC_NLSEF3_Def* nlsef, const float e1[], const float e2[], float u0[]);
+
 #endif
 
@@ -12,6 +12,7 @@
 
 #include <rtthread.h>
 #include "quaternion.h"
+#include "est_store.h"
 
 rt_err_t attitude_est_init(void);
 quaternion attitude_est_get_quaternion(void);
@@ -20,7 +21,10 @@ void attitude_inputAcc(const float acc[3]);
 void attitude_inputGyr(const float gyr[3]);
 void attitude_inputMag(const float mag[3]);
 void attitude_loop(void *parameter);
-void attitude_est_run(float dT);
+void attitude_est_run(void);
+void attitude_est_quaternion_to_euler(const void* q, void* e);
+void attitude_est_store_collect(Est_State* state);
+void attitude_est_store_apply(const Est_State* state);
 void att_gyr_acc_fusion(float dT);
 void att_mag_fusion(float dT);
 	
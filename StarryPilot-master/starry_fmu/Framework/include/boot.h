@@ -0,0 +1,36 @@
+/*
+ * File      : boot.h
+ *
+ * Boot graph. Each stage is an init function with the stages it depends
+ * on; stages with a stack run on their own thread as soon as their
+ * dependencies are done, the others run in order on the boot thread. The
+ * start and end of each stage are kept for "sys boot".
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __BOOT_H__
+#define __BOOT_H__
+
+#include <rtthread.h>
+#include "global.h"
+
+#define BOOT_STAGE_MAX		16
+#define BOOT_DEP(i)			(1u << (i))
+
+typedef struct
+{
+	const char* name;
+	rt_err_t (*init)(void);
+	uint32_t depend;		/* BOOT_DEP() of earlier stages */
+	uint16_t stack_size;	/* 0: run on the boot thread */
+}Boot_Stage;
+
+/* Run the stages and return once all of them are done. A failed stage is
+ * reported but does not hold back the stages depending on it. */
+rt_err_t boot_run(const Boot_Stage* stage, uint8_t num);
+void boot_report(void);
+
+#endif
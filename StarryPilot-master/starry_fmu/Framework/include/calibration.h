@@ -14,6 +14,7 @@
 //#include <rtdevice.h>
 #include "shell.h"
 #include "light_matrix.h"
+#include "ellipsoid_fit.h"
 
 #define CALI_THREAD_SLEEP_MS  5 /* cali thread run loop 5ms */
 #define GYR_CALIBRATE_COUNT   500
@@ -22,10 +23,7 @@
 
 typedef struct
 {
-	double V[9];
-	double D[9];
-	double P[9][9];
-	double R;
+	EllipsoidFit_Def fit;
 	
 	double OFS[3];
 	double GAIN[3];
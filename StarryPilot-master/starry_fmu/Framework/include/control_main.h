@@ -52,5 +52,10 @@ uint8_t control_request(bool request);
 uint8_t control_set(char* name, float val);
 HomePosition ctrl_get_home(void);
 uint8_t ctrl_set_home(void);
+FrameType ctrl_get_frame_type(void);
+/* attitude target of the last control step, rad */
+Euler ctrl_get_target_euler(void);
+/* 1 with the relative altitude held (m) in alt, 0 when not holding */
+uint8_t ctrl_get_alt_setpoint(float* alt);
 
 #endif
@@ -27,6 +27,8 @@ typedef enum
 	Pos_Period,
 }Copter_Period;
 
+void copter_init(void);
+void copter_main_loop(uint32_t att_est_period, uint32_t pos_est_period, uint32_t control_period);
 void copter_entry(void *parameter);
 uint32_t copter_get_event_period(Copter_Period event);
 
@@ -2,6 +2,9 @@
 #ifndef __DECLINATION_H__
 #define __DECLINATION_H__
 
+#include <stdint.h>
+
+int16_t compass_get_lookup_value(uint8_t x, uint8_t y);
 float compass_get_declination(double lat, double lon);
 	
 #endif
\ No newline at end of file
@@ -1,32 +1,46 @@
 /*
  * File      : delay.h
  *
+ * time source of time_nowUs/time_nowMs:
+ * - target: the cycle counter of the core (DWT), extended to 64 bit in the
+ *   SysTick interrupt by time_tick_update()
+ * - TIME_SOURCE_SIM: simulated time, it only moves when the simulator calls
+ *   time_sim_set/time_sim_step or when the code waits, so the flight code
+ *   can be stepped in lockstep at any speed
  *
  * Change Logs:
  * Date           Author       	Notes
  * 2016-6-6    		zoujiachi   	the first version
  */
- 
+
 #ifndef __DELAY_H__
 #define __DELAY_H__
 
 #include "stm32f4xx.h"
+#include "global.h"
 
-typedef struct 
+typedef struct
 {
     volatile uint32_t msPeriod;		//整周期的时间 , ms
-    uint32_t ticksPerUs;  			//每us的tick数 168M/1e6=168
-    uint32_t ticksPerMs;  			//每ms的tick数 168M/1e3=168000
+    uint32_t ticksPerUs;  			//每us的cycle数 168M/1e6=168
+    uint32_t ticksPerMs;  			//每ms的cycle数 168M/1e3=168000
     uint32_t msPerPeriod; 			//每周期的ms数
+    volatile uint64_t usBase;		//cycBase时刻的时间, us
+    volatile uint32_t cycBase;		//usBase时刻的cycle计数
 }DELAY_TIME_Def;
 
 void device_delay_init(void);
+void time_tick_update(void);
 uint64_t time_nowUs(void);
 uint32_t time_nowMs(void);
 void time_waitUs(uint32_t delay);
 void time_waitMs(uint32_t delay);
 
-extern DELAY_TIME_Def _delay_t;
-
+#ifdef TIME_SOURCE_SIM
+void time_sim_set(uint64_t us);
+void time_sim_step(uint64_t us);
 #endif
 
+extern VEHICLE_STATE DELAY_TIME_Def _delay_t;
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * File      : ellipsoid_fit.h
+ *
+ * Least squares fit of an ellipsoid
+ *   V0*x^2 + V1*y^2 + V2*z^2 + 2*V3*xy + 2*V4*xz + 2*V5*yz + 2*V6*x + 2*V7*y + 2*V8*z = 1
+ * either sample by sample (recursive least squares) or over a batch of samples.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __ELLIPSOID_FIT_H__
+#define __ELLIPSOID_FIT_H__
+
+#include <stdint.h>
+
+#define ELLIPSOID_FIT_N			9
+#define ELLIPSOID_FIT_U_SIZE	(ELLIPSOID_FIT_N*(ELLIPSOID_FIT_N-1)/2)
+
+/* All computation is in single precision. To keep it well conditioned the
+ * samples are divided by the norm of the first sample, so V and P live in
+ * that normalised space; ellipsoid_fit_get returns V for the raw samples.
+ * The covariance is kept factorised as P = U*diag(d)*U' (Bierman), which
+ * stays symmetric positive definite where P -= K*D*P would not in float. */
+typedef struct
+{
+	float V[ELLIPSOID_FIT_N];		/* ellipsoid parameters, normalised */
+	float U[ELLIPSOID_FIT_U_SIZE];	/* unit upper triangle of P, column by column */
+	float d[ELLIPSOID_FIT_N];		/* diagonal factor of P */
+	float R;						/* measurement noise */
+	float scale;					/* 1/|first sample|, 0 before the first sample */
+	uint32_t n;						/* samples taken */
+}EllipsoidFit_Def;
+
+void ellipsoid_fit_init(EllipsoidFit_Def* fit);
+void ellipsoid_fit_update(EllipsoidFit_Def* fit, const float val[3]);
+int ellipsoid_fit_batch(EllipsoidFit_Def* fit, const float (*val)[3], uint32_t n);
+void ellipsoid_fit_get(const EllipsoidFit_Def* fit, float V[ELLIPSOID_FIT_N]);
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * File      : est_store.h
+ *
+ * Warm start of the estimators. What takes them seconds to learn after a
+ * cold boot (the gyro bias, the accel z bias, for the EKF the attitude and
+ * bias covariance, and the magnetic declination) is written to the card on
+ * disarm and before a reboot, and read back at the next boot. The biases
+ * are only taken once the baro reports a temperature close to the one
+ * they were learned at.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __EST_STORE_H__
+#define __EST_STORE_H__
+
+#include <rtthread.h>
+#include "global.h"
+
+#define EST_STORE_FILE_NAME		"/sys/est_state.bin"
+#define EST_STORE_MAGIC			0x54534545	/* "EEST" */
+#define EST_STORE_VERSION		1
+
+/* validity of a stored state */
+#define EST_STORE_MAX_TEMP_DIFF	10.0f		/* deg C, of the baro */
+#define EST_STORE_MAX_AGE		(7*24*3600)	/* s, only checked with a running rtc */
+#define EST_STORE_MAX_BOOT		5			/* boots restored without a new save */
+/* how long to wait for the baro temperature after the first request */
+#define EST_STORE_TEMP_TIMEOUT	2000		/* ms */
+
+/* est_store_take */
+#define EST_STORE_NONE			-1			/* no state for this boot */
+#define EST_STORE_WAIT			0
+#define EST_STORE_OK			1
+
+typedef struct
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t crc;				/* math_crc16 of what follows */
+	float gyr_bias[3];			/* rad/s, the gyro reads rate + bias */
+	float acc_bias_z;			/* m/s^2, the body z accel reads acc + bias */
+	float att_var[4];			/* EKF variance of q0~q3, 0 from the AHRS */
+	float gyr_bias_var[3];		/* EKF variance of the gyro bias */
+	float acc_bias_z_var;
+	float mag_decl;				/* deg */
+	uint32_t mag_decl_set;		/* mag_decl is from a gps home */
+	float temperature;			/* deg C, baro at the save */
+	uint32_t time;				/* s, rtc at the save, 0 without rtc */
+	uint32_t boot_cnt;			/* boots it was restored at */
+}Est_State;
+
+/* Read the stored state once per boot and check its age, the estimators
+ * call it from their init. 0: there is a state to take. */
+int est_store_load(void);
+/* Host tools: warm start from state instead of the card. */
+void est_store_set(const Est_State* state);
+/* Called by the estimator on each update until it gives EST_STORE_OK
+ * (state filled, apply it) or EST_STORE_NONE. */
+int est_store_take(Est_State* state);
+/* the last known declination, 0: there is one */
+int est_store_get_decl(float* decl);
+/* Collect the state of the running estimator and write it. */
+rt_err_t est_store_save(void);
+/* Collect the state now and leave the write to the logger thread, for
+ * callers that must not block on the card. */
+void est_store_request_save(void);
+/* Write the state of the last request, if any. */
+void est_store_flush(void);
+
+#endif
@@ -32,6 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "global.h"
 
+void fast_loop(void);
 void fastloop_entry(void *parameter);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*
+ * File      : fast_math.h
+ *
+ * Polynomial approximations of the libm functions on the attitude paths,
+ * single precision, no tables and no branches on the argument.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __FAST_MATH_H__
+#define __FAST_MATH_H__
+
+#include <math.h>
+#include "global.h"
+#include "ap_math.h"
+
+/* Largest error over every float argument (tool/fast_math checks them
+ * exhaustively on the host):
+ *   fast_atan2f	< 4e-7 rad (2.3e-5 deg), odd minimax polynomial of degree 15
+ *   fast_asinf		< 4e-7 rad (2.3e-5 deg), sqrt(1-|x|) times a minimax polynomial
+ *					of degree 6, exact at 0 and +-1
+ *   math_rsqrt		< 5e-6 relative, the bit hack with two Newton steps (ap_math.c)
+ * Signed zeros follow libm: atan2(+-0, +0) is +-0 and atan2(+-0, -0) is +-pi.
+ * sqrtf stays libm, it is one VSQRT on the FPU. */
+float fast_atan2f(float y, float x);
+float fast_asinf(float x);
+
+/* Code that can live with the errors above calls these. FAST_MATH in
+ * global.h switches them between the approximations and libm. */
+#ifdef FAST_MATH
+	#define MATH_ATAN2F(y, x)		fast_atan2f(y, x)
+	#define MATH_ASINF(x)			fast_asinf(x)
+	#define MATH_RSQRTF(x)			math_rsqrt(x)
+#else
+	#define MATH_ATAN2F(y, x)		atan2f(y, x)
+	#define MATH_ASINF(x)			asinf(x)
+	#define MATH_RSQRTF(x)			(1.0f/sqrtf(x))
+#endif
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * File      : geo_proj.h
+ *
+ * Local tangent plane projection around a reference (home) coordinate.
+ * The scale factors of the reference are computed once by geo_proj_init,
+ * a projection then only takes a few single precision operations.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __GEO_PROJ_H__
+#define __GEO_PROJ_H__
+
+#include <stdint.h>
+
+#define GEO_EARTH_RADIUS		6371000.0	/* m, same sphere as gps_calc_geometry_distance2 */
+
+/* Accuracy against the azimuthal equidistant projection of
+ * gps_calc_geometry_distance2 (spherical earth, reference |lat| <= 70 deg):
+ *   horizontal error < 1 mm within 1 km of the reference,
+ *                    < 1 cm within 5 km, < 5 cm within 10 km, < 10 m within 50 km.
+ * The error grows with the cube of the distance, so call geo_proj_init
+ * again with a new reference if the vehicle flies further away.
+ * See tool/geo_proj for the host check. */
+typedef struct
+{
+	int32_t	ref_lat;	/* reference latitude, 1e-7 degree */
+	int32_t	ref_lon;	/* reference longitude, 1e-7 degree */
+	float	k_north;	/* m per 1e-7 degree of latitude */
+	float	k_east;		/* m per 1e-7 degree of longitude at ref_lat */
+	float	k_tan;		/* tan(ref_lat) in rad per 1e-7 degree, scales k_east with latitude */
+	float	k_conv;		/* tan(ref_lat)/(2R) in 1/m, meridian convergence */
+	uint8_t	init;		/* not bool, global.h typedefs its own */
+}GeoProj_Def;
+
+void geo_proj_init(GeoProj_Def* proj, int32_t ref_lat, int32_t ref_lon);
+int geo_proj_project(const GeoProj_Def* proj, int32_t lat, int32_t lon, float* x, float* y);
+
+#endif
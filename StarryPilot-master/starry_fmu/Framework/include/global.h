@@ -20,6 +20,7 @@
 
 #define FASTLOOP_THREAD_PRIORITY		3
 #define COPTER_THREAD_PRIORITY			4
+#define GPS_THREAD_PRIORITY				8
 #define STARRYIO_THREAD_PRIORITY		9
 #define FINSH_THREAD_PRIORITY			10
 #define LOGGER_THREAD_PRIORITY			11
@@ -47,9 +48,24 @@
 
 /* HIL simulation */
 //#define HIL_SIMULATION
+/* with HIL_SIMULATION, fly the built-in vehicle model instead of an external simulator */
+//#define HIL_USE_MODEL
 
 /* global configuration */
 //#define AHRS_USE_EKF
+/* the polynomial atan2/asin and the rsqrt bit hack of fast_math.h instead of
+ * libm where the code opted in, see fast_math.h for their errors */
+#define FAST_MATH
+
+/* The state of the vehicle lives in file scope (and function static)
+ * variables, each declared VEHICLE_STATE. On target that is nothing. A host
+ * build with MULTI_VEHICLE makes them thread local, so every thread running
+ * the flight code flies a vehicle of its own. */
+#ifdef MULTI_VEHICLE
+	#define VEHICLE_STATE		__thread
+#else
+	#define VEHICLE_STATE
+#endif
 
 typedef int bool;
 #define true	1
@@ -0,0 +1,53 @@
+/*
+ * File      : imu_integrator.h
+ *
+ * Integrates the gyro and acc samples into a delta angle and a delta
+ * velocity over an interval, with the coning and sculling corrections, so
+ * an estimator running slower than the sensors sees every sample.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __IMU_INTEGRATOR_H__
+#define __IMU_INTEGRATOR_H__
+
+#include <stdint.h>
+#include "global.h"
+
+typedef struct
+{
+	float delta_ang[3];		/* rad, rotation over the interval, coning corrected */
+	float delta_vel[3];		/* m/s, specific force over the interval in the body frame at its start, sculling corrected */
+	float dt;				/* s, length of the interval */
+	uint32_t time_stamp;	/* ms, end of the interval */
+}IMU_Delta;
+
+typedef struct
+{
+	uint32_t interval_us;
+	uint64_t last_us;		/* time of the last sample, 0 before the first */
+	uint32_t dt_us;			/* integrated so far */
+	float last_gyr[3];
+	float last_acc[3];
+	float alpha[3];			/* sum of the delta angles */
+	float beta[3];			/* coning */
+	float vel[3];			/* sum of the delta velocities */
+	float scul[3];			/* sculling */
+	float last_dalpha[3];
+	float last_dvel[3];
+}IMU_Integrator;
+
+void imu_integrator_reset(IMU_Integrator* integ, uint32_t interval_ms);
+/* add a sample taken at time_us, returns true for the sample that fills the
+ * interval; later samples are integrated on until imu_integrator_output */
+bool imu_integrator_input(IMU_Integrator* integ, const float gyr[3], const float acc[3], uint64_t time_us);
+/* true while at least one interval is integrated */
+bool imu_integrator_full(const IMU_Integrator* integ);
+/* the delta integrated so far, the integration goes on */
+void imu_integrator_peek(const IMU_Integrator* integ, IMU_Delta* delta);
+/* the delta integrated so far, then start the next one */
+void imu_integrator_output(IMU_Integrator* integ, IMU_Delta* delta);
+
+#endif
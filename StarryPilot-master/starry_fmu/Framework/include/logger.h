@@ -91,6 +91,8 @@ typedef struct
 	LOG_ELEMENT_FLOAT(GPS_HDOP);
 	LOG_ELEMENT_FLOAT(BARO_ALT);
 	LOG_ELEMENT_FLOAT(BARO_VEL);
+	LOG_ELEMENT_FLOAT(ROLL_SP);
+	LOG_ELEMENT_FLOAT(PITCH_SP);
 //	LOG_ELEMENT_FLOAT(KF_U_X);
 //	LOG_ELEMENT_FLOAT(KF_U_Y);
 //	LOG_ELEMENT_FLOAT(KF_U_Z);
@@ -145,5 +147,8 @@ typedef struct
 }LOG_HeaderDef;
 
 void logger_entry(void *parameter);
+/* have the logger thread call est_store_flush, or call it directly when
+ * the logger thread is not running */
+void logger_request_est_store(void);
 
 #endif
@@ -0,0 +1,64 @@
+/*
+ * File      : mixer.h
+ *
+ * Table driven motor mixer: each motor output is a row of an N x 4 matrix
+ * times the roll, pitch, yaw and thrust commands, followed by one of the
+ * desaturation strategies when an output leaves the motor range.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __MIXER_H__
+#define __MIXER_H__
+
+#include <stdint.h>
+#include "control_main.h"
+
+#define MIXER_MAX_MOTOR		6
+
+typedef enum
+{
+	MIXER_ROLL = 0,
+	MIXER_PITCH,
+	MIXER_YAW,
+	MIXER_THRUST,
+	MIXER_AXIS_NUM,
+}Mixer_Axis;
+
+typedef enum
+{
+	/* clip every output to the range on its own, as ctrl_constrain_throttle does */
+	MIXER_DESAT_CLIP = 0,
+	/* roll and pitch keep priority, yaw is the first to give way, thrust is
+	 * only lowered */
+	MIXER_DESAT_YAW,
+	/* roll, pitch and yaw keep full authority at any throttle, thrust is
+	 * shifted either way to make room; the three are scaled down together
+	 * when even that does not fit */
+	MIXER_DESAT_AIRMODE,
+	MIXER_DESAT_NUM,
+}Mixer_Desat;
+
+typedef struct
+{
+	uint8_t motor_num;
+	uint8_t desat;
+	float out_min;
+	float out_max;
+	float mix[MIXER_MAX_MOTOR][MIXER_AXIS_NUM];
+	float inv_thrust[MIXER_MAX_MOTOR];	/* 1/mix[i][MIXER_THRUST] */
+}Mixer_Def;
+
+/* motors of the built-in geometry of a frame type, 0 when unknown */
+uint8_t mixer_frame_motor_num(FrameType frame);
+/* built-in geometry, mixer_frame_motor_num() rows of roll, pitch, yaw, thrust */
+const float (*mixer_frame_geometry(FrameType frame))[MIXER_AXIS_NUM];
+/* 0 on success, 1 with a bad motor number, 2 unless every thrust coefficient is positive */
+uint8_t mixer_init(Mixer_Def* mixer, const float (*mix)[MIXER_AXIS_NUM], uint8_t motor_num,
+					float out_min, float out_max, Mixer_Desat desat);
+/* ctrl: roll, pitch, yaw, thrust, out: motor_num outputs within out_min~out_max */
+void mixer_run(const Mixer_Def* mixer, const float ctrl[MIXER_AXIS_NUM], float* out);
+
+#endif
@@ -12,6 +12,7 @@
 
 #include <stm32f4xx.h>
 #include "quaternion.h"
+#include "global.h"
 
 #define PARAM_MAX_NAME_LEN
 
@@ -218,6 +219,38 @@ typedef struct
 	PARAM_DECLARE(HIL_POS_EST_PRD);
 	PARAM_DECLARE(HIL_CONTROL_PRD);
 }PARAM_GROUP(HIL_SIM);
+
+typedef struct
+{
+	PARAM_DECLARE(MIX_SOURCE);
+	PARAM_DECLARE(MIX_DESAT);
+	PARAM_DECLARE(MIX_MOTOR_NUM);
+	/* keep the rows together and in order, they are read as one matrix */
+	PARAM_DECLARE(MIX_M1_ROLL);
+	PARAM_DECLARE(MIX_M1_PITCH);
+	PARAM_DECLARE(MIX_M1_YAW);
+	PARAM_DECLARE(MIX_M1_THRUST);
+	PARAM_DECLARE(MIX_M2_ROLL);
+	PARAM_DECLARE(MIX_M2_PITCH);
+	PARAM_DECLARE(MIX_M2_YAW);
+	PARAM_DECLARE(MIX_M2_THRUST);
+	PARAM_DECLARE(MIX_M3_ROLL);
+	PARAM_DECLARE(MIX_M3_PITCH);
+	PARAM_DECLARE(MIX_M3_YAW);
+	PARAM_DECLARE(MIX_M3_THRUST);
+	PARAM_DECLARE(MIX_M4_ROLL);
+	PARAM_DECLARE(MIX_M4_PITCH);
+	PARAM_DECLARE(MIX_M4_YAW);
+	PARAM_DECLARE(MIX_M4_THRUST);
+	PARAM_DECLARE(MIX_M5_ROLL);
+	PARAM_DECLARE(MIX_M5_PITCH);
+	PARAM_DECLARE(MIX_M5_YAW);
+	PARAM_DECLARE(MIX_M5_THRUST);
+	PARAM_DECLARE(MIX_M6_ROLL);
+	PARAM_DECLARE(MIX_M6_PITCH);
+	PARAM_DECLARE(MIX_M6_YAW);
+	PARAM_DECLARE(MIX_M6_THRUST);
+}PARAM_GROUP(MIXER);
 /* Parameter Declare End */		
 
 #define PARAM_GET(_group, _name)				((_param_##_group *)(param_list._param_##_group.content))->_name
@@ -242,13 +275,20 @@ typedef struct{
 	param_group_info	PARAM_GROUP(ALT_CONTROLLER);
 	param_group_info	PARAM_GROUP(ADRC_ATT);
 	param_group_info	PARAM_GROUP(HIL_SIM);
+	param_group_info	PARAM_GROUP(MIXER);
 }param_list_t;
 
-extern param_list_t param_list;
+extern VEHICLE_STATE param_list_t param_list;
 
 uint8_t param_init(void);
 const PARAM_Def * get_param(void);
 void param_release(void);
+#ifdef MULTI_VEHICLE
+/* give the calling vehicle its own copy of the parameters, so one
+ * vehicle's param_set does not change the others */
+uint8_t param_vehicle_init(void);
+void param_vehicle_release(void);
+#endif
 
 param_info_t* param_get(char* group_name, char* param_name);
 param_info_t* param_get_by_name(char* param_name);
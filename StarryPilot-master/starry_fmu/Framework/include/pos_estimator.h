@@ -13,6 +13,7 @@
 #include <rtthread.h>
 #include <rtdevice.h>
 #include "global.h"
+#include "geo_proj.h"
 
 typedef struct
 {
@@ -24,6 +25,7 @@ typedef struct
 	bool	lidar_altitude_set;
 	bool	gps_coordinate_set;
 	float	mag_decl;	/* magnetic declination, in degree */
+	GeoProj_Def proj;	/* local tangent plane around lat/lon */
 }HOME_Pos;
 
 typedef enum
@@ -73,9 +75,11 @@ typedef struct
 	float obs_vz;
 }POS_KF_Log;
 
-void pos_est_init(float dT);
+rt_err_t pos_est_init(float dT);
 void pos_est_reset(void);
 void pos_est_update(float dT);
+void pos_est_get_acc_bias(float bias[3]);
+void pos_est_set_acc_bias(const float bias[3]);
 HOME_Pos pos_home_get(void);
 void pos_get_home(HOME_Pos* home_pos);
 void pos_home_set(HOME_Item item, void* data);
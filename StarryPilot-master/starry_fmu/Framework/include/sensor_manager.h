@@ -15,6 +15,7 @@
 #include "ms5611.h"
 #include "global.h"
 #include "ap_math.h"
+#include "imu_integrator.h"
 
 //#define USE_EXTERNAL_MAG_DEV
 
@@ -109,6 +110,7 @@ typedef struct
 }GPS_Driv_Vel;
 
 rt_err_t device_sensor_init(void);
+rt_err_t device_gps_init(void);
 void sensor_manager_init(void);
 void sensor_loop(void *parameter);
 
@@ -147,12 +149,19 @@ bool lidar_is_ready(void);
 void lidar_lite_store(float dis);
 
 /* gps API */
+struct vehicle_gps_position_s;
 struct vehicle_gps_position_s gps_get_report(void);
 int gps_get_position(Vector3f_t* gps_pos, struct vehicle_gps_position_s gps_report);
 int gps_get_velocity(Vector3f_t* gps_vel, struct vehicle_gps_position_s gps_report);
 void gps_calc_geometry_distance(Vector3f_t* dis, double lat1, double lon1, double lat2, double lon2);
 void gps_calc_geometry_distance2(Vector3f_t* dis, double ref_lat, double ref_lon, double lat, double lon);
 void gps_get_status(GPS_Status* gps_sta);
+bool gps_status_update(GPS_Status* gps_sta, const struct vehicle_gps_position_s* gps_report);
+
+/* imu delta API */
+void sensor_imu_delta_set_interval(uint32_t interval_ms);
+void sensor_imu_delta_update(const float gyr[3], const float acc[3]);
+bool sensor_imu_delta_take(IMU_Delta* imu_delta);
 
 /* common api */
 void sensor_collect(void);
@@ -0,0 +1,27 @@
+/*
+ * File      : sitl_interface.h
+ *
+ * Closes the HIL loop on the built-in vehicle model (sitl_model.c) instead
+ * of an external simulator: the model takes MOTOR_THROTTLE and publishes
+ * HIL_SENSOR and GPS_POSITION, which hil_sensor_collect() turns into the
+ * sensor topics as it does for the MAVLink HIL messages.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __SITL_INTERFACE_H__
+#define __SITL_INTERFACE_H__
+
+#include "sitl_model.h"
+
+/* the model is stepped once per fast loop */
+#define SITL_STEP_MS			1
+#define SITL_GPS_PERIOD			100
+
+int sitl_interface_init(const SITL_Param_Def* param, FrameType frame, uint32_t seed);
+void sitl_interface_step(void);
+SITL_Model_Def* sitl_interface_get_model(void);
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * File      : sitl_model.h
+ *
+ * Rigid body multirotor model for software in the loop simulation: motor
+ * lag, thrust and reaction torque, drag, ground contact and noisy
+ * gyr/acc/mag/baro/gps. The motor layout is derived from the built-in
+ * mixer geometry (mixer.c), so every frame type it has can be flown.
+ *
+ * The model only depends on its inputs and a seeded random generator;
+ * stepping it with the same throttle and step size gives the same result.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __SITL_MODEL_H__
+#define __SITL_MODEL_H__
+
+#include <stdint.h>
+#include "quaternion.h"
+#include "control_main.h"
+
+#define SITL_MAX_MOTOR		6
+
+typedef struct
+{
+	/* airframe */
+	float mass;				/* kg */
+	float inertia[3];		/* kg*m^2, about body x y z */
+	float arm_length;		/* m, motor to centre */
+	float hover_throttle;	/* throttle holding the vehicle in hover */
+	float thrust_expo;		/* 0: thrust linear in throttle, 1: quadratic */
+	float motor_tau;		/* s, motor time constant */
+	float yaw_moment;		/* m, reaction torque per thrust */
+	float drag;				/* N/(m/s)^2 */
+	float rot_drag;			/* N*m/(rad/s) */
+	/* sensors */
+	float gyr_noise;		/* rad/s */
+	float gyr_bias[3];		/* rad/s */
+	float acc_noise;		/* m/s^2 */
+	float acc_bias[3];		/* m/s^2 */
+	float mag_noise;		/* gauss */
+	float mag_strength;		/* gauss */
+	float mag_decl;			/* deg */
+	float mag_incl;			/* deg, positive down */
+	float baro_noise;		/* m */
+	float gps_noise;		/* m, correlated position error */
+	float gps_tau;			/* s, correlation time of the position error */
+	float gps_vel_noise;	/* m/s */
+	float gps_eph;			/* m, reported accuracy */
+	uint8_t gps_sats;
+	/* home */
+	double home_lat;		/* degree */
+	double home_lon;		/* degree */
+	float home_alt;			/* m, above sea level */
+}SITL_Param_Def;
+
+typedef struct
+{
+	float pos[3];			/* m, NED from home */
+	float vel[3];			/* m/s, NED */
+	float acc[3];			/* m/s^2, NED */
+	quaternion att;			/* body to NED */
+	float rate[3];			/* rad/s, body */
+	float motor[SITL_MAX_MOTOR];	/* motor output after the lag, 0~1 */
+	uint8_t on_ground;
+}SITL_State_Def;
+
+typedef struct
+{
+	int32_t lat;			/* 1e-7 degree */
+	int32_t lon;			/* 1e-7 degree */
+	int32_t alt;			/* mm above sea level */
+	float vel[3];			/* m/s, NED */
+	float eph;				/* m */
+	uint8_t satellites;
+}SITL_GPS_Def;
+
+typedef struct
+{
+	SITL_Param_Def param;
+	SITL_State_Def state;
+	uint8_t motor_num;
+	float motor_pos[SITL_MAX_MOTOR][2];	/* m, body x y */
+	float motor_yaw[SITL_MAX_MOTOR];	/* +1: reaction torque along body +z */
+	float max_thrust;					/* N per motor */
+	float mag_ned[3];					/* gauss */
+	float gps_err[3];					/* m, current correlated gps error */
+	/* disturbance, set by the user and held until changed */
+	float wind[3];						/* m/s, NED */
+	float ext_torque[3];				/* N*m, body */
+	uint64_t rng;
+	uint64_t time_us;
+}SITL_Model_Def;
+
+void sitl_model_default_param(SITL_Param_Def* param);
+int sitl_model_init(SITL_Model_Def* model, const SITL_Param_Def* param, FrameType frame, uint32_t seed);
+uint8_t sitl_model_motor_num(FrameType frame);
+void sitl_model_step(SITL_Model_Def* model, const float* throttle, float dt);
+
+/* sensor samples, every call draws new noise */
+void sitl_model_imu(SITL_Model_Def* model, float gyr[3], float acc[3], float mag[3]);
+void sitl_model_baro(SITL_Model_Def* model, float* alt, float* pressure, float* temperature);
+void sitl_model_gps(SITL_Model_Def* model, float dt, SITL_GPS_Def* gps);
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * File      : starryio_upload_proto.h
+ *
+ * StarryIO bootloader protocol, independent of the transport so that it
+ * can run both on the fmu and on a host against a stand-in bootloader.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __STARRYIO_UPLOAD_PROTO_H__
+#define __STARRYIO_UPLOAD_PROTO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum {
+
+	PROTO_NOP				= 0x00,
+	PROTO_OK				= 0x10,
+	PROTO_FAILED			= 0x11,
+	PROTO_INSYNC			= 0x12,
+	PROTO_INVALID			= 0x13,
+	PROTO_BAD_SILICON_REV  	= 0x14,
+	PROTO_EOC				= 0x20,
+	PROTO_GET_SYNC			= 0x21,
+	PROTO_GET_DEVICE		= 0x22,
+	PROTO_CHIP_ERASE		= 0x23,
+	PROTO_CHIP_VERIFY		= 0x24,
+	PROTO_PROG_MULTI		= 0x27,
+	PROTO_READ_MULTI		= 0x28,
+	PROTO_GET_CRC			= 0x29,
+	PROTO_GET_OTP			= 0x2a,
+	PROTO_GET_SN			= 0x2b,
+	PROTO_GET_CHIP			= 0x2c,
+	PROTO_SET_DELAY			= 0x2d,
+	PROTO_GET_CHIP_DES		= 0x2e,
+	PROTO_REBOOT			= 0x30,
+
+	INFO_BL_REV			= 1,		/**< bootloader protocol revision */
+	BL_REV				= 5,		/**< supported bootloader protocol  */
+	INFO_BOARD_ID		= 2,		/**< board type */
+	INFO_BOARD_REV		= 3,		/**< board revision */
+	INFO_FLASH_SIZE		= 4,		/**< max firmware size in bytes */
+
+	PROG_MULTI_MAX		= 252,		/**< protocol max is 255, must be multiple of 4 */
+
+};
+
+/* number of PROG_MULTI frames sent before the first sync is awaited.
+ * The bootloader has to buffer (window-1) frames while one is written
+ * to flash, so keep it small. 1 gives the old stop-and-wait behaviour. */
+#define UPLOADER_DEFAULT_WINDOW		4
+#define UPLOADER_MAX_WINDOW			16
+
+typedef enum
+{
+	UPLOADER_OK = 0,
+	UPLOADER_ERROR,
+	UPLOADER_TIMEOUT,
+	UPLOADER_READ_FAIL,
+	UPLOADER_CRC_FAIL,
+}UPLOADER_Result;
+
+typedef struct
+{
+	/* write size bytes to the link, return 0 on success */
+	int (*send)(void* ctx, const uint8_t* buff, uint32_t size);
+	/* receive one byte within timeout ms, return 0 on success */
+	int (*recv)(void* ctx, uint8_t* c, uint32_t timeout);
+	/* monotonic time in ms */
+	uint32_t (*now_ms)(void* ctx);
+	void* ctx;
+}uploader_port;
+
+/* read up to size bytes of the image, return the number of bytes read */
+typedef uint32_t (*uploader_read_fn)(void* src, uint8_t* buff, uint32_t size);
+
+typedef struct
+{
+	uint32_t fw_size;		/* bytes of the image */
+	uint32_t frames;		/* PROG_MULTI frames sent */
+	uint32_t prog_ms;		/* time spent in programming */
+	uint32_t total_ms;		/* programming + crc verify */
+	uint32_t bytes_per_sec;	/* image throughput over total_ms */
+	uint32_t crc;			/* crc reported by the bootloader */
+	uint32_t crc_expected;	/* crc32part of the image and 0xff fill */
+}uploader_stat;
+
+uint32_t crc32part(const uint8_t *src, size_t len, uint32_t crc32val);
+
+UPLOADER_Result uploader_proto_sync(const uploader_port* port);
+UPLOADER_Result uploader_proto_get_info(const uploader_port* port, int param, uint8_t* val, uint32_t size);
+UPLOADER_Result uploader_proto_erase(const uploader_port* port);
+UPLOADER_Result uploader_proto_program(const uploader_port* port, uploader_read_fn read, void* src,
+									   uint32_t fw_size, uint8_t window, uploader_stat* stat);
+UPLOADER_Result uploader_proto_reboot(const uploader_port* port);
+
+#endif
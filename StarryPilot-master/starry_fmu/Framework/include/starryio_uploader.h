@@ -5,6 +5,7 @@
  * Change Logs:
  * Date           Author       	Notes
  * 2017-02-04     zoujiachi   	the first version
+ * 2026-10-18     agent       	pipelined upload window
  */
  
 #ifndef __PX4IO_UPLOADER_H__
@@ -15,6 +16,6 @@
 
 rt_err_t uploader_init(void);
 rt_err_t uploader_deinit(void);
-void starryio_upload(void);
+void starryio_upload(uint8_t window);
 
 #endif
@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "global.h"
 #include "quaternion.h"
 #include "ap_math.h"
+#include "est_store.h"
 
 uint8_t state_est_init(float dT);
 uint8_t state_est_reset(void);
@@ -40,5 +41,7 @@ uint8_t state_est_update(void);
 void state_est_get_quaternion(quaternion* q);
 void state_est_get_position(Vector3f_t *pos);
 void state_est_get_velocity(Vector3f_t *vel);
+void state_est_store_collect(Est_State* state);
+void state_est_store_apply(const Est_State* state);
 
 #endif
\ No newline at end of file
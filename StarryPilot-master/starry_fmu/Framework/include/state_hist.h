@@ -0,0 +1,35 @@
+/*
+ * File      : state_hist.h
+ *
+ * History of whole state vectors with the time they belong to, so a delayed
+ * measurement can be fused against the state at the time it was taken.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __STATE_HIST_H__
+#define __STATE_HIST_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+	uint16_t size;			/* snapshots */
+	uint16_t dim;			/* floats in a snapshot */
+	uint16_t head;			/* newest snapshot */
+	uint16_t cnt;
+	uint32_t *time_stamp;	/* ms */
+	float *data;			/* size*dim, one snapshot after the other */
+}State_Hist;
+
+uint8_t state_hist_create(State_Hist *hist, uint16_t size, uint16_t dim);
+void state_hist_flush(State_Hist *hist);
+/* store dim floats of x taken at time_stamp, overwrites the oldest snapshot once full */
+void state_hist_push(State_Hist *hist, uint32_t time_stamp, const float *x);
+/* the oldest snapshot not older than time_stamp, the newest one if all are
+ * older and the oldest one if all are newer, NULL when empty */
+const float* state_hist_lookup(const State_Hist *hist, uint32_t time_stamp);
+
+#endif
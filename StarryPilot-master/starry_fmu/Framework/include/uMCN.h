@@ -30,9 +30,25 @@ struct mcn_node
 {
 	volatile uint8_t renewal;
 	void (*cb)(void *parameter);
+	uint32_t read_cnt;	// pub_cnt of hub at the last copy
 	McnNode_t next;
 };
 
+/* the counters of a hub at one moment, rates are measured between two */
+typedef struct
+{
+	uint32_t pub_cnt;
+	uint32_t copy_cnt;
+	uint32_t time;	// ms
+}McnMark;
+
+typedef struct
+{
+	float pub_hz;
+	float copy_hz;
+	float byte_ps;	// published bytes per second
+}McnRate;
+
 typedef struct mcn_hub		McnHub;
 struct mcn_hub
 {
@@ -43,29 +59,55 @@ struct mcn_hub
 	McnNode_t link_tail;
 	uint32_t link_num;
 	uint8_t published;	// publish flag
+	uint32_t pub_cnt;	// publish count
+	uint32_t copy_cnt;	// copy count, mcn_copy and mcn_copy_from_hub
+	McnMark report;	// window of the MAVLink report
+	McnHub* next;	// all advertised hubs
+	/* a derived topic is never published, pdata is transformed from the
+	 * source data when copied, at most once per publish of the source */
+	McnHub* source;
+	void (*transform)(const void* src, void* dst);
+	uint32_t derived_cnt;	// pub_cnt of source that pdata was transformed at
+	McnHub* derived_head;	// topics derived from this one
+	McnHub* derived_next;
 };
 
 #define MCN_ID(_name)				(&__mcn_##_name)
 
-#define MCN_DECLARE(_name) 			extern McnHub __mcn_##_name
+#define MCN_DECLARE(_name) 			extern VEHICLE_STATE McnHub __mcn_##_name
 	
 #define MCN_DEFINE(_name, _size)			\
-	McnHub __mcn_##_name = {	        	\
+	VEHICLE_STATE McnHub __mcn_##_name = {	\
 		.obj_name = #_name,					\
 		.obj_size = _size,					\
 		.pdata = NULL,                      \
 		.link_head = NULL,	                \
 		.link_tail = NULL,	                \
 		.link_num = 0,						\
-		.published = 0						\
+		.published = 0,						\
+		.pub_cnt = 0,						\
+		.copy_cnt = 0,						\
+		.next = NULL,						\
+		.source = NULL,						\
+		.transform = NULL,					\
+		.derived_cnt = 0,					\
+		.derived_head = NULL,				\
+		.derived_next = NULL				\
 	}
 	
 int mcn_advertise(McnHub* hub);
+int mcn_advertise_derived(McnHub* hub, McnHub* source, void (*transform)(const void* src, void* dst));
 McnNode_t mcn_subscribe(McnHub* hub, void (*cb)(void *parameter));
 int mcn_publish(McnHub* hub, const void* data);
 bool mcn_poll(McnNode_t node_t);
 int mcn_copy(McnHub* hub, McnNode_t node_t, void* buffer);
 int mcn_copy_from_hub(McnHub* hub, void* buffer);
 
+McnHub* mcn_next_hub(McnHub* hub);
+McnHub* mcn_find_hub(const char* name);
+uint32_t mcn_max_lag(McnHub* hub);
+void mcn_mark(McnHub* hub, McnMark* mark);
+void mcn_rate(McnHub* hub, const McnMark* from, McnRate* rate);
+
 #endif
 	
\ No newline at end of file
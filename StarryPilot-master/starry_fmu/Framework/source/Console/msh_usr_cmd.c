@@ -11,12 +11,15 @@
 #include <finsh.h>
 #include <shell.h>
 #include <string.h>
+#include <stdlib.h>
 #include "calibration.h"
 #include "starryio_uploader.h"
+#include "starryio_upload_proto.h"
 #include "pos_estimator.h"
 #include "msh_usr_cmd.h"
 #include "msh.h"
 #include "console.h"
+#include "est_store.h"
 
 typedef int (*shell_handle_func)(int, char**, int, sh_optv*);
 
@@ -166,6 +169,10 @@ int handle_help_shell_cmd(int argc, char** argv)
 		}
 		if( strcmp(argv[1], "uploader") == 0 ){
 			Console.print("Upload bin file to starry io.\n");
+			Console.print("Usage: uploader [-w=<window>]\n");
+			Console.print("\n");
+			Console.print("-w=<window>:\n");
+			Console.print("\t%s\n", "Frames in flight before waiting for sync (1 = stop-and-wait).");
 		}
 		if( strcmp(argv[1], "sensor") == 0 ){
 			Console.print("Get sensor information.\n");
@@ -323,6 +330,8 @@ int handle_help_shell_cmd(int argc, char** argv)
 
 int cmd_reboot(int argc, char** argv)
 {
+	/* keep what the estimators learned for the next boot */
+	est_store_save();
 	rt_kprintf("rebooting...\n\n");
 	NVIC_SystemReset();
 	return 0;
@@ -345,12 +354,25 @@ int cmd_calib(int argc, char** argv)
 }
 FINSH_FUNCTION_EXPORT_ALIAS(cmd_calib, __cmd_calib, calibrate the acc and mag sensor.);
 
-int cmd_uploader(int argc, char** argv)
+int handle_uploader_shell_cmd(int argc, char** argv, int optc, sh_optv* optv)
 {
-	starryio_upload();
+	uint8_t window = UPLOADER_DEFAULT_WINDOW;
+	
+	for(int i = 0 ; i < optc ; i++){
+		if(strcmp("-w", optv[i].opt) == 0 && optv[i].val != NULL){
+			window = atoi(optv[i].val);
+		}
+	}
+	
+	starryio_upload(window);
 	
 	return 1;
 }
+
+int cmd_uploader(int argc, char** argv)
+{
+	return shell_cmd_process(argc, argv, handle_uploader_shell_cmd);
+}
 FINSH_FUNCTION_EXPORT_ALIAS(cmd_uploader, __cmd_uploader, upload bin file to starryio.);
 
 int handle_sensor_shell_cmd(int argc, char** argv);
@@ -466,6 +488,13 @@ int cmd_pos_est(int argc, char** argv)
 }
 FINSH_FUNCTION_EXPORT_ALIAS(cmd_pos_est, __cmd_pos_est, position estimator commands);
 
+int handle_uMCN_cmd(int argc, char** argv);
+int cmd_mcn(int argc, char** argv)
+{
+	return handle_uMCN_cmd(argc, argv);
+}
+FINSH_FUNCTION_EXPORT_ALIAS(cmd_mcn, __cmd_mcn, uMCN topic list/echo/hz);
+
 int handle_mavproxy_shell_cmd(int argc, char** argv);
 int cmd_mavproxy(int argc, char** argv)
 {
@@ -24,22 +24,41 @@ static float adrc_sign(float val)
 		return -1.0f;
 }
 
-float adrc_fhan(float v1, float v2, float r0, float h0)//最速fhan函数
+/* x limited to -1~1 */
+static inline float _adrc_sat(float x)
+{
+	x = x > 1.0f ? 1.0f : x;
+	return x < -1.0f ? -1.0f : x;
+}
+
+/* fhan with d = h0*h0*r0 given. The sign() terms of the textbook form only
+ * pick one of two branches, which is written here as selects and a
+ * saturation, so the same code runs for every input:
+ *	a = |y| < d ? a0 + y : a2
+ *	fhan = -r0*sat(a/d) */
+static inline float _adrc_fhan(float v1, float v2, float r0, float h0, float d, float inv_d)
 {
-	float d = h0 * h0 * r0;
 	float a0 = h0 * v2;
 	float y = v1 + a0;
 	float a1 = sqrtf(d*(d + 8.0f*fabsf(y)));
-	float a2 = a0 + adrc_sign(y)*(a1-d)*0.5f;
-	float sy = (adrc_sign(y+d) - adrc_sign(y-d))*0.5f;
-	float a = (a0 + y - a2)*sy + a2;
-	float sa = (adrc_sign(a+d) - adrc_sign(a-d))*0.5f;
+	float a2 = a0 + copysignf((a1-d)*0.5f, y);
+	float a = fabsf(y) < d ? a0 + y : a2;
+	
+	return -r0*_adrc_sat(a*inv_d);
+}
+
+float adrc_fhan(float v1, float v2, float r0, float h0)//最速fhan函数
+{
+	float d = h0 * h0 * r0;
 	
-	return -r0*(a/d - adrc_sign(a))*sa - r0*adrc_sign(a);
+	return _adrc_fhan(v1, v2, r0, h0, d, 1.0f/d);
 }
 
 float adrc_fal(float e, float alpha, float delta)//fal函数
 {
+	/* kept as a branch: within delta the power does not depend on e, which
+	 * a branch free max(|e|,delta)^alpha*sat(e/delta) would put on the
+	 * z1 -> e -> z2 chain of the ESO */
 	if(fabsf(e) <= delta){
 		return e / (powf(delta, 1.0f-alpha));
 	}else{
@@ -136,4 +155,79 @@ float adrc_nlsef(ADRC_NLSEF_Def* nlsef_t, float e1, float e2)
 	float u0 = -adrc_fhan(e1, nlsef_t->c*e2, nlsef_t->r1, nlsef_t->h1);
 
 	return u0;
-}
\ No newline at end of file
+}
+
+void adrc_td3_init(ADRC_TD3_Def* td, uint8_t axis_num, float h, float r0, float h0)
+{
+	td->axis_num = axis_num < ADRC_AXIS_NUM ? axis_num : ADRC_AXIS_NUM;
+	td->h = h;
+	td->r = r0;
+	td->h0 = h0;
+	td->d = h0 * h0 * r0;
+	td->inv_d = 1.0f / td->d;
+	for(uint8_t i = 0 ; i < ADRC_AXIS_NUM ; i++){
+		td->v1[i] = td->v2[i] = 0.0f;
+	}
+}
+
+void adrc_td3(ADRC_TD3_Def* td, const float v[])
+{
+	for(uint8_t i = 0 ; i < td->axis_num ; i++){
+		float fv = _adrc_fhan(td->v1[i] - v[i], td->v2[i], td->r, td->h0, td->d, td->inv_d);
+		
+		td->v1[i] += td->h * td->v2[i];
+		td->v2[i] += td->h * fv;
+	}
+}
+
+void adrc_td3_control(ADRC_TD3_Def* td, const float err[])
+{
+	for(uint8_t i = 0 ; i < td->axis_num ; i++){
+		float fv = _adrc_fhan(-err[i], td->v2[i], td->r, td->h0, td->d, td->inv_d);
+		
+		td->v1[i] += td->h * td->v2[i];
+		td->v2[i] += td->h * fv;
+	}
+}
+
+void adrc_leso3_init(ADRC_LESO3_Def* leso, uint8_t axis_num, float h, float w, float b0)
+{
+	leso->axis_num = axis_num < ADRC_AXIS_NUM ? axis_num : ADRC_AXIS_NUM;
+	leso->h = h;
+	// (s + w)^2 = s^2 + beta_1 * s + beta_2
+	leso->beta1 = 2.0f*w;
+	leso->beta2 = w*w;
+	for(uint8_t i = 0 ; i < ADRC_AXIS_NUM ; i++){
+		leso->b0[i] = b0;
+		leso->u[i] = 0.0f;
+		leso->z1[i] = leso->z2[i] = 0.0f;
+	}
+}
+
+void adrc_leso3(ADRC_LESO3_Def* leso, const float y[])
+{
+	for(uint8_t i = 0 ; i < leso->axis_num ; i++){
+		float e = leso->z1[i] - y[i];
+		
+		leso->z1[i] += leso->h*(leso->z2[i] + leso->b0[i]*leso->u[i] - leso->beta1*e);
+		leso->z2[i] -= leso->h*leso->beta2*e;
+	}
+}
+
+void adrc_nlsef3_init(ADRC_NLSEF3_Def* nlsef, uint8_t axis_num, float h, float r1, float h1, float c)
+{
+	nlsef->axis_num = axis_num < ADRC_AXIS_NUM ? axis_num : ADRC_AXIS_NUM;
+	nlsef->h = h;
+	nlsef->h1 = h1;
+	nlsef->r1 = r1;
+	nlsef->c = c;
+	nlsef->d = h1 * h1 * r1;
+	nlsef->inv_d = 1.0f / nlsef->d;
+}
+
+void adrc_nlsef3(const ADRC_NLSEF3_Def* nlsef, const float e1[], const float e2[], float u0[])
+{
+	for(uint8_t i = 0 ; i < nlsef->axis_num ; i++){
+		u0[i] = -_adrc_fhan(e1[i], nlsef->c*e2[i], nlsef->r1, nlsef->h1, nlsef->d, nlsef->inv_d);
+	}
+}
@@ -18,13 +18,13 @@
 #define RATES_I_LIMIT				0.2f
 #define I_LIMIT						1.0f
 
-static float i_accum[3] = {0,0,0};
-float rate_i_accum[3] = {0,0,0};
-static float pre_gyr[3];
-static float pre_err[3];
-static float _derivative[3] = {0, 0, 0};
-static float err_alpha = 0.0f;
-static float d_alpha = 0.0f;
+static VEHICLE_STATE float i_accum[3] = {0,0,0};
+VEHICLE_STATE float rate_i_accum[3] = {0,0,0};
+static VEHICLE_STATE float pre_gyr[3];
+static VEHICLE_STATE float pre_err[3];
+static VEHICLE_STATE float _derivative[3] = {0, 0, 0};
+static VEHICLE_STATE float err_alpha = 0.0f;
+static VEHICLE_STATE float d_alpha = 0.0f;
 //static float err_lpf[3] = {0,0,0};
 //static float pre_err_rate[3] = {0,0,0};
 
@@ -46,72 +46,91 @@ uint8_t att_pid_init(float dt)
     return 0;
 }
 
-extern ADRC_Log adrc_log;
-uint8_t att_pid_update(const float input[3],float output[3], const float gyr_rad[3], float dt, float throttle)
+/* gains of the three axes side by side */
+typedef struct
 {
-	float att_p[3] = {	PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_P), 
-						PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_P), 
-						PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_P)};
-	
-	float att_rate_p[3] = { PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_RATE_P),
-							PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_RATE_P),
-							PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_P)};
+	float att_p[3];
+	float rate_p[3];
+	float rate_i[3];
+	float rate_d[3];
+	float output_limit[3];
+	float rate_i_limit[3];
+}Att_PID_Gain;
+
+static void _att_pid_gain(Att_PID_Gain* g)
+{
+	g->att_p[0] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_P);
+	g->att_p[1] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_P);
+	g->att_p[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_P);
 	
-	float att_rate_i[3] = { PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_RATE_I),
-							PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_RATE_I),
-							PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_I)};
+	g->rate_p[0] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_RATE_P);
+	g->rate_p[1] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_RATE_P);
+	g->rate_p[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_P);
 	
-	float att_rate_d[3] = { PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_RATE_D),
-							PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_RATE_D),
-							PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_D)};
+	g->rate_i[0] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_RATE_I);
+	g->rate_i[1] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_RATE_I);
+	g->rate_i[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_I);
 	
-	float att_output_limit[3] = {	PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLLOUT_LIM),
-									PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCHOUT_LIM),
-									PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWOUT_LIM)};
+	g->rate_d[0] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLL_RATE_D);
+	g->rate_d[1] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCH_RATE_D);
+	g->rate_d[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_D);
 	
-	float att_rate_i_limit[3] = {	PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLLR_I_LIM),
-									PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCHR_I_LIM),
-									PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWR_I_LIM)};
-					
-    /* outter ring controls angle */
-    float rates_sp[3] = {0};
-    for(int i=0;i<3;i++)
-    {
-		/* outter ring only contains P controller */
-		rates_sp[i] = input[i] * att_p[i];
-    }
+	g->output_limit[0] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLLOUT_LIM);
+	g->output_limit[1] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCHOUT_LIM);
+	g->output_limit[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWOUT_LIM);
 	
-	adrc_log.sp_rate = rates_sp[1];
+	g->rate_i_limit[0] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_ROLLR_I_LIM);
+	g->rate_i_limit[1] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_PITCHR_I_LIM);
+	g->rate_i_limit[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWR_I_LIM);
+}
 
-	float err_rates[3] = {0};
-    for(int i = 0 ; i<3 ; i++)
-    {
-        err_rates[i] = rates_sp[i] - gyr_rad[i];
-		//err_lpf[i] = err_lpf[i] + err_alpha*(err_rates[i]-err_lpf[i]);
-//		float deriv = (pre_gyr[i] - gyr_rad[i]) / dt * att_rate_d[i];
-		float deriv = (err_rates[i] - pre_err[i]) / dt * att_rate_d[i];
-		_derivative[i] = _derivative[i] + d_alpha*(deriv - _derivative[i]);
-		output[i] = err_rates[i] * att_rate_p[i] + _derivative[i] + rate_i_accum[i];
-		//pre_gyr[i] = gyr_rad[i];
-		constrain(&output[i], -att_output_limit[i], att_output_limit[i]);
-		pre_err[i] = err_rates[i];
-    }
-	
-	
+/* only the yaw gains, for the yaw loop run next to the adrc */
+static void _att_pid_yaw_gain(Att_PID_Gain* g)
+{
+	g->att_p[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_P);
+	g->rate_p[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_P);
+	g->rate_i[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_I);
+	g->rate_d[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_D);
+	g->output_limit[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWOUT_LIM);
+	g->rate_i_limit[2] = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWR_I_LIM);
+}
+
+/* axes first~last-1 in one pass, the limits and the integral gate are
+ * selects rather than branches */
+static void _att_pid_axes(const Att_PID_Gain* g, const float input[3], float output[3], const float gyr_rad[3],
+							float dt, float throttle, int first, int last)
+{
+	float inv_dt = 1.0f / dt;
 	//TODO: should check the throttle here?
 	//if(throttle > MIN_TAKEOFF_THROTTLE){
-	if(throttle > 0.3f){
-		for(int i=0;i<3;i++){
-			float rate_i = rate_i_accum[i] + err_rates[i] * att_rate_i[i] * dt;
-//			if(rate_i > -RATES_I_LIMIT && rate_i < RATES_I_LIMIT 
-//					&& output[i] > -RATES_I_LIMIT && output[i] < RATES_I_LIMIT){
-//				rate_i_accum[i] = rate_i;
-//			}
-			if(rate_i > -att_rate_i_limit[i] && rate_i < att_rate_i_limit[i]){
-				rate_i_accum[i] = rate_i;
-			}
-		}
+	int integrate = throttle > 0.3f;
+	
+	for(int i = first ; i < last ; i++){
+		/* outter ring only contains P controller */
+		float rates_sp = input[i] * g->att_p[i];
+		/* inner ring controls angular rate */
+		float err_rates = rates_sp - gyr_rad[i];
+		float deriv = (err_rates - pre_err[i]) * inv_dt * g->rate_d[i];
+		_derivative[i] = _derivative[i] + d_alpha*(deriv - _derivative[i]);
+		float out = err_rates * g->rate_p[i] + _derivative[i] + rate_i_accum[i];
+		out = out > g->output_limit[i] ? g->output_limit[i] : out;
+		output[i] = out < -g->output_limit[i] ? -g->output_limit[i] : out;
+		pre_err[i] = err_rates;
+		
+		float rate_i = rate_i_accum[i] + err_rates * g->rate_i[i] * dt;
+		int keep = integrate && rate_i > -g->rate_i_limit[i] && rate_i < g->rate_i_limit[i];
+		rate_i_accum[i] = keep ? rate_i : rate_i_accum[i];
 	}
+}
+
+extern VEHICLE_STATE ADRC_Log adrc_log;
+uint8_t att_pid_update(const float input[3],float output[3], const float gyr_rad[3], float dt, float throttle)
+{
+	Att_PID_Gain g;
+	
+	_att_pid_gain(&g);
+	adrc_log.sp_rate = input[1] * g.att_p[1];
+	_att_pid_axes(&g, input, output, gyr_rad, dt, throttle, 0, 3);
 	
 	//param_release();
 	
@@ -120,39 +139,14 @@ uint8_t att_pid_update(const float input[3],float output[3], const float gyr_rad
 
 uint8_t att_yaw_pid_control(const float input, float* output, float gyr_rad, float dt, float throttle)
 {
-	float att_p = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_P);
-	
-	float att_rate_p = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_P);
-	
-	float att_rate_i = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_I);
-	
-	float att_rate_d = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAW_RATE_D);
+	Att_PID_Gain g;
+	float in[3] = {0.0f, 0.0f, input};
+	float gyr[3] = {0.0f, 0.0f, gyr_rad};
+	float out[3];
 	
-	float att_output_limit = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWOUT_LIM);
-	
-	float att_rate_i_limit = PARAM_GET_FLOAT(ATT_CONTROLLER, ATT_YAWR_I_LIM);
-					
-    /* outter ring controls angle */
-	float rates_sp = input * att_p;
-
-	/* outter ring controls angular rate */
-	float err_rates = rates_sp - gyr_rad;
-	float deriv = (err_rates - pre_err[2]) / dt * att_rate_d;
-	_derivative[2] = _derivative[2] + d_alpha*(deriv - _derivative[2]);
-	*output = err_rates * att_rate_p + _derivative[2] + rate_i_accum[2];
-	constrain(output, -att_output_limit, att_output_limit);
-	pre_err[2] = err_rates;
-	
-	
-	//TODO: should check the throttle here?
-	//if(throttle > MIN_TAKEOFF_THROTTLE){
-	if(throttle > 0.3f){
-		float rate_i = rate_i_accum[2] + err_rates * att_rate_i * dt;
-		if(rate_i > -att_rate_i_limit && rate_i < att_rate_i_limit){
-			rate_i_accum[2] = rate_i;
-		}
-	}
+	_att_pid_yaw_gain(&g);
+	_att_pid_axes(&g, in, out, gyr, dt, throttle, 2, 3);
+	*output = out[2];
 	
 	return 0;
 }
-
@@ -34,9 +34,9 @@
 //#define RATE_ACCUM_BOUND	0.1f	
 #define RATE_ACCUM_BOUND	0.4f
 
-P_Controler alt_controller;
-P_Controler vel_controller;
-PID_Controler acc_controller;
+VEHICLE_STATE P_Controler alt_controller;
+VEHICLE_STATE P_Controler vel_controller;
+VEHICLE_STATE PID_Controler acc_controller;
 
 void alt_controller_reset(void)
 {
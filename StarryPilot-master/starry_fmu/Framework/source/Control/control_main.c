@@ -33,6 +33,8 @@
 #include "copter_main.h"
 #include "adrc_att.h"
 #include "gps.h"
+#include "mixer.h"
+#include "est_store.h"
 
 #define EVENT_CONTROL			(1<<0)
 
@@ -62,32 +64,34 @@ struct	Control_Req_Param
 	float base_throttle;	/* 0.0~1.0 */
 	float roll_sp;			/* deg */
 	float pitch_sp;			/* deg */
-}_ctrl_req_param;
+};
+VEHICLE_STATE struct Control_Req_Param _ctrl_req_param;
 
-static bool _request_control = false;
-static rt_device_t motor_device_t;
-static float yaw_target;
-static Euler _att_et;
+static VEHICLE_STATE bool _request_control = false;
+static VEHICLE_STATE rt_device_t motor_device_t;
+static VEHICLE_STATE float yaw_target;
+static VEHICLE_STATE Euler _att_et;
 /* 0:lock	1:unlock*/
-static float _vehicle_status = 0;
-static float _throttle_out[MOTOR_NUM];
+static VEHICLE_STATE float _vehicle_status = 0;
+static VEHICLE_STATE float _throttle_out[MOTOR_NUM];
 /* in attitude control mode, the yaw is locked by default */
-static uint8_t att_mode_lock_yaw = 0;
+static VEHICLE_STATE uint8_t att_mode_lock_yaw = 0;
 /* control mode. 1:attitude control mode	2:altitude hold mode */
-static uint8_t _control_mode = 1;
-static float _baseThrottle = 0.0f;
-static float _throttle_alpha = 0.0f;	//throttle LPF
-static float _throttle_lpf = 0.0f;
-static uint8_t alt_hold_mode = 0;
-static float alt_setpoint = 0.0f;
-static uint8_t _att_outerloop_update = 1;
-Euler _ec;	//current euler angle
-HomePosition _home = {0.0f, 0.0f, 0};	// home position
+static VEHICLE_STATE uint8_t _control_mode = 1;
+static VEHICLE_STATE float _baseThrottle = 0.0f;
+static VEHICLE_STATE float _throttle_alpha = 0.0f;	//throttle LPF
+static VEHICLE_STATE float _throttle_lpf = 0.0f;
+static VEHICLE_STATE uint8_t alt_hold_mode = 0;
+static VEHICLE_STATE float alt_setpoint = 0.0f;
+static VEHICLE_STATE uint8_t _att_outerloop_update = 1;
+static VEHICLE_STATE Mixer_Def _mixer;
+VEHICLE_STATE Euler _ec;	//current euler angle
+VEHICLE_STATE HomePosition _home = {0.0f, 0.0f, 0};	// home position
 
 #ifdef BLUEJAY
-FrameType _frame_type = frame_type_4;
+VEHICLE_STATE FrameType _frame_type = frame_type_4;
 #else
-FrameType _frame_type = frame_type_1;	/* the default frame type is X frame */
+VEHICLE_STATE FrameType _frame_type = frame_type_1;	/* the default frame type is X frame */
 #endif
 
 static char* TAG = "Control";
@@ -97,9 +101,9 @@ MCN_DEFINE(ADRC, sizeof(ADRC_Log));
 
 MCN_DECLARE(ATT_EULER);
 MCN_DECLARE(ALT_INFO);
-McnNode_t alt_node_t;
+VEHICLE_STATE McnNode_t alt_node_t;
 
-ADRC_TD_Def throttle_td[MOTOR_NUM];
+VEHICLE_STATE ADRC_TD_Def throttle_td[MOTOR_NUM];
 
 void ctrl_throttle_set_lpf(float cutoff_freq, float dt)
 {
@@ -188,60 +192,55 @@ void ctrl_constrain_throttle(float* throttle, uint8_t throttle_num)
 	}
 }
 
+FrameType ctrl_get_frame_type(void)
+{
+	return _frame_type;
+}
+
+void _ctrl_load_mixer(void)
+{
+	const float (*mix)[MIXER_AXIS_NUM] = mixer_frame_geometry(_frame_type);
+	uint8_t motor_num = mixer_frame_motor_num(_frame_type);
+	float param_mix[MIXER_MAX_MOTOR][MIXER_AXIS_NUM];
+	
+	if(PARAM_GET_INT32(MIXER, MIX_SOURCE) == 1){
+		/* the MIX_Mn rows follow each other in the group */
+		param_info_t* p = &PARAM_GET(MIXER, MIX_M1_ROLL);
+		for(uint8_t i = 0 ; i < MIXER_MAX_MOTOR ; i++){
+			for(uint8_t j = 0 ; j < MIXER_AXIS_NUM ; j++){
+				param_mix[i][j] = p[i*MIXER_AXIS_NUM+j].val.f;
+			}
+		}
+		mix = (const float (*)[MIXER_AXIS_NUM])param_mix;
+		motor_num = PARAM_GET_UINT32(MIXER, MIX_MOTOR_NUM);
+	}
+	
+	if(motor_num > MOTOR_NUM){
+		Console.e(TAG, "mixer has %d motors, MOTOR_NUM is %d\n", motor_num, MOTOR_NUM);
+		_mixer.motor_num = 0;
+		return;
+	}
+	uint8_t res = mixer_init(&_mixer, mix, motor_num, THROTTLE_MIN, THROTTLE_MAX, (Mixer_Desat)PARAM_GET_INT32(MIXER, MIX_DESAT));
+	if(res){
+		Console.e(TAG, "err:%d, mixer init fail, frame type:%d\n", res, _frame_type);
+	}
+}
+
+/* out has MOTOR_NUM channels, those the mixer does not drive stay at the minimum */
 void _ctrl_mix_throttle_out(float *out, float* in, float base_throttle)
 {
-	if(_frame_type == frame_type_1){
-		/* X frame */
-		/* -1	 1	 1 */
-		/*  1	-1	 1 */
-		/*  1	 1	-1 */
-		/* -1	-1	-1 */
-		out[0] = base_throttle - in[0] + in[1] + in[2];
-		out[1] = base_throttle + in[0] - in[1] + in[2];
-		out[2] = base_throttle + in[0] + in[1] - in[2];
-		out[3] = base_throttle - in[0] - in[1] - in[2];		
-	}else if(_frame_type == frame_type_2){
-		/* + frame */
-		/* -sqrt(2)	  0	 		sqrt(2) */
-		/*  sqrt(2)	  0	 		sqrt(2) */
-		/*  0	 	sqrt(2)		-sqrt(2) */
-		/*  0		-sqrt(2)	-sqrt(2) */
-		out[0] = base_throttle - 1.414f*in[0]          			+ 1.414f*in[2];
-		out[1] = base_throttle + 1.414f*in[0]          			+ 1.414f*in[2];
-		out[2] = base_throttle          		+ 1.414f*in[1] 	- 1.414f*in[2];
-		out[3] = base_throttle          		- 1.414f*in[1] 	- 1.414f*in[2];	
-	}else if(_frame_type == frame_type_3){
-		/* hexrotor frame */
-		/*      0	 	  1	 	-1 */
-		/*      0	 	 -1		 1 */
-		/*  sqrt(3)/2	-1/2	-1 */
-		/* -sqrt(3)/2	 1/2	 1 */
-		/*  sqrt(3)/2	 1/2	 1 */
-		/* -sqrt(3)/2	-1/2	-1 */
-		out[0] = base_throttle                 +      in[1]  - in[2];
-		out[1] = base_throttle                 -      in[1]  + in[2];
-		out[2] = base_throttle + 0.866f*in[0]  - 0.5f*in[1]  - in[2];
-		out[3] = base_throttle - 0.866f*in[0]  + 0.5f*in[1]  + in[2];
-		out[4] = base_throttle + 0.866f*in[0]  + 0.5f*in[1]  + in[2];
-		out[5] = base_throttle - 0.866f*in[0]  - 0.5f*in[1]  - in[2];		
-	}else if(_frame_type == frame_type_4){
-		/* blue jay's frame */
-		/*     -1	 	  0	 	  -1 */
-		/*      1	 	  0		   1 */
-		/*     1/2    sqrt(3)/2	  -1 */
-		/*    -1/2	 -sqrt(3)/2	   1 */
-		/*    -1/2	  sqrt(3)/2	   1 */
-		/*     1/2	 -sqrt(3)/2	  -1 */
-		out[0] = base_throttle+ 1.414f*(-      in[0]                )  - in[2];
-		out[1] = base_throttle+ 1.414f*(+      in[0]                )  + in[2];
-		out[2] = base_throttle+ 1.414f*(+ 0.5f*in[0]  + 0.866f*in[1])  - in[2];
-		out[3] = base_throttle+ 1.414f*(- 0.5f*in[0]  - 0.866f*in[1])  + in[2];
-		out[4] = base_throttle+ 1.414f*(- 0.5f*in[0]  + 0.866f*in[1])  + in[2];
-		out[5] = base_throttle+ 1.414f*(+ 0.5f*in[0]  - 0.866f*in[1])  - in[2];		
-	}else{
-		Console.e(TAG, "err, unknow frame type:%d\n", _frame_type);
+	for(uint8_t i = _mixer.motor_num ; i < MOTOR_NUM ; i++){
+		out[i] = THROTTLE_MIN;
+	}
+	
+	if(_mixer.motor_num == 0){
+		Console.e(TAG, "err, no mixer for frame type:%d\n", _frame_type);
 		rc_enter_status(RC_LOCK_STATUS);
+		return;
 	}
+	
+	float ctrl[MIXER_AXIS_NUM] = {in[0], in[1], in[2], base_throttle};
+	mixer_run(&_mixer, ctrl, out);
 }
 
 quaternion _calc_target_quaternion(int ctrl_mode, float dT)
@@ -331,7 +330,7 @@ void throttle_compensate(float* throttle)
 	}
 }
 
-ADRC_Log adrc_log;
+VEHICLE_STATE ADRC_Log adrc_log;
 void _ctrl_att_with_baseThrottle(float baseThrottle, float dT)
 {
 	float out[3];
@@ -353,6 +352,7 @@ void _ctrl_att_with_baseThrottle(float baseThrottle, float dT)
 		
 		/* calculate target attitude according to rc value */
 		Euler et = _calc_target_euler(1, dT);
+		_att_et = et;
 		
 		/* calculate attitude error */
 		err[0] = et.roll - _ec.roll;
@@ -392,9 +392,8 @@ void _ctrl_att_with_baseThrottle(float baseThrottle, float dT)
 			att_pid_update(err, out, gyr_t, dT, baseThrottle);
 		}
 
-		/* calculate motor output */
+		/* calculate motor output, desaturated by the mixer */
 		_ctrl_mix_throttle_out(_throttle_out, out, baseThrottle);
-		ctrl_constrain_throttle(_throttle_out, MOTOR_NUM);
 		/* throttle feedforward to compensate motor delay */
 		throttle_compensate(_throttle_out);
 	}else{
@@ -412,6 +411,19 @@ void _ctrl_att_with_baseThrottle(float baseThrottle, float dT)
 //	return _home;
 //}
 
+Euler ctrl_get_target_euler(void)
+{
+	return _att_et;
+}
+
+uint8_t ctrl_get_alt_setpoint(float* alt)
+{
+	if(alt_hold_mode)
+		*alt = alt_setpoint*0.01f;	// change to m
+	
+	return alt_hold_mode;
+}
+
 uint8_t ctrl_set_home(void)
 {
 	struct vehicle_gps_position_s gps_t = gps_get_report();
@@ -462,12 +474,13 @@ void ctrl_set_throttle(float* throttle, uint8_t throttle_num)
 		}
 	}
 
-#ifdef HIL_SIMULATION
+	/* the built-in model (HIL_USE_MODEL) takes the throttle from MOTOR_THROTTLE */
+#if defined(HIL_SIMULATION) && !defined(HIL_USE_MODEL)
 	float control[16] = {0.0f};
 	for(int i = 0 ; i < throttle_num ; i++)
 		control[i] = _throttle_out[i];
 	mavlink_send_hil_actuator_control(control, throttle_num);
-#else
+#elif !defined(HIL_SIMULATION)
 	rt_device_write(motor_device_t, MOTOR_CH_ALL, throttle, throttle_num);
 #endif
 	
@@ -500,6 +513,9 @@ void ctrl_unlock_vehicle(void)
 	
 	adrc_att_reset(0.001f*control_period);
 	
+	/* take the mixer parameters changed while locked */
+	_ctrl_load_mixer();
+	
 	_ctrl_req_param.base_throttle = 0.0f;
 	_ctrl_req_param.roll_sp = 0.0f;
 	_ctrl_req_param.pitch_sp = 0.0f;
@@ -508,6 +524,8 @@ void ctrl_unlock_vehicle(void)
 void ctrl_lock_vehicle(void)
 {
 	int on_off = 0;
+	/* a disarm, not the lock at init */
+	int disarm = _vehicle_status != 0;
 	
 	for(int i = 0 ; i < MOTOR_NUM ; i++){
 		_throttle_out[i] = 0.0f;
@@ -516,10 +534,17 @@ void ctrl_lock_vehicle(void)
 	rt_device_control(motor_device_t, PWM_CMD_ENABLE, (void*)&on_off);
 	_vehicle_status = 0;
 	alt_hold_mode = 0;
+	
+	/* keep what the estimators learned for the next boot, the logger
+	 * thread writes it */
+	if(disarm)
+		est_store_request_save();
 }
 
 void control_init(void)
 {
+	_ctrl_load_mixer();
+	
 	motor_device_t = rt_device_find("motor");
 	if(motor_device_t == RT_NULL){
 		Console.e(TAG, "can't find motor device\n");
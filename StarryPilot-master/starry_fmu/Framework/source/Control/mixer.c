@@ -0,0 +1,220 @@
+/*
+ * File      : mixer.c
+ *
+ * The desaturation looks for the largest scale s in 0~1 of an attitude
+ * command u and a thrust T so that every output T*h(i) + base(i) + s*u(i)
+ * stays within the range, h being the thrust column. With everything
+ * divided by h(i) that holds for some T exactly when every pair of motors
+ * i, j satisfies
+ *	(lo - base(i))/h(i) - s*u(i)/h(i) <= (hi - base(j))/h(j) - s*u(j)/h(j)
+ * which bounds s linearly, so s is the smallest of those bounds.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include "mixer.h"
+
+/* no upper bound on the thrust */
+#define MIXER_THRUST_FREE		1e30f
+/* rounding left over from a command that was scaled to just fit */
+#define MIXER_ROUNDING			1e-6f
+
+/* roll, pitch, yaw and thrust of each motor, the mixing matrices
+ * _ctrl_mix_throttle_out used to write out by hand */
+static const float _mix_x[4][MIXER_AXIS_NUM] = {
+	{-1.0f,  1.0f,  1.0f, 1.0f},
+	{ 1.0f, -1.0f,  1.0f, 1.0f},
+	{ 1.0f,  1.0f, -1.0f, 1.0f},
+	{-1.0f, -1.0f, -1.0f, 1.0f},
+};
+static const float _mix_plus[4][MIXER_AXIS_NUM] = {
+	{-1.414f,  0.0f,    1.414f, 1.0f},
+	{ 1.414f,  0.0f,    1.414f, 1.0f},
+	{ 0.0f,    1.414f, -1.414f, 1.0f},
+	{ 0.0f,   -1.414f, -1.414f, 1.0f},
+};
+static const float _mix_hex[6][MIXER_AXIS_NUM] = {
+	{ 0.0f,    1.0f, -1.0f, 1.0f},
+	{ 0.0f,   -1.0f,  1.0f, 1.0f},
+	{ 0.866f, -0.5f, -1.0f, 1.0f},
+	{-0.866f,  0.5f,  1.0f, 1.0f},
+	{ 0.866f,  0.5f,  1.0f, 1.0f},
+	{-0.866f, -0.5f, -1.0f, 1.0f},
+};
+/* blue jay's frame */
+static const float _mix_bluejay[6][MIXER_AXIS_NUM] = {
+	{-1.414f,          0.0f,           -1.0f, 1.0f},
+	{ 1.414f,          0.0f,            1.0f, 1.0f},
+	{ 1.414f*0.5f,     1.414f*0.866f,  -1.0f, 1.0f},
+	{-1.414f*0.5f,    -1.414f*0.866f,   1.0f, 1.0f},
+	{-1.414f*0.5f,     1.414f*0.866f,   1.0f, 1.0f},
+	{ 1.414f*0.5f,    -1.414f*0.866f,  -1.0f, 1.0f},
+};
+
+/* s*d <= r */
+static float _bound_scale(float s, float d, float r)
+{
+	if(d > 0.0f){
+		if(r < s*d)
+			s = r/d;
+	}else if(r < -MIXER_ROUNDING){
+		/* out of range even without the command */
+		s = 0.0f;
+	}
+
+	return s;
+}
+
+/* largest s in 0~1 for which some thrust no larger than t_max keeps every
+ * output of base + s*u within the range */
+static float _max_scale(const Mixer_Def* mixer, const float* base, const float* u, float t_max)
+{
+	float lo[MIXER_MAX_MOTOR], hi[MIXER_MAX_MOTOR], v[MIXER_MAX_MOTOR];
+	float s = 1.0f;
+	uint8_t n = mixer->motor_num;
+
+	for(uint8_t i = 0 ; i < n ; i++){
+		lo[i] = (mixer->out_min - base[i])*mixer->inv_thrust[i];
+		hi[i] = (mixer->out_max - base[i])*mixer->inv_thrust[i];
+		v[i] = u[i]*mixer->inv_thrust[i];
+	}
+	for(uint8_t i = 0 ; i < n ; i++){
+		for(uint8_t j = 0 ; j < n ; j++){
+			s = _bound_scale(s, v[j] - v[i], hi[j] - lo[i]);
+		}
+		s = _bound_scale(s, -v[i], t_max - lo[i]);
+	}
+
+	return s > 0.0f ? s : 0.0f;
+}
+
+/* the thrust nearest to t that keeps every output of c within the range */
+static float _fit_thrust(const Mixer_Def* mixer, const float* c, float t, float t_max)
+{
+	float t_lo = -MIXER_THRUST_FREE;
+	float t_hi = MIXER_THRUST_FREE;
+
+	for(uint8_t i = 0 ; i < mixer->motor_num ; i++){
+		float lo = (mixer->out_min - c[i])*mixer->inv_thrust[i];
+		float hi = (mixer->out_max - c[i])*mixer->inv_thrust[i];
+		if(lo > t_lo)
+			t_lo = lo;
+		if(hi < t_hi)
+			t_hi = hi;
+	}
+	if(t > t_hi)
+		t = t_hi;
+	if(t < t_lo && t_lo <= t_max)
+		t = t_lo;
+
+	return t;
+}
+
+uint8_t mixer_frame_motor_num(FrameType frame)
+{
+	switch(frame)
+	{
+		case frame_type_1:
+		case frame_type_2:
+			return 4;
+		case frame_type_3:
+		case frame_type_4:
+			return 6;
+		default:
+			return 0;
+	}
+}
+
+const float (*mixer_frame_geometry(FrameType frame))[MIXER_AXIS_NUM]
+{
+	switch(frame)
+	{
+		case frame_type_1: return _mix_x;
+		case frame_type_2: return _mix_plus;
+		case frame_type_3: return _mix_hex;
+		case frame_type_4: return _mix_bluejay;
+		default: return NULL;
+	}
+}
+
+uint8_t mixer_init(Mixer_Def* mixer, const float (*mix)[MIXER_AXIS_NUM], uint8_t motor_num,
+					float out_min, float out_max, Mixer_Desat desat)
+{
+	memset(mixer, 0, sizeof(Mixer_Def));
+
+	if(mix == NULL || motor_num == 0 || motor_num > MIXER_MAX_MOTOR)
+		return 1;
+	for(uint8_t i = 0 ; i < motor_num ; i++){
+		if(!(mix[i][MIXER_THRUST] > 0.0f))
+			return 2;
+	}
+
+	memcpy(mixer->mix, mix, motor_num*sizeof(mixer->mix[0]));
+	for(uint8_t i = 0 ; i < motor_num ; i++){
+		mixer->inv_thrust[i] = 1.0f/mix[i][MIXER_THRUST];
+	}
+	mixer->out_min = out_min;
+	mixer->out_max = out_max;
+	mixer->desat = desat < MIXER_DESAT_NUM ? desat : MIXER_DESAT_CLIP;
+	mixer->motor_num = motor_num;
+
+	return 0;
+}
+
+void mixer_run(const Mixer_Def* mixer, const float ctrl[MIXER_AXIS_NUM], float* out)
+{
+	float rp[MIXER_MAX_MOTOR], yaw[MIXER_MAX_MOTOR], c[MIXER_MAX_MOTOR];
+	float t = ctrl[MIXER_THRUST];
+	uint8_t n = mixer->motor_num;
+	uint8_t saturated = 0;
+
+	/* roll and pitch are kept apart from yaw for the desaturation */
+	for(uint8_t i = 0 ; i < n ; i++){
+		const float* m = mixer->mix[i];
+		rp[i] = m[MIXER_ROLL]*ctrl[MIXER_ROLL] + m[MIXER_PITCH]*ctrl[MIXER_PITCH];
+		yaw[i] = m[MIXER_YAW]*ctrl[MIXER_YAW];
+		c[i] = rp[i] + yaw[i];
+		float o = m[MIXER_THRUST]*t + c[i];
+		saturated |= (o < mixer->out_min) | (o > mixer->out_max);
+	}
+
+	switch(saturated ? mixer->desat : MIXER_DESAT_CLIP)
+	{
+		case MIXER_DESAT_YAW:
+		{
+			float zero[MIXER_MAX_MOTOR] = {0.0f};
+			float s = _max_scale(mixer, zero, rp, t);
+
+			/* roll and pitch as far as they fit, then yaw in what room is left */
+			for(uint8_t i = 0 ; i < n ; i++)
+				c[i] = s*rp[i];
+			float k = _max_scale(mixer, c, yaw, t);
+			for(uint8_t i = 0 ; i < n ; i++)
+				c[i] += k*yaw[i];
+			t = _fit_thrust(mixer, c, t, t);
+		}break;
+		case MIXER_DESAT_AIRMODE:
+		{
+			float zero[MIXER_MAX_MOTOR] = {0.0f};
+			float s = _max_scale(mixer, zero, c, MIXER_THRUST_FREE);
+			for(uint8_t i = 0 ; i < n ; i++)
+				c[i] *= s;
+			t = _fit_thrust(mixer, c, t, MIXER_THRUST_FREE);
+		}break;
+		default:
+			break;
+	}
+
+	/* all MIXER_DESAT_CLIP does, after a desaturation only rounding is left to clip */
+	for(uint8_t i = 0 ; i < n ; i++){
+		float o = mixer->mix[i][MIXER_THRUST]*t + c[i];
+		if(o < mixer->out_min)
+			o = mixer->out_min;
+		if(o > mixer->out_max)
+			o = mixer->out_max;
+		out[i] = o;
+	}
+}
@@ -19,35 +19,32 @@
 #include "param.h"
 #include "gps.h"
 #include "state_est.h"
+#include "sitl_interface.h"
 
 #define EVENT_COPTER_FAST_LOOP		(1<<0)
 
-static struct rt_timer timer_copter;
-static struct rt_event event_copter;
-uint32_t _att_est_period, _pos_est_period, _control_period;
-uint32_t _ekf_est_period;
+static VEHICLE_STATE struct rt_timer timer_copter;
+static VEHICLE_STATE struct rt_event event_copter;
+VEHICLE_STATE uint32_t _att_est_period, _pos_est_period, _control_period;
+VEHICLE_STATE uint32_t _ekf_est_period;
 
 static char* TAG = "Copter_Main";
 
 void copter_main_loop(uint32_t att_est_period, uint32_t pos_est_period, uint32_t control_period)
 {
-	static uint32_t ahrs_time = 0;
-	static uint32_t pos_est_time = 0;
-	static uint32_t ctrl_time = 0;
-	static uint32_t state_est_time = 0;
+	static VEHICLE_STATE uint32_t pos_est_time = 0;
+	static VEHICLE_STATE uint32_t ctrl_time = 0;
 	
 	uint32_t now = time_nowMs();
 
+	/* the estimators run on each delta angle and velocity the sensors
+	 * integrate over their period, so no imu sample is skipped */
 #ifdef AHRS_USE_EKF	
-	if(TIME_GAP(state_est_time, now) >= 4){
-		state_est_time = now;
-		state_est_update();
-	}
+	sensor_imu_delta_set_interval(_ekf_est_period);
+	state_est_update();
 #else	
-	if(TIME_GAP(ahrs_time, now) >= att_est_period){
-		ahrs_time = now;
-		attitude_est_run(0.001f*att_est_period);
-	}
+	sensor_imu_delta_set_interval(att_est_period);
+	attitude_est_run();
 	
 	if(TIME_GAP(pos_est_time, now) >= pos_est_period){
 		pos_est_time = now;
@@ -90,12 +87,8 @@ uint32_t copter_get_event_period(Copter_Period event)
 	return period;
 }
 
-void copter_entry(void *parameter)
+void copter_init(void)
 {
-	rt_err_t res;
-	rt_uint32_t recv_set = 0;
-	rt_uint32_t wait_set = EVENT_COPTER_FAST_LOOP;
-	
 #ifdef HIL_SIMULATION
 	_att_est_period = PARAM_GET_UINT32(HIL_SIM, HIL_ATT_EST_PRD);
 	_pos_est_period = PARAM_GET_UINT32(HIL_SIM, HIL_POS_EST_PRD);
@@ -113,10 +106,24 @@ void copter_entry(void *parameter)
 	state_est_init(1e-3*_ekf_est_period);
 #ifdef HIL_SIMULATION
 	hil_interface_init(HIL_SENSOR_LEVEL);
+#ifdef HIL_USE_MODEL
+	sitl_interface_init(NULL, ctrl_get_frame_type(), 0);
+#endif
 	Console.print("HIL Mode...\n");
 #endif
 	sensor_manager_init();
-	pos_est_init(1e-3f*_pos_est_period);
+	if(pos_est_init(1e-3f*_pos_est_period) != RT_EOK){
+		Console.e(TAG, "pos estimator init fail\n");
+	}
+}
+
+void copter_entry(void *parameter)
+{
+	rt_err_t res;
+	rt_uint32_t recv_set = 0;
+	rt_uint32_t wait_set = EVENT_COPTER_FAST_LOOP;
+	
+	copter_init();
 	
 	/* create event */
 	res = rt_event_init(&event_copter, "copter_event", RT_IPC_FLAG_FIFO);
@@ -32,11 +32,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "filter.h"
 #include "hil_interface.h"
 #include "control_main.h"
+#include "sitl_interface.h"
 
 #define EVENT_FAST_LOOP		(1<<0)
 
-static struct rt_timer timer_fastloop;
-static struct rt_event event_fastloop;
+static VEHICLE_STATE struct rt_timer timer_fastloop;
+static VEHICLE_STATE struct rt_event event_fastloop;
 
 static void timer_fastloop_update(void* parameter)
 {
@@ -47,6 +48,9 @@ void fast_loop(void)
 {
 	
 #ifdef HIL_SIMULATION
+#ifdef HIL_USE_MODEL
+	sitl_interface_step();
+#endif
 	hil_sensor_collect();
 #else
 	sensor_collect();
@@ -80,7 +80,9 @@ FRESULT f_deldir(TCHAR *path)
 
 int fm_init(const TCHAR* path)
 {
-	FRESULT f_res = f_mount(&_fs, "0:", 0);  
+	/* mount now rather than at the first access, so the card comes up in
+	 * its own boot stage */
+	FRESULT f_res = f_mount(&_fs, "0:", 1);  
 	if(f_res == FR_OK){
 		_fmInit = 1;
 		//Console.print("File Manager Init Success\n");
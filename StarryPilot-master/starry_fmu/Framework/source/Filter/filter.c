@@ -13,16 +13,16 @@
 #include "sensor_manager.h"
 #include "butter.h"
 
-static float g_gyr[3];
-static float g_mag[3];
-static float g_acc[3];
-
-static Butter2 _butter_acc[3];
-static Butter2 _butter_gyr[3];
-static Butter2 _butter_mag[3];
-static Butter3* _butter3_gyr[3];
-static Butter3* _butter3_acc[3];
-static Butter3* _butter3_mag[3];
+static VEHICLE_STATE float g_gyr[3];
+static VEHICLE_STATE float g_mag[3];
+static VEHICLE_STATE float g_acc[3];
+
+static VEHICLE_STATE Butter2 _butter_acc[3];
+static VEHICLE_STATE Butter2 _butter_gyr[3];
+static VEHICLE_STATE Butter2 _butter_mag[3];
+static VEHICLE_STATE Butter3* _butter3_gyr[3];
+static VEHICLE_STATE Butter3* _butter3_acc[3];
+static VEHICLE_STATE Butter3* _butter3_mag[3];
 
 
 float lpf_get_alpha(float cutoff_freq, float dt)
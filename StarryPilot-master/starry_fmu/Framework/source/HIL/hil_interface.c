@@ -17,15 +17,15 @@
 #include "sensor_manager.h"
 #include "gps.h"
 
-static HIL_Option _hil_op;
-static McnNode_t hil_state_node_t;
-static McnNode_t hil_sensor_node_t;
-static McnNode_t hil_gps_node_t;
-static McnNode_t hil_baro_node_t;
-static float _hil_baro_last_alt = 0;
-static uint32_t _hil_baro_last_time = 0;
-static BaroPosition _hil_baro_pos = {0,0};
-static GPS_Status _hil_gps_status;
+static VEHICLE_STATE HIL_Option _hil_op;
+static VEHICLE_STATE McnNode_t hil_state_node_t;
+static VEHICLE_STATE McnNode_t hil_sensor_node_t;
+static VEHICLE_STATE McnNode_t hil_gps_node_t;
+static VEHICLE_STATE McnNode_t hil_baro_node_t;
+static VEHICLE_STATE float _hil_baro_last_alt = 0;
+static VEHICLE_STATE uint32_t _hil_baro_last_time = 0;
+static VEHICLE_STATE BaroPosition _hil_baro_pos = {0,0};
+static VEHICLE_STATE GPS_Status _hil_gps_status;
 
 static char* TAG = "HIL";
 
@@ -44,7 +44,7 @@ MCN_DECLARE(GPS_STATUS);
 
 int hil_sensor_collect(void)
 {
-	static uint32_t last_time = 0;
+	static VEHICLE_STATE uint32_t last_time = 0;
 	if(_hil_op == HIL_SENSOR_LEVEL){
 		if(mcn_poll(hil_sensor_node_t)){
 			
@@ -75,6 +75,8 @@ int hil_sensor_collect(void)
 			magfilter_input(mag);
 			mcn_publish(MCN_ID(SENSOR_MAG), mag);
 			mcn_publish(MCN_ID(SENSOR_FILTER_MAG), magfilter_current());
+			/* integrate delta angle and velocity of the low passed samples */
+			sensor_imu_delta_update(gyrfilter_current(), accfilter_current());
 			
 			if(hil_baro_report.time_stamp - _hil_baro_last_time >= 20){
 				float dt = 0.02f;
@@ -97,22 +99,7 @@ int hil_sensor_collect(void)
 			mcn_copy(MCN_ID(GPS_POSITION), hil_gps_node_t, &gps_pos_t);
 			
 			// check legality
-			if(_hil_gps_status.status!=GPS_AVAILABLE && gps_pos_t.satellites_used>=6 && IN_RANGE(gps_pos_t.eph, 0.0f, 2.5f)){
-				
-				_hil_gps_status.fix_cnt++;
-				
-				if(_hil_gps_status.fix_cnt >= 10){
-					_hil_gps_status.status = GPS_AVAILABLE;
-					
-					// gps becomes available, publish
-					mcn_publish(MCN_ID(GPS_STATUS), &_hil_gps_status);
-				}
-			}
-			if(_hil_gps_status.status!=GPS_INAVAILABLE && (gps_pos_t.satellites_used<=4 || gps_pos_t.eph>3.5f)){
-				
-				_hil_gps_status.status = GPS_INAVAILABLE;
-				_hil_gps_status.fix_cnt = 0;
-				
+			if(gps_status_update(&_hil_gps_status, &gps_pos_t)){
 				mcn_publish(MCN_ID(GPS_STATUS), &_hil_gps_status);
 			}
 		}
@@ -24,35 +24,34 @@
 #define gyroMeasDrift 3.14159265358979 * (0.4f / 180.0f) // gyroscope measurement error in rad/s/s (shown as 0.2f deg/s/s)
 //#define beta sqrt(3.0f / 4.0f) * gyroMeasError // compute beta
 //#define zeta sqrt(3.0f / 4.0f) * gyroMeasDrift // compute zeta
-static float beta = 0.8660254f * gyroMeasError; // compute beta
+static VEHICLE_STATE float beta = 0.8660254f * gyroMeasError; // compute beta
 static float zeta = 0.8660254f * gyroMeasDrift; // compute zeta
 // Global system variables
 //float a_x, a_y, a_z; // accelerometer measurements
 //float w_x, w_y, w_z; // gyroscope measurements in rad/s
 //float m_x, m_y, m_z; // magnetometer measurements
 //float SEq_1 = 1, SEq_2 = 0, SEq_3 = 0, SEq_4 = 0; // estimated orientation quaternion elements with initial conditions
-float b_x = 1, b_z = 0; // reference direction of flux in earth frame
-float w_bx = 0, w_by = 0, w_bz = 0; // estimate gyroscope biases error
+VEHICLE_STATE float b_x = 1, b_z = 0; // reference direction of flux in earth frame
+VEHICLE_STATE float w_bx = 0, w_by = 0, w_bz = 0; // estimate gyroscope biases error
 
-static float accU[3], magU[3];
-static float delta[3];
+static VEHICLE_STATE float delta[3];
 //static float FACTOR_P = 2.0f;
 //static float FACTOR_I = 0.005f;
-static float FACTOR_P = 0.25f;
-static float FACTOR_I = 0.1f;
+static VEHICLE_STATE float FACTOR_P = 0.25f;
+static VEHICLE_STATE float FACTOR_I = 0.1f;
 
-static float acc_cross[3];
-static float mag_cross[3];
+static VEHICLE_STATE float acc_cross[3];
+static VEHICLE_STATE float mag_cross[3];
 static float acc_const[3] = {0.0f, 0.0f, -1.0f};
 static float mag_const[3] = {1.0f, 0.0f, 0.0f};
-static float gyr_bias[3];
-static float errX_Int = 0.0f;
-static float errY_Int = 0.0f;
-static float errZ_Int = 0.0f;
+static VEHICLE_STATE float gyr_bias[3];
+static VEHICLE_STATE float errX_Int = 0.0f;
+static VEHICLE_STATE float errY_Int = 0.0f;
+static VEHICLE_STATE float errZ_Int = 0.0f;
 
 float comp_gain = 0.05f;
 
-extern McnNode_t _home_node_t;
+extern VEHICLE_STATE McnNode_t _home_node_t;
 MCN_DECLARE(HOME_POS);
 
 void Runge_Kutta_1st(quaternion* attitude, quaternion q, float g[3], float dT)
@@ -98,8 +97,26 @@ void AHRS_reset(quaternion * q, const float acc[3],const float mag[3])
 	gyr_bias[2] = 0.0f;
 }
 
+/* the gyro bias AHRS_update has learned, as the gyro reads rate + bias */
+void AHRS_get_gyr_bias(float bias[3])
+{
+	/* gyr_bias is the correction added to the gyro */
+	bias[0] = -gyr_bias[0];
+	bias[1] = -gyr_bias[1];
+	bias[2] = -gyr_bias[2];
+}
+
+void AHRS_set_gyr_bias(const float bias[3])
+{
+	gyr_bias[0] = -bias[0];
+	gyr_bias[1] = -bias[1];
+	gyr_bias[2] = -bias[2];
+}
+
 void AHRS_update(quaternion * q, const float gyr[3], const float acc[3], const float mag[3], float dT)
 {	
+	float accU[3], magU[3];
+	
 	Vector3_Normalize(accU, acc);
 	Vector3_Normalize(magU, mag);
 	
@@ -160,9 +177,9 @@ void MahonyAHRS_update(quaternion * q,const float gyr[3],const float acc[3],cons
 	float hx, hy, hz, bx, bz;  
 	float vx, vy, vz, wx, wy, wz;   
 	float ex, ey, ez;  
-	static float exInt = 0.0f;
-	static float eyInt = 0.0f;
-	static float ezInt = 0.0f;
+	static VEHICLE_STATE float exInt = 0.0f;
+	static VEHICLE_STATE float eyInt = 0.0f;
+	static VEHICLE_STATE float ezInt = 0.0f;
 
 	// auxiliary variables to reduce number of repeated operations   
 	float qw_qw_2 = 2.0f*q->w*q->w;  
@@ -178,6 +195,7 @@ void MahonyAHRS_update(quaternion * q,const float gyr[3],const float acc[3],cons
 	
 
 	// normalise the measurements  
+	float accU[3], magU[3];
 	Vector3_Normalize(accU, acc);
 	Vector3_Normalize(magU, mag);
 
@@ -435,6 +453,8 @@ void MARG_AHRS_update(quaternion* q, float g_x, float g_y, float g_z, float a_x,
 // TODO
 void AHRS_gyr_acc_fusion(quaternion * q, const float gyr[3], const float acc[3], float dT)
 {	
+	float accU[3];
+	
 	Vector3_Normalize(accU, acc);
 	
 	/* transfer acc and mag from body frame to nav frame */
@@ -470,6 +490,8 @@ void AHRS_gyr_acc_fusion(quaternion * q, const float gyr[3], const float acc[3],
 // TODO
 void AHRS_mag_fusion(quaternion * q, const float mag[3], float dT)
 {	
+	float magU[3];
+	
 	Vector3_Normalize(magU, mag);
 	
 	/* transfer acc and mag from body frame to nav frame */
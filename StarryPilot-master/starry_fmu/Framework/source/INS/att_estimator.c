@@ -20,6 +20,9 @@
 #include "att_estimator.h"
 #include "control_main.h"
 #include "uMCN.h"
+#include "imu_integrator.h"
+#include "pos_estimator.h"
+#include "est_store.h"
 
 #define AHRS_USE_DEFAULT
 //#define AHRS_USE_MAHONY
@@ -31,37 +34,94 @@
 MCN_DECLARE(SENSOR_ACC);
 MCN_DECLARE(SENSOR_MAG);
 MCN_DECLARE(HOME_POS);
+MCN_DECLARE(SENSOR_IMU_DELTA);
 
 MCN_DEFINE(ATT_EULER, sizeof(Euler));	
 MCN_DEFINE(ATT_QUATERNION, sizeof(quaternion));
 
 static char *TAG = "Att_Est";
 
-static quaternion _att_q;
+static VEHICLE_STATE quaternion _att_q;
 
-McnNode_t _home_node_t;
+VEHICLE_STATE McnNode_t _home_node_t;
+static VEHICLE_STATE McnNode_t _imu_delta_node_t;
+/* a stored state waits for est_store_take */
+static VEHICLE_STATE uint8_t _warm_pending;
 
-void attitude_est_run(float dT)
+/* runs once per imu delta, the interval is set by sensor_imu_delta_set_interval() */
+void attitude_est_run(void)
 {	
 	float gyr_t[3], acc_t[3], mag_t[3];
-	sensor_get_gyr(gyr_t);
-	sensor_get_acc(acc_t);
+	IMU_Delta imu_delta;
+	
+	/* the first mag sample may come after the first delta, the delta is
+	 * left to the integrator until there is one */
 	sensor_get_mag(mag_t);
+	if(mag_t[0] == 0.0f && mag_t[1] == 0.0f && mag_t[2] == 0.0f)
+		return;
+	
+	if(!mcn_poll(_imu_delta_node_t))
+		return;
+	/* the delta SENSOR_IMU_DELTA announced plus whatever came after it */
+	if(!sensor_imu_delta_take(&imu_delta) || imu_delta.dt <= 0.0f)
+		return;
+	
+	/* mean rate and specific force over the interval, coning and sculling corrected */
+	float dT = imu_delta.dt;
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		gyr_t[i] = imu_delta.delta_ang[i] / dT;
+		acc_t[i] = imu_delta.delta_vel[i] / dT;
+	}
+	
+	if(_warm_pending){
+		Est_State warm;
+		int res = est_store_take(&warm);
+		if(res != EST_STORE_WAIT){
+			_warm_pending = 0;
+			if(res == EST_STORE_OK)
+				attitude_est_store_apply(&warm);
+		}
+	}
 	
 #if   defined ( AHRS_USE_DEFAULT ) 
 	AHRS_update(&_att_q, gyr_t, acc_t, mag_t, dT);
 #elif defined ( AHRS_USE_MARG )
-	MARG_AHRS_Update(&_att_q, gyr_t[0], gyr_t[1], gyr_t[2], -acc_t[0], -acc_t[1], -acc_t[2], mag_t[0], mag_t[1], mag_t[2], dT);
+	MARG_AHRS_update(&_att_q, gyr_t[0], gyr_t[1], gyr_t[2], -acc_t[0], -acc_t[1], -acc_t[2], mag_t[0], mag_t[1], mag_t[2], dT);
 #elif defined ( AHRS_USE_MAHONY )
 	MahonyAHRS_update(&_att_q, gyr_t, acc_t, mag_t, dT);
 #else
 	#error Please select AHRS method.
 #endif
 	
+	/* ATT_EULER is derived from it */
 	mcn_publish(MCN_ID(ATT_QUATERNION), &_att_q);
-	Euler euler;
-	quaternion_toEuler(&_att_q, &euler);
-	mcn_publish(MCN_ID(ATT_EULER), &euler);
+}
+
+/* the biases AHRS_update and pos_est_update have learned */
+void attitude_est_store_collect(Est_State* state)
+{
+	float acc_bias[3];
+	
+	AHRS_get_gyr_bias(state->gyr_bias);
+	/* pos_est learns it in NED, the vehicle stands level when disarmed */
+	pos_est_get_acc_bias(acc_bias);
+	state->acc_bias_z = acc_bias[2];
+}
+
+void attitude_est_store_apply(const Est_State* state)
+{
+	float acc_bias[3];
+	
+	AHRS_set_gyr_bias(state->gyr_bias);
+	pos_est_get_acc_bias(acc_bias);
+	acc_bias[2] = state->acc_bias_z;
+	pos_est_set_acc_bias(acc_bias);
+}
+
+/* transform of the derived topic ATT_EULER */
+void attitude_est_quaternion_to_euler(const void* q, void* e)
+{
+	quaternion_toEuler((const quaternion*)q, (Euler*)e);
 }
 
 rt_err_t attitude_est_init(void)
@@ -76,23 +136,26 @@ rt_err_t attitude_est_init(void)
 	sensor_mag_get_calibrated_data(mag);
 #endif
 	AHRS_reset(&_att_q, acc, mag);
-	
+	/* the biases of the last flight are taken once the baro is up */
+	_warm_pending = (est_store_load() == 0);
 	
 	int mcn_res = mcn_advertise(MCN_ID(ATT_QUATERNION));
 	if(mcn_res != 0){
 		Console.e(TAG, "err:%d, ATT_QUATERNION advertise fail!\n", mcn_res);
 	}
-	mcn_res = mcn_advertise(MCN_ID(ATT_EULER));
+	mcn_res = mcn_advertise_derived(MCN_ID(ATT_EULER), MCN_ID(ATT_QUATERNION), attitude_est_quaternion_to_euler);
 	if(mcn_res != 0){
 		Console.e(TAG, "err:%d, ATT_EULER advertise fail!\n", mcn_res);
 	}
+	/* pos_est may run before the first imu delta arrives */
+	mcn_publish(MCN_ID(ATT_QUATERNION), &_att_q);
 	
 	_home_node_t = mcn_subscribe(MCN_ID(HOME_POS), NULL);
 	if(_home_node_t == NULL)
 		Console.e(TAG, "_home_node_t subscribe err\n");
-
-	/* delay 10ms to make sure mag data is ready while AHRS_calculating() is invoked */
-	rt_thread_delay(10);
+	_imu_delta_node_t = mcn_subscribe(MCN_ID(SENSOR_IMU_DELTA), NULL);
+	if(_imu_delta_node_t == NULL)
+		Console.e(TAG, "_imu_delta_node_t subscribe err\n");
 
 	return RT_EOK;
 }
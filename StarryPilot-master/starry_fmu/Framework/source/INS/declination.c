@@ -177,10 +177,37 @@ int16_t compass_get_lookup_value(uint8_t x, uint8_t y)
 	return val;
 }
 
+/* the four corners of the last 5x5 degree cell, the compressed rows are
+ * only walked again when the position leaves this cell */
+typedef struct
+{
+	int16_t latmin;
+	int16_t lonmin;
+	int16_t decSW, decSE, decNW, decNE;
+	bool valid;
+}decl_cell_t;
+
+static VEHICLE_STATE decl_cell_t _decl_cell;
+
+static void compass_load_cell(int16_t latmin, int16_t lonmin)
+{
+	uint8_t latmin_index,lonmin_index;
+
+	latmin_index= (90+latmin)/5;
+	lonmin_index= (180+lonmin)/5;
+
+	_decl_cell.decSW = compass_get_lookup_value(latmin_index, lonmin_index);
+	_decl_cell.decSE = compass_get_lookup_value(latmin_index, lonmin_index+1);
+	_decl_cell.decNE = compass_get_lookup_value(latmin_index+1, lonmin_index+1);
+	_decl_cell.decNW = compass_get_lookup_value(latmin_index+1, lonmin_index);
+	_decl_cell.latmin = latmin;
+	_decl_cell.lonmin = lonmin;
+	_decl_cell.valid = true;
+}
+
 float compass_get_declination(double lat, double lon)
 {
-    int16_t decSW, decSE, decNW, decNE, lonmin, latmin;
-    uint8_t latmin_index,lonmin_index;
+    int16_t lonmin, latmin;
     float decmin, decmax;
 
     // Constrain to valid inputs
@@ -189,23 +216,17 @@ float compass_get_declination(double lat, double lon)
 
     latmin = floorf(lat/5)*5;
     lonmin = floorf(lon/5)*5;
+    // lat 90 and lon 180 belong to the last cell, the grid has no row/column beyond them
+    if(latmin > 85) latmin = 85;
+    if(lonmin > 175) lonmin = 175;
 
-    latmin_index= (90+latmin)/5;
-    lonmin_index= (180+lonmin)/5;
-
-    decSW = compass_get_lookup_value(latmin_index, lonmin_index);
-    decSE = compass_get_lookup_value(latmin_index, lonmin_index+1);
-    decNE = compass_get_lookup_value(latmin_index+1, lonmin_index+1);
-    decNW = compass_get_lookup_value(latmin_index+1, lonmin_index);
+    if(!_decl_cell.valid || _decl_cell.latmin != latmin || _decl_cell.lonmin != lonmin){
+        compass_load_cell(latmin, lonmin);
+    }
 
     /* approximate declination within the grid using bilinear interpolation */
-    decmin = (lon - lonmin) / 5 * (decSE - decSW) + decSW;
-    decmax = (lon - lonmin) / 5 * (decNE - decNW) + decNW;
+    decmin = (lon - lonmin) / 5 * (_decl_cell.decSE - _decl_cell.decSW) + _decl_cell.decSW;
+    decmax = (lon - lonmin) / 5 * (_decl_cell.decNE - _decl_cell.decNW) + _decl_cell.decNW;
 	
     return (lat - latmin) / 5 * (decmax - decmin) + decmin;// in degree
 }
-
-
-
-
-
@@ -0,0 +1,251 @@
+/*
+ * File      : est_store.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include <time.h>
+#include "est_store.h"
+#include "att_estimator.h"
+#include "state_est.h"
+#include "pos_estimator.h"
+#include "sensor_manager.h"
+#include "file_manager.h"
+#include "ff.h"
+#include "uMCN.h"
+#include "console.h"
+#include "delay.h"
+#include "ap_math.h"
+#include "logger.h"
+
+MCN_DECLARE(SENSOR_BARO);
+
+static char *TAG = "Est_Store";
+
+static VEHICLE_STATE Est_State _state;
+static VEHICLE_STATE uint8_t _loaded;
+/* EST_STORE_WAIT while _state is there to take */
+static VEHICLE_STATE int _status = EST_STORE_NONE;
+static VEHICLE_STATE uint8_t _decl_set;
+static VEHICLE_STATE uint32_t _wait_start;
+static VEHICLE_STATE uint8_t _wait_started;
+/* collected by est_store_request_save, written by est_store_flush */
+static VEHICLE_STATE Est_State _save;
+static VEHICLE_STATE uint8_t _save_pending;
+
+static uint16_t _crc(const Est_State* state)
+{
+	const uint32_t start = offsetof(Est_State, gyr_bias);
+
+	return math_crc16(0, (const uint8_t*)state + start, sizeof(Est_State) - start);
+}
+
+/* s from the rtc, 0 if it does not run */
+static uint32_t _rtc_time(void)
+{
+	rt_device_t rtc = rt_device_find("rtc");
+	time_t now = 0;
+
+	if(rtc == RT_NULL || rt_device_control(rtc, RT_DEVICE_CTRL_RTC_GET_TIME, &now) != RT_EOK)
+		return 0;
+	return now > 0 ? (uint32_t)now : 0;
+}
+
+static rt_err_t _write(Est_State* state)
+{
+	FIL fp;
+	UINT bw = 0;
+
+	if(!fm_init_complete())
+		return RT_ERROR;
+	state->magic = EST_STORE_MAGIC;
+	state->version = EST_STORE_VERSION;
+	state->crc = _crc(state);
+
+	FRESULT res = f_open(&fp, EST_STORE_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE);
+	if(res != FR_OK){
+		Console.e(TAG, "%s open err:%d\n", EST_STORE_FILE_NAME, res);
+		return RT_ERROR;
+	}
+	res = f_write(&fp, state, sizeof(Est_State), &bw);
+	f_close(&fp);
+
+	return (res == FR_OK && bw == sizeof(Est_State)) ? RT_EOK : RT_ERROR;
+}
+
+static void _use(const Est_State* state)
+{
+	_state = *state;
+	_status = EST_STORE_WAIT;
+	_wait_started = 0;
+	_decl_set = state->mag_decl_set;
+}
+
+int est_store_load(void)
+{
+	Est_State s;
+	FIL fp;
+	UINT br = 0;
+
+	/* both estimators are initialized, the state is read once */
+	if(_loaded)
+		return _status == EST_STORE_WAIT ? 0 : 1;
+	_loaded = 1;
+
+	if(!fm_init_complete())
+		return 1;
+	if(f_open(&fp, EST_STORE_FILE_NAME, FA_OPEN_EXISTING | FA_READ) != FR_OK){
+		/* never saved, cold start */
+		return 1;
+	}
+	FRESULT res = f_read(&fp, &s, sizeof(s), &br);
+	f_close(&fp);
+	if(res != FR_OK || br != sizeof(s) || s.magic != EST_STORE_MAGIC
+			|| s.version != EST_STORE_VERSION || s.crc != _crc(&s)){
+		Console.e(TAG, "%s invalid, cold start\n", EST_STORE_FILE_NAME);
+		return 1;
+	}
+
+	/* the declination does not age */
+	_decl_set = s.mag_decl_set;
+	_state.mag_decl = s.mag_decl;
+
+	uint32_t now = _rtc_time();
+	if(s.time && now && (now < s.time || now - s.time > EST_STORE_MAX_AGE)){
+		Console.print("estimator state saved %u s ago, cold start\n", now - s.time);
+		return 1;
+	}
+	if(s.boot_cnt >= EST_STORE_MAX_BOOT){
+		Console.print("estimator state restored %u boots already, cold start\n", s.boot_cnt);
+		return 1;
+	}
+	/* a state restored again and again without a disarm in between runs out */
+	s.boot_cnt++;
+	_write(&s);
+
+	_use(&s);
+	return 0;
+}
+
+void est_store_set(const Est_State* state)
+{
+	_loaded = 1;
+	_use(state);
+}
+
+int est_store_take(Est_State* state)
+{
+	if(_status != EST_STORE_WAIT)
+		return EST_STORE_NONE;
+
+	uint32_t now = time_nowMs();
+	if(!_wait_started){
+		_wait_start = now;
+		_wait_started = 1;
+	}
+
+	if(MCN_ID(SENSOR_BARO)->published){
+		MS5611_REPORT_Def baro;
+
+		mcn_copy_from_hub(MCN_ID(SENSOR_BARO), &baro);
+		_status = EST_STORE_NONE;
+		/* the biases drift with temperature */
+		if(!(fabsf(baro.temperature - _state.temperature) <= EST_STORE_MAX_TEMP_DIFF)){
+			Console.print("temperature %.1f C, estimator state of %.1f C, cold start\n", baro.temperature, _state.temperature);
+			return EST_STORE_NONE;
+		}
+		*state = _state;
+		Console.print("estimator warm start, gyr bias %.4f %.4f %.4f rad/s, az bias %.3f m/s2\n",
+			_state.gyr_bias[0], _state.gyr_bias[1], _state.gyr_bias[2], _state.acc_bias_z);
+		return EST_STORE_OK;
+	}
+	if(TIME_GAP(_wait_start, now) > EST_STORE_TEMP_TIMEOUT){
+		_status = EST_STORE_NONE;
+		Console.print("no baro temperature, cold start\n");
+		return EST_STORE_NONE;
+	}
+
+	return EST_STORE_WAIT;
+}
+
+int est_store_get_decl(float* decl)
+{
+	if(!_decl_set)
+		return 1;
+	*decl = _state.mag_decl;
+	return 0;
+}
+
+static void _collect(Est_State* state)
+{
+	Est_State s;
+	HOME_Pos home = pos_home_get();
+
+	memset(&s, 0, sizeof(s));
+#ifdef AHRS_USE_EKF
+	state_est_store_collect(&s);
+#else
+	attitude_est_store_collect(&s);
+#endif
+	if(home.gps_coordinate_set){
+		s.mag_decl = home.mag_decl;
+		s.mag_decl_set = 1;
+	}else if(_decl_set){
+		s.mag_decl = _state.mag_decl;
+		s.mag_decl_set = 1;
+	}
+	s.temperature = NAN;
+	if(MCN_ID(SENSOR_BARO)->published){
+		MS5611_REPORT_Def baro;
+
+		mcn_copy_from_hub(MCN_ID(SENSOR_BARO), &baro);
+		s.temperature = baro.temperature;
+	}
+	s.time = _rtc_time();
+	s.boot_cnt = 0;
+
+	*state = s;
+}
+
+rt_err_t est_store_save(void)
+{
+	Est_State s;
+
+	_collect(&s);
+	rt_err_t res = _write(&s);
+	if(res != RT_EOK)
+		Console.e(TAG, "estimator state save fail\n");
+	return res;
+}
+
+void est_store_request_save(void)
+{
+	Est_State s;
+
+	_collect(&s);
+	OS_ENTER_CRITICAL;
+	_save = s;
+	_save_pending = 1;
+	OS_EXIT_CRITICAL;
+	logger_request_est_store();
+}
+
+void est_store_flush(void)
+{
+	Est_State s;
+	uint8_t pending;
+
+	OS_ENTER_CRITICAL;
+	pending = _save_pending;
+	s = _save;
+	_save_pending = 0;
+	OS_EXIT_CRITICAL;
+
+	if(pending && _write(&s) != RT_EOK)
+		Console.e(TAG, "estimator state save fail\n");
+}
@@ -0,0 +1,119 @@
+/*
+ * File      : imu_integrator.c
+ *
+ * The corrections are the second order ones of Savage, "Strapdown Inertial
+ * Navigation Integration Algorithm Design", for samples taken at a fixed
+ * rate: with a(m), v(m) the delta angle and velocity of sample m and
+ * alpha, nu their sums over the interval so far,
+ *	coning		beta += 1/2 (alpha + a(m-1)/6) x a(m)
+ *	sculling	scul += 1/2 ((alpha + a(m-1)/6) x v(m) + (nu + v(m-1)/6) x a(m))
+ * and at the end of the interval
+ *	delta_ang = alpha + beta
+ *	delta_vel = nu + 1/2 alpha x nu + scul
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include "imu_integrator.h"
+#include "ap_math.h"
+
+/* a late sample still closes the interval it was meant for */
+#define IMU_INTERVAL_TOLERANCE_US		500
+/* a gap longer than this restarts the integration */
+#define IMU_MAX_SAMPLE_GAP_US			20000
+
+static void _restart(IMU_Integrator* integ)
+{
+	integ->dt_us = 0;
+	memset(integ->alpha, 0, sizeof(integ->alpha));
+	memset(integ->beta, 0, sizeof(integ->beta));
+	memset(integ->vel, 0, sizeof(integ->vel));
+	memset(integ->scul, 0, sizeof(integ->scul));
+}
+
+void imu_integrator_reset(IMU_Integrator* integ, uint32_t interval_ms)
+{
+	integ->interval_us = interval_ms*1000;
+	integ->last_us = 0;
+	_restart(integ);
+	memset(integ->last_dalpha, 0, sizeof(integ->last_dalpha));
+	memset(integ->last_dvel, 0, sizeof(integ->last_dvel));
+}
+
+bool imu_integrator_input(IMU_Integrator* integ, const float gyr[3], const float acc[3], uint64_t time_us)
+{
+	uint64_t gap = time_us - integ->last_us;
+
+	if(integ->last_us == 0 || time_us <= integ->last_us || gap > IMU_MAX_SAMPLE_GAP_US){
+		/* nothing to integrate against yet */
+		uint32_t interval_ms = integ->interval_us/1000;
+
+		imu_integrator_reset(integ, interval_ms);
+		integ->last_us = time_us;
+		memcpy(integ->last_gyr, gyr, sizeof(integ->last_gyr));
+		memcpy(integ->last_acc, acc, sizeof(integ->last_acc));
+		return false;
+	}
+
+	float dt = 1e-6f*gap;
+	float dalpha[3], dvel[3], a[3], v[3], c1[3], c2[3];
+
+	/* trapezoidal increments between this sample and the last */
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		dalpha[i] = 0.5f*(gyr[i] + integ->last_gyr[i])*dt;
+		dvel[i] = 0.5f*(acc[i] + integ->last_acc[i])*dt;
+		a[i] = integ->alpha[i] + integ->last_dalpha[i]*(1.0f/6.0f);
+		v[i] = integ->vel[i] + integ->last_dvel[i]*(1.0f/6.0f);
+	}
+
+	Vector3_CrossProduct(c1, a, dalpha);
+	for(uint8_t i = 0 ; i < 3 ; i++)
+		integ->beta[i] += 0.5f*c1[i];
+
+	Vector3_CrossProduct(c1, a, dvel);
+	Vector3_CrossProduct(c2, v, dalpha);
+	for(uint8_t i = 0 ; i < 3 ; i++)
+		integ->scul[i] += 0.5f*(c1[i] + c2[i]);
+
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		integ->alpha[i] += dalpha[i];
+		integ->vel[i] += dvel[i];
+		integ->last_dalpha[i] = dalpha[i];
+		integ->last_dvel[i] = dvel[i];
+		integ->last_gyr[i] = gyr[i];
+		integ->last_acc[i] = acc[i];
+	}
+	integ->last_us = time_us;
+	integ->dt_us += (uint32_t)gap;
+
+	/* only once per interval, the interval may go on when nobody takes it */
+	return imu_integrator_full(integ) && integ->dt_us - (uint32_t)gap + IMU_INTERVAL_TOLERANCE_US < integ->interval_us;
+}
+
+bool imu_integrator_full(const IMU_Integrator* integ)
+{
+	return integ->dt_us + IMU_INTERVAL_TOLERANCE_US >= integ->interval_us;
+}
+
+void imu_integrator_peek(const IMU_Integrator* integ, IMU_Delta* delta)
+{
+	float rot[3];
+
+	/* rotation of the velocity sum over the interval */
+	Vector3_CrossProduct(rot, integ->alpha, integ->vel);
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		delta->delta_ang[i] = integ->alpha[i] + integ->beta[i];
+		delta->delta_vel[i] = integ->vel[i] + 0.5f*rot[i] + integ->scul[i];
+	}
+	delta->dt = 1e-6f*integ->dt_us;
+	delta->time_stamp = (uint32_t)(integ->last_us/1000);
+}
+
+void imu_integrator_output(IMU_Integrator* integ, IMU_Delta* delta)
+{
+	imu_integrator_peek(integ, delta);
+	_restart(integ);
+}
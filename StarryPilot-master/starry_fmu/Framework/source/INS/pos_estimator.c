@@ -24,8 +24,9 @@
 #include "control_alt.h"
 #include "filter.h"
 #include "uMCN.h"
-#include "fifo.h"
+#include "state_hist.h"
 #include "declination.h"
+#include "est_store.h"
 
 #ifdef HIL_SIMULATION
 	#define KF_GPS_POS_DELAY		0
@@ -41,14 +42,15 @@
 
 #define KF_MAX_DELAY_OFFFSET	20
 
-static HOME_Pos _home_pos;
-static McnNode_t alt_node_t;
-static McnNode_t gps_node_t;
-static KF_Def pos_kf[3];
-static FIFO _hist_x[3][2];
-static float _acc_bias[3] = {0,0,0};
+static VEHICLE_STATE HOME_Pos _home_pos;
+static VEHICLE_STATE McnNode_t alt_node_t;
+static VEHICLE_STATE McnNode_t gps_node_t;
+static VEHICLE_STATE KF_Def pos_kf[3];
+static VEHICLE_STATE State_Hist _hist_x;
+static VEHICLE_STATE uint8_t _pos_est_ready = 0;
+static VEHICLE_STATE float _acc_bias[3] = {0,0,0};
 
-static Altitude_Info _altInfo;
+static VEHICLE_STATE Altitude_Info _altInfo;
 
 static char *TAG = "POS";
 
@@ -100,6 +102,8 @@ void pos_home_set(HOME_Item item, void* data)
 		double *gps_coor = data;
 		_home_pos.lat = gps_coor[0];
 		_home_pos.lon = gps_coor[1];
+		/* cache the projection scale factors, gps_get_position is single precision afterwards */
+		geo_proj_init(&_home_pos.proj, (int32_t)lround(gps_coor[0]*1e7), (int32_t)lround(gps_coor[1]*1e7));
 		_home_pos.gps_coordinate_set = true;
 		
 		//calculate magnetic declination
@@ -109,6 +113,21 @@ void pos_home_set(HOME_Item item, void* data)
 	mcn_publish(MCN_ID(HOME_POS), &_home_pos);
 }
 
+/* the accel bias pos_est_update has learned, NED */
+void pos_est_get_acc_bias(float bias[3])
+{
+	bias[0] = _acc_bias[0];
+	bias[1] = _acc_bias[1];
+	bias[2] = _acc_bias[2];
+}
+
+void pos_est_set_acc_bias(const float bias[3])
+{
+	_acc_bias[0] = bias[0];
+	_acc_bias[1] = bias[1];
+	_acc_bias[2] = bias[2];
+}
+
 HOME_Pos pos_home_get(void)
 {
 	return _home_pos;
@@ -153,6 +172,9 @@ void pos_est_update(float dT)
 	float accE[3];
 	GPS_Status gps_status;
 	
+	if(!_pos_est_ready)
+		return;
+	
 	mcn_copy_from_hub(MCN_ID(GPS_STATUS), &gps_status);
 	
 	if(mcn_poll(alt_node_t) && _home_pos.baro_altitude_set==false){
@@ -193,9 +215,9 @@ void pos_est_update(float dT)
 	Vector3f_t vel = {0,0,0};
 	struct vehicle_gps_position_s gps_pos = gps_get_report();
 
-	if(gps_status.status == GPS_AVAILABLE && _home_pos.gps_coordinate_set){
+	if(gps_status.status == GPS_AVAILABLE && _home_pos.gps_coordinate_set
+		&& gps_get_position(&pos, gps_pos) == 0){
 		
-		gps_get_position(&pos, gps_pos);
 		gps_get_velocity(&vel, gps_pos);
 	}
 	
@@ -223,31 +245,26 @@ void pos_est_update(float dT)
 	KF_Predict(&pos_kf[1]);
 	KF_Predict(&pos_kf[2]);
 	
-	// store history state
+	// store history state, x and vx of each axis
+	uint32_t now = time_nowMs();
+	float x[6];
 	for(uint8_t i = 0 ; i < 3 ; i++){
 		for(uint8_t j = 0 ; j < 2 ; j++){
-			fifo_push(&_hist_x[i][j], pos_kf[i].x.element[j][0]);
+			x[i*2+j] = pos_kf[i].x.element[j][0];
 		}
 	}
+	state_hist_push(&_hist_x, now, x);
 	
-	// calculate observer delay offset
-	uint32_t now = time_nowMs();
-	int interval = (int)(1e3f*dT);
-	uint32_t gps_pos_hist_offset = (now - (gps_pos.timestamp_position-KF_GPS_POS_DELAY))/interval;
-	uint32_t baro_pos_hist_offset = (now - (baro_pos.time_stamp-KF_BARO_POS_DELAY))/interval;
-	uint32_t gps_vel_hist_offset = (now - (gps_pos.timestamp_velocity-KF_GPS_VEL_DELAY))/interval;
-	uint32_t baro_vel_hist_offset = (now - (baro_pos.time_stamp-KF_BARO_VEL_DELAY))/interval;
-	
-	// constrain offset
-	gps_pos_hist_offset = constrain_uint32(gps_pos_hist_offset, 0, KF_MAX_DELAY_OFFFSET);
-	baro_pos_hist_offset = constrain_uint32(baro_pos_hist_offset, 0, KF_MAX_DELAY_OFFFSET);
-	gps_vel_hist_offset = constrain_uint32(gps_vel_hist_offset, 0, KF_MAX_DELAY_OFFFSET);
-	baro_vel_hist_offset = constrain_uint32(baro_vel_hist_offset, 0, KF_MAX_DELAY_OFFFSET);
+	// find the states at the time the observations were taken
+	const float* gps_pos_hist = state_hist_lookup(&_hist_x, gps_pos.timestamp_position-KF_GPS_POS_DELAY);
+	const float* baro_pos_hist = state_hist_lookup(&_hist_x, baro_pos.time_stamp-KF_BARO_POS_DELAY);
+	const float* gps_vel_hist = state_hist_lookup(&_hist_x, gps_pos.timestamp_velocity-KF_GPS_VEL_DELAY);
+	const float* baro_vel_hist = state_hist_lookup(&_hist_x, baro_pos.time_stamp-KF_BARO_VEL_DELAY);
 
-	uint32_t hist_offset[3][2] = {
-		{gps_pos_hist_offset, gps_vel_hist_offset},
-		{gps_pos_hist_offset, gps_vel_hist_offset},
-		{baro_pos_hist_offset, baro_vel_hist_offset}
+	const float* hist[3][2] = {
+		{gps_pos_hist, gps_vel_hist},
+		{gps_pos_hist, gps_vel_hist},
+		{baro_pos_hist, baro_vel_hist}
 	};
 	
 	float delta_x[3][2];
@@ -255,7 +272,7 @@ void pos_est_update(float dT)
 		
 		// calculate delta state
 		for(uint8_t j = 0 ; j < 2 ; j++){
-			float hist_val = fifo_read_back(&_hist_x[i][j], hist_offset[i][j]);
+			float hist_val = hist[i][j][i*2+j];
 			delta_x[i][j] = pos_kf[i].x.element[j][0] - hist_val;
 			
 			// set current state to history value
@@ -317,7 +334,7 @@ void pos_est_reset(void)
 	//set_home_cur_alt();
 }
 
-void pos_est_init(float dT)
+rt_err_t pos_est_init(float dT)
 {
 	int mcn_res = mcn_advertise(MCN_ID(ALT_INFO));
 	if(mcn_res != 0){
@@ -339,6 +356,9 @@ void pos_est_init(float dT)
 	hp.baro_altitude_set = 0;
 	hp.gps_coordinate_set = 0;
 	hp.lidar_altitude_set = 0;
+	/* the last known declination until the gps sets home */
+	hp.mag_decl = 0.0f;
+	est_store_get_decl(&hp.mag_decl);
 	// publish to init HOME_Pos
 	mcn_publish(MCN_ID(HOME_POS), &hp);
 	
@@ -399,17 +419,20 @@ void pos_est_init(float dT)
 	R[3] = (double)r_vz*r_vz;
 	KF_Init(&pos_kf[2], F, B, H, P, Q, R, x_init, true, dT);
 
-	for(int i = 0 ; i < 3 ; i++){
-		for(int j = 0 ; j < 2 ; j++){
-			fifo_create(&_hist_x[i][j], KF_MAX_DELAY_OFFFSET+1);
-			fifo_flush(&_hist_x[i][j]);
-		}
+	// KF_MAX_DELAY_OFFFSET steps back, pos_est_update() runs every dT
+	_pos_est_ready = 0;
+	if(state_hist_create(&_hist_x, KF_MAX_DELAY_OFFFSET+1, 6) != 0){
+		Console.e(TAG, "state history create fail\n");
+		return RT_ERROR;
 	}
 
 	_home_pos.baro_altitude_set = false;
 	_home_pos.lidar_altitude_set = false;
 	_home_pos.gps_coordinate_set = false;
-	_home_pos.mag_decl = 0.0f;
+	_home_pos.mag_decl = hp.mag_decl;
+	_pos_est_ready = 1;
+	
+	return RT_EOK;
 }
 
 int handle_pos_est_shell_cmd(int argc, char** argv)
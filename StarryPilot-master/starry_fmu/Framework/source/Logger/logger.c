@@ -22,19 +22,23 @@
 #include "global.h"
 #include "gps.h"
 #include "sensor_manager.h"
+#include "est_store.h"
+#include "control_main.h"
 #include <string.h>
 #include <stdlib.h>
 
 #define LOGGER_DEFAULT_PERIOD		100
 #define EVENT_LOG_RECORD			(1<<0)
+#define EVENT_EST_STORE				(1<<1)
 
-LOG_HeaderDef* log_header_t = NULL;
+VEHICLE_STATE LOG_HeaderDef* log_header_t = NULL;
 
 static char* TAG = "Logger";
-FIL logger_fp;
-LOGGER_InfoDef _logger_info;
-static struct rt_timer _timer_logger;
-static struct rt_event event_log;
+VEHICLE_STATE FIL logger_fp;
+VEHICLE_STATE LOGGER_InfoDef _logger_info;
+static VEHICLE_STATE struct rt_timer _timer_logger;
+static VEHICLE_STATE struct rt_event event_log;
+static VEHICLE_STATE uint8_t _event_ready = 0;
 
 MCN_DECLARE(ATT_QUATERNION);
 MCN_DECLARE(ATT_EULER);
@@ -105,6 +109,8 @@ LOG_ElementInfoDef element_info_list[] =
 	LOG_ELEMENT_INFO_FLOAT(GPS_HDOP),
 	LOG_ELEMENT_INFO_FLOAT(BARO_ALT),
 	LOG_ELEMENT_INFO_FLOAT(BARO_VEL),
+	LOG_ELEMENT_INFO_FLOAT(ROLL_SP),
+	LOG_ELEMENT_INFO_FLOAT(PITCH_SP),
 //	LOG_ELEMENT_INFO_FLOAT(KF_U_X),
 //	LOG_ELEMENT_INFO_FLOAT(KF_U_Y),
 //	LOG_ELEMENT_INFO_FLOAT(KF_U_Z),
@@ -249,9 +255,10 @@ uint8_t logger_record(void)
 	mcn_copy_from_hub(MCN_ID(ALT_INFO), &alt_info);
 	mcn_copy_from_hub(MCN_ID(POS_INFO), &pos_info);
 	struct vehicle_gps_position_s gps_report = gps_get_report();
-	Vector3f_t pos, vel;
+	Vector3f_t pos = {0,0,0}, vel;
 	gps_get_position(&pos, gps_report);
 	gps_get_velocity(&vel, gps_report);
+	Euler att_sp = ctrl_get_target_euler();
 	
 	LOG_SET_ELEMENT(_logger_info, QUATERNION_W, quat.w);
 	LOG_SET_ELEMENT(_logger_info, QUATERNION_X, quat.x);
@@ -305,6 +312,8 @@ uint8_t logger_record(void)
 	LOG_SET_ELEMENT(_logger_info, GPS_HDOP, gps_report.hdop);
 	LOG_SET_ELEMENT(_logger_info, BARO_ALT, baro_pos.altitude);
 	LOG_SET_ELEMENT(_logger_info, BARO_VEL, baro_pos.velocity);
+	LOG_SET_ELEMENT(_logger_info, ROLL_SP, Rad2Deg(att_sp.roll));
+	LOG_SET_ELEMENT(_logger_info, PITCH_SP, Rad2Deg(att_sp.pitch));
 //	LOG_SET_ELEMENT(_logger_info, KF_U_X, pos_kf_log.u_x);
 //	LOG_SET_ELEMENT(_logger_info, KF_U_Y, pos_kf_log.u_y);
 //	LOG_SET_ELEMENT(_logger_info, KF_U_Z, pos_kf_log.u_z);
@@ -442,14 +451,26 @@ static void timer_logger_record(void* parameter)
 	rt_event_send(&event_log, EVENT_LOG_RECORD);
 }
 
+void logger_request_est_store(void)
+{
+	if(_event_ready){
+		rt_event_send(&event_log, EVENT_EST_STORE);
+	}else{
+		/* no logger thread to hand it to, write it from the caller */
+		Console.w(TAG, "logger thread not running, est state written directly\n");
+		est_store_flush();
+	}
+}
+
 void logger_entry(void *parameter)
 {
 	rt_err_t res;
 	rt_uint32_t recv_set = 0;
-	rt_uint32_t wait_set = EVENT_LOG_RECORD;
+	rt_uint32_t wait_set = EVENT_LOG_RECORD | EVENT_EST_STORE;
 	
 	/* create event */
 	res = rt_event_init(&event_log, "logger_event", RT_IPC_FLAG_FIFO);
+	_event_ready = 1;
 	
 	rt_timer_init(&_timer_logger, "logger",
 					timer_logger_record,
@@ -464,7 +485,11 @@ void logger_entry(void *parameter)
 								RT_WAITING_FOREVER, &recv_set);
 		
 		if(res == RT_EOK){
-			logger_record();
+			if(recv_set & EVENT_LOG_RECORD)
+				logger_record();
+			/* the card write is kept out of the control thread */
+			if(recv_set & EVENT_EST_STORE)
+				est_store_flush();
 		}else{
 			/* some error happens */
 			Console.e(TAG, "logger loop, err:%d\r\n" , res);
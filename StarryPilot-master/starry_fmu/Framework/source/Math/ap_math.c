@@ -11,20 +11,20 @@
 #include <rtthread.h>
 #include <math.h>
 #include "ap_math.h"
+#include "fast_math.h"
 
 // 快速算“平方根的倒数”。
 // http://zh.wikipedia.org/wiki/%E5%B9%B3%E6%96%B9%E6%A0%B9%E5%80%92%E6%95%B0%E9%80%9F%E7%AE%97%E6%B3%95
 float math_rsqrt(float number)
 {
-    long i;
+    union { float f; int32_t i; } u;           // 32 bit on every target, long is 64 bit on a 64 bit host
     float x2, y;
     const float threehalfs = 1.5F;
 
     x2 = number * 0.5F;
-    y  = number;
-    i  = * ( long * ) &y;                       // evil floating point bit level hacking（对浮点数的邪恶位级hack）
-    i  = 0x5f3759df - ( i >> 1 );               // what the fuck?（这他妈的是怎么回事？）
-    y  = * ( float * ) &i;
+    u.f = number;                               // evil floating point bit level hacking（对浮点数的邪恶位级hack）
+    u.i = 0x5f3759df - ( u.i >> 1 );            // what the fuck?（这他妈的是怎么回事？）
+    y  = u.f;
     y  = y * ( threehalfs - ( x2 * y * y ) );   // 1st iteration （第一次牛顿迭代）
     y  = y * ( threehalfs - ( x2 * y * y ) );   // 2nd iteration, this can be removed（第二次迭代，可以删除）
 
@@ -139,7 +139,9 @@ void Vector3_Set(float vector[3], float x, float y, float z)
 
 void Vector3_Normalize(float result[3], const float vector[3])
 {
-	float rsqrt = math_rsqrt(vector[0]*vector[0]+vector[1]*vector[1]+vector[2]*vector[2]);
+	float norm_sq = vector[0]*vector[0]+vector[1]*vector[1]+vector[2]*vector[2];
+	/* a zero vector stays zero, 1/sqrtf(0) would turn it into NaN */
+	float rsqrt = norm_sq > 0.0f ? MATH_RSQRTF(norm_sq) : 0.0f;
     result[0] = vector[0] * rsqrt;
     result[1] = vector[1] * rsqrt;
 	result[2] = vector[2] * rsqrt;
@@ -159,12 +161,13 @@ float Vector3_DotProduct(const float vector1[3], const float vector2[3])
 
 float Vector3_Length(const float vector[3])
 {
-	return sqrt(vector[0]*vector[0]+vector[1]*vector[1]+vector[2]*vector[2]);
+	return sqrtf(vector[0]*vector[0]+vector[1]*vector[1]+vector[2]*vector[2]);
 }
 
 void Vector2_Normalize(float result[2], float vector[2])
 {
-	float rsqrt = math_rsqrt(vector[0]*vector[0]+vector[1]*vector[1]);
+	float norm_sq = vector[0]*vector[0]+vector[1]*vector[1];
+	float rsqrt = norm_sq > 0.0f ? MATH_RSQRTF(norm_sq) : 0.0f;
 	result[0] = vector[0] * rsqrt;
     result[1] = vector[1] * rsqrt;
 }
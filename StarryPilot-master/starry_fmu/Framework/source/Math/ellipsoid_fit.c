@@ -0,0 +1,307 @@
+/*
+ * File      : ellipsoid_fit.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <math.h>
+#include <string.h>
+#include "ellipsoid_fit.h"
+
+#define N		ELLIPSOID_FIT_N
+
+/* smallest value kept in the diagonal factor of P */
+#define ELLIPSOID_FIT_D_MIN		1e-20f
+
+/* index of U(i,j), i < j, in the packed unit upper triangle */
+#define U_IDX(i, j)		((j)*((j)-1)/2 + (i))
+
+static void _regressor(EllipsoidFit_Def* fit, const float val[3], float D[N])
+{
+	float x = val[0] * fit->scale;
+	float y = val[1] * fit->scale;
+	float z = val[2] * fit->scale;
+
+	D[0] = x*x;
+	D[1] = y*y;
+	D[2] = z*z;
+	D[3] = 2.0f*x*y;
+	D[4] = 2.0f*x*z;
+	D[5] = 2.0f*y*z;
+	D[6] = 2.0f*x;
+	D[7] = 2.0f*y;
+	D[8] = 2.0f*z;
+}
+
+/* The normalisation is fixed by the first sample. P was initialised for
+ * raw samples, express it for normalised ones as well. */
+static int _set_scale(EllipsoidFit_Def* fit, const float val[3])
+{
+	float norm, f[N];
+
+	if(fit->scale > 0.0f){
+		return 0;
+	}
+	norm = sqrtf(val[0]*val[0] + val[1]*val[1] + val[2]*val[2]);
+	if(!(norm > 0.0f) || !isfinite(norm)){
+		return -1;
+	}
+	fit->scale = 1.0f / norm;
+
+	/* V_normalised = V / scale^2 for the quadratic terms, V / scale for the linear ones */
+	for(uint8_t i = 0 ; i < N ; i++){
+		f[i] = i < 6 ? norm*norm : norm;
+	}
+	/* P = F*P*F, F = diag(f) */
+	for(uint8_t j = 0 ; j < N ; j++){
+		fit->V[j] *= f[j];
+		fit->d[j] *= f[j]*f[j];
+		for(uint8_t i = 0 ; i < j ; i++){
+			fit->U[U_IDX(i, j)] *= f[i] / f[j];
+		}
+	}
+
+	return 0;
+}
+
+/* in place Cholesky factorisation A = L*L', L is left in the lower triangle */
+static int _cholesky(float A[N][N])
+{
+	for(uint8_t j = 0 ; j < N ; j++){
+		float d = A[j][j];
+		for(uint8_t k = 0 ; k < j ; k++){
+			d -= A[j][k]*A[j][k];
+		}
+		if(!(d > 0.0f)){
+			return -1;
+		}
+		A[j][j] = sqrtf(d);
+		for(uint8_t i = j+1 ; i < N ; i++){
+			float s = A[i][j];
+			for(uint8_t k = 0 ; k < j ; k++){
+				s -= A[i][k]*A[j][k];
+			}
+			A[i][j] = s / A[j][j];
+		}
+	}
+	return 0;
+}
+
+/* solve L*L'*x = b, x may alias b */
+static void _cholesky_solve(float L[N][N], const float b[N], float x[N])
+{
+	for(uint8_t i = 0 ; i < N ; i++){
+		float s = b[i];
+		for(uint8_t k = 0 ; k < i ; k++){
+			s -= L[i][k]*x[k];
+		}
+		x[i] = s / L[i][i];
+	}
+	for(int8_t i = N-1 ; i >= 0 ; i--){
+		float s = x[i];
+		for(uint8_t k = i+1 ; k < N ; k++){
+			s -= L[k][i]*x[k];
+		}
+		x[i] = s / L[i][i];
+	}
+}
+
+/* P = gain * inv(L*L') */
+static void _cholesky_inverse(float L[N][N], float gain, float P[N][N])
+{
+	float col[N];
+
+	for(uint8_t j = 0 ; j < N ; j++){
+		for(uint8_t i = 0 ; i < N ; i++){
+			col[i] = (i == j) ? gain : 0.0f;
+		}
+		_cholesky_solve(L, col, col);
+		for(uint8_t i = 0 ; i < N ; i++){
+			P[i][j] = col[i];
+		}
+	}
+}
+
+/* P = U*diag(d)*U' */
+static void _ud_to_p(const EllipsoidFit_Def* fit, float P[N][N])
+{
+	for(uint8_t i = 0 ; i < N ; i++){
+		for(uint8_t k = i ; k < N ; k++){
+			/* U(i,j) = 0 for j < i, U(j,j) = 1 */
+			float s = (i == k) ? fit->d[k] : fit->U[U_IDX(i, k)]*fit->d[k];
+			for(uint8_t j = k+1 ; j < N ; j++){
+				s += fit->U[U_IDX(i, j)]*fit->d[j]*fit->U[U_IDX(k, j)];
+			}
+			P[i][k] = P[k][i] = s;
+		}
+	}
+}
+
+/* factorise P = U*diag(d)*U', from the last column backwards */
+static void _p_to_ud(EllipsoidFit_Def* fit, float P[N][N])
+{
+	for(int8_t j = N-1 ; j >= 0 ; j--){
+		float dj = P[j][j];
+		for(uint8_t k = j+1 ; k < N ; k++){
+			dj -= fit->d[k]*fit->U[U_IDX(j, k)]*fit->U[U_IDX(j, k)];
+		}
+		if(dj < ELLIPSOID_FIT_D_MIN){
+			dj = ELLIPSOID_FIT_D_MIN;
+		}
+		fit->d[j] = dj;
+		for(int8_t i = 0 ; i < j ; i++){
+			float s = P[i][j];
+			for(uint8_t k = j+1 ; k < N ; k++){
+				s -= fit->d[k]*fit->U[U_IDX(i, k)]*fit->U[U_IDX(j, k)];
+			}
+			fit->U[U_IDX(i, j)] = s / dj;
+		}
+	}
+}
+
+void ellipsoid_fit_init(EllipsoidFit_Def* fit)
+{
+	memset(fit, 0, sizeof(EllipsoidFit_Def));
+
+	for(uint8_t i = 0 ; i < N ; i++){
+		fit->d[i] = i < 3 ? 10.0f : 1.0f;
+	}
+	fit->R = 0.001f;
+}
+
+/* rank-1 recursive least squares update, in Bierman's U-D form:
+ *   f = U'*D', v = diag(d)*f, S = D*P*D' + R
+ *   V = V + U*v/S * (1 - D*V)
+ * and U, d are updated to the factors of P - P*D'*D*P/S. The diagonal
+ * factor is only ever scaled, never subtracted from, so P stays positive
+ * definite in single precision. About 130 multiplies per sample. */
+void ellipsoid_fit_update(EllipsoidFit_Def* fit, const float val[3])
+{
+	float D[N], f[N], v[N], K[N];
+	float alpha, beta, err;
+
+	if(_set_scale(fit, val)){
+		return;
+	}
+	_regressor(fit, val, D);
+
+	err = 1.0f;
+	for(uint8_t j = 0 ; j < N ; j++){
+		f[j] = D[j];
+		for(uint8_t i = 0 ; i < j ; i++){
+			f[j] += fit->U[U_IDX(i, j)]*D[i];
+		}
+		v[j] = fit->d[j]*f[j];
+		err -= D[j]*fit->V[j];
+	}
+	if(!isfinite(err)){
+		return;
+	}
+
+	alpha = fit->R + v[0]*f[0];
+	fit->d[0] *= fit->R / alpha;
+	K[0] = v[0];
+	for(uint8_t j = 1 ; j < N ; j++){
+		float lambda;
+
+		beta = alpha;
+		alpha += v[j]*f[j];
+		lambda = -f[j] / beta;
+		fit->d[j] *= beta / alpha;
+		if(fit->d[j] < ELLIPSOID_FIT_D_MIN){
+			fit->d[j] = ELLIPSOID_FIT_D_MIN;
+		}
+		for(uint8_t i = 0 ; i < j ; i++){
+			float u = fit->U[U_IDX(i, j)];
+			fit->U[U_IDX(i, j)] = u + K[i]*lambda;
+			K[i] += v[j]*u;
+		}
+		K[j] = v[j];
+	}
+
+	err /= alpha;
+	for(uint8_t i = 0 ; i < N ; i++){
+		fit->V[i] += K[i]*err;
+	}
+	fit->n++;
+}
+
+/* Fit n samples at once by the normal equations, combined with what the
+ * fit already holds: (R*inv(P) + sum(D'*D)) * V = R*inv(P)*V + sum(D').
+ * Gives the same result as n calls of ellipsoid_fit_update and leaves P
+ * consistent, so updates can continue afterwards. Returns -1 if the
+ * samples do not determine an ellipsoid. */
+int ellipsoid_fit_batch(EllipsoidFit_Def* fit, const float (*val)[3], uint32_t n)
+{
+	float A[N][N], b[N], D[N];
+	uint32_t used = 0, k;
+
+	/* normalise by the first usable sample before P is inverted */
+	for(k = 0 ; k < n && _set_scale(fit, val[k]) ; k++);
+
+	/* information form of the current estimate */
+	_ud_to_p(fit, A);
+	if(_cholesky(A)){
+		return -1;
+	}
+	{
+		float L[N][N];
+
+		memcpy(L, A, sizeof(L));
+		_cholesky_inverse(L, fit->R, A);
+	}
+	for(uint8_t i = 0 ; i < N ; i++){
+		b[i] = 0.0f;
+		for(uint8_t j = 0 ; j < N ; j++){
+			b[i] += A[i][j]*fit->V[j];
+		}
+	}
+
+	for(k = 0 ; k < n ; k++){
+		if(_set_scale(fit, val[k])){
+			continue;
+		}
+		_regressor(fit, val[k], D);
+		if(!isfinite(D[0] + D[1] + D[2])){
+			continue;
+		}
+		for(uint8_t i = 0 ; i < N ; i++){
+			for(uint8_t j = i ; j < N ; j++){
+				A[i][j] += D[i]*D[j];
+			}
+			b[i] += D[i];
+		}
+		used++;
+	}
+	for(uint8_t i = 0 ; i < N ; i++){
+		for(uint8_t j = 0 ; j < i ; j++){
+			A[i][j] = A[j][i];
+		}
+	}
+
+	if(_cholesky(A)){
+		return -1;
+	}
+	_cholesky_solve(A, b, fit->V);
+	{
+		float P[N][N];
+
+		_cholesky_inverse(A, fit->R, P);
+		_p_to_ud(fit, P);
+	}
+	fit->n += used;
+
+	return 0;
+}
+
+/* ellipsoid parameters for the raw (not normalised) samples */
+void ellipsoid_fit_get(const EllipsoidFit_Def* fit, float V[ELLIPSOID_FIT_N])
+{
+	float s2 = fit->scale * fit->scale;
+
+	for(uint8_t i = 0 ; i < N ; i++){
+		V[i] = fit->V[i] * (i < 6 ? s2 : fit->scale);
+	}
+}
@@ -0,0 +1,61 @@
+/*
+ * File      : fast_math.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include "fast_math.h"
+
+#define FM_PI_2		1.57079632679f
+
+/* minimax of atan(z)/z over z in 0~1, as a polynomial of z^2 */
+#define ATAN_C0		9.999993356e-01f
+#define ATAN_C1		-3.332986083e-01f
+#define ATAN_C2		1.994656563e-01f
+#define ATAN_C3		-1.390862789e-01f
+#define ATAN_C4		9.642190613e-02f
+#define ATAN_C5		-5.591221283e-02f
+#define ATAN_C6		2.186286838e-02f
+#define ATAN_C7		-4.054540446e-03f
+
+/* minimax of (pi/2 - asin(x))/sqrt(1-x) over x in 0~1, with the constant
+ * held at pi/2 so that asin(0) is 0 */
+#define ASIN_C0		FM_PI_2
+#define ASIN_C1		-2.145960412e-01f
+#define ASIN_C2		8.888409586e-02f
+#define ASIN_C3		-4.939036974e-02f
+#define ASIN_C4		2.812913744e-02f
+#define ASIN_C5		-1.233149795e-02f
+#define ASIN_C6		2.723368392e-03f
+
+float fast_atan2f(float y, float x)
+{
+	float ax = fabsf(x);
+	float ay = fabsf(y);
+	float mx = ax > ay ? ax : ay;
+	float mn = ax > ay ? ay : ax;
+	/* 0/0 is kept away, atan2(0, 0) comes out 0 */
+	float z = mn / (mx > 0.0f ? mx : 1.0f);
+	float s = z * z;
+	float r = z * (ATAN_C0 + s*(ATAN_C1 + s*(ATAN_C2 + s*(ATAN_C3 + s*(ATAN_C4 + s*(ATAN_C5 + s*(ATAN_C6 + s*ATAN_C7)))))));
+
+	/* octant, quadrant and sign */
+	r = ay > ax ? FM_PI_2 - r : r;
+	r = signbit(x) ? 2.0f*FM_PI_2 - r : r;
+
+	return copysignf(r, y);
+}
+
+float fast_asinf(float x)
+{
+	float ax = fabsf(x);
+	float p = ASIN_C0 + ax*(ASIN_C1 + ax*(ASIN_C2 + ax*(ASIN_C3 + ax*(ASIN_C4 + ax*(ASIN_C5 + ax*ASIN_C6)))));
+	float t = 1.0f - ax;
+
+	/* out of -1~1 is taken as +-1, where libm gives NaN */
+	t = t > 0.0f ? t : 0.0f;
+
+	return copysignf(FM_PI_2 - sqrtf(t)*p, x);
+}
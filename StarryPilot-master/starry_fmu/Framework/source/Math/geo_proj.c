@@ -0,0 +1,65 @@
+/*
+ * File      : geo_proj.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <math.h>
+#include "geo_proj.h"
+
+#define GEO_DEG_E7_TO_RAD		(3.14159265358979323846 / 180.0 * 1e-7)
+#define GEO_LAT_MAX				900000000	/* 1e-7 degree */
+#define GEO_LON_MAX				1800000000
+
+void geo_proj_init(GeoProj_Def* proj, int32_t ref_lat, int32_t ref_lon)
+{
+	/* the only trigonometry, done once in double */
+	double lat_rad = (double)ref_lat * GEO_DEG_E7_TO_RAD;
+
+	proj->ref_lat = ref_lat;
+	proj->ref_lon = ref_lon;
+	proj->k_north = (float)(GEO_DEG_E7_TO_RAD * GEO_EARTH_RADIUS);
+	proj->k_east = (float)(GEO_DEG_E7_TO_RAD * GEO_EARTH_RADIUS * cos(lat_rad));
+	proj->k_tan = (float)(GEO_DEG_E7_TO_RAD * tan(lat_rad));
+	proj->k_conv = (float)(tan(lat_rad) / (2.0 * GEO_EARTH_RADIUS));
+	proj->init = 1;
+}
+
+/* project lat/lon (1e-7 degree) to north/east meters relative to the reference,
+ * return -1 and leave x/y alone if the projection has not been initialised
+ * or lat/lon is not a coordinate */
+int geo_proj_project(const GeoProj_Def* proj, int32_t lat, int32_t lon, float* x, float* y)
+{
+	int32_t d_lat;
+	int64_t d_lon;
+	float f_lat, east;
+
+	if(!proj->init){
+		return -1;
+	}
+	if(lat < -GEO_LAT_MAX || lat > GEO_LAT_MAX || lon < -GEO_LON_MAX || lon > GEO_LON_MAX){
+		return -1;
+	}
+
+	/* differences are exact in integer and small enough for float */
+	d_lat = lat - proj->ref_lat;
+	d_lon = (int64_t)lon - proj->ref_lon;
+	/* wrap across the antimeridian */
+	if(d_lon > 1800000000){
+		d_lon -= 3600000000LL;
+	}else if(d_lon < -1800000000){
+		d_lon += 3600000000LL;
+	}
+
+	/* second order expansion of the azimuthal equidistant projection:
+	 * north = R*d_lat + tan(ref_lat)/(2R) * east^2	(meridian convergence)
+	 * east  = R*cos(ref_lat)*d_lon * (1 - tan(ref_lat)*d_lat) */
+	f_lat = (float)d_lat;
+	east = (float)d_lon * proj->k_east;
+	*x = f_lat * proj->k_north + east * east * proj->k_conv;
+	*y = east * (1.0f - f_lat * proj->k_tan);
+
+	return 0;
+}
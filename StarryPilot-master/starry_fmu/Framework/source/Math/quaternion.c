@@ -10,10 +10,13 @@
 #include "quaternion.h"
 #include "ap_math.h"
 #include "global.h"
+#include "fast_math.h"
 
 void quaternion_normalize(quaternion * q)
 {
-    float norm_r = math_rsqrt(q->w*q->w + q->x*q->x + q->y*q->y + q->z*q->z);
+    float norm_sq = q->w*q->w + q->x*q->x + q->y*q->y + q->z*q->z;
+    /* a zero quaternion stays zero instead of going NaN */
+    float norm_r = norm_sq > 0.0f ? MATH_RSQRTF(norm_sq) : 0.0f;
     q->w *= norm_r;
     q->x *= norm_r;
     q->y *= norm_r;
@@ -138,23 +141,23 @@ void quaternion_fromTwoVectorRotation(quaternion * result,const float from[3],co
 //euler[3]: roll pitch yaw	unit:rad
 void quaternion_toEuler(const quaternion *q, Euler *e)
 {
-	double ysqr = q->y * q->y;
+	float ysqr = q->y * q->y;
 
 	// roll (x-axis rotation)
-	double t0 = +2.0f * (q->w * q->x + q->y * q->z);
-	double t1 = +1.0f - 2.0f * (q->x * q->x + ysqr);
-	e->roll = atan2f(t0, t1);
+	float t0 = +2.0f * (q->w * q->x + q->y * q->z);
+	float t1 = +1.0f - 2.0f * (q->x * q->x + ysqr);
+	e->roll = MATH_ATAN2F(t0, t1);
 
 	// pitch (y-axis rotation)
-	double t2 = +2.0f * (q->w * q->y - q->z * q->x);
+	float t2 = +2.0f * (q->w * q->y - q->z * q->x);
 	t2 = t2 > 1.0f ? 1.0f : t2;
 	t2 = t2 < -1.0f ? -1.0f : t2;
-	e->pitch = asinf(t2);
+	e->pitch = MATH_ASINF(t2);
 
 	// yaw (z-axis rotation)
-	double t3 = +2.0f * (q->w * q->z + q->x *q->y);
-	double t4 = +1.0f - 2.0f * (ysqr + q->z * q->z);  
-	e->yaw = atan2f(t3, t4);
+	float t3 = +2.0f * (q->w * q->z + q->x *q->y);
+	float t4 = +1.0f - 2.0f * (ysqr + q->z * q->z);  
+	e->yaw = MATH_ATAN2F(t3, t4);
 }
 
 //euler[3]: roll pitch yaw	 unit:rad
@@ -183,19 +186,19 @@ float quaternion_getEuler(const quaternion q, int index)
 {
 	if(index == 0){
 		// roll
-		double t0 = +2.0f * (q.w * q.x + q.y * q.z);
-		double t1 = +1.0f - 2.0f * (q.x * q.x + q.y*q.y);
-		return atan2(t0, t1);
+		float t0 = +2.0f * (q.w * q.x + q.y * q.z);
+		float t1 = +1.0f - 2.0f * (q.x * q.x + q.y*q.y);
+		return MATH_ATAN2F(t0, t1);
 	}else if(index == 1){
 		// pitch
-		double t2 = +2.0f * (q.w * q.y - q.z * q.x);
+		float t2 = +2.0f * (q.w * q.y - q.z * q.x);
 		t2 = t2 > 1.0f ? 1.0f : t2;
 		t2 = t2 < -1.0f ? -1.0f : t2;
-		return asin(t2);
+		return MATH_ASINF(t2);
 	}else{
 		// yaw
-		double t3 = +2.0f * (q.w * q.z + q.x *q.y);
-		double t4 = +1.0f - 2.0f * (q.y*q.y + q.z * q.z);  
-		return atan2(t3, t4);
+		float t3 = +2.0f * (q.w * q.z + q.x *q.y);
+		float t4 = +1.0f - 2.0f * (q.y*q.y + q.z * q.z);  
+		return MATH_ATAN2F(t3, t4);
 	}
 }
@@ -74,6 +74,8 @@ extern int mavlink_lowlevel_read(uint8_t* buff, uint16_t len);
 extern void mavproxy_lowlevel_init(void);
 extern int mavproxy_console_proc(int count);
 uint8_t mavproxy_temp_msg_push(mavlink_message_t *msg);
+uint8_t mavproxy_period_msg_register(uint8_t msgid, uint16_t period_ms, void (* msg_pack_cb)(mavlink_message_t *msg_t), uint8_t enable);
+uint8_t mavproxy_period_msg_set(void (* msg_pack_cb)(mavlink_message_t *msg_t), uint16_t period_ms, uint8_t enable);
 
 uint8_t mavlink_msg_transfer(uint8_t chan, uint8_t* msg_buff, uint16_t len)
 {
@@ -233,6 +235,38 @@ void mavproxy_msg_gps_raw_int_pack(mavlink_message_t *msg_t)
 	mavlink_msg_gps_raw_int_encode(mavlink_system.sysid, mavlink_system.compid, msg_t, &gps_raw_int);
 }
 
+/* one uMCN topic per message, in turn: publish rate (x), copy rate (y)
+ * and bytes per second (z) since the topic was last reported. The topic
+ * names do not fit the 10 chars of name, it holds "mcn<id>" with the id
+ * "mcn list" shows. */
+void mavproxy_msg_mcn_stat_pack(mavlink_message_t *msg_t)
+{
+	static McnHub* hub = NULL;
+	static uint16_t id = 0;
+	mavlink_debug_vect_t debug_vect;
+	McnRate rate;
+	
+	/* the first topic again after the last one */
+	hub = hub != NULL ? mcn_next_hub(hub) : NULL;
+	if(hub == NULL){
+		hub = mcn_next_hub(NULL);
+		id = 0;
+	}else{
+		id++;
+	}
+	
+	mcn_rate(hub, &hub->report, &rate);
+	mcn_mark(hub, &hub->report);
+	
+	debug_vect.time_usec = time_nowUs();
+	snprintf(debug_vect.name, sizeof(debug_vect.name), "mcn%u", (unsigned)id);
+	debug_vect.x = rate.pub_hz;
+	debug_vect.y = rate.copy_hz;
+	debug_vect.z = rate.byte_ps;
+	
+	mavlink_msg_debug_vect_encode(mavlink_system.sysid, mavlink_system.compid, msg_t, &debug_vect);
+}
+
 void mavproxy_msg_param_pack(mavlink_message_t *msg_t, param_info_t *param)
 {
 	mavlink_param_value_t param_value;
@@ -587,6 +621,27 @@ void mavproxy_rx_entry(void *param)
 int handle_mavproxy_shell_cmd(int argc, char** argv)
 {
 	if(argc > 1){
+		if(strcmp(argv[1], "mcn") == 0){
+			/* mavproxy mcn [period ms|stop], the topics are reported one per period */
+			if(argc > 2 && strcmp(argv[2], "stop") == 0){
+				mavproxy_period_msg_set(mavproxy_msg_mcn_stat_pack, 0, 0);
+				return 0;
+			}
+			int period = argc > 2 ? atoi(argv[2]) : 100;
+			if(period <= 0 || period > 0xFFFF){
+				Console.e(TAG, "invalid period:%s\n", argv[2]);
+				return 1;
+			}
+			if(mcn_next_hub(NULL) == NULL){
+				Console.e(TAG, "no mcn topic advertised\n");
+				return 1;
+			}
+			/* a second call changes the period of the running stream */
+			if(!mavproxy_period_msg_set(mavproxy_msg_mcn_stat_pack, period, 1)){
+				if(!mavproxy_period_msg_register(MAVLINK_MSG_ID_DEBUG_VECT, period, mavproxy_msg_mcn_stat_pack, 1))
+					return 1;
+			}
+		}
 		if(strcmp(argv[1], "send") == 0){
 			if(argc < 3 )
 				return 1;
@@ -628,6 +683,23 @@ uint8_t mavproxy_period_msg_register(uint8_t msgid, uint16_t period_ms, void (*
 	}
 }
 
+/* change a registered msg, found by its pack callback, a period of 0 keeps the old one */
+uint8_t mavproxy_period_msg_set(void (* msg_pack_cb)(mavlink_message_t *msg_t), uint16_t period_ms, uint8_t enable)
+{
+	for(uint16_t i = 0 ; i < _period_msg_queue.size ; i++){
+		MAV_PeriodMsg *msg_t = &_period_msg_queue.queue[i];
+		
+		if(msg_t->msg_pack_cb == msg_pack_cb){
+			if(period_ms)
+				msg_t->period = period_ms;
+			msg_t->enable = enable;
+			return 1;
+		}
+	}
+	
+	return 0;
+}
+
 uint8_t mavproxy_temp_msg_push(mavlink_message_t *msg)
 {
 	if(_mav_disable)
@@ -19,6 +19,7 @@
 
 #define PARAM_FILE_NAME				"/sys/param.xml"
 #define YXML_STACK_SIZE				1024
+#define PARAM_READ_CHUNK			64
 
 //PARAM_Def global_param;
 //PARAM_Def* global_param_t = &global_param;
@@ -151,13 +152,46 @@ PARAM_GROUP(HIL_SIM) PARAM_DECLARE_GROUP(HIL_SIM) = \
 	PARAM_DEFINE_UINT32(HIL_CONTROL_PRD, 4),  /* CONTROL PERIOD */
 };
 
+PARAM_GROUP(MIXER) PARAM_DECLARE_GROUP(MIXER) = \
+{ \
+	PARAM_DEFINE_INT32(MIX_SOURCE, 0),		/* 0: built-in geometry of the frame type	1: the MIX_Mn rows */
+	PARAM_DEFINE_INT32(MIX_DESAT, 1),		/* 0: clip	1: yaw gives way first	2: airmode */
+	PARAM_DEFINE_UINT32(MIX_MOTOR_NUM, 4),	/* rows used with MIX_SOURCE 1 */
+	/* the X frame */
+	PARAM_DEFINE_FLOAT(MIX_M1_ROLL, -1.0),
+	PARAM_DEFINE_FLOAT(MIX_M1_PITCH, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M1_YAW, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M1_THRUST, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M2_ROLL, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M2_PITCH, -1.0),
+	PARAM_DEFINE_FLOAT(MIX_M2_YAW, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M2_THRUST, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M3_ROLL, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M3_PITCH, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M3_YAW, -1.0),
+	PARAM_DEFINE_FLOAT(MIX_M3_THRUST, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M4_ROLL, -1.0),
+	PARAM_DEFINE_FLOAT(MIX_M4_PITCH, -1.0),
+	PARAM_DEFINE_FLOAT(MIX_M4_YAW, -1.0),
+	PARAM_DEFINE_FLOAT(MIX_M4_THRUST, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M5_ROLL, 0.0),
+	PARAM_DEFINE_FLOAT(MIX_M5_PITCH, 0.0),
+	PARAM_DEFINE_FLOAT(MIX_M5_YAW, 0.0),
+	PARAM_DEFINE_FLOAT(MIX_M5_THRUST, 1.0),
+	PARAM_DEFINE_FLOAT(MIX_M6_ROLL, 0.0),
+	PARAM_DEFINE_FLOAT(MIX_M6_PITCH, 0.0),
+	PARAM_DEFINE_FLOAT(MIX_M6_YAW, 0.0),
+	PARAM_DEFINE_FLOAT(MIX_M6_THRUST, 1.0),
+};
+
 /* step 4: Define param list */
-param_list_t param_list = { \
+VEHICLE_STATE param_list_t param_list = { \
 	PARAM_DEFINE_GROUP(CALIBRATION),
 	PARAM_DEFINE_GROUP(ATT_CONTROLLER),
 	PARAM_DEFINE_GROUP(ALT_CONTROLLER),
 	PARAM_DEFINE_GROUP(ADRC_ATT),
 	PARAM_DEFINE_GROUP(HIL_SIM),
+	PARAM_DEFINE_GROUP(MIXER),
 };
 /* Define Parameter End */
 
@@ -402,10 +436,10 @@ int param_set(char* group_name, char* param_name, char* val)
 
 int param_parse_state_machine(yxml_t *x, yxml_ret_t r, PARAM_PARSE_STATE* status)
 {
-	static char attr_cnt = 0;
-	static char group_name[30];
-	static char param_name[30];
-	static char content[20];
+	static VEHICLE_STATE char attr_cnt = 0;
+	static VEHICLE_STATE char group_name[30];
+	static VEHICLE_STATE char param_name[30];
+	static VEHICLE_STATE char content[20];
 	
 	switch(*status)
 	{
@@ -588,7 +622,7 @@ void param_load(void)
 	FIL fp;
 	UINT br;
 	yxml_ret_t yxml_r;
-	char c;
+	char buf[PARAM_READ_CHUNK];
 	FRESULT res = f_open(&fp, PARAM_FILE_NAME, FA_OPEN_EXISTING | FA_READ);
 	
 	PARAM_PARSE_STATE status = PARAM_PARSE_START;
@@ -599,13 +633,16 @@ void param_load(void)
 			yxml_t yxml_handle;
 			yxml_init(&yxml_handle, yxml_stack, YXML_STACK_SIZE);
 			while(!f_eof(&fp)){
+				/* a byte per f_read locked the scheduler once per byte */
 				OS_ENTER_CRITICAL;
-				res = f_read(&fp, &c, 1, &br);
+				res = f_read(&fp, buf, sizeof(buf), &br);
 				OS_EXIT_CRITICAL;
 				
-				if(res == FR_OK && br == 1){
-					yxml_r = yxml_parse(&yxml_handle, c);
-					param_parse_state_machine(&yxml_handle, yxml_r, &status);
+				if(res == FR_OK && br > 0){
+					for(UINT i = 0 ; i < br ; i++){
+						yxml_r = yxml_parse(&yxml_handle, buf[i]);
+						param_parse_state_machine(&yxml_handle, yxml_r, &status);
+					}
 				}
 				else{
 					Console.e(TAG, "xml file read err\n");
@@ -676,6 +713,44 @@ int handle_param_shell_cmd(int argc, char** argv)
 	return 0;
 }
 
+#ifdef MULTI_VEHICLE
+/* param_list is per vehicle, the groups it points to are not */
+static VEHICLE_STATE param_info_t* _shared_content[sizeof(param_list_t)/sizeof(param_group_info)];
+
+uint8_t param_vehicle_init(void)
+{
+	param_group_info* gp = (param_group_info*)&param_list;
+	for(int j = 0 ; j < sizeof(param_list)/sizeof(param_group_info) ; j++) {
+		uint32_t size = gp->param_num*sizeof(param_info_t);
+		param_info_t* content = (param_info_t*)rt_malloc(size);
+		if(content == NULL){
+			Console.e(TAG, "no memory for group %s\n", gp->name);
+			param_vehicle_release();
+			return 1;
+		}
+		memcpy(content, gp->content, size);
+		_shared_content[j] = gp->content;
+		gp->content = content;
+		gp++;
+	}
+	
+	return 0;
+}
+
+void param_vehicle_release(void)
+{
+	param_group_info* gp = (param_group_info*)&param_list;
+	for(int j = 0 ; j < sizeof(param_list)/sizeof(param_group_info) ; j++) {
+		if(_shared_content[j]){
+			rt_free(gp->content);
+			gp->content = _shared_content[j];
+			_shared_content[j] = NULL;
+		}
+		gp++;
+	}
+}
+#endif
+
 uint8_t param_init(void)
 {
 	//_param_user_cnt = 0;
@@ -30,10 +30,10 @@ typedef enum
 }RC_SIGNAL;
 
 static char* TAG = "RC";
-static float _chan_val[CHAN_NUM];
-static bool _rc_connect = false;
-static uint32_t _time_last_receive = 0;
-RC_STATUS _rc_status = RC_LOCK_STATUS;
+static VEHICLE_STATE float _chan_val[CHAN_NUM];
+static VEHICLE_STATE bool _rc_connect = false;
+static VEHICLE_STATE uint32_t _time_last_receive = 0;
+VEHICLE_STATE RC_STATUS _rc_status = RC_LOCK_STATUS;
 
 MCN_DEFINE(RC_STATUS, sizeof(RC_STATUS));	
 
@@ -0,0 +1,131 @@
+/*
+ * File      : sitl_interface.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include <math.h>
+#include "global.h"
+#include "console.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "motor.h"
+#include "gps.h"
+#include "mavproxy.h"
+#include "sitl_interface.h"
+
+static VEHICLE_STATE SITL_Model_Def _model;
+static VEHICLE_STATE uint32_t _gps_cnt;
+static VEHICLE_STATE uint8_t _sitl_init = 0;
+
+static char* TAG = "SITL";
+
+MCN_DECLARE(MOTOR_THROTTLE);
+MCN_DECLARE(HIL_SENSOR);
+MCN_DECLARE(GPS_POSITION);
+
+static void _publish_sensor(void)
+{
+	mavlink_hil_sensor_t hil_sensor;
+	float gyr[3], acc[3], mag[3];
+	float alt, pressure, temperature;
+
+	sitl_model_imu(&_model, gyr, acc, mag);
+	/* the mavlink struct is packed, its floats can not be written through a pointer */
+	sitl_model_baro(&_model, &alt, &pressure, &temperature);
+
+	memset(&hil_sensor, 0, sizeof(hil_sensor));
+	hil_sensor.time_usec = _model.time_us;
+	hil_sensor.xacc = acc[0];
+	hil_sensor.yacc = acc[1];
+	hil_sensor.zacc = acc[2];
+	hil_sensor.xgyro = gyr[0];
+	hil_sensor.ygyro = gyr[1];
+	hil_sensor.zgyro = gyr[2];
+	hil_sensor.xmag = mag[0];
+	hil_sensor.ymag = mag[1];
+	hil_sensor.zmag = mag[2];
+	hil_sensor.pressure_alt = alt;
+	hil_sensor.abs_pressure = pressure;
+	hil_sensor.temperature = temperature;
+	/* all but diff_pressure */
+	hil_sensor.fields_updated = 0x1BFF;
+
+	mcn_publish(MCN_ID(HIL_SENSOR), &hil_sensor);
+}
+
+/* the same fields mavproxy fills from HIL_GPS */
+static void _publish_gps(void)
+{
+	struct vehicle_gps_position_s gps_position;
+	SITL_GPS_Def gps;
+
+	sitl_model_gps(&_model, 1e-3f*SITL_GPS_PERIOD, &gps);
+
+	memset(&gps_position, 0, sizeof(gps_position));
+	gps_position.lat = gps.lat;
+	gps_position.lon = gps.lon;
+	gps_position.alt = gps.alt;
+	gps_position.eph = gps.eph;
+	gps_position.epv = gps.eph;
+	gps_position.vel_m_s = sqrtf(gps.vel[0]*gps.vel[0] + gps.vel[1]*gps.vel[1]);
+	gps_position.vel_n_m_s = gps.vel[0];
+	gps_position.vel_e_m_s = gps.vel[1];
+	gps_position.vel_d_m_s = gps.vel[2];
+	gps_position.vel_ned_valid = 1;
+	gps_position.fix_type = 3;
+	gps_position.satellites_used = gps.satellites;
+	gps_position.timestamp_position = gps_position.timestamp_velocity = time_nowMs();
+
+	mcn_publish(MCN_ID(GPS_POSITION), &gps_position);
+}
+
+void sitl_interface_step(void)
+{
+	float throttle[MOTOR_NUM];
+
+	if(!_sitl_init){
+		return;
+	}
+
+	if(mcn_copy_from_hub(MCN_ID(MOTOR_THROTTLE), throttle)){
+		memset(throttle, 0, sizeof(throttle));
+	}
+	sitl_model_step(&_model, throttle, 1e-3f*SITL_STEP_MS);
+
+	_publish_sensor();
+	if(++_gps_cnt >= SITL_GPS_PERIOD/SITL_STEP_MS){
+		_gps_cnt = 0;
+		_publish_gps();
+	}
+}
+
+SITL_Model_Def* sitl_interface_get_model(void)
+{
+	return &_model;
+}
+
+int sitl_interface_init(const SITL_Param_Def* param, FrameType frame, uint32_t seed)
+{
+	SITL_Param_Def default_param;
+
+	if(sitl_model_motor_num(frame) > MOTOR_NUM){
+		Console.e(TAG, "frame type:%d needs %d motors, MOTOR_NUM is %d\n", frame, sitl_model_motor_num(frame), MOTOR_NUM);
+		return 1;
+	}
+	if(param == NULL){
+		sitl_model_default_param(&default_param);
+		param = &default_param;
+	}
+	if(sitl_model_init(&_model, param, frame, seed)){
+		Console.e(TAG, "err, unknow frame type:%d\n", frame);
+		return 1;
+	}
+	_gps_cnt = 0;
+	_sitl_init = 1;
+
+	return 0;
+}
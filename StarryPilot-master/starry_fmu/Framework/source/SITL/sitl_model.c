@@ -0,0 +1,275 @@
+/*
+ * File      : sitl_model.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <math.h>
+#include <string.h>
+#include "global.h"
+#include "ap_math.h"
+#include "geo_proj.h"
+#include "sitl_model.h"
+#include "mixer.h"
+
+/* xorshift64*, the same sequence on every target */
+static uint64_t _rand_u64(SITL_Model_Def* model)
+{
+	model->rng ^= model->rng >> 12;
+	model->rng ^= model->rng << 25;
+	model->rng ^= model->rng >> 27;
+	return model->rng * 0x2545F4914F6CDD1DULL;
+}
+
+/* uniform in (0, 1] */
+static float _rand_uniform(SITL_Model_Def* model)
+{
+	return (float)((_rand_u64(model) >> 40) + 1) * (1.0f / 16777216.0f);
+}
+
+/* standard normal, Box-Muller */
+static float _rand_gauss(SITL_Model_Def* model)
+{
+	float u1 = _rand_uniform(model);
+	float u2 = _rand_uniform(model);
+
+	return sqrtf(-2.0f*logf(u1)) * cosf(2.0f*PI*u2);
+}
+
+static float _thrust_curve(const SITL_Param_Def* param, float s)
+{
+	return param->thrust_expo*s*s + (1.0f - param->thrust_expo)*s;
+}
+
+/* att = att * exp(rate*dt), body rates */
+static void _att_integrate(quaternion* att, const float rate[3], float dt)
+{
+	float w = sqrtf(rate[0]*rate[0] + rate[1]*rate[1] + rate[2]*rate[2]);
+	float half = 0.5f*w*dt;
+	float s = (w > 1e-9f) ? sinf(half)/w : 0.5f*dt;
+	quaternion d = {cosf(half), rate[0]*s, rate[1]*s, rate[2]*s};
+	quaternion q = *att;
+
+	att->w = q.w*d.w - q.x*d.x - q.y*d.y - q.z*d.z;
+	att->x = q.w*d.x + q.x*d.w + q.y*d.z - q.z*d.y;
+	att->y = q.w*d.y - q.x*d.z + q.y*d.w + q.z*d.x;
+	att->z = q.w*d.z + q.x*d.y - q.y*d.x + q.z*d.w;
+	quaternion_normalize(att);
+}
+
+void sitl_model_default_param(SITL_Param_Def* param)
+{
+	memset(param, 0, sizeof(SITL_Param_Def));
+
+	/* a 450 class quadrotor */
+	param->mass = 1.5f;
+	param->inertia[0] = 0.029f;
+	param->inertia[1] = 0.029f;
+	param->inertia[2] = 0.055f;
+	param->arm_length = 0.225f;
+	param->hover_throttle = 0.5f;
+	param->thrust_expo = 0.5f;
+	param->motor_tau = 0.02f;
+	param->yaw_moment = 0.016f;
+	param->drag = 0.05f;
+	param->rot_drag = 0.002f;
+
+	param->gyr_noise = 0.01f;
+	param->acc_noise = 0.1f;
+	param->mag_noise = 0.005f;
+	param->mag_strength = 0.5f;
+	param->mag_decl = 0.0f;
+	param->mag_incl = 60.0f;
+	param->baro_noise = 0.1f;
+	param->gps_noise = 0.5f;
+	param->gps_tau = 60.0f;
+	param->gps_vel_noise = 0.05f;
+	param->gps_eph = 1.0f;
+	param->gps_sats = 10;
+
+	/* the location the HIL logs were taken at */
+	param->home_lat = 47.366730;
+	param->home_lon = 8.550084;
+	param->home_alt = 488.0f;
+}
+
+uint8_t sitl_model_motor_num(FrameType frame)
+{
+	return mixer_frame_motor_num(frame);
+}
+
+int sitl_model_init(SITL_Model_Def* model, const SITL_Param_Def* param, FrameType frame, uint32_t seed)
+{
+	const float (*mix)[MIXER_AXIS_NUM] = mixer_frame_geometry(frame);
+	float decl, incl;
+
+	if(mix == NULL)
+		return -1;
+
+	memset(model, 0, sizeof(SITL_Model_Def));
+	model->param = *param;
+	model->motor_num = sitl_model_motor_num(frame);
+
+	/* A motor whose throttle the mixer raises for a positive roll command
+	 * sits on the left (-y), for a positive pitch command at the front (+x),
+	 * for a positive yaw command it spins so its reaction torque is along +z. */
+	for(uint8_t i = 0 ; i < model->motor_num ; i++){
+		float r = sqrtf(mix[i][0]*mix[i][0] + mix[i][1]*mix[i][1]);
+
+		model->motor_pos[i][0] = param->arm_length * mix[i][1] / r;
+		model->motor_pos[i][1] = -param->arm_length * mix[i][0] / r;
+		model->motor_yaw[i] = mix[i][2] > 0.0f ? 1.0f : -1.0f;
+	}
+	model->max_thrust = param->mass * GRAVITY_MSS
+						/ (model->motor_num * _thrust_curve(param, param->hover_throttle));
+
+	decl = Deg2Rad(param->mag_decl);
+	incl = Deg2Rad(param->mag_incl);
+	model->mag_ned[0] = param->mag_strength * cosf(incl) * cosf(decl);
+	model->mag_ned[1] = param->mag_strength * cosf(incl) * sinf(decl);
+	model->mag_ned[2] = param->mag_strength * sinf(incl);
+
+	quaternion_load_init_attitude(&model->state.att);
+	model->state.on_ground = 1;
+
+	/* xorshift needs a non zero state */
+	model->rng = ((uint64_t)seed << 32) ^ 0x9E3779B97F4A7C15ULL;
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		model->gps_err[i] = param->gps_noise * _rand_gauss(model);
+	}
+
+	return 0;
+}
+
+void sitl_model_step(SITL_Model_Def* model, const float* throttle, float dt)
+{
+	const SITL_Param_Def* param = &model->param;
+	SITL_State_Def* s = &model->state;
+	float alpha = dt / (param->motor_tau + dt);
+	float thrust = 0.0f;
+	float torque[3] = {0.0f, 0.0f, 0.0f};
+	float f_body[3], f_ned[3], ang_acc[3], air[3];
+	float speed;
+
+	for(uint8_t i = 0 ; i < model->motor_num ; i++){
+		float u = constrain_float(throttle[i], 0.0f, 1.0f);
+		float t;
+
+		s->motor[i] += (u - s->motor[i]) * alpha;
+		t = model->max_thrust * _thrust_curve(param, s->motor[i]);
+
+		thrust += t;
+		/* thrust is along -z: torque = r x (0, 0, -t) */
+		torque[0] -= model->motor_pos[i][1] * t;
+		torque[1] += model->motor_pos[i][0] * t;
+		torque[2] += model->motor_yaw[i] * param->yaw_moment * t;
+	}
+
+	/* rotation: I*dw = torque - w x (I*w) - damping */
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		torque[i] += model->ext_torque[i] - param->rot_drag * s->rate[i];
+	}
+	ang_acc[0] = (torque[0] - (param->inertia[2] - param->inertia[1]) * s->rate[1] * s->rate[2]) / param->inertia[0];
+	ang_acc[1] = (torque[1] - (param->inertia[0] - param->inertia[2]) * s->rate[2] * s->rate[0]) / param->inertia[1];
+	ang_acc[2] = (torque[2] - (param->inertia[1] - param->inertia[0]) * s->rate[0] * s->rate[1]) / param->inertia[2];
+
+	/* translation */
+	f_body[0] = f_body[1] = 0.0f;
+	f_body[2] = -thrust;
+	quaternion_rotateVector(&s->att, f_body, f_ned);
+	/* drag on the velocity through the air */
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		air[i] = s->vel[i] - model->wind[i];
+	}
+	speed = sqrtf(air[0]*air[0] + air[1]*air[1] + air[2]*air[2]);
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		s->acc[i] = (f_ned[i] - param->drag * speed * air[i]) / param->mass;
+	}
+	s->acc[2] += GRAVITY_MSS;
+
+	/* semi-implicit Euler */
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		s->rate[i] += ang_acc[i] * dt;
+		s->vel[i] += s->acc[i] * dt;
+		s->pos[i] += s->vel[i] * dt;
+	}
+	_att_integrate(&s->att, s->rate, dt);
+
+	/* ground at home altitude: the vehicle rests level on its legs until
+	 * the thrust lifts it */
+	s->on_ground = 0;
+	if(s->pos[2] >= 0.0f && s->vel[2] >= 0.0f){
+		float yaw = quaternion_getEuler(s->att, 2);
+		Euler e = {0.0f, 0.0f, yaw};
+
+		quaternion_fromEuler(e, &s->att);
+		memset(s->vel, 0, sizeof(s->vel));
+		memset(s->acc, 0, sizeof(s->acc));
+		memset(s->rate, 0, sizeof(s->rate));
+		s->pos[2] = 0.0f;
+		s->on_ground = 1;
+	}
+
+	model->time_us += (uint64_t)(dt * 1e6f + 0.5f);
+}
+
+void sitl_model_imu(SITL_Model_Def* model, float gyr[3], float acc[3], float mag[3])
+{
+	const SITL_Param_Def* param = &model->param;
+	SITL_State_Def* s = &model->state;
+	float f_ned[3];
+
+	/* specific force, what the accelerometer senses */
+	f_ned[0] = s->acc[0];
+	f_ned[1] = s->acc[1];
+	f_ned[2] = s->acc[2] - GRAVITY_MSS;
+	quaternion_inv_rotateVector(&s->att, f_ned, acc);
+	quaternion_inv_rotateVector(&s->att, model->mag_ned, mag);
+
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		gyr[i] = s->rate[i] + param->gyr_bias[i] + param->gyr_noise * _rand_gauss(model);
+		acc[i] += param->acc_bias[i] + param->acc_noise * _rand_gauss(model);
+		mag[i] += param->mag_noise * _rand_gauss(model);
+	}
+}
+
+void sitl_model_baro(SITL_Model_Def* model, float* alt, float* pressure, float* temperature)
+{
+	float h = model->param.home_alt - model->state.pos[2];
+
+	/* standard atmosphere below 11km */
+	*temperature = 15.0f - 0.0065f * h;
+	*pressure = 1013.25f * powf(1.0f - 2.25577e-5f * h, 5.25588f);
+	*alt = h + model->param.baro_noise * _rand_gauss(model);
+}
+
+/* dt is the time since the last fix, the position error is a first order
+ * Gauss-Markov process so consecutive fixes wander like a real receiver */
+void sitl_model_gps(SITL_Model_Def* model, float dt, SITL_GPS_Def* gps)
+{
+	const SITL_Param_Def* param = &model->param;
+	SITL_State_Def* s = &model->state;
+	float a = expf(-dt / param->gps_tau);
+	float w = param->gps_noise * sqrtf(1.0f - a*a);
+	double north, east, lat;
+
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		model->gps_err[i] = a * model->gps_err[i] + w * _rand_gauss(model);
+	}
+
+	/* the sphere of geo_proj, so the projection at home gives pos back */
+	north = s->pos[0] + model->gps_err[0];
+	east = s->pos[1] + model->gps_err[1];
+	lat = param->home_lat + north / GEO_EARTH_RADIUS * (180.0 / PI);
+	gps->lat = (int32_t)lround(lat * 1e7);
+	gps->lon = (int32_t)lround((param->home_lon + east / (GEO_EARTH_RADIUS * cos(lat * PI / 180.0)) * (180.0 / PI)) * 1e7);
+	gps->alt = (int32_t)lroundf((param->home_alt - s->pos[2] - model->gps_err[2]) * 1e3f);
+
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		gps->vel[i] = s->vel[i] + param->gps_vel_noise * _rand_gauss(model);
+	}
+	gps->eph = param->gps_eph;
+	gps->satellites = param->gps_sats;
+}
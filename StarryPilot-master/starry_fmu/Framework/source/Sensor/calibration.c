@@ -171,18 +171,7 @@ void gyr_mavlink_calibration_start(void)
 
 void cali_obj_init(Cali_Obj *obj)
 {
-	for(int i = 0 ; i < 9 ; i++){
-		obj->V[i] = 0.0f;
-		obj->D[i] = 0.0f;
-		for(int j = 0 ; j < 9 ; j++){
-			obj->P[i][j] = 0.0f;
-		}
-	}
-	
-	obj->P[0][0] = obj->P[1][1] = obj->P[2][2] = 10.0f;
-	obj->P[3][3] = obj->P[4][4] = obj->P[5][5] = 1.0f;
-	obj->P[6][6] = obj->P[7][7] = obj->P[8][8] = 1.0f;
-	obj->R = 0.001f;
+	ellipsoid_fit_init(&obj->fit);
 	
 	MatCreate(&obj->EigVec, 3, 3);
 	MatCreate(&obj->RotM, 3, 3);
@@ -196,77 +185,7 @@ void cali_obj_delete(Cali_Obj *obj)
 
 void cali_least_squre_update(Cali_Obj *obj, float val[3])
 {
-	double x = val[0];
-	double y = val[1];
-	double z = val[2];
-	
-	obj->D[0] = x*x;
-	obj->D[1] = y*y;
-	obj->D[2] = z*z;
-	obj->D[3] = 2.0f*x*y;
-	obj->D[4] = 2.0f*x*z;
-	obj->D[5] = 2.0f*y*z;
-	obj->D[6] = 2.0f*x;
-	obj->D[7] = 2.0f*y;
-	obj->D[8] = 2.0f*z;
-	
-	// Y = Z-D*V
-	float DV = 0.0f;
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		DV += obj->D[i]*obj->V[i];
-	}
-	float Y = 1.0f - DV;
-	
-	// S = D*P*D' + R
-	double DP[9];
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		DP[i] = 0.0f;
-		for(uint8_t j = 0 ; j < 9 ; j++){
-			DP[i] += obj->D[j]*obj->P[j][i];
-		}
-	}
-	double DPDT = 0.0f;
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		DPDT += DP[i] * obj->D[i];
-	}
-	double S = DPDT + obj->R;
-	
-	// K = P*D'/S
-	double K[9];
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		K[i] = 0.0f;
-		for(uint8_t j = 0 ; j < 9 ; j++){
-			K[i] += obj->P[i][j] * obj->D[j];
-		}
-		K[i] = K[i]/S;
-	}
-	
-	// V = V + K*Y
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		obj->V[i] += K[i]*Y;
-	}
-	
-	// P = P - K*D*P
-	double KD[9][9];
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		for(uint8_t j = 0 ; j < 9 ; j++){
-			KD[i][j] = K[i] * obj->D[j];
-		}
-	}
-	double KDP[9][9];
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		for(uint8_t j = 0 ; j < 9 ; j++){
-			KDP[i][j] = 0.0f;
-			for(uint8_t k = 0 ; k < 9 ; k++){
-				KDP[i][j] += KD[i][k] * obj->P[j][k];
-			}
-		}
-	}	
-	for(uint8_t i = 0 ; i < 9 ; i++){
-		for(uint8_t j = 0 ; j < 9 ; j++){
-			obj->P[i][j] -= KDP[i][j];
-		}
-	}	
+	ellipsoid_fit_update(&obj->fit, val);
 }
 
 void cali_solve(Cali_Obj *obj, double radius)
@@ -291,24 +210,27 @@ void cali_solve(Cali_Obj *obj, double radius)
 	MatCreate(&GMat, 3, 3);
 	MatCreate(&InvEigVec, 3, 3);
 	
+	float V[ELLIPSOID_FIT_N];
+	ellipsoid_fit_get(&obj->fit, V);
+	
 	LIGHT_MATRIX_TYPE valA[16] = {
-		obj->V[0], obj->V[3], obj->V[4], obj->V[6],
-		obj->V[3], obj->V[1], obj->V[5], obj->V[7],
-		obj->V[4], obj->V[5], obj->V[2], obj->V[8],
-		obj->V[6], obj->V[7], obj->V[8],    -1
+		V[0], V[3], V[4], V[6],
+		V[3], V[1], V[5], V[7],
+		V[4], V[5], V[2], V[8],
+		V[6], V[7], V[8],    -1
 	};
 	MatSetVal(&A, valA);
 	
 	LIGHT_MATRIX_TYPE valB[9] = {
-		obj->V[0], obj->V[3], obj->V[4],
-		obj->V[3], obj->V[1], obj->V[5],
-		obj->V[4], obj->V[5], obj->V[2],
+		V[0], V[3], V[4],
+		V[3], V[1], V[5],
+		V[4], V[5], V[2],
 	};
 	MatSetVal(&B, valB);
 	
 	MatInv(&B, &InvB);
 	
-	LIGHT_MATRIX_TYPE v1[3] = {obj->V[6], obj->V[7], obj->V[8]};
+	LIGHT_MATRIX_TYPE v1[3] = {V[6], V[7], V[8]};
 	for(uint8_t i = 0 ; i < 3 ; i++){
 		obj->OFS[i] = 0.0f;
 		for(uint8_t j = 0 ; j < 3 ; j++){
@@ -0,0 +1,39 @@
+/*
+ * File      : gps_status.c
+ *
+ * The gps availability check shared by sensor_collect(), the HIL sensor
+ * path and the host replay, so they all judge a report the same way.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include "global.h"
+#include "gps.h"
+#include "sensor_manager.h"
+
+#define GPS_FIX_CNT_AVAILABLE		10
+
+/* returns true when the status changed and should be published */
+bool gps_status_update(GPS_Status* gps_sta, const struct vehicle_gps_position_s* gps_report)
+{
+	if(gps_sta->status!=GPS_AVAILABLE && gps_report->satellites_used>=6 && IN_RANGE(gps_report->eph, 0.0f, 2.5f)){
+		
+		gps_sta->fix_cnt++;
+		
+		if(gps_sta->fix_cnt >= GPS_FIX_CNT_AVAILABLE){
+			// gps becomes available
+			gps_sta->status = GPS_AVAILABLE;
+			return true;
+		}
+	}
+	if(gps_sta->status!=GPS_INAVAILABLE && (gps_report->satellites_used<=4 || gps_report->eph>3.5f)){
+		
+		gps_sta->status = GPS_INAVAILABLE;
+		gps_sta->fix_cnt = 0;
+		return true;
+	}
+	
+	return false;
+}
@@ -31,6 +31,8 @@
 #include "att_estimator.h"
 #include "pos_estimator.h"
 #include "calibration.h"
+#include "copter_main.h"
+#include "imu_integrator.h"
 
 #define ADDR_CMD_CONVERT_D1			0x48	/* write to this address to start pressure conversion */
 #define ADDR_CMD_CONVERT_D2			0x58	/* write to this address to start temperature conversion */
@@ -74,6 +76,7 @@ static uint32_t _baro_last_time = 0;
 static BaroPosition _baro_pos = {0.0f, 0.0f, 0.0f};
 static GPS_Driv_Vel _gps_driv_vel;
 static bool _gps_connected = false;
+static VEHICLE_STATE IMU_Integrator _imu_integrator;
 
 MCN_DEFINE(SENSOR_MEASURE_GYR, 12);	
 MCN_DEFINE(SENSOR_MEASURE_ACC, 12);
@@ -89,6 +92,7 @@ MCN_DEFINE(SENSOR_LIDAR, sizeof(float));
 MCN_DEFINE(CORRECT_LIDAR, sizeof(float));
 MCN_DEFINE(BARO_POSITION, sizeof(BaroPosition));
 MCN_DEFINE(GPS_STATUS, sizeof(GPS_Status));
+MCN_DEFINE(SENSOR_IMU_DELTA, sizeof(IMU_Delta));
 
 MCN_DECLARE(GPS_POSITION);
 
@@ -554,7 +558,7 @@ void gps_calc_geometry_distance(Vector3f_t* dis, double ref_lat, double ref_lon,
 	double delta_lon = Deg2Rad(lon - ref_lon);
 	
 	dis->x = (float)(delta_lat * EARTH_RADIUS);
-	dis->y = (float)(delta_lon * EARTH_RADIUS * arm_cos_f32(lat));
+	dis->y = (float)(delta_lon * EARTH_RADIUS * arm_cos_f32(Deg2Rad(lat)));
 }
 
 void gps_calc_geometry_distance2(Vector3f_t* dis, double ref_lat, double ref_lon, double lat, double lon)
@@ -597,9 +601,11 @@ int gps_get_position(Vector3f_t* gps_pos, struct vehicle_gps_position_s gps_repo
 		return -1;
 	}
 
-	//gps_calc_geometry_distance2(gps_pos, home.lat, home.lon, (double)gps_report.lat*1e-7, (double)gps_report.lon*1e-7);
-	gps_calc_geometry_distance(gps_pos, home.lat, home.lon, (double)gps_report.lat*1e-7, (double)gps_report.lon*1e-7);
-	gps_pos->z = (float)gps_report.alt*1e-3;
+	if(geo_proj_project(&home.proj, gps_report.lat, gps_report.lon, &gps_pos->x, &gps_pos->y) != 0){
+		// no projection or not a coordinate
+		return -1;
+	}
+	gps_pos->z = (float)gps_report.alt*1e-3f;
 	
 	return 0;
 }
@@ -626,6 +632,45 @@ void gps_get_status(GPS_Status* gps_sta)
 	mcn_copy_from_hub(MCN_ID(GPS_STATUS), gps_sta);
 }
 
+/**************************	IMU DELTA API **************************/
+void sensor_imu_delta_set_interval(uint32_t interval_ms)
+{
+	if(_imu_integrator.interval_us != interval_ms*1000)
+		imu_integrator_reset(&_imu_integrator, interval_ms);
+}
+
+/* integrate a gyr and acc sample, publish SENSOR_IMU_DELTA once the interval
+ * is full; the samples after it are added until the estimator takes the delta */
+void sensor_imu_delta_update(const float gyr[3], const float acc[3])
+{
+	IMU_Delta imu_delta;
+	bool full;
+	
+	OS_ENTER_CRITICAL;
+	full = imu_integrator_input(&_imu_integrator, gyr, acc, time_nowUs());
+	if(full)
+		imu_integrator_peek(&_imu_integrator, &imu_delta);
+	OS_EXIT_CRITICAL;
+	
+	if(full)
+		mcn_publish(MCN_ID(SENSOR_IMU_DELTA), &imu_delta);
+}
+
+/* everything integrated since the last take, so an estimator running late
+ * loses no samples; false if not a whole interval is integrated yet */
+bool sensor_imu_delta_take(IMU_Delta* imu_delta)
+{
+	bool full;
+	
+	OS_ENTER_CRITICAL;
+	full = imu_integrator_full(&_imu_integrator);
+	if(full)
+		imu_integrator_output(&_imu_integrator, imu_delta);
+	OS_EXIT_CRITICAL;
+	
+	return full;
+}
+
 /************************** Public API ***************************/
 void sensor_get_gyr(float gyr[3])
 {
@@ -695,15 +740,7 @@ rt_err_t device_sensor_init(void)
 	}
 	rt_device_open(baro_device_t , RT_DEVICE_OFLAG_RDWR);
 	
-	/* init gps device */
-	gps_device_t = rt_device_find(GPS_DEVICE_NAME);
-	if(gps_device_t == RT_NULL)
-	{
-		Console.e(TAG, "can't find gps device\r\n");
-		return RT_EEMPTY;
-	}
-	rt_err_t gps_open_res = rt_device_open(gps_device_t , RT_DEVICE_OFLAG_RDWR);
-	_gps_connected = gps_open_res == RT_EOK ? true : false;
+	/* the gps is opened by device_gps_init */
 
 #ifdef USE_LIDAR_I2C	
 	/* init lidar lite device */
@@ -779,6 +816,11 @@ rt_err_t device_sensor_init(void)
 	if(mcn_res != 0){
 		Console.e(TAG, "err:%d, GPS_STATUS advertise fail!\n", mcn_res);
 	}
+	mcn_res = mcn_advertise(MCN_ID(SENSOR_IMU_DELTA));
+	if(mcn_res != 0){
+		Console.e(TAG, "err:%d, SENSOR_IMU_DELTA advertise fail!\n", mcn_res);
+	}
+	imu_integrator_reset(&_imu_integrator, AHRS_PERIOD);
 	
 	gps_node_t = mcn_subscribe(MCN_ID(GPS_POSITION), NULL);
 	if(gps_node_t == NULL)
@@ -796,14 +838,33 @@ rt_err_t device_sensor_init(void)
 	return res;
 }
 
+/* Opening the gps configures the receiver over ubx, which takes seconds
+ * when there is none, so it is kept apart from device_sensor_init and
+ * can run next to the rest of the boot. */
+rt_err_t device_gps_init(void)
+{
+	gps_device_t = rt_device_find(GPS_DEVICE_NAME);
+	if(gps_device_t == RT_NULL)
+	{
+		Console.e(TAG, "can't find gps device\r\n");
+		return RT_EEMPTY;
+	}
+	rt_err_t gps_open_res = rt_device_open(gps_device_t , RT_DEVICE_OFLAG_RDWR);
+	_gps_connected = gps_open_res == RT_EOK ? true : false;
+	
+	return gps_open_res;
+}
+
 void sensor_collect(void)
 {
 	float gyr[3], acc[3], mag[3];
+	bool gyr_ok = false, acc_ok = false;
 
 	if(sensor_gyr_get_calibrated_data(gyr) == RT_EOK){
 		gyrfilter_input(gyr);
 		mcn_publish(MCN_ID(SENSOR_GYR), gyr);
 		mcn_publish(MCN_ID(SENSOR_FILTER_GYR), gyrfilter_current());
+		gyr_ok = true;
 	}else{
 		Console.e(TAG, "fail to get gyr data\n");
 	}
@@ -812,10 +873,17 @@ void sensor_collect(void)
 		accfilter_input(acc);
 		mcn_publish(MCN_ID(SENSOR_ACC), acc);
 		mcn_publish(MCN_ID(SENSOR_FILTER_ACC), accfilter_current());
+		acc_ok = true;
 	}else{
 		Console.e(TAG, "fail to get acc data\n");
 	}
 	
+	/* the integrator takes the low passed samples, as the estimators did
+	 * before, so the vibration stays out of them */
+	if(gyr_ok && acc_ok){
+		sensor_imu_delta_update(gyrfilter_current(), accfilter_current());
+	}
+	
 	if(sensor_mag_ready()){
 		if(sensor_mag_get_calibrated_data(mag) == RT_EOK){
 			magfilter_input(mag);
@@ -855,9 +923,8 @@ void sensor_collect(void)
 		mcn_copy(MCN_ID(GPS_POSITION), gps_node_t, &gps_pos_t);
 		
 		HOME_Pos home = pos_home_get();
-		if(home.gps_coordinate_set == true){
-			Vector3f_t pos;
-			gps_get_position(&pos, gps_pos_t);
+		Vector3f_t pos;
+		if(home.gps_coordinate_set == true && gps_get_position(&pos, gps_pos_t) == 0){
 			
 			_gps_driv_vel.velocity.x = (pos.x - _gps_driv_vel.last_pos.x) / 0.1f;	// the gps update interval is 100ms
 			_gps_driv_vel.velocity.y = (pos.y - _gps_driv_vel.last_pos.y) / 0.1f;
@@ -869,22 +936,7 @@ void sensor_collect(void)
 		}
 		
 		// check legality
-		if(_gps_status.status!=GPS_AVAILABLE && gps_pos_t.satellites_used>=6 && IN_RANGE(gps_pos_t.eph, 0.0f, 2.5f)){
-			
-			_gps_status.fix_cnt++;
-			
-			if(_gps_status.fix_cnt >= 10){
-				_gps_status.status = GPS_AVAILABLE;
-				
-				// gps becomes available, publish
-				mcn_publish(MCN_ID(GPS_STATUS), &_gps_status);
-			}
-		}
-		if(_gps_status.status!=GPS_INAVAILABLE && (gps_pos_t.satellites_used<=4 || gps_pos_t.eph>3.5f)){
-			
-			_gps_status.status = GPS_INAVAILABLE;
-			_gps_status.fix_cnt = 0;
-			
+		if(gps_status_update(&_gps_status, &gps_pos_t)){
 			mcn_publish(MCN_ID(GPS_STATUS), &_gps_status);
 		}
 	}
@@ -35,37 +35,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "pos_estimator.h"
 #include "sensor_manager.h"
 #include "gps.h"
-#include "fifo.h"
+#include "imu_integrator.h"
+#include "att_estimator.h"
 
-#define EKF_MAX_DELAY_OFFFSET		20
-#define EKF_STATE_X_DELAY			100
-#define EKF_STATE_Y_DELAY			100
-#define EKF_STATE_Z_DELAY			100
-#define EKF_STATE_VX_DELAY			100
-#define EKF_STATE_VY_DELAY			100
-#define EKF_STATE_VZ_DELAY			100
-#define EKF_STATE_Q0_DELAY			4
-#define EKF_STATE_Q1_DELAY			4
-#define EKF_STATE_Q2_DELAY			4
-#define EKF_STATE_Q3_DELAY			4
-#define EKF_STATE_GX_BIAS_DELAY		0
-#define EKF_STATE_GY_BIAS_DELAY		0
-#define EKF_STATE_GZ_BIAS_DELAY		0
-#define EKF_STATE_AZ_BIAS_DELAY		0
-	
-static EKF_Def ekf_14;
-static quaternion _est_att_q;
-static Euler _est_att_e;
-static FIFO _hist_x[14];
+static VEHICLE_STATE EKF_Def ekf_14;
+static VEHICLE_STATE quaternion _est_att_q;
+static VEHICLE_STATE McnNode_t _imu_delta_node_t;
+/* a stored state waits for est_store_take */
+static VEHICLE_STATE uint8_t _warm_pending;
 
 MCN_DECLARE(ATT_QUATERNION);
 MCN_DECLARE(ATT_EULER);
 MCN_DECLARE(BARO_POSITION);
 MCN_DECLARE(ALT_INFO);
 MCN_DECLARE(POS_INFO);
-MCN_DECLARE(SENSOR_FILTER_ACC);
 MCN_DECLARE(SENSOR_FILTER_MAG);
-MCN_DECLARE(SENSOR_FILTER_GYR);
+MCN_DECLARE(SENSOR_IMU_DELTA);
 
 static char *TAG = "State_EST";
 
@@ -91,33 +76,56 @@ void state_est_get_velocity(Vector3f_t *vel)
 	vel->z = MAT_ELEMENT(ekf_14.X, STATE_VZ, 0);
 }
 
+/* the biases and the variances the EKF has learned */
+void state_est_store_collect(Est_State* state)
+{
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		state->gyr_bias[i] = MAT_ELEMENT(ekf_14.X, STATE_GX_BIAS+i, 0);
+		state->gyr_bias_var[i] = MAT_ELEMENT(ekf_14.P, STATE_GX_BIAS+i, STATE_GX_BIAS+i);
+	}
+	state->acc_bias_z = MAT_ELEMENT(ekf_14.X, STATE_AZ_BIAS, 0);
+	state->acc_bias_z_var = MAT_ELEMENT(ekf_14.P, STATE_AZ_BIAS, STATE_AZ_BIAS);
+	for(uint8_t i = 0 ; i < 4 ; i++){
+		state->att_var[i] = MAT_ELEMENT(ekf_14.P, STATE_Q0+i, STATE_Q0+i);
+	}
+}
+
+void state_est_store_apply(const Est_State* state)
+{
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		MAT_ELEMENT(ekf_14.X, STATE_GX_BIAS+i, 0) = state->gyr_bias[i];
+		MAT_ELEMENT(ekf_14.P, STATE_GX_BIAS+i, STATE_GX_BIAS+i) = state->gyr_bias_var[i];
+	}
+	MAT_ELEMENT(ekf_14.X, STATE_AZ_BIAS, 0) = state->acc_bias_z;
+	MAT_ELEMENT(ekf_14.P, STATE_AZ_BIAS, STATE_AZ_BIAS) = state->acc_bias_z_var;
+	/* the attitude itself starts over from acc and mag, it is no more
+	 * certain than the stored variance says */
+	for(uint8_t i = 0 ; i < 4 ; i++){
+		float* var = &MAT_ELEMENT(ekf_14.P, STATE_Q0+i, STATE_Q0+i);
+		if(state->att_var[i] > *var)
+			*var = state->att_var[i];
+	}
+}
+
 uint8_t state_est_init(float dT)
 {
 	EKF14_Init(&ekf_14, dT);
-	
-	uint32_t interval = dT*1e3;
-	uint32_t hist_offset[14] = {
-		EKF_STATE_X_DELAY/interval, EKF_STATE_Y_DELAY/interval, EKF_STATE_Z_DELAY/interval,
-		EKF_STATE_VX_DELAY/interval, EKF_STATE_VY_DELAY/interval, EKF_STATE_VZ_DELAY/interval,
-		EKF_STATE_Q0_DELAY/interval, EKF_STATE_Q1_DELAY/interval, EKF_STATE_Q2_DELAY/interval, EKF_STATE_Q3_DELAY/interval,
-		EKF_STATE_GX_BIAS_DELAY/interval, EKF_STATE_GY_BIAS_DELAY/interval, EKF_STATE_GZ_BIAS_DELAY/interval, 
-		EKF_STATE_AZ_BIAS_DELAY/interval
-	};
-	
-	for(uint8_t i = 0 ; i < 14 ; i++){
-		fifo_create(&_hist_x[i], hist_offset[i]+1);
-		fifo_flush(&_hist_x[i]);
-	}
+	/* the biases of the last flight are taken once the baro is up */
+	_warm_pending = (est_store_load() == 0);
 	
 	int mcn_res = mcn_advertise(MCN_ID(ATT_QUATERNION));
 	if(mcn_res != 0){
 		Console.e(TAG, "err:%d, ATT_QUATERNION advertise fail!\n", mcn_res);
 	}
-	mcn_res = mcn_advertise(MCN_ID(ATT_EULER));
+	mcn_res = mcn_advertise_derived(MCN_ID(ATT_EULER), MCN_ID(ATT_QUATERNION), attitude_est_quaternion_to_euler);
 	if(mcn_res != 0){
 		Console.e(TAG, "err:%d, ATT_EULER advertise fail!\n", mcn_res);
 	}
 	
+	_imu_delta_node_t = mcn_subscribe(MCN_ID(SENSOR_IMU_DELTA), NULL);
+	if(_imu_delta_node_t == NULL)
+		Console.e(TAG, "_imu_delta_node_t subscribe err\n");
+	
 	return 0;
 }
 
@@ -128,19 +136,29 @@ uint8_t state_est_reset(void)
 	return 0;
 }
 
+/* runs once per imu delta, the interval is set by sensor_imu_delta_set_interval() */
 uint8_t state_est_update(void)
 {
 	float acc[3], gyr[3], mag[3];
 	uint32_t enable = 0xFFFF;
+	IMU_Delta imu_delta;
+	
+	if(!mcn_poll(_imu_delta_node_t))
+		return 0;
+	/* the delta SENSOR_IMU_DELTA announced plus whatever came after it */
+	if(!sensor_imu_delta_take(&imu_delta) || imu_delta.dt <= 0.0f)
+		return 0;
 	
 	pos_try_sethome();
 	
-	//sensor_get_acc(acc);
-	mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_ACC), acc);
+	/* mean rate and specific force over the interval, coning and sculling corrected */
+	ekf_14.dT = imu_delta.dt;
+	for(uint8_t i = 0 ; i < 3 ; i++){
+		gyr[i] = imu_delta.delta_ang[i] / imu_delta.dt;
+		acc[i] = imu_delta.delta_vel[i] / imu_delta.dt;
+	}
 	//sensor_get_mag(mag);
 	mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_MAG), mag);
-	//sensor_get_gyr(gyr);
-	mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_GYR), gyr);
 	
 	if(acc[0] == 0.0f && acc[1] == 0.0f && acc[2] == 0.0f){
 		enable &= 0xC7;
@@ -160,8 +178,8 @@ uint8_t state_est_update(void)
 	HOME_Pos home_pos;
 	pos_get_home(&home_pos);
 	
-	if(gps_status.status == GPS_AVAILABLE && home_pos.gps_coordinate_set){
-		gps_get_position(&pos, gps_report);
+	if(gps_status.status == GPS_AVAILABLE && home_pos.gps_coordinate_set
+		&& gps_get_position(&pos, gps_report) == 0){
 		gps_get_velocity(&vel, gps_report);
 	}else{
 		enable &= 0xFC;
@@ -203,28 +221,6 @@ uint8_t state_est_update(void)
 	
 	EKF14_SerialPrediction(&ekf_14, 0xFFFF);
 	
-	// store history state
-	// for(uint8_t n = 0 ; n < 14 ; n++){
-	// 	fifo_push(&_hist_x[n], MAT_ELEMENT(ekf_14.X, n, 0)); 
-	// }
-	
-	// calculate delta state
-//	float delta_x[14];
-//	for(uint8_t n = 0 ; n < 14 ; n++){
-//		// read history state
-//		float hist_val;
-//		if(_hist_x[n].cnt == _hist_x[n].size){ // read history data only fifo is full
-//			hist_val = fifo_pop(&_hist_x[n]);
-//		}else{
-//			hist_val = MAT_ELEMENT(ekf_14.X, n, 0);
-//		}
-//		
-//		delta_x[n] = MAT_ELEMENT(ekf_14.X, n, 0) - hist_val;
-//		
-//		// set current state to history value
-//		MAT_ELEMENT(ekf_14.X, n, 0) = hist_val;
-//	}
-	
 	if((acc[0] == 0.0f && acc[1] == 0.0f && acc[2] == 0.0f) || (mag[0] == 0.0f && mag[1] == 0.0f && mag[2] == 0.0f)){
 		//EKF14_SerialCorrect(&ekf_14, enable);
 		state_est_reset();
@@ -232,20 +228,23 @@ uint8_t state_est_update(void)
 	else{
 		//EKF14_SerialCorrect(&ekf_14, enable);
 		EKF14_Correct(&ekf_14);
+		
+		/* after the resets while the sensors come up */
+		if(_warm_pending){
+			Est_State warm;
+			int res = est_store_take(&warm);
+			if(res != EST_STORE_WAIT){
+				_warm_pending = 0;
+				if(res == EST_STORE_OK)
+					state_est_store_apply(&warm);
+			}
+		}
 	}
-//	EKF14_SerialCorrect(&ekf_14, enable);
-	
-	// add delta state back
-//	for(uint8_t n = 0 ; n < 14 ; n++){
-//		MAT_ELEMENT(ekf_14.X, n, 0) += delta_x[n];
-//	}
 	
 	state_est_get_quaternion(&_est_att_q);
+	/* ATT_EULER is derived from it */
 	mcn_publish(MCN_ID(ATT_QUATERNION), &_est_att_q);
 
-	quaternion_toEuler(&_est_att_q, &_est_att_e);
-	mcn_publish(MCN_ID(ATT_EULER), &_est_att_e);
-
 	Vector3f_t ned_pos, ned_vel;
 	state_est_get_position(&ned_pos);
 	state_est_get_velocity(&ned_vel);
@@ -14,6 +14,9 @@
 
 /* calculate CPU usage each 100ms */
 #define OS_STATISTIC_INTERVAL		500
+/* the idle counter runs at a fixed rate, a short count at boot scales up
+ * to OS_STATISTIC_INTERVAL */
+#define OS_STATISTIC_CALI_INTERVAL	50
 
 static uint64_t _os_idle_ctr = 0;
 static uint64_t _os_ctr_max;
@@ -54,10 +57,10 @@ void statistic_init(void)
 	rt_enter_critical();
 	_os_idle_ctr = 0;
 	rt_exit_critical();
-	/* we only have idle thread ready now, delay OS_STATISTIC_INTERVAL to count the maximal value of counter */
-	rt_thread_delay(OS_STATISTIC_INTERVAL);
+	/* we only have idle thread ready now, delay OS_STATISTIC_CALI_INTERVAL to count the maximal value of counter */
+	rt_thread_delay(OS_STATISTIC_CALI_INTERVAL);
 	rt_enter_critical();
-	_os_ctr_max = _os_idle_ctr;
+	_os_ctr_max = _os_idle_ctr * (OS_STATISTIC_INTERVAL / OS_STATISTIC_CALI_INTERVAL);
 	rt_exit_critical();
 	
 	/* register a timer event to calculate CPU usage */
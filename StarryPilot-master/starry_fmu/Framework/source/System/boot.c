@@ -0,0 +1,133 @@
+/*
+ * File      : boot.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include "boot.h"
+#include "console.h"
+#include "delay.h"
+
+static char *TAG = "Boot";
+
+static struct rt_event _boot_event;
+static const Boot_Stage* _stage;
+static uint8_t _stage_num;
+static uint32_t _start_ms[BOOT_STAGE_MAX];
+static uint32_t _end_ms[BOOT_STAGE_MAX];
+static rt_err_t _res[BOOT_STAGE_MAX];
+static uint32_t _boot_start, _boot_end;
+static uint8_t _boot_done;
+
+static void _run_stage(uint8_t i)
+{
+	rt_uint32_t recved;
+
+	if(_stage[i].depend)
+		rt_event_recv(&_boot_event, _stage[i].depend, RT_EVENT_FLAG_AND, RT_WAITING_FOREVER, &recved);
+
+	_start_ms[i] = time_nowMs();
+	_res[i] = _stage[i].init();
+	_end_ms[i] = time_nowMs();
+	if(_res[i] != RT_EOK)
+		Console.w(TAG, "%s fail:%d\n", _stage[i].name, _res[i]);
+
+	/* the flags are never cleared, every stage waiting on it sees it */
+	rt_event_send(&_boot_event, BOOT_DEP(i));
+}
+
+static void _stage_entry(void* parameter)
+{
+	_run_stage((uint8_t)(rt_ubase_t)parameter);
+}
+
+rt_err_t boot_run(const Boot_Stage* stage, uint8_t num)
+{
+	rt_uint32_t recved;
+	uint32_t all = 0, on_thread = 0;
+	uint8_t i;
+
+	if(num > BOOT_STAGE_MAX)
+		return RT_ERROR;
+	for(i = 0 ; i < num ; i++){
+		/* depending on a later stage could wait forever */
+		if(stage[i].depend & ~(BOOT_DEP(i) - 1)){
+			Console.e(TAG, "%s depends on a later stage\n", stage[i].name);
+			return RT_ERROR;
+		}
+		all |= BOOT_DEP(i);
+	}
+
+	_stage = stage;
+	_stage_num = num;
+	_boot_done = 0;
+	rt_event_init(&_boot_event, "boot", RT_IPC_FLAG_FIFO);
+	_boot_start = time_nowMs();
+
+	/* the threads share the priority and time slice of the boot thread */
+	for(i = 0 ; i < num ; i++){
+		if(stage[i].stack_size == 0)
+			continue;
+		rt_thread_t tid = rt_thread_create(stage[i].name, _stage_entry, (void*)(rt_ubase_t)i,
+							stage[i].stack_size, rt_thread_self()->current_priority, 20);
+		if(tid != RT_NULL){
+			rt_thread_startup(tid);
+			on_thread |= BOOT_DEP(i);
+		}else{
+			Console.w(TAG, "no thread for %s, run it in order\n", stage[i].name);
+		}
+	}
+	for(i = 0 ; i < num ; i++){
+		if(!(on_thread & BOOT_DEP(i)))
+			_run_stage(i);
+	}
+	rt_event_recv(&_boot_event, all, RT_EVENT_FLAG_AND, RT_WAITING_FOREVER, &recved);
+
+	_boot_end = time_nowMs();
+	_boot_done = 1;
+	rt_event_detach(&_boot_event);
+
+	return RT_EOK;
+}
+
+void boot_report(void)
+{
+	uint8_t i;
+
+	if(!_boot_done){
+		Console.print("boot not finished\n");
+		return;
+	}
+
+	Console.print("stage            start(ms)   end(ms)  time(ms)\n");
+	for(i = 0 ; i < _stage_num ; i++){
+		Console.print("%-16s %9u %9u %9u%s\n", _stage[i].name, _start_ms[i] - _boot_start,
+			_end_ms[i] - _boot_start, _end_ms[i] - _start_ms[i], _res[i] == RT_EOK ? "" : "  fail");
+	}
+	Console.print("boot graph: %u ms, ready at %u ms after reset\n", _boot_end - _boot_start, _boot_end);
+
+	/* walk back from the last stage to end through the dependency that
+	 * ended last, that is what the boot waited for */
+	int last = -1;
+	for(i = 0 ; i < _stage_num ; i++){
+		if(last < 0 || _end_ms[i] > _end_ms[last])
+			last = i;
+	}
+	uint8_t path[BOOT_STAGE_MAX];
+	uint8_t len = 0;
+	while(last >= 0){
+		path[len++] = last;
+		int dep = -1;
+		for(i = 0 ; i < _stage_num ; i++){
+			if((_stage[last].depend & BOOT_DEP(i)) && (dep < 0 || _end_ms[i] > _end_ms[dep]))
+				dep = i;
+		}
+		last = dep;
+	}
+	Console.print("critical path:");
+	while(len)
+		Console.print(" %s", _stage[path[--len]].name);
+	Console.print("\n");
+}
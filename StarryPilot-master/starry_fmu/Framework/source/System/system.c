@@ -10,6 +10,7 @@
 #include "system.h"
 #include "statistic.h"
 #include "console.h"
+#include "boot.h"
 #include <string.h>
 #include <rtthread.h>
 
@@ -338,6 +339,11 @@ static long _sys_list_device(struct rt_list_node *list)
 
 int handle_sys_shell_cmd(int argc, char** argv)
 {
+	if(argc >= 2 && strcmp(argv[1], "boot") == 0){
+		boot_report();
+		return 0;
+	}
+	
 	float cpu_usage = get_cpu_usage();
 	
 	Console.print("CPU Usage: %.2f\n", cpu_usage);
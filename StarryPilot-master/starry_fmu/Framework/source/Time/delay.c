@@ -8,23 +8,97 @@
 */
 
 #include <rtthread.h>
+#include <rthw.h>
 #include "delay.h"
 
-DELAY_TIME_Def _delay_t;
+VEHICLE_STATE DELAY_TIME_Def _delay_t;
+
+#ifdef TIME_SOURCE_SIM
+
+/************************** simulated time **************************/
+void time_sim_set(uint64_t us)
+{
+	_delay_t.usBase = us;
+	_delay_t.msPeriod = (uint32_t)(us / 1000);
+}
+
+void time_sim_step(uint64_t us)
+{
+	time_sim_set(_delay_t.usBase + us);
+}
+
+void time_tick_update(void)
+{
+}
+
+uint64_t time_nowUs(void)
+{
+	return _delay_t.usBase;
+}
+
+uint32_t time_nowMs(void)
+{
+	return _delay_t.msPeriod;
+}
+
+/* nobody else moves the clock, waiting has to do it */
+void time_waitUs(uint32_t delay)
+{
+	time_sim_step(delay);
+}
+
+void device_delay_init(void)
+{
+	_delay_t.msPerPeriod = 1000/RT_TICK_PER_SECOND;
+	time_sim_set(0);
+}
+
+#else
+
+/************************** cycle counter **************************/
+// SysTick中断中调用, 把cycle计数折算到usBase, 32位的计数不会溢出
+void time_tick_update(void)
+{
+	rt_base_t level = rt_hw_interrupt_disable();
+	uint32_t us = (DWT->CYCCNT - _delay_t.cycBase) / _delay_t.ticksPerUs;
+
+	_delay_t.cycBase += us * _delay_t.ticksPerUs;
+	_delay_t.usBase += us;
+	_delay_t.msPeriod += _delay_t.msPerPeriod;
+
+	rt_hw_interrupt_enable(level);
+}
 
 // 获取当前时间，us。
 uint64_t time_nowUs(void)
 {
-    return _delay_t.msPeriod * (uint64_t)1000 + (SysTick->LOAD - SysTick->VAL) / _delay_t.ticksPerUs;
+	uint32_t period, cyc;
+	uint64_t us;
+
+	/* read again if the SysTick interrupt updated the base in between */
+	do{
+		period = _delay_t.msPeriod;
+		us = _delay_t.usBase;
+		cyc = DWT->CYCCNT - _delay_t.cycBase;
+	}while(period != _delay_t.msPeriod);
+
+	return us + cyc / _delay_t.ticksPerUs;
 }
 
 // 获取当前时间，ms。
 uint32_t time_nowMs(void)
 {
-    return _delay_t.msPeriod + (SysTick->LOAD - SysTick->VAL) / _delay_t.ticksPerMs;
+	uint32_t period, cyc;
+
+	do{
+		period = _delay_t.msPeriod;
+		cyc = DWT->CYCCNT - _delay_t.cycBase;
+	}while(period != _delay_t.msPeriod);
+
+	return period + cyc / _delay_t.ticksPerMs;
 }
 
-// 延时delay us，delay>=4时才准确。
+// 延时delay us。
 void time_waitUs(uint32_t delay)
 {
     uint64_t target = time_nowUs() + delay;
@@ -32,20 +106,29 @@ void time_waitUs(uint32_t delay)
 		;
 }
 
-// 延时delay ms。
-void time_waitMs(uint32_t delay)
-{
-    time_waitUs(delay * 1000);
-}
-
 void device_delay_init(void)
 {
 	RCC_ClocksTypeDef  rcc_clocks;
 
     RCC_GetClocksFreq(&rcc_clocks);
-	
-    _delay_t.msPeriod = 0;  							
-    _delay_t.ticksPerUs = rcc_clocks.HCLK_Frequency/8 / 1e6;    	
-    _delay_t.ticksPerMs = rcc_clocks.HCLK_Frequency/8 / 1e3;    	
-    _delay_t.msPerPeriod = 1000/RT_TICK_PER_SECOND;  	
+
+	/* enable the cycle counter */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    _delay_t.msPeriod = 0;
+    _delay_t.ticksPerUs = rcc_clocks.HCLK_Frequency / 1e6;
+    _delay_t.ticksPerMs = rcc_clocks.HCLK_Frequency / 1e3;
+    _delay_t.msPerPeriod = 1000/RT_TICK_PER_SECOND;
+    _delay_t.usBase = 0;
+    _delay_t.cycBase = 0;
+}
+
+#endif
+
+// 延时delay ms。
+void time_waitMs(uint32_t delay)
+{
+    time_waitUs(delay * 1000);
 }
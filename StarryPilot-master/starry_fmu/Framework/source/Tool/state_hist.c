@@ -0,0 +1,80 @@
+/*
+ * File      : state_hist.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include "state_hist.h"
+#include "global.h"
+#include "console.h"
+
+/* physical index of the k-th snapshot counted from the oldest */
+static uint16_t _index(const State_Hist *hist, uint16_t k)
+{
+	uint32_t index = (uint32_t)hist->head + hist->size + 1 - hist->cnt + k;
+
+	return (index >= hist->size) ? (index - hist->size) : index;
+}
+
+uint8_t state_hist_create(State_Hist *hist, uint16_t size, uint16_t dim)
+{
+	hist->time_stamp = (uint32_t*)OS_MALLOC(size*sizeof(uint32_t));
+	hist->data = (float*)OS_MALLOC(size*dim*sizeof(float));
+	if(hist->time_stamp == NULL || hist->data == NULL){
+		Console.print("state hist create fail\n");
+		if(hist->time_stamp)
+			OS_FREE(hist->time_stamp);
+		if(hist->data)
+			OS_FREE(hist->data);
+		hist->time_stamp = NULL;
+		hist->data = NULL;
+		hist->size = 0;
+		return 1;
+	}
+	hist->size = size;
+	hist->dim = dim;
+	state_hist_flush(hist);
+
+	return 0;
+}
+
+void state_hist_flush(State_Hist *hist)
+{
+	if(hist == NULL)
+		return;
+	hist->head = hist->size - 1;
+	hist->cnt = 0;
+}
+
+void state_hist_push(State_Hist *hist, uint32_t time_stamp, const float *x)
+{
+	hist->head++;
+	if(hist->head >= hist->size)
+		hist->head = 0;
+	hist->time_stamp[hist->head] = time_stamp;
+	memcpy(&hist->data[hist->head*hist->dim], x, hist->dim*sizeof(float));
+	if(hist->cnt < hist->size)
+		hist->cnt++;
+}
+
+const float* state_hist_lookup(const State_Hist *hist, uint32_t time_stamp)
+{
+	if(hist->cnt == 0)
+		return NULL;
+
+	/* the snapshots are in time order, look for the first one at or after time_stamp */
+	uint16_t lo = 0;
+	uint16_t hi = hist->cnt - 1;
+	while(lo < hi){
+		uint16_t mid = (lo + hi) / 2;
+		if((int32_t)(hist->time_stamp[_index(hist, mid)] - time_stamp) >= 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return &hist->data[_index(hist, lo)*hist->dim];
+}
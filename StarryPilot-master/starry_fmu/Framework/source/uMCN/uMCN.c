@@ -10,9 +10,20 @@
 #include <string.h>
 #include "uMCN.h"
 #include "console.h"
+#include "delay.h"
 
 static char* TAG = "uMCN";
 
+/* every advertised hub, in the order of advertising */
+static VEHICLE_STATE McnHub* _hub_head;
+static VEHICLE_STATE McnHub* _hub_tail;
+
+/* a derived topic counts the publishes of its source */
+static uint32_t _mcn_pub_cnt(McnHub* hub)
+{
+	return hub->source != NULL ? hub->source->pub_cnt : hub->pub_cnt;
+}
+
 int mcn_advertise(McnHub* hub)
 {
 	int res = 0;
@@ -26,12 +37,66 @@ int mcn_advertise(McnHub* hub)
 	hub->pdata = MCN_MALLOC(hub->obj_size);
 	if(hub->pdata == NULL){
 		res = -1;
+	}else{
+		/* register the hub */
+		hub->next = NULL;
+		if(_hub_tail == NULL){
+			_hub_head = _hub_tail = hub;
+		}else{
+			_hub_tail->next = hub;
+			_hub_tail = hub;
+		}
 	}
 	MCN_EXIT_CRITICAL;
 	
+	if(res == 0){
+		mcn_mark(hub, &hub->report);
+	}
+	
 	return res;
 }
 
+/* hub gets its data from source through transform, evaluated only when a
+ * subscriber copies it. The transform runs within MCN_ENTER_CRITICAL. */
+int mcn_advertise_derived(McnHub* hub, McnHub* source, void (*transform)(const void* src, void* dst))
+{
+	if(hub->pdata != NULL){
+		// already advertised
+		return 0;
+	}
+	if(source->pdata == NULL || source->source != NULL || transform == NULL){
+		// source not advertised, or derived itself
+		Console.e(TAG, "uMCN, %s can not derive from %s\n", hub->obj_name, source->obj_name);
+		return -1;
+	}
+	
+	int res = mcn_advertise(hub);
+	if(res != 0){
+		return res;
+	}
+	
+	MCN_ENTER_CRITICAL;
+	hub->source = source;
+	hub->transform = transform;
+	/* transformed at the first copy */
+	hub->derived_cnt = source->pub_cnt - 1;
+	hub->published = source->published;
+	hub->derived_next = source->derived_head;
+	source->derived_head = hub;
+	MCN_EXIT_CRITICAL;
+	
+	return 0;
+}
+
+/* call within MCN_ENTER_CRITICAL */
+static void _mcn_derive(McnHub* hub)
+{
+	if(hub->source != NULL && hub->derived_cnt != hub->source->pub_cnt){
+		hub->transform(hub->source->pdata, hub->pdata);
+		hub->derived_cnt = hub->source->pub_cnt;
+	}
+}
+
 McnNode_t mcn_subscribe(McnHub* hub, void (*cb)(void *parameter))
 {
 	if(hub->link_num >= MCN_MAX_LINK_NUM){
@@ -49,6 +114,7 @@ McnNode_t mcn_subscribe(McnHub* hub, void (*cb)(void *parameter))
 	node->next = NULL;
 	
 	MCN_ENTER_CRITICAL;
+	node->read_cnt = _mcn_pub_cnt(hub);
 	/* no node link yet */
 	if(hub->link_tail == NULL){
 		hub->link_head = hub->link_tail = node;
@@ -74,25 +140,42 @@ int mcn_publish(McnHub* hub, const void* data)
 		return -1;
 	}
 	
+	if(hub->source != NULL){
+		Console.w(TAG, "derived %s publish!\n", hub->obj_name);
+		return -1;
+	}
+	
 	MCN_ENTER_CRITICAL;
 	/* copy data to hub */
 	memcpy(hub->pdata, data, hub->obj_size);
-	/* update each node's renewal flag */
-	McnNode_t node = hub->link_head;
-	while(node != NULL){
-		node->renewal = 1;
-		node = node->next;
+	/* update each node's renewal flag, also of the derived topics */
+	McnHub* d = hub;
+	while(d != NULL){
+		McnNode_t node = d->link_head;
+		while(node != NULL){
+			node->renewal = 1;
+			node = node->next;
+		}
+		d->published = 1;
+		d = (d == hub) ? hub->derived_head : d->derived_next;
 	}
-	hub->published = 1;
+	hub->pub_cnt++;
 	MCN_EXIT_CRITICAL;
 	
-	/* invoke callback func */
-	node = hub->link_head;
-	while(node != NULL){
-		if(node->cb != NULL){
-			node->cb(hub->pdata);
+	/* invoke callback func, a derived topic is transformed only if it has one */
+	d = hub;
+	while(d != NULL){
+		McnNode_t node = d->link_head;
+		while(node != NULL){
+			if(node->cb != NULL){
+				MCN_ENTER_CRITICAL;
+				_mcn_derive(d);
+				MCN_EXIT_CRITICAL;
+				node->cb(d->pdata);
+			}
+			node = node->next;
 		}
-		node = node->next;
+		d = (d == hub) ? hub->derived_head : d->derived_next;
 	}
 	
 	return 0;
@@ -122,8 +205,11 @@ int mcn_copy(McnHub* hub, McnNode_t node_t, void* buffer)
 	}
 	
 	MCN_ENTER_CRITICAL;
+	_mcn_derive(hub);
 	memcpy(buffer, hub->pdata, hub->obj_size);
 	node_t->renewal = 0;
+	node_t->read_cnt = _mcn_pub_cnt(hub);
+	hub->copy_cnt++;
 	MCN_EXIT_CRITICAL;
 	
 	return 0;
@@ -142,21 +228,214 @@ int mcn_copy_from_hub(McnHub* hub, void* buffer)
 	}
 	
 	MCN_ENTER_CRITICAL;
+	_mcn_derive(hub);
 	memcpy(buffer, hub->pdata, hub->obj_size);
+	hub->copy_cnt++;
 	MCN_EXIT_CRITICAL;
 	
 	return 0;
 }
 
+/* hub NULL gives the first advertised hub */
+McnHub* mcn_next_hub(McnHub* hub)
+{
+	return hub == NULL ? _hub_head : hub->next;
+}
+
+McnHub* mcn_find_hub(const char* name)
+{
+	McnHub* hub = _hub_head;
+	
+	while(hub != NULL){
+		if(strcmp(hub->obj_name, name) == 0)
+			break;
+		hub = hub->next;
+	}
+	
+	return hub;
+}
+
+/* most publishes a subscriber has not copied yet, subscribers with a
+ * callback take every publish */
+uint32_t mcn_max_lag(McnHub* hub)
+{
+	uint32_t lag = 0;
+	
+	MCN_ENTER_CRITICAL;
+	McnNode_t node = hub->link_head;
+	while(node != NULL){
+		if(node->cb == NULL && _mcn_pub_cnt(hub) - node->read_cnt > lag){
+			lag = _mcn_pub_cnt(hub) - node->read_cnt;
+		}
+		node = node->next;
+	}
+	MCN_EXIT_CRITICAL;
+	
+	return lag;
+}
+
+void mcn_mark(McnHub* hub, McnMark* mark)
+{
+	MCN_ENTER_CRITICAL;
+	mark->pub_cnt = _mcn_pub_cnt(hub);
+	mark->copy_cnt = hub->copy_cnt;
+	MCN_EXIT_CRITICAL;
+	mark->time = time_nowMs();
+}
+
+/* rates from mark on, a derived topic publishes no bytes */
+void mcn_rate(McnHub* hub, const McnMark* from, McnRate* rate)
+{
+	McnMark now;
+	
+	mcn_mark(hub, &now);
+	float dt = (now.time - from->time) * 1e-3f;
+	if(dt <= 0.0f){
+		rate->pub_hz = rate->copy_hz = rate->byte_ps = 0.0f;
+		return;
+	}
+	rate->pub_hz = (now.pub_cnt - from->pub_cnt) / dt;
+	rate->copy_hz = (now.copy_cnt - from->copy_cnt) / dt;
+	rate->byte_ps = hub->source != NULL ? 0.0f : rate->pub_hz * hub->obj_size;
+}
+
+/* id is the advertise order, "mavproxy mcn" reports the topics by it */
+static void _mcn_list(void)
+{
+	unsigned id = 0;
+	
+	Console.print("%4s %-20s %5s %4s %10s %10s %6s %s\n", "id", "topic", "size", "subs", "published", "copied", "lag", "derived from");
+	for(McnHub* hub = mcn_next_hub(NULL) ; hub != NULL ; hub = mcn_next_hub(hub), id++){
+		Console.print("%4u %-20s %5u %4u %10u %10u %6u %s\n", id, hub->obj_name, (unsigned)hub->obj_size, (unsigned)hub->link_num,
+			(unsigned)_mcn_pub_cnt(hub), (unsigned)hub->copy_cnt, (unsigned)mcn_max_lag(hub),
+			hub->source != NULL ? hub->source->obj_name : "");
+	}
+}
+
+/* the topic has no type, each word is shown as float and hex */
+static void _mcn_echo_data(McnHub* hub, const uint8_t* data)
+{
+	uint32_t i;
+	
+	for(i = 0 ; i + 4 <= hub->obj_size ; i += 4){
+		float f;
+		uint32_t w;
+		memcpy(&f, &data[i], 4);
+		memcpy(&w, &data[i], 4);
+		Console.print("  [%2u] %14.6f  %08x\n", (unsigned)i, f, (unsigned)w);
+	}
+	for( ; i < hub->obj_size ; i++){
+		Console.print("  [%2u] %02x\n", (unsigned)i, data[i]);
+	}
+}
+
+static int _mcn_echo(const char* name, int count)
+{
+	McnHub* hub = mcn_find_hub(name);
+	uint8_t* data;
+	
+	if(hub == NULL){
+		Console.print("no topic %s\n", name);
+		return 1;
+	}
+	data = (uint8_t*)MCN_MALLOC(hub->obj_size);
+	if(data == NULL){
+		return 1;
+	}
+	
+	for(int n = 0 ; n < count ; n++){
+		uint32_t cnt = _mcn_pub_cnt(hub);
+		uint32_t start = time_nowMs();
+		
+		/* the current data first, then each new publish */
+		while(n > 0 && _mcn_pub_cnt(hub) == cnt){
+			if(time_nowMs() - start > 1000){
+				Console.print("%s not published for 1s\n", name);
+				MCN_FREE(data);
+				return 1;
+			}
+			rt_thread_delay(1);
+		}
+		if(mcn_copy_from_hub(hub, data) != 0){
+			Console.print("%s not published yet\n", name);
+			break;
+		}
+		Console.print("%s #%u at %u ms:\n", name, (unsigned)_mcn_pub_cnt(hub), (unsigned)time_nowMs());
+		_mcn_echo_data(hub, data);
+	}
+	MCN_FREE(data);
+	
+	return 0;
+}
+
+static int _mcn_hz(const char* name, uint32_t window_ms)
+{
+	McnHub* only = NULL;
+	McnMark* mark;
+	int num = 0, i;
+	
+	if(name != NULL){
+		only = mcn_find_hub(name);
+		if(only == NULL){
+			Console.print("no topic %s\n", name);
+			return 1;
+		}
+	}
+	for(McnHub* hub = mcn_next_hub(NULL) ; hub != NULL ; hub = mcn_next_hub(hub)){
+		num++;
+	}
+	mark = (McnMark*)MCN_MALLOC(num * sizeof(McnMark));
+	if(mark == NULL){
+		return 1;
+	}
+	
+	i = 0;
+	for(McnHub* hub = mcn_next_hub(NULL) ; hub != NULL && i < num ; hub = mcn_next_hub(hub)){
+		mcn_mark(hub, &mark[i++]);
+	}
+	rt_thread_delay(window_ms * RT_TICK_PER_SECOND / 1000);
+	
+	Console.print("%-20s %9s %9s %9s %6s\n", "topic", "pub Hz", "copy Hz", "B/s", "lag");
+	i = 0;
+	for(McnHub* hub = mcn_next_hub(NULL) ; hub != NULL && i < num ; hub = mcn_next_hub(hub), i++){
+		McnRate rate;
+		if(only != NULL && hub != only)
+			continue;
+		mcn_rate(hub, &mark[i], &rate);
+		Console.print("%-20s %9.1f %9.1f %9.0f %6u\n", hub->obj_name, rate.pub_hz, rate.copy_hz, rate.byte_ps,
+			(unsigned)mcn_max_lag(hub));
+	}
+	MCN_FREE(mark);
+	
+	return 0;
+}
+
 int handle_uMCN_cmd(int argc, char** argv)
 {
 	if(argc > 1){
+		if(strcmp("list", argv[1]) == 0){
+			_mcn_list();
+		}
 		if(strcmp("echo", argv[1]) == 0){
 			if(argc > 2){
-
+				return _mcn_echo(argv[2], argc > 3 ? atoi(argv[3]) : 1);
 			}
 		}
+		if(strcmp("hz", argv[1]) == 0){
+			const char* name = NULL;
+			uint32_t window = 1000;
+			/* mcn hz [topic] [window ms] */
+			for(int i = 2 ; i < argc ; i++){
+				if(atoi(argv[i]) > 0)
+					window = atoi(argv[i]);
+				else
+					name = argv[i];
+			}
+			return _mcn_hz(name, window);
+		}
+	}else{
+		Console.print("usage: mcn list | echo <topic> [count] | hz [topic] [window ms]\n");
 	}
 	
 	return 0;
-}
\ No newline at end of file
+}
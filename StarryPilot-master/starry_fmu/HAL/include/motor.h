@@ -13,7 +13,11 @@
 #include <rtthread.h>
 #include <rtdevice.h>
 
+#ifdef BLUEJAY
+#define MOTOR_NUM	6	/* the hexrotor frames mix 6 outputs */
+#else
 #define MOTOR_NUM	4
+#endif
 
 #define MOTOR_MIN_DC	0.05f		/* minimal duty cycle: 1ms/20ms=0.05 */
 #define MOTOR_MAX_DC	0.1f		/* minimal duty cycle: 2ms/20ms=0.1 */	
@@ -0,0 +1,174 @@
+/*
+ * File      : adrc_check.c
+ *
+ * Host check of the branch free fhan and of the three axis ADRC parts
+ * (adrc.c) against the textbook forms they replace.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "adrc.h"
+
+float adrc_fhan(float v1, float v2, float r0, float h0);
+
+/* relative to the size of the values compared */
+#define TOL_FUNC	1e-5f
+
+#define CHECK(_cond, ...)	do{ if(!(_cond)){ printf(__VA_ARGS__); fail = 1; } }while(0)
+
+/****************** adrc.c as it was ******************/
+static float old_sign(float val)
+{
+	if(val >= 0.0f)
+		return 1.0f;
+	else
+		return -1.0f;
+}
+
+static float old_fhan(float v1, float v2, float r0, float h0)
+{
+	float d = h0 * h0 * r0;
+	float a0 = h0 * v2;
+	float y = v1 + a0;
+	float a1 = sqrtf(d*(d + 8.0f*fabsf(y)));
+	float a2 = a0 + old_sign(y)*(a1-d)*0.5f;
+	float sy = (old_sign(y+d) - old_sign(y-d))*0.5f;
+	float a = (a0 + y - a2)*sy + a2;
+	float sa = (old_sign(a+d) - old_sign(a-d))*0.5f;
+
+	return -r0*(a/d - old_sign(a))*sa - r0*old_sign(a);
+}
+
+static float urand(float lo, float hi)
+{
+	return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+static float rel_diff(float a, float b)
+{
+	float m = fabsf(b) > 1.0f ? fabsf(b) : 1.0f;
+
+	return fabsf(a - b) / m;
+}
+
+static int check_func(int samples)
+{
+	float max_fhan = 0.0f;
+	int fail = 0;
+
+	for(int n = 0 ; n < samples ; n++){
+		float r0 = urand(1.0f, 1000.0f);
+		float h0 = urand(0.001f, 0.1f);
+		float d = h0 * h0 * r0;
+		/* a third right around the switching lines |y| = d and |a| = d */
+		float v1 = (n % 3) ? urand(-5.0f, 5.0f) : urand(-2.0f, 2.0f)*d;
+		float v2 = (n % 3) ? urand(-50.0f, 50.0f) : urand(-2.0f, 2.0f)*d/h0;
+		/* sat() keeps fhan within r0 */
+		float e = rel_diff(adrc_fhan(v1, v2, r0, h0), old_fhan(v1, v2, r0, h0)) / r0;
+		if(e > max_fhan)
+			max_fhan = e;
+	}
+	CHECK(max_fhan <= TOL_FUNC, "fhan differs by %g of r0\n", max_fhan);
+
+	printf("%d samples fhan max diff %.2e of r0  %s\n", samples, max_fhan, fail ? "FAIL" : "ok");
+
+	return fail;
+}
+
+/* each axis of the three axis parts against a scalar textbook step from
+ * the same state, fed with a noisy swing as the attitude loop sees it. The
+ * TD with r0 = 1000 chatters on noise, so two runs of it part after a while
+ * on rounding alone and only single steps are comparable. */
+static int check_axes(int steps)
+{
+	/* the default ADRC_ATT parameters at CONTROL_PERIOD */
+	float h = 0.004f;
+	ADRC_TD3_Def td, td_ctrl;
+	ADRC_LESO3_Def leso;
+	ADRC_NLSEF3_Def nlsef;
+	float max_td = 0.0f, max_ctrl = 0.0f, max_leso = 0.0f, max_nlsef = 0.0f;
+	int fail = 0;
+
+	adrc_td3_init(&td, 3, h, 1000.0f, h);
+	adrc_td3_init(&td_ctrl, 3, h, 25.0f, 20.0f*h);
+	adrc_leso3_init(&leso, 3, 0.001f, 120.0f, 400.0f);
+	adrc_nlsef3_init(&nlsef, 3, h, 100.0f, 50.0f*h, 0.01f);
+
+	for(int k = 0 ; k < steps ; k++){
+		float t = k * h;
+		float err[3], v[3], y[3], u0[3];
+		float ref_td[3][2], ref_ctrl[3][2], ref_leso[3][2], ref_u0[3];
+
+		for(int i = 0 ; i < 3 ; i++){
+			err[i] = 0.3f*sinf(t*(1.0f + i)) + urand(-0.02f, 0.02f);
+			v[i] = 2.0f*sinf(t*(3.0f + i)) + urand(-0.2f, 0.2f);
+			y[i] = 1.5f*cosf(t*(2.0f + i)) + urand(-0.1f, 0.1f);
+			leso.u[i] = 0.1f*sinf(t*(5.0f + i));
+
+			/* adrc_td, adrc_td_control, adrc_leso and adrc_nlsef as they were */
+			float fv = old_fhan(td.v1[i] - v[i], td.v2[i], 1000.0f, h);
+			ref_td[i][0] = td.v1[i] + h * td.v2[i];
+			ref_td[i][1] = td.v2[i] + h * fv;
+
+			fv = old_fhan(-err[i], td_ctrl.v2[i], 25.0f, 20.0f*h);
+			ref_ctrl[i][0] = td_ctrl.v1[i] + h * td_ctrl.v2[i];
+			ref_ctrl[i][1] = td_ctrl.v2[i] + h * fv;
+
+			float e = leso.z1[i] - y[i];
+			ref_leso[i][0] = leso.z1[i] + 0.001f*(leso.z2[i] + 400.0f*leso.u[i] - 240.0f*e);
+			ref_leso[i][1] = leso.z2[i] - 0.001f*14400.0f*e;
+		}
+		adrc_td3(&td, v);
+		adrc_td3_control(&td_ctrl, err);
+		adrc_leso3(&leso, y);
+		adrc_nlsef3(&nlsef, err, td.v2, u0);
+
+		for(int i = 0 ; i < 3 ; i++){
+			float d;
+
+			ref_u0[i] = -old_fhan(err[i], 0.01f*td.v2[i], 100.0f, 50.0f*h);
+
+			d = fmaxf(rel_diff(td.v1[i], ref_td[i][0]), rel_diff(td.v2[i], ref_td[i][1]));
+			if(d > max_td)
+				max_td = d;
+			d = fmaxf(rel_diff(td_ctrl.v1[i], ref_ctrl[i][0]), rel_diff(td_ctrl.v2[i], ref_ctrl[i][1]));
+			if(d > max_ctrl)
+				max_ctrl = d;
+			d = fmaxf(rel_diff(leso.z1[i], ref_leso[i][0]), rel_diff(leso.z2[i], ref_leso[i][1]));
+			if(d > max_leso)
+				max_leso = d;
+			/* of r1, the most it gives */
+			d = fabsf(u0[i] - ref_u0[i]) / 100.0f;
+			if(d > max_nlsef)
+				max_nlsef = d;
+		}
+	}
+	CHECK(max_td <= TOL_FUNC, "td3 differs from adrc_td by %g\n", max_td);
+	CHECK(max_ctrl <= TOL_FUNC, "td3 control differs from adrc_td_control by %g\n", max_ctrl);
+	CHECK(max_leso <= TOL_FUNC, "leso3 differs from adrc_leso by %g\n", max_leso);
+	CHECK(max_nlsef <= TOL_FUNC, "nlsef3 differs from adrc_nlsef by %g of r1\n", max_nlsef);
+
+	printf("%d steps max diff  td3 %.2e  td3 control %.2e  leso3 %.2e  nlsef3 %.2e  %s\n", steps,
+			max_td, max_ctrl, max_leso, max_nlsef, fail ? "FAIL" : "ok");
+
+	return fail;
+}
+
+int main(int argc, char** argv)
+{
+	int samples = argc > 1 ? atoi(argv[1]) : 1000000;
+	int fail = 0;
+
+	srand(1);
+	fail |= check_func(samples);
+	/* 10 min of flight at CONTROL_PERIOD */
+	fail |= check_axes(150000);
+
+	printf("%s\n", fail ? "FAIL" : "all ok");
+	return fail;
+}
@@ -0,0 +1,311 @@
+/*
+ * File      : bench.c
+ *
+ * Host microbenchmarks of the Framework kernels (bench_kernel.c). Each
+ * kernel is warmed up, its batch size calibrated so a batch takes about
+ * the target time, then timed over a number of batches; min, median,
+ * 90th/99th percentile, max and mean per call are reported, optionally as
+ * csv. A csv of an earlier run can be given as baseline: the kernels whose
+ * median and minimum both moved beyond the threshold are marked, and the
+ * exit status is 1 if one got slower.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include "host_port.h"
+#include "host_sensor.h"
+#include "bench.h"
+
+#define MAX_BASE			256
+#define MAX_NAME			64
+
+typedef struct
+{
+	const Bench_Kernel* kernel;
+	uint32_t calls;			/* per batch */
+	double mean, min, p50, p90, p99, max;	/* ns per call */
+}Bench_Result;
+
+typedef struct
+{
+	char name[MAX_NAME];
+	double min, p50;
+}Bench_Base;
+
+/* set by the options */
+static int _samples = 101;
+static double _target_us = 50.0;
+static double _warmup_ms = 20.0;
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+	double da = *(const double*)a, db = *(const double*)b;
+
+	return da < db ? -1 : da > db ? 1 : 0;
+}
+
+/* nearest rank */
+static double percentile(const double* sorted, int num, double p)
+{
+	int i = (int)(p/100.0*num + 0.5) - 1;
+
+	if(i < 0)
+		i = 0;
+	if(i >= num)
+		i = num-1;
+	return sorted[i];
+}
+
+static double time_batch(const Bench_Kernel* k, uint32_t calls)
+{
+	double t0 = now_ns();
+
+	k->run(calls);
+	return now_ns() - t0;
+}
+
+static void bench_run(const Bench_Kernel* k, Bench_Result* res, double* sample)
+{
+	uint32_t calls = 1;
+	double t0, sum = 0.0;
+
+	if(k->setup)
+		k->setup();
+
+	/* grow the batch until it takes the target time */
+	while(calls < (1u << 30) && time_batch(k, calls) < _target_us*1e3)
+		calls *= 2;
+	/* warm up caches, branch predictors and the cpu clock */
+	t0 = now_ns();
+	while(now_ns() - t0 < _warmup_ms*1e6)
+		k->run(calls);
+
+	for(int i = 0 ; i < _samples ; i++){
+		sample[i] = time_batch(k, calls) / calls;
+		sum += sample[i];
+	}
+	qsort(sample, _samples, sizeof(double), cmp_double);
+
+	res->kernel = k;
+	res->calls = calls;
+	res->mean = sum / _samples;
+	res->min = sample[0];
+	res->p50 = percentile(sample, _samples, 50.0);
+	res->p90 = percentile(sample, _samples, 90.0);
+	res->p99 = percentile(sample, _samples, 99.0);
+	res->max = sample[_samples-1];
+}
+
+/* "1kHz" -> 1000 */
+static double path_rate(const char* path)
+{
+	double rate = atof(path);
+
+	return strstr(path, "kHz") ? rate*1e3 : rate;
+}
+
+static int load_base(const char* name, Bench_Base* base)
+{
+	FILE* fp = fopen(name, "r");
+	char line[256];
+	int num = 0;
+
+	if(fp == NULL){
+		perror(name);
+		return -1;
+	}
+	while(fgets(line, sizeof(line), fp) && num < MAX_BASE){
+		char path[16];
+		uint32_t calls;
+		double mean;
+
+		/* the header does not scan */
+		if(sscanf(line, "%63[^,],%15[^,],%u,%lf,%lf,%lf", base[num].name, path, &calls, &mean,
+				&base[num].min, &base[num].p50) == 6)
+			num++;
+	}
+	fclose(fp);
+	return num;
+}
+
+static const Bench_Base* find_base(const Bench_Base* base, int num, const char* name)
+{
+	for(int i = 0 ; i < num ; i++){
+		if(strcmp(base[i].name, name) == 0)
+			return &base[i];
+	}
+	return NULL;
+}
+
+static int selected(const Bench_Kernel* k, const char* pattern, const char* path)
+{
+	if(path && strcmp(k->path, path) != 0)
+		return 0;
+	if(pattern == NULL)
+		return 1;
+	/* comma separated substrings */
+	for(const char* p = pattern ; *p ; ){
+		const char* end = strchr(p, ',');
+		int len = end ? (int)(end-p) : (int)strlen(p);
+
+		if(len && memmem(k->name, strlen(k->name), p, len))
+			return 1;
+		p += end ? len+1 : len;
+	}
+	return 0;
+}
+
+static void usage(FILE* fp)
+{
+	fprintf(fp, "usage: bench [-k name,...] [-p path] [-s samples] [-t target_us] [-w warmup_ms] [-c out.csv] [-b base.csv] [-r threshold%%] [-a cpu] [-l]\n");
+}
+
+int main(int argc, char** argv)
+{
+	const char* pattern = NULL;
+	const char* path = NULL;
+	const char* csv_name = NULL;
+	const char* base_name = NULL;
+	double threshold = 5.0;
+	int cpu = -1, list = 0;
+	int opt;
+
+	while((opt = getopt(argc, argv, "k:p:s:t:w:c:b:r:a:lh")) != -1){
+		switch(opt)
+		{
+			case 'k': pattern = optarg; break;
+			case 'p': path = optarg; break;
+			case 's': _samples = atoi(optarg); break;
+			case 't': _target_us = atof(optarg); break;
+			case 'w': _warmup_ms = atof(optarg); break;
+			case 'c': csv_name = optarg; break;
+			case 'b': base_name = optarg; break;
+			case 'r': threshold = atof(optarg); break;
+			case 'a': cpu = atoi(optarg); break;
+			case 'l': list = 1; break;
+			default:
+				usage(opt == 'h' ? stdout : stderr);
+				return opt == 'h' ? 0 : 2;
+		}
+	}
+	if(optind != argc || _samples <= 0 || _target_us <= 0.0 || _warmup_ms < 0.0 || threshold < 0.0){
+		usage(stderr);
+		return 2;
+	}
+	if(list){
+		for(int i = 0 ; i < bench_kernel_num ; i++){
+			if(selected(&bench_kernel[i], pattern, path))
+				printf("%-34s %s\n", bench_kernel[i].name, bench_kernel[i].path);
+		}
+		return 0;
+	}
+	if(cpu >= 0){
+		cpu_set_t set;
+
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if(sched_setaffinity(0, sizeof(set), &set) != 0){
+			perror("sched_setaffinity");
+			return 1;
+		}
+	}
+
+	Bench_Base* base = NULL;
+	int base_num = 0;
+	if(base_name){
+		base = calloc(MAX_BASE, sizeof(Bench_Base));
+		if(base == NULL || (base_num = load_base(base_name, base)) < 0)
+			return 1;
+	}
+
+	host_port_init();
+	host_sensor_init();
+	bench_kernel_init();
+
+	Bench_Result* res = calloc(bench_kernel_num, sizeof(Bench_Result));
+	double* sample = calloc(_samples, sizeof(double));
+	if(res == NULL || sample == NULL){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	int num = 0;
+	for(int i = 0 ; i < bench_kernel_num ; i++){
+		if(selected(&bench_kernel[i], pattern, path))
+			bench_run(&bench_kernel[i], &res[num++], sample);
+	}
+
+	int slower = 0;
+	printf("%-34s %6s %9s %9s %9s %9s %9s %7s", "kernel", "path", "min", "p50", "p90", "p99", "max", "load");
+	if(base)
+		printf(" %9s %7s", "base p50", "change");
+	printf("\n");
+	for(int i = 0 ; i < num ; i++){
+		const Bench_Result* r = &res[i];
+
+		/* the share of a host cpu the kernel takes at its rate */
+		printf("%-34s %6s %9.1f %9.1f %9.1f %9.1f %9.1f %6.3f%%", r->kernel->name, r->kernel->path,
+			r->min, r->p50, r->p90, r->p99, r->max, r->p50*path_rate(r->kernel->path)*1e-7);
+		if(base){
+			const Bench_Base* b = find_base(base, base_num, r->kernel->name);
+			if(b){
+				double change = 100.0*(r->p50 - b->p50)/b->p50;
+				double change_min = 100.0*(r->min - b->min)/b->min;
+
+				printf(" %9.1f %+6.1f%%", b->p50, change);
+				if(change > threshold && change_min > threshold){
+					printf("  slower");
+					slower++;
+				}else if(change < -threshold && change_min < -threshold){
+					printf("  faster");
+				}
+			}else{
+				printf(" %9s", "new");
+			}
+		}
+		printf("\n");
+	}
+	printf("ns per call over %d batches of about %.0f us after %.0f ms warm-up\n", _samples, _target_us, _warmup_ms);
+
+	if(csv_name){
+		FILE* fp = strcmp(csv_name, "-") == 0 ? stdout : fopen(csv_name, "w");
+
+		if(fp == NULL){
+			perror(csv_name);
+			return 1;
+		}
+		fprintf(fp, "kernel,path,calls,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+		for(int i = 0 ; i < num ; i++){
+			const Bench_Result* r = &res[i];
+			fprintf(fp, "%s,%s,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", r->kernel->name, r->kernel->path,
+				r->calls, r->mean, r->min, r->p50, r->p90, r->p99, r->max);
+		}
+		if(fp != stdout)
+			fclose(fp);
+	}
+	if(base && slower)
+		printf("%d kernel%s slower than %s by more than %.1f%%\n", slower, slower > 1 ? "s" : "", base_name, threshold);
+
+	free(res);
+	free(sample);
+	free(base);
+
+	return slower ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * File      : bench.h
+ *
+ * A kernel is timed in batches: run(n) makes n calls of the code under
+ * test on the inputs prepared by setup(), so the harness only reads the
+ * clock around a batch. Results a call would otherwise throw away go to
+ * bench_sink, so the compiler can not drop the call.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdint.h>
+
+/* the rate the kernel runs at on the target (copter_main.h periods) */
+#define BENCH_PATH_1K		"1kHz"		/* fast loop: sensors, filters, LESO */
+#define BENCH_PATH_500		"500Hz"		/* AHRS_PERIOD */
+#define BENCH_PATH_250		"250Hz"		/* CONTROL_PERIOD, EKF_PERIOD */
+#define BENCH_PATH_100		"100Hz"		/* POS_EST_PERIOD */
+
+typedef struct
+{
+	const char* name;
+	const char* path;
+	void (*setup)(void);		/* may be NULL */
+	void (*run)(uint32_t n);
+}Bench_Kernel;
+
+extern const Bench_Kernel bench_kernel[];
+extern const int bench_kernel_num;
+
+extern volatile float bench_sink;
+
+/* make the inputs the kernels cycle through */
+void bench_kernel_init(void);
+
+#endif
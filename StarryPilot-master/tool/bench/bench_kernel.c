@@ -0,0 +1,821 @@
+/*
+ * File      : bench_kernel.c
+ *
+ * The kernels of the fast loop (1 kHz), the attitude estimator (500 Hz),
+ * the controller and ekf (250 Hz) and the position kf (100 Hz). Each call
+ * takes the next of BENCH_RING inputs, recorded from a slow tumble with
+ * sensor noise, so data dependent paths and branches see varying data.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "global.h"
+#include "quaternion.h"
+#include "ap_math.h"
+#include "light_matrix.h"
+#include "butter.h"
+#include "fir.h"
+#include "kf.h"
+#include "ekf.h"
+#include "AHRS.h"
+#include "imu_integrator.h"
+#include "adrc.h"
+#include "adrc_att.h"
+#include "att_pid.h"
+#include "mixer.h"
+#include "att_estimator.h"
+#include "uMCN.h"
+#include "bench.h"
+
+#define BENCH_RING			256
+#define FIR_ORDER			16
+
+volatile float bench_sink;
+
+/* control_main.c defines these on target */
+MCN_DEFINE(ADRC, sizeof(ADRC_Log));
+VEHICLE_STATE ADRC_Log adrc_log;
+
+MCN_DECLARE(SENSOR_ACC);
+MCN_DECLARE(SENSOR_MAG);
+MCN_DECLARE(ATT_QUATERNION);
+MCN_DECLARE(ATT_EULER);
+
+typedef struct
+{
+	float gyr[3];		/* rad/s */
+	float acc[3];		/* m/s^2, -g when level */
+	float mag[3];		/* gauss */
+	quaternion q;
+	Euler e;
+	float err[3];		/* attitude error, rad */
+	float v;			/* a scalar signal */
+}Bench_Input;
+
+static Bench_Input _in[BENCH_RING];
+static uint32_t _idx;
+
+static float _randn(void)
+{
+	float u1 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+	float u2 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+
+	return sqrtf(-2.0f*logf(u1)) * cosf(2.0f*PI*u2);
+}
+
+static void _make_input(void)
+{
+	static int done;
+	const float mag_ned[3] = {0.25f, 0.0f, 0.43f};
+	const float g_ned[3] = {0.0f, 0.0f, -GRAVITY_MSS};
+
+	if(done)
+		return;
+	srand(1);
+	for(int i = 0 ; i < BENCH_RING ; i++){
+		Bench_Input* in = &_in[i];
+		float t = i * 0.004f;
+
+		in->e.roll = 0.3f*sinf(2.0f*t);
+		in->e.pitch = 0.2f*sinf(3.0f*t + 1.0f);
+		in->e.yaw = 1.0f*sinf(0.5f*t);
+		quaternion_fromEuler(in->e, &in->q);
+		in->gyr[0] = 0.6f*cosf(2.0f*t) + 0.01f*_randn();
+		in->gyr[1] = 0.6f*cosf(3.0f*t + 1.0f) + 0.01f*_randn();
+		in->gyr[2] = 0.5f*cosf(0.5f*t) + 0.01f*_randn();
+		quaternion_inv_rotateVector(&in->q, g_ned, in->acc);
+		quaternion_inv_rotateVector(&in->q, mag_ned, in->mag);
+		for(int k = 0 ; k < 3 ; k++){
+			in->acc[k] += 0.1f*_randn();
+			in->mag[k] += 0.005f*_randn();
+			in->err[k] = 0.05f*_randn();
+		}
+		in->v = sinf(10.0f*t) + 0.1f*_randn();
+	}
+	done = 1;
+}
+
+static inline const Bench_Input* _next(void)
+{
+	return &_in[_idx++ & (BENCH_RING-1)];
+}
+
+/**************************** math ****************************/
+static void run_quaternion_mult(uint32_t n)
+{
+	quaternion r;
+
+	while(n--){
+		const Bench_Input* a = _next();
+		quaternion_mult(&r, &a->q, &_in[(_idx+17) & (BENCH_RING-1)].q);
+		bench_sink = r.w;
+	}
+}
+
+static void run_quaternion_normalize(uint32_t n)
+{
+	while(n--){
+		quaternion q = _next()->q;
+		q.w *= 1.001f;
+		quaternion_normalize(&q);
+		bench_sink = q.w;
+	}
+}
+
+static void run_quaternion_rotateVector(uint32_t n)
+{
+	float v[3];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		quaternion_rotateVector(&a->q, a->acc, v);
+		bench_sink = v[0];
+	}
+}
+
+static void run_quaternion_inv_rotateVector(uint32_t n)
+{
+	float v[3];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		quaternion_inv_rotateVector(&a->q, a->mag, v);
+		bench_sink = v[0];
+	}
+}
+
+static void run_quaternion_toEuler(uint32_t n)
+{
+	Euler e;
+
+	while(n--){
+		quaternion_toEuler(&_next()->q, &e);
+		bench_sink = e.yaw;
+	}
+}
+
+static void run_quaternion_fromEuler(uint32_t n)
+{
+	quaternion q;
+
+	while(n--){
+		quaternion_fromEuler(_next()->e, &q);
+		bench_sink = q.w;
+	}
+}
+
+static void run_quaternion_fromTwoVectorRotation(uint32_t n)
+{
+	quaternion q;
+
+	while(n--){
+		const Bench_Input* a = _next();
+		quaternion_fromTwoVectorRotation(&q, a->acc, a->mag);
+		bench_sink = q.w;
+	}
+}
+
+static void run_math_rsqrt(uint32_t n)
+{
+	while(n--){
+		float v = _next()->v;
+		bench_sink = math_rsqrt(1.0f + v*v);
+	}
+}
+
+static void run_Vector3_Normalize(uint32_t n)
+{
+	float v[3];
+
+	while(n--){
+		Vector3_Normalize(v, _next()->acc);
+		bench_sink = v[2];
+	}
+}
+
+static void run_Vector3_CrossProduct(uint32_t n)
+{
+	float v[3];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		Vector3_CrossProduct(v, a->acc, a->mag);
+		bench_sink = v[1];
+	}
+}
+
+/**************************** light_matrix ****************************/
+static Mat _a2, _b2, _c2, _a3, _b3, _c3;
+
+static void setup_mat(void)
+{
+	static int done;
+	float a2[] = {2.0f, 0.5f, 0.5f, 1.0f};
+	float a3[] = {4.0f, 1.0f, 0.5f, 1.0f, 3.0f, 0.2f, 0.5f, 0.2f, 2.0f};
+
+	if(done)
+		return;
+	MatCreate(&_a2, 2, 2);
+	MatCreate(&_b2, 2, 2);
+	MatCreate(&_c2, 2, 2);
+	MatCreate(&_a3, 3, 3);
+	MatCreate(&_b3, 3, 3);
+	MatCreate(&_c3, 3, 3);
+	MatSetVal(&_a2, a2);
+	MatSetVal(&_b2, a2);
+	MatSetVal(&_a3, a3);
+	MatSetVal(&_b3, a3);
+	done = 1;
+}
+
+static void run_MatMul_2x2(uint32_t n)
+{
+	while(n--){
+		_a2.element[0][0] = 2.0f + 0.1f*_next()->v;
+		MatMul(&_a2, &_b2, &_c2);
+		bench_sink = _c2.element[1][1];
+	}
+}
+
+static void run_MatAdd_2x2(uint32_t n)
+{
+	while(n--){
+		_a2.element[0][0] = 2.0f + 0.1f*_next()->v;
+		MatAdd(&_a2, &_b2, &_c2);
+		bench_sink = _c2.element[0][0];
+	}
+}
+
+static void run_MatTrans_2x2(uint32_t n)
+{
+	while(n--){
+		_a2.element[0][1] = 0.5f + 0.1f*_next()->v;
+		MatTrans(&_a2, &_c2);
+		bench_sink = _c2.element[1][0];
+	}
+}
+
+static void run_MatInv_2x2(uint32_t n)
+{
+	while(n--){
+		_a2.element[0][0] = 2.0f + 0.1f*_next()->v;
+		MatInv(&_a2, &_c2);
+		bench_sink = _c2.element[1][1];
+	}
+}
+
+static void run_MatMul_3x3(uint32_t n)
+{
+	while(n--){
+		_a3.element[0][0] = 4.0f + 0.1f*_next()->v;
+		MatMul(&_a3, &_b3, &_c3);
+		bench_sink = _c3.element[2][2];
+	}
+}
+
+static void run_MatInv_3x3(uint32_t n)
+{
+	while(n--){
+		_a3.element[0][0] = 4.0f + 0.1f*_next()->v;
+		MatInv(&_a3, &_c3);
+		bench_sink = _c3.element[2][2];
+	}
+}
+
+/**************************** filters ****************************/
+static Butter2 _butter2;
+static Butter3* _butter3;
+static FIR _fir;
+static float _fir_coeff[FIR_ORDER+1];
+static float _fir_buffer[FIR_ORDER+1];
+
+static void setup_filter(void)
+{
+	/* 30Hz at 1kHz, as filter.c */
+	float b[4] = {0.0007f, 0.0021f, 0.0021f, 0.0007f};
+	float a[4] = {1.0f, -2.6236f, 2.3147f, -0.6855f};
+
+	butter2_set_cutoff_frequency(&_butter2, 1000, 30);
+	butter2_reset(&_butter2, 0.0f);
+	if(_butter3 == NULL)
+		_butter3 = butter3_filter_create(b, a);
+	for(int i = 0 ; i <= FIR_ORDER ; i++)
+		_fir_coeff[i] = 1.0f / (FIR_ORDER+1);
+	fir_init(&_fir, FIR_ORDER, _fir_coeff, _fir_buffer);
+}
+
+static void run_butter2_filter_process(uint32_t n)
+{
+	while(n--){
+		bench_sink = butter2_filter_process(&_butter2, _next()->v);
+	}
+}
+
+static void run_butter3_filter_process(uint32_t n)
+{
+	while(n--){
+		bench_sink = butter3_filter_process(_next()->v, _butter3);
+	}
+}
+
+static void run_fir_filter_process(uint32_t n)
+{
+	while(n--){
+		bench_sink = fir_filter_process(&_fir, _next()->v);
+	}
+}
+
+/**************************** imu integrator ****************************/
+static IMU_Integrator _imu_integ;
+static uint64_t _imu_time_us;
+
+static void setup_imu_integrator(void)
+{
+	imu_integrator_reset(&_imu_integ, 4);
+	_imu_time_us = 1000;
+}
+
+/* one sample of the fast loop, closing an interval every 4th */
+static void run_imu_integrator_input(uint32_t n)
+{
+	IMU_Delta imu_delta;
+
+	while(n--){
+		const Bench_Input* a = _next();
+
+		_imu_time_us += 1000;
+		if(imu_integrator_input(&_imu_integ, a->gyr, a->acc, _imu_time_us)){
+			imu_integrator_output(&_imu_integ, &imu_delta);
+			bench_sink = imu_delta.delta_ang[0];
+		}
+	}
+}
+
+/**************************** AHRS ****************************/
+static quaternion _ahrs_q;
+
+static void setup_ahrs(void)
+{
+	AHRS_reset(&_ahrs_q, _in[0].acc, _in[0].mag);
+}
+
+static void run_AHRS_update(uint32_t n)
+{
+	while(n--){
+		const Bench_Input* a = _next();
+		AHRS_update(&_ahrs_q, a->gyr, a->acc, a->mag, 0.002f);
+	}
+	bench_sink = _ahrs_q.w;
+}
+
+static void run_MahonyAHRS_update(uint32_t n)
+{
+	while(n--){
+		const Bench_Input* a = _next();
+		MahonyAHRS_update(&_ahrs_q, a->gyr, a->acc, a->mag, 0.002f);
+	}
+	bench_sink = _ahrs_q.w;
+}
+
+static void run_MARG_AHRS_update(uint32_t n)
+{
+	while(n--){
+		const Bench_Input* a = _next();
+		MARG_AHRS_update(&_ahrs_q, a->gyr[0], a->gyr[1], a->gyr[2], -a->acc[0], -a->acc[1], -a->acc[2],
+			a->mag[0], a->mag[1], a->mag[2], 0.002f);
+	}
+	bench_sink = _ahrs_q.w;
+}
+
+static void run_AHRS_gyr_acc_fusion(uint32_t n)
+{
+	while(n--){
+		const Bench_Input* a = _next();
+		AHRS_gyr_acc_fusion(&_ahrs_q, a->gyr, a->acc, 0.002f);
+	}
+	bench_sink = _ahrs_q.w;
+}
+
+static void run_AHRS_mag_fusion(uint32_t n)
+{
+	while(n--){
+		AHRS_mag_fusion(&_ahrs_q, _next()->mag, 0.002f);
+	}
+	bench_sink = _ahrs_q.w;
+}
+
+/**************************** kf / ekf ****************************/
+static KF_Def _kf;
+static EKF_Def _ekf;
+
+/* Predict alone lets P grow without bound and Update/Correct alone lets it
+ * shrink into denormals, so these kernels go back to the state setup left
+ * each time the input ring wraps */
+static float _kf_x0[2], _kf_P0[4];
+static float _ekf_X0[STATE_AZ_BIAS+1], _ekf_P0[(STATE_AZ_BIAS+1)*(STATE_AZ_BIAS+1)];
+
+/* one axis of the position kf, as pos_est_init */
+static void setup_kf(void)
+{
+	static int created;
+	float dT = 0.01f;
+	float F[] = {1, dT, 0, 1};
+	float B[] = {0, dT};
+	float H[] = {1, 0, 0, 1};
+	float Q[] = {0.05f*0.05f*dT*dT, 0, 0, 0.1f*0.1f*dT*dT};
+	float R[] = {1.0f, 0, 0, 0.2f*0.2f};
+	float x[] = {0, 0};
+
+	if(!created){
+		KF_Create(&_kf, 2, 1);
+		created = 1;
+	}
+	KF_Init(&_kf, F, B, H, Q, Q, R, x, true, dT);
+	for(int i = 0 ; i < 2 ; i++){
+		_kf_x0[i] = _kf.x.element[i][0];
+		_kf_P0[2*i] = _kf.P.element[i][0];
+		_kf_P0[2*i+1] = _kf.P.element[i][1];
+	}
+}
+
+static inline void _kf_restore(void)
+{
+	if((_idx & (BENCH_RING-1)) == 0){
+		MatSetVal(&_kf.x, _kf_x0);
+		MatSetVal(&_kf.P, _kf_P0);
+	}
+}
+
+static void run_KF_Predict(uint32_t n)
+{
+	while(n--){
+		_kf_restore();
+		_kf.u.element[0][0] = _next()->v;
+		KF_Predict(&_kf);
+	}
+	bench_sink = _kf.x.element[0][0];
+}
+
+static void run_KF_Update(uint32_t n)
+{
+	while(n--){
+		_kf_restore();
+		const Bench_Input* a = _next();
+		_kf.z.element[0][0] = a->v;
+		_kf.z.element[1][0] = a->gyr[0];
+		KF_Update(&_kf);
+	}
+	bench_sink = _kf.x.element[0][0];
+}
+
+static void setup_ekf(void)
+{
+	static int init;
+
+	if(!init){
+		EKF14_Init(&_ekf, 0.004f);
+		init = 1;
+	}
+	/* EKF14_Reset takes the initial attitude from the sensor topics */
+	mcn_publish(MCN_ID(SENSOR_ACC), _in[0].acc);
+	mcn_publish(MCN_ID(SENSOR_MAG), _in[0].mag);
+	EKF14_Reset(&_ekf);
+	memcpy(_ekf_X0, _ekf.X.pData, sizeof(_ekf_X0));
+	memcpy(_ekf_P0, _ekf.P.pData, sizeof(_ekf_P0));
+}
+
+static inline void _ekf_restore(void)
+{
+	if((_idx & (BENCH_RING-1)) == 0){
+		memcpy(_ekf.X.pData, _ekf_X0, sizeof(_ekf_X0));
+		memcpy(_ekf.P.pData, _ekf_P0, sizeof(_ekf_P0));
+	}
+}
+
+/* the inputs state_est_update gives it */
+static void _ekf_input(const Bench_Input* a)
+{
+	for(int k = 0 ; k < 3 ; k++){
+		MAT_ELEMENT(_ekf.U, k, 0) = a->gyr[k];
+		MAT_ELEMENT(_ekf.U, 3+k, 0) = a->acc[k];
+		MAT_ELEMENT(_ekf.U, 6+k, 0) = a->mag[k];
+	}
+	MAT_ELEMENT(_ekf.Z, 0, 0) = 0.0f;
+	MAT_ELEMENT(_ekf.Z, 1, 0) = 0.0f;
+	MAT_ELEMENT(_ekf.Z, 2, 0) = a->v;
+	MAT_ELEMENT(_ekf.Z, 3, 0) = 0.0f;
+	MAT_ELEMENT(_ekf.Z, 4, 0) = 0.0f;
+	MAT_ELEMENT(_ekf.Z, 5, 0) = -1.0f;
+	MAT_ELEMENT(_ekf.Z, 6, 0) = 1.0f;
+	MAT_ELEMENT(_ekf.Z, 7, 0) = 0.0f;
+}
+
+static void run_EKF14_SerialPrediction(uint32_t n)
+{
+	while(n--){
+		_ekf_restore();
+		_ekf_input(_next());
+		EKF14_SerialPrediction(&_ekf, 0xFFFF);
+	}
+	bench_sink = MAT_ELEMENT(_ekf.X, STATE_Q0, 0);
+}
+
+static void run_EKF14_Correct(uint32_t n)
+{
+	while(n--){
+		_ekf_restore();
+		_ekf_input(_next());
+		EKF14_Correct(&_ekf);
+	}
+	bench_sink = MAT_ELEMENT(_ekf.X, STATE_Q0, 0);
+}
+
+/* one state_est_update step */
+static void run_EKF14_step(uint32_t n)
+{
+	while(n--){
+		_ekf_input(_next());
+		EKF14_SerialPrediction(&_ekf, 0xFFFF);
+		EKF14_Correct(&_ekf);
+	}
+	bench_sink = MAT_ELEMENT(_ekf.X, STATE_Q0, 0);
+}
+
+/**************************** adrc / pid ****************************/
+static ADRC_TD_Def _td;
+static TD_Controller_Def _td_ctrl;
+static ADRC_LESO_Def _leso;
+static ADRC_ESO_Def _eso;
+static ADRC_NLSEF_Def _nlsef;
+static ADRC_TD3_Def _td3;
+static ADRC_TD3_Def _td3_ctrl;
+static ADRC_LESO3_Def _leso3;
+static ADRC_NLSEF3_Def _nlsef3;
+
+/* the default ADRC_ATT parameters */
+static void setup_adrc(void)
+{
+	float h = 0.004f;
+
+	adrc_td_init(&_td, h, 1000.0f, h);
+	adrc_td_control_init(&_td_ctrl, h, 25.0f, 20.0f*h);
+	adrc_leso_init(&_leso, 0.001f, 120.0f, 400.0f);
+	adrc_eso_init(&_eso, 0.001f, 70.0f, 2500.0f, 0.25f, 0.1f, 400.0f);
+	adrc_nlsef_init(&_nlsef, h, 100.0f, 50.0f*h, 0.01f);
+	adrc_td3_init(&_td3, 3, h, 1000.0f, h);
+	adrc_td3_init(&_td3_ctrl, 3, h, 25.0f, 20.0f*h);
+	adrc_leso3_init(&_leso3, 3, 0.001f, 120.0f, 400.0f);
+	adrc_nlsef3_init(&_nlsef3, 3, h, 100.0f, 50.0f*h, 0.01f);
+}
+
+static void run_adrc_td(uint32_t n)
+{
+	while(n--){
+		adrc_td(&_td, _next()->v);
+	}
+	bench_sink = _td.v1;
+}
+
+static void run_adrc_td_control(uint32_t n)
+{
+	while(n--){
+		bench_sink = adrc_td_control(&_td_ctrl, _next()->err[0]);
+	}
+}
+
+static void run_adrc_leso(uint32_t n)
+{
+	while(n--){
+		adrc_leso(&_leso, _next()->gyr[0]);
+	}
+	bench_sink = _leso.z1;
+}
+
+static void run_adrc_eso(uint32_t n)
+{
+	while(n--){
+		adrc_eso(&_eso, _next()->gyr[0]);
+	}
+	bench_sink = _eso.z1;
+}
+
+static void run_adrc_nlsef(uint32_t n)
+{
+	while(n--){
+		const Bench_Input* a = _next();
+		bench_sink = adrc_nlsef(&_nlsef, a->err[0], a->gyr[0]);
+	}
+}
+
+/* the three axis parts run all of roll, pitch and yaw per call, compare
+ * with three calls of the scalar ones */
+static void run_adrc_td3(uint32_t n)
+{
+	while(n--){
+		adrc_td3(&_td3, _next()->gyr);
+	}
+	bench_sink = _td3.v1[0];
+}
+
+static void run_adrc_td3_control(uint32_t n)
+{
+	while(n--){
+		adrc_td3_control(&_td3_ctrl, _next()->err);
+	}
+	bench_sink = _td3_ctrl.v2[0];
+}
+
+static void run_adrc_leso3(uint32_t n)
+{
+	while(n--){
+		adrc_leso3(&_leso3, _next()->gyr);
+	}
+	bench_sink = _leso3.z1[0];
+}
+
+static void run_adrc_nlsef3(uint32_t n)
+{
+	float u0[3];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		adrc_nlsef3(&_nlsef3, a->err, a->gyr, u0);
+		bench_sink = u0[0];
+	}
+}
+
+static void setup_att_ctrl(void)
+{
+	static int advertised;
+
+	/* adrc_att_control publishes its log as on target */
+	if(!advertised){
+		mcn_advertise(MCN_ID(ADRC));
+		advertised = 1;
+	}
+	adrc_att_init(0.004f);
+	adrc_att_reset(0.004f);
+	att_pid_init(0.002f);
+}
+
+static void run_adrc_att_observer_update(uint32_t n)
+{
+	while(n--){
+		adrc_att_observer_update(_next()->gyr, 0.5f);
+	}
+}
+
+static void run_adrc_att_control(uint32_t n)
+{
+	float out[3];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		adrc_att_control((float*)a->err, a->gyr, out, 0.5f);
+		bench_sink = out[0];
+	}
+}
+
+static void run_att_pid_update(uint32_t n)
+{
+	float out[3], err[3];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		err[0] = Rad2Deg(a->err[0]);
+		err[1] = Rad2Deg(a->err[1]);
+		err[2] = Rad2Deg(a->err[2]);
+		att_pid_update(err, out, a->gyr, 0.004f, 0.5f);
+		bench_sink = out[0];
+	}
+}
+
+/**************************** mixer ****************************/
+static Mixer_Def _mixer_yaw, _mixer_airmode;
+
+static void setup_mixer(void)
+{
+	mixer_init(&_mixer_yaw, mixer_frame_geometry(frame_type_3), 6, 0.0f, 0.9f, MIXER_DESAT_YAW);
+	mixer_init(&_mixer_airmode, mixer_frame_geometry(frame_type_3), 6, 0.0f, 0.9f, MIXER_DESAT_AIRMODE);
+}
+
+/* commands large enough to saturate now and then, hexrotor */
+static void _mixer_bench(const Mixer_Def* mixer, uint32_t n)
+{
+	float ctrl[MIXER_AXIS_NUM], out[MIXER_MAX_MOTOR];
+
+	while(n--){
+		const Bench_Input* a = _next();
+		ctrl[MIXER_ROLL] = 4.0f*a->err[0];
+		ctrl[MIXER_PITCH] = 4.0f*a->err[1];
+		ctrl[MIXER_YAW] = 4.0f*a->err[2];
+		ctrl[MIXER_THRUST] = 0.5f + 0.4f*a->v;
+		mixer_run(mixer, ctrl, out);
+		bench_sink = out[0];
+	}
+}
+
+static void run_mixer_run(uint32_t n)
+{
+	_mixer_bench(&_mixer_yaw, n);
+}
+
+static void run_mixer_run_airmode(uint32_t n)
+{
+	_mixer_bench(&_mixer_airmode, n);
+}
+
+/**************************** uMCN ****************************/
+static void setup_att_topic(void)
+{
+	/* as attitude_est_init advertises them */
+	mcn_advertise(MCN_ID(ATT_QUATERNION));
+	mcn_advertise_derived(MCN_ID(ATT_EULER), MCN_ID(ATT_QUATERNION), attitude_est_quaternion_to_euler);
+}
+
+/* the end of attitude_est_run, ATT_EULER is not transformed */
+static void run_att_topic_publish(uint32_t n)
+{
+	while(n--){
+		mcn_publish(MCN_ID(ATT_QUATERNION), &_next()->q);
+	}
+}
+
+/* a reader of ATT_EULER after every publish, transformed each time */
+static void run_att_euler_copy(uint32_t n)
+{
+	Euler e;
+
+	while(n--){
+		mcn_publish(MCN_ID(ATT_QUATERNION), &_next()->q);
+		mcn_copy_from_hub(MCN_ID(ATT_EULER), &e);
+		bench_sink = e.roll;
+	}
+}
+
+const Bench_Kernel bench_kernel[] = {
+	/* fast loop */
+	{"butter2_filter_process",		BENCH_PATH_1K,	setup_filter,	run_butter2_filter_process},
+	{"butter3_filter_process",		BENCH_PATH_1K,	setup_filter,	run_butter3_filter_process},
+	{"fir_filter_process",			BENCH_PATH_1K,	setup_filter,	run_fir_filter_process},
+	{"imu_integrator_input",		BENCH_PATH_1K,	setup_imu_integrator,	run_imu_integrator_input},
+	{"adrc_leso",					BENCH_PATH_1K,	setup_adrc,		run_adrc_leso},
+	{"adrc_eso",					BENCH_PATH_1K,	setup_adrc,		run_adrc_eso},
+	{"adrc_leso3",					BENCH_PATH_1K,	setup_adrc,		run_adrc_leso3},
+	{"adrc_att_observer_update",	BENCH_PATH_1K,	setup_att_ctrl,	run_adrc_att_observer_update},
+	/* attitude estimator */
+	{"AHRS_update",					BENCH_PATH_500,	setup_ahrs,		run_AHRS_update},
+	{"MahonyAHRS_update",			BENCH_PATH_500,	setup_ahrs,		run_MahonyAHRS_update},
+	{"MARG_AHRS_update",			BENCH_PATH_500,	setup_ahrs,		run_MARG_AHRS_update},
+	{"AHRS_gyr_acc_fusion",			BENCH_PATH_500,	setup_ahrs,		run_AHRS_gyr_acc_fusion},
+	{"AHRS_mag_fusion",				BENCH_PATH_500,	setup_ahrs,		run_AHRS_mag_fusion},
+	{"quaternion_mult",				BENCH_PATH_500,	NULL,			run_quaternion_mult},
+	{"quaternion_normalize",		BENCH_PATH_500,	NULL,			run_quaternion_normalize},
+	{"quaternion_rotateVector",		BENCH_PATH_500,	NULL,			run_quaternion_rotateVector},
+	{"quaternion_inv_rotateVector",	BENCH_PATH_500,	NULL,			run_quaternion_inv_rotateVector},
+	{"quaternion_toEuler",			BENCH_PATH_500,	NULL,			run_quaternion_toEuler},
+	{"quaternion_fromEuler",		BENCH_PATH_500,	NULL,			run_quaternion_fromEuler},
+	{"quaternion_fromTwoVectorRotation", BENCH_PATH_500, NULL,		run_quaternion_fromTwoVectorRotation},
+	{"math_rsqrt",					BENCH_PATH_500,	NULL,			run_math_rsqrt},
+	{"Vector3_Normalize",			BENCH_PATH_500,	NULL,			run_Vector3_Normalize},
+	{"Vector3_CrossProduct",		BENCH_PATH_500,	NULL,			run_Vector3_CrossProduct},
+	{"att_topic_publish",			BENCH_PATH_500,	setup_att_topic,	run_att_topic_publish},
+	{"att_euler_copy",				BENCH_PATH_500,	setup_att_topic,	run_att_euler_copy},
+	/* controller and ekf */
+	{"adrc_td",						BENCH_PATH_250,	setup_adrc,		run_adrc_td},
+	{"adrc_td_control",				BENCH_PATH_250,	setup_adrc,		run_adrc_td_control},
+	{"adrc_nlsef",					BENCH_PATH_250,	setup_adrc,		run_adrc_nlsef},
+	{"adrc_td3",					BENCH_PATH_250,	setup_adrc,		run_adrc_td3},
+	{"adrc_td3_control",			BENCH_PATH_250,	setup_adrc,		run_adrc_td3_control},
+	{"adrc_nlsef3",					BENCH_PATH_250,	setup_adrc,		run_adrc_nlsef3},
+	{"adrc_att_control",			BENCH_PATH_250,	setup_att_ctrl,	run_adrc_att_control},
+	{"att_pid_update",				BENCH_PATH_250,	setup_att_ctrl,	run_att_pid_update},
+	{"mixer_run",					BENCH_PATH_250,	setup_mixer,	run_mixer_run},
+	{"mixer_run_airmode",			BENCH_PATH_250,	setup_mixer,	run_mixer_run_airmode},
+	{"EKF14_SerialPrediction",		BENCH_PATH_250,	setup_ekf,		run_EKF14_SerialPrediction},
+	{"EKF14_Correct",				BENCH_PATH_250,	setup_ekf,		run_EKF14_Correct},
+	{"EKF14_step",					BENCH_PATH_250,	setup_ekf,		run_EKF14_step},
+	/* position kf */
+	{"KF_Predict",					BENCH_PATH_100,	setup_kf,		run_KF_Predict},
+	{"KF_Update",					BENCH_PATH_100,	setup_kf,		run_KF_Update},
+	{"MatMul_2x2",					BENCH_PATH_100,	setup_mat,		run_MatMul_2x2},
+	{"MatAdd_2x2",					BENCH_PATH_100,	setup_mat,		run_MatAdd_2x2},
+	{"MatTrans_2x2",				BENCH_PATH_100,	setup_mat,		run_MatTrans_2x2},
+	{"MatInv_2x2",					BENCH_PATH_100,	setup_mat,		run_MatInv_2x2},
+	{"MatMul_3x3",					BENCH_PATH_100,	setup_mat,		run_MatMul_3x3},
+	{"MatInv_3x3",					BENCH_PATH_100,	setup_mat,		run_MatInv_3x3},
+};
+
+const int bench_kernel_num = sizeof(bench_kernel)/sizeof(Bench_Kernel);
+
+/* the inputs are shared by all kernels */
+void bench_kernel_init(void)
+{
+	_make_input();
+	_idx = 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * File      : decl_check.c
+ *
+ * Host check of the cached declination lookup (declination.c) against the
+ * uncached one, which reads the four corners from the compressed table on
+ * every call.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ap_math.h"
+#include "declination.h"
+
+/* same as ap_math.c */
+float constrain_float(float amt, float low, float high)
+{
+	if (isnan(amt)) {
+		return (low+high)*0.5f;
+	}
+	return ((amt)<(low)?(low):((amt)>(high)?(high):(amt)));
+}
+
+/* compass_get_declination before the cell cache, lat 90 / lon 180 excluded
+ * since they index past the table there */
+static float ref_declination(double lat, double lon)
+{
+	int16_t decSW, decSE, decNW, decNE, lonmin, latmin;
+	uint8_t latmin_index,lonmin_index;
+	float decmin, decmax;
+
+	lat = constrain_float(lat, -90, 90);
+	lon = constrain_float(lon, -180, 180);
+
+	latmin = floorf(lat/5)*5;
+	lonmin = floorf(lon/5)*5;
+
+	latmin_index= (90+latmin)/5;
+	lonmin_index= (180+lonmin)/5;
+
+	decSW = compass_get_lookup_value(latmin_index, lonmin_index);
+	decSE = compass_get_lookup_value(latmin_index, lonmin_index+1);
+	decNE = compass_get_lookup_value(latmin_index+1, lonmin_index+1);
+	decNW = compass_get_lookup_value(latmin_index+1, lonmin_index);
+
+	decmin = (lon - lonmin) / 5 * (decSE - decSW) + decSW;
+	decmax = (lon - lonmin) / 5 * (decNE - decNW) + decNW;
+
+	return (lat - latmin) / 5 * (decmax - decmin) + decmin;
+}
+
+/* lat 90 and lon 180 are clamped into the last cell, so there the lookup
+ * interpolates along the last row or column of the table only */
+static float edge_declination(double lat, double lon)
+{
+	int16_t a, b;
+	double f;
+
+	if(lat >= 90.0){
+		int lonmin = (int)floor(lon/5)*5;
+		if(lonmin > 175) lonmin = 175;
+		a = compass_get_lookup_value(36, (180+lonmin)/5);
+		b = compass_get_lookup_value(36, (180+lonmin)/5+1);
+		f = (lon - lonmin) / 5;
+	}else{
+		int latmin = (int)floor(lat/5)*5;
+		a = compass_get_lookup_value((90+latmin)/5, 72);
+		b = compass_get_lookup_value((90+latmin)/5+1, 72);
+		f = (lat - latmin) / 5;
+	}
+	return a + f * (b - a);
+}
+
+static int check_edge(double lat, double lon, long* n)
+{
+	float a = compass_get_declination(lat, lon);
+	float b = edge_declination(lat, lon);
+
+	(*n)++;
+	if(!(fabsf(a - b) < 1e-3f)){
+		printf("edge mismatch at lat %.7f lon %.7f: %f != %f\n", lat, lon, a, b);
+		return 1;
+	}
+	return 0;
+}
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int check(double lat, double lon, long* n)
+{
+	float a = compass_get_declination(lat, lon);
+	float b = ref_declination(lat, lon);
+
+	(*n)++;
+	if(memcmp(&a, &b, sizeof(float)) != 0){
+		printf("mismatch at lat %.7f lon %.7f: %f != %f\n", lat, lon, a, b);
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	long n = 0;
+	int fail = 0;
+	int i, j;
+
+	/* whole globe on a 0.1 degree raster, row by row and column by column
+	 * so that the cache is both hit and missed */
+	for(i = -899 ; i < 900 ; i++){
+		for(j = -1799 ; j < 1800 ; j++){
+			fail |= check(i * 0.1, j * 0.1, &n);
+		}
+	}
+	for(j = -1799 ; j < 1800 ; j++){
+		for(i = -899 ; i < 900 ; i++){
+			fail |= check(i * 0.1, j * 0.1, &n);
+		}
+	}
+	/* random points, jumping between cells */
+	srand(1);
+	for(i = 0 ; i < 1000000 ; i++){
+		double lat = -89.999 + 179.998 * rand() / RAND_MAX;
+		double lon = -179.999 + 359.998 * rand() / RAND_MAX;
+		fail |= check(lat, lon, &n);
+	}
+	/* the poles and the antimeridian must stay inside the table */
+	{
+		float a = compass_get_declination(90.0, 180.0);
+		float b = compass_get_declination(-90.0, -180.0);
+		if(isnan(a) || isnan(b) || fabsf(a) > 180.0f || fabsf(b) > 180.0f){
+			printf("bad value at the table edge: %f %f\n", a, b);
+			fail = 1;
+		}
+	}
+	printf("%ld points compared, %s\n", n, fail ? "FAIL" : "identical");
+
+	/* lat 90 and lon 180, where the former lookup read past the table and
+	 * is not compared: the last row and column of the table, interpolated
+	 * along the edge, and continuous with the points just inside */
+	{
+		long m = 0;
+		int edge_fail = 0;
+
+		for(j = -1800 ; j <= 1800 ; j++){
+			edge_fail |= check_edge(90.0, j * 0.1, &m);
+		}
+		for(i = -900 ; i <= 900 ; i++){
+			edge_fail |= check_edge(i * 0.1, 180.0, &m);
+		}
+		for(j = -1800 ; j <= 1800 ; j++){
+			float a = compass_get_declination(90.0, j * 0.1);
+			float b = compass_get_declination(90.0 - 1e-6, j * 0.1);
+			if(!(fabsf(a - b) < 1e-2f)){
+				printf("step at lat 90 lon %.1f: %f %f\n", j * 0.1, a, b);
+				edge_fail = 1;
+			}
+		}
+		for(i = -900 ; i <= 900 ; i++){
+			float a = compass_get_declination(i * 0.1, 180.0);
+			float b = compass_get_declination(i * 0.1, 180.0 - 1e-6);
+			if(!(fabsf(a - b) < 1e-2f)){
+				printf("step at lon 180 lat %.1f: %f %f\n", i * 0.1, a, b);
+				edge_fail = 1;
+			}
+		}
+		printf("%ld edge points at lat 90 / lon 180, %s\n", m, edge_fail ? "FAIL" : "on the last row/column");
+		fail |= edge_fail;
+	}
+
+	/* a vehicle moving slowly, as after take off */
+	{
+		volatile float sink = 0.0f;
+		int m = 2000000;
+		double t0, t1, t2;
+
+		t0 = now_sec();
+		for(i = 0 ; i < m ; i++){
+			sink += compass_get_declination(47.39 + i * 1e-7, 8.54 + i * 1e-7);
+		}
+		t1 = now_sec();
+		for(i = 0 ; i < m ; i++){
+			sink += ref_declination(47.39 + i * 1e-7, 8.54 + i * 1e-7);
+		}
+		t2 = now_sec();
+		printf("cached %.1f ns/call, uncached %.1f ns/call (host)\n",
+			(t1 - t0) * 1e9 / m, (t2 - t1) * 1e9 / m);
+	}
+
+	return fail;
+}
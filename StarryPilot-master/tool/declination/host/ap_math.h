@@ -0,0 +1,12 @@
+/* host stand-in for starry_fmu/Framework/include/ap_math.h */
+#ifndef __AP_MATH_H__
+#define __AP_MATH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+float constrain_float(float amt, float low, float high);
+
+#endif
@@ -0,0 +1,11 @@
+/* host stand-in for starry_fmu/Framework/include/global.h */
+#ifndef __GLOBAL_H__
+#define __GLOBAL_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* see global.h, the check runs one vehicle */
+#define VEHICLE_STATE
+
+#endif
@@ -0,0 +1,416 @@
+/*
+ * File      : ellipsoid_check.c
+ *
+ * Host check of the single precision ellipsoid fit (ellipsoid_fit.c) used
+ * by the acc/mag calibration, against the former double precision update
+ * of calibration.c and against tool/Calibration/my_ellipsoid_fit.m.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ellipsoid_fit.h"
+
+#define MAX_SAMPLES		10000
+
+typedef struct
+{
+	double ofs[3];
+	double gain[3];		/* ascending */
+	double rot[3][3];	/* transform matrix for radius 1 */
+}result_t;
+
+static float _xyz[MAX_SAMPLES][3];
+
+/************************ former calibration.c update ************************/
+
+typedef struct
+{
+	double V[9];
+	double D[9];
+	double P[9][9];
+	double R;
+}old_obj_t;
+
+static void old_init(old_obj_t *obj)
+{
+	memset(obj, 0, sizeof(old_obj_t));
+	obj->P[0][0] = obj->P[1][1] = obj->P[2][2] = 10.0f;
+	obj->P[3][3] = obj->P[4][4] = obj->P[5][5] = 1.0f;
+	obj->P[6][6] = obj->P[7][7] = obj->P[8][8] = 1.0f;
+	obj->R = 0.001f;
+}
+
+static void old_update(old_obj_t *obj, float val[3])
+{
+	double x = val[0];
+	double y = val[1];
+	double z = val[2];
+
+	obj->D[0] = x*x;
+	obj->D[1] = y*y;
+	obj->D[2] = z*z;
+	obj->D[3] = 2.0f*x*y;
+	obj->D[4] = 2.0f*x*z;
+	obj->D[5] = 2.0f*y*z;
+	obj->D[6] = 2.0f*x;
+	obj->D[7] = 2.0f*y;
+	obj->D[8] = 2.0f*z;
+
+	float DV = 0.0f;
+	for(int i = 0 ; i < 9 ; i++){
+		DV += obj->D[i]*obj->V[i];
+	}
+	float Y = 1.0f - DV;
+
+	double DP[9];
+	for(int i = 0 ; i < 9 ; i++){
+		DP[i] = 0.0f;
+		for(int j = 0 ; j < 9 ; j++){
+			DP[i] += obj->D[j]*obj->P[j][i];
+		}
+	}
+	double DPDT = 0.0f;
+	for(int i = 0 ; i < 9 ; i++){
+		DPDT += DP[i] * obj->D[i];
+	}
+	double S = DPDT + obj->R;
+
+	double K[9];
+	for(int i = 0 ; i < 9 ; i++){
+		K[i] = 0.0f;
+		for(int j = 0 ; j < 9 ; j++){
+			K[i] += obj->P[i][j] * obj->D[j];
+		}
+		K[i] = K[i]/S;
+	}
+	for(int i = 0 ; i < 9 ; i++){
+		obj->V[i] += K[i]*Y;
+	}
+	double KD[9][9];
+	for(int i = 0 ; i < 9 ; i++){
+		for(int j = 0 ; j < 9 ; j++){
+			KD[i][j] = K[i] * obj->D[j];
+		}
+	}
+	double KDP[9][9];
+	for(int i = 0 ; i < 9 ; i++){
+		for(int j = 0 ; j < 9 ; j++){
+			KDP[i][j] = 0.0f;
+			for(int k = 0 ; k < 9 ; k++){
+				KDP[i][j] += KD[i][k] * obj->P[j][k];
+			}
+		}
+	}
+	for(int i = 0 ; i < 9 ; i++){
+		for(int j = 0 ; j < 9 ; j++){
+			obj->P[i][j] -= KDP[i][j];
+		}
+	}
+}
+
+/******************************** solving ***********************************/
+
+/* Jacobi eigen decomposition of a symmetric 3x3, eigenvectors in columns */
+static void eig3(double A[3][3], double val[3], double vec[3][3])
+{
+	double a[3][3];
+	int i, j, k, it;
+
+	memcpy(a, A, sizeof(a));
+	for(i = 0 ; i < 3 ; i++) for(j = 0 ; j < 3 ; j++) vec[i][j] = (i == j);
+
+	for(it = 0 ; it < 100 ; it++){
+		double off = fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2]);
+		if(off < 1e-15) break;
+		for(i = 0 ; i < 2 ; i++){
+			for(j = i+1 ; j < 3 ; j++){
+				double th, c, s;
+				if(fabs(a[i][j]) < 1e-300) continue;
+				th = 0.5 * atan2(2*a[i][j], a[j][j] - a[i][i]);
+				c = cos(th); s = sin(th);
+				for(k = 0 ; k < 3 ; k++){
+					double ki = a[k][i], kj = a[k][j];
+					a[k][i] = c*ki - s*kj;
+					a[k][j] = s*ki + c*kj;
+				}
+				for(k = 0 ; k < 3 ; k++){
+					double ik = a[i][k], jk = a[j][k];
+					a[i][k] = c*ik - s*jk;
+					a[j][k] = s*ik + c*jk;
+				}
+				for(k = 0 ; k < 3 ; k++){
+					double ki = vec[k][i], kj = vec[k][j];
+					vec[k][i] = c*ki - s*kj;
+					vec[k][j] = s*ki + c*kj;
+				}
+			}
+		}
+	}
+	for(i = 0 ; i < 3 ; i++) val[i] = a[i][i];
+	/* ascending */
+	for(i = 0 ; i < 2 ; i++){
+		for(j = i+1 ; j < 3 ; j++){
+			if(val[j] < val[i]){
+				double t = val[i]; val[i] = val[j]; val[j] = t;
+				for(k = 0 ; k < 3 ; k++){ t = vec[k][i]; vec[k][i] = vec[k][j]; vec[k][j] = t; }
+			}
+		}
+	}
+}
+
+static int inv3(double m[3][3], double r[3][3])
+{
+	double det = m[0][0]*(m[1][1]*m[2][2]-m[1][2]*m[2][1])
+			   - m[0][1]*(m[1][0]*m[2][2]-m[1][2]*m[2][0])
+			   + m[0][2]*(m[1][0]*m[2][1]-m[1][1]*m[2][0]);
+	int i, j;
+	if(fabs(det) < 1e-300) return -1;
+	for(i = 0 ; i < 3 ; i++){
+		for(j = 0 ; j < 3 ; j++){
+			int i1 = (j+1)%3, i2 = (j+2)%3, j1 = (i+1)%3, j2 = (i+2)%3;
+			r[i][j] = (m[i1][j1]*m[i2][j2] - m[i1][j2]*m[i2][j1]) / det;
+		}
+	}
+	return 0;
+}
+
+/* cali_solve of calibration.c in double; A is the 4x4 algebraic form */
+static int solve_A(double A[4][4], result_t* res)
+{
+	double B[3][3], invB[3][3], E[3][3], val[3], vec[3][3];
+	double AT44;
+	int i, j, k;
+
+	for(i = 0 ; i < 3 ; i++) for(j = 0 ; j < 3 ; j++) B[i][j] = A[i][j];
+	if(inv3(B, invB)) return -1;
+	for(i = 0 ; i < 3 ; i++){
+		res->ofs[i] = 0;
+		for(j = 0 ; j < 3 ; j++) res->ofs[i] -= invB[i][j]*A[j][3];
+	}
+	/* translate to the center: only AT(4,4) changes besides the zeroed column */
+	AT44 = A[3][3];
+	for(i = 0 ; i < 3 ; i++){
+		AT44 += 2*res->ofs[i]*A[i][3];
+		for(j = 0 ; j < 3 ; j++) AT44 += res->ofs[i]*A[i][j]*res->ofs[j];
+	}
+	for(i = 0 ; i < 3 ; i++) for(j = 0 ; j < 3 ; j++) E[i][j] = -A[i][j]/AT44;
+	eig3(E, val, vec);
+	for(i = 0 ; i < 3 ; i++){
+		if(!(val[i] > 0)) return -1;
+		res->gain[i] = sqrt(1.0/val[i]);
+	}
+	/* rot = vec * diag(1/gain) * vec' */
+	for(i = 0 ; i < 3 ; i++){
+		for(j = 0 ; j < 3 ; j++){
+			res->rot[i][j] = 0;
+			for(k = 0 ; k < 3 ; k++) res->rot[i][j] += vec[i][k]*vec[j][k]/res->gain[k];
+		}
+	}
+	/* gains ascending, eig3 sorts the eigenvalues ascending */
+	{
+		double t = res->gain[0]; res->gain[0] = res->gain[2]; res->gain[2] = t;
+	}
+	return 0;
+}
+
+static int solve_V(const double V[9], result_t* res)
+{
+	double A[4][4] = {
+		{V[0], V[3], V[4], V[6]},
+		{V[3], V[1], V[5], V[7]},
+		{V[4], V[5], V[2], V[8]},
+		{V[6], V[7], V[8], -1},
+	};
+	return solve_A(A, res);
+}
+
+/* my_ellipsoid_fit.m in double */
+static int matlab_fit(float (*xyz)[3], int n, result_t* res)
+{
+	double M[9][10];
+	double b[9], v[10], u[10];
+	int i, j, k;
+
+	memset(M, 0, sizeof(M));
+	for(k = 0 ; k < n ; k++){
+		double x = xyz[k][0], y = xyz[k][1], z = xyz[k][2];
+		double x2 = x*x, y2 = y*y, z2 = z*z;
+		double D[9] = {x2+y2-2*z2, x2-2*y2+z2, 4*x*y, 2*x*z, 2*y*z, 2*x, 2*y, 2*z, 1};
+		double Rk = x2+y2+z2;
+		for(i = 0 ; i < 9 ; i++){
+			for(j = 0 ; j < 9 ; j++) M[i][j] += D[i]*D[j];
+			M[i][9] += D[i]*Rk;
+		}
+	}
+	/* Gauss elimination with partial pivoting */
+	for(i = 0 ; i < 9 ; i++){
+		int p = i;
+		for(k = i+1 ; k < 9 ; k++) if(fabs(M[k][i]) > fabs(M[p][i])) p = k;
+		if(fabs(M[p][i]) < 1e-300) return -1;
+		for(j = 0 ; j < 10 ; j++){ double t = M[i][j]; M[i][j] = M[p][j]; M[p][j] = t; }
+		for(k = i+1 ; k < 9 ; k++){
+			double f = M[k][i]/M[i][i];
+			for(j = i ; j < 10 ; j++) M[k][j] -= f*M[i][j];
+		}
+	}
+	for(i = 8 ; i >= 0 ; i--){
+		double s = M[i][9];
+		for(j = i+1 ; j < 9 ; j++) s -= M[i][j]*b[j];
+		b[i] = s/M[i][i];
+	}
+	/* v = mtxref*[-1/3; b] */
+	u[0] = -1.0/3; for(i = 0 ; i < 9 ; i++) u[i+1] = b[i];
+	v[0] = 3*u[0] + u[1] + u[2];
+	v[1] = 3*u[0] + u[1] - 2*u[2];
+	v[2] = 3*u[0] - 2*u[1] + u[2];
+	v[3] = 2*u[3];
+	for(i = 4 ; i < 10 ; i++) v[i] = u[i];
+	{
+		double nn = v[9];
+		double A[4][4] = {
+			{-v[0], -v[3], -v[4], -v[6]},
+			{-v[3], -v[1], -v[5], -v[7]},
+			{-v[4], -v[5], -v[2], -v[8]},
+			{-v[6], -v[7], -v[8], -nn},
+		};
+		return solve_A(A, res);
+	}
+}
+
+/******************************** report ************************************/
+
+static void print_result(const char* name, const result_t* r)
+{
+	printf("%-14s center % .5f % .5f % .5f  radius %.5f %.5f %.5f\n", name,
+		r->ofs[0], r->ofs[1], r->ofs[2], r->gain[0], r->gain[1], r->gain[2]);
+}
+
+static double diff_result(const result_t* a, const result_t* b)
+{
+	double d = 0, scale = (b->gain[0] + b->gain[1] + b->gain[2]) / 3;
+	int i, j;
+	for(i = 0 ; i < 3 ; i++){
+		d = fmax(d, fabs(a->ofs[i] - b->ofs[i]) / scale);
+		d = fmax(d, fabs(a->gain[i] - b->gain[i]) / scale);
+		for(j = 0 ; j < 3 ; j++) d = fmax(d, fabs(a->rot[i][j] - b->rot[i][j]) * scale);
+	}
+	return d;
+}
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int load(const char* file)
+{
+	FILE* fp = fopen(file, "r");
+	int n = 0;
+
+	if(fp == NULL){
+		printf("can not open %s\n", file);
+		return -1;
+	}
+	while(n < MAX_SAMPLES && fscanf(fp, "%f %f %f", &_xyz[n][0], &_xyz[n][1], &_xyz[n][2]) == 3){
+		n++;
+	}
+	fclose(fp);
+	return n;
+}
+
+static int check_file(const char* file, double tol)
+{
+	old_obj_t old;
+	EllipsoidFit_Def rls, batch;
+	result_t r_old, r_rls, r_batch, r_ref;
+	double V[9];
+	float Vf[9];
+	int n, i, fail = 0;
+
+	n = load(file);
+	if(n <= 0) return 1;
+	printf("%s: %d samples\n", file, n);
+
+	old_init(&old);
+	ellipsoid_fit_init(&rls);
+	ellipsoid_fit_init(&batch);
+	for(i = 0 ; i < n ; i++){
+		old_update(&old, _xyz[i]);
+		ellipsoid_fit_update(&rls, _xyz[i]);
+	}
+	if(ellipsoid_fit_batch(&batch, (const float (*)[3])_xyz, n)){
+		printf("batch fit failed\n");
+		return 1;
+	}
+
+	if(solve_V(old.V, &r_old)) { printf("old fit not an ellipsoid\n"); return 1; }
+	ellipsoid_fit_get(&rls, Vf);
+	for(i = 0 ; i < 9 ; i++) V[i] = Vf[i];
+	if(solve_V(V, &r_rls)) { printf("rls fit not an ellipsoid\n"); return 1; }
+	ellipsoid_fit_get(&batch, Vf);
+	for(i = 0 ; i < 9 ; i++) V[i] = Vf[i];
+	if(solve_V(V, &r_batch)) { printf("batch fit not an ellipsoid\n"); return 1; }
+	if(matlab_fit(_xyz, n, &r_ref)) { printf("reference fit failed\n"); return 1; }
+
+	print_result("double rls", &r_old);
+	print_result("float rls", &r_rls);
+	print_result("float batch", &r_batch);
+	print_result("matlab fit", &r_ref);
+
+	/* the matlab fit constrains the ellipsoid differently and has no prior,
+	 * so it is only required not to move further away than with the double fit */
+	{
+		double d_old = diff_result(&r_rls, &r_old);
+		double d_batch = diff_result(&r_batch, &r_rls);
+		double d_ref = diff_result(&r_rls, &r_ref);
+		double d_old_ref = diff_result(&r_old, &r_ref);
+		fail = !(d_old < tol && d_batch < tol && d_ref < d_old_ref + tol);
+		printf("relative difference: float rls/double rls %.2e, float batch/float rls %.2e (tol %.0e)\n",
+			d_old, d_batch, tol);
+		printf("                     float rls/matlab %.2e, double rls/matlab %.2e %s\n",
+			d_ref, d_old_ref, fail ? "FAIL" : "OK");
+	}
+
+	/* cost of one update */
+	{
+		int m = 200000;
+		double t0, t1, t2;
+
+		old_init(&old);
+		ellipsoid_fit_init(&rls);
+		t0 = now_sec();
+		for(i = 0 ; i < m ; i++) old_update(&old, _xyz[i % n]);
+		t1 = now_sec();
+		for(i = 0 ; i < m ; i++) ellipsoid_fit_update(&rls, _xyz[i % n]);
+		t2 = now_sec();
+		printf("update: double %.0f ns, float %.0f ns (host, hardware double)\n\n",
+			(t1 - t0) * 1e9 / m, (t2 - t1) * 1e9 / m);
+	}
+	return fail;
+}
+
+int main(int argc, char** argv)
+{
+	const char* def[] = {
+		"../Calibration/mag.dat", "../Calibration/mag2.dat",
+		"../Calibration/acc.dat", "../Calibration/acc2.dat",
+	};
+	double tol = 1e-3;
+	int fail = 0, i;
+
+	if(argc > 1){
+		for(i = 1 ; i < argc ; i++) fail |= check_file(argv[i], tol);
+	}else{
+		for(i = 0 ; i < 4 ; i++) fail |= check_file(def[i], tol);
+	}
+	return fail;
+}
@@ -0,0 +1,940 @@
+/*
+ * File      : est_bench.c
+ *
+ * Accuracy against cost of the attitude and state estimators. Datasets are
+ * flown by the firmware on the built-in vehicle model as in ../sitl, each
+ * with its own noise, biases, wind and stick script, and every ms the sensor
+ * topics and the true state of the model are recorded. Each estimator then
+ * runs on each dataset at each period, in a thread of its own
+ * (MULTI_VEHICLE), fed the recorded topics the way copter_main_loop feeds
+ * it, and its estimates are compared with the truth every ms while the
+ * update calls are timed. With -W each run is repeated, warm started
+ * from the state the estimator had learned at rest in the first.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "host_port.h"
+#include "host_sensor.h"
+#include "host_mavlink.h"
+#include "global.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "quaternion.h"
+#include "AHRS.h"
+#include "motor.h"
+#include "rc.h"
+#include "param.h"
+#include "control_main.h"
+#include "copter_main.h"
+#include "fast_loop.h"
+#include "pos_estimator.h"
+#include "imu_integrator.h"
+#include "state_est.h"
+#include "att_estimator.h"
+#include "est_store.h"
+#include "sitl_interface.h"
+#include "est_sensor.h"
+
+#ifndef MULTI_VEHICLE
+#error "est_bench runs every estimator in a thread of its own, build with -DMULTI_VEHICLE"
+#endif
+#if !defined(HIL_SIMULATION) || !defined(HIL_USE_MODEL)
+#error "the datasets are flown on the built-in model, build with -DHIL_SIMULATION -DHIL_USE_MODEL"
+#endif
+
+#define MAX_PERIOD			8
+/* the receiver delivers a ppm frame every 20ms */
+#define RC_PERIOD			20
+
+/* the flight, s: idle while the estimators settle, unlock, climb, then
+ * stick segments until the end */
+#define T_UNLOCK			10.0f
+#define T_CLIMB				12.0f
+#define T_MANEUVER			16.0f
+
+/* a flight beyond this is a crash */
+#define FAIL_TILT			70.0f		/* deg */
+
+/* the estimate has converged once its errors stay below these until the
+ * unlock */
+#define CONV_TILT			1.0f		/* deg */
+#define CONV_YAW			3.0f		/* deg */
+
+MCN_DECLARE(SENSOR_GYR);
+MCN_DECLARE(SENSOR_ACC);
+MCN_DECLARE(SENSOR_MAG);
+MCN_DECLARE(SENSOR_FILTER_GYR);
+MCN_DECLARE(SENSOR_IMU_DELTA);
+MCN_DECLARE(SENSOR_FILTER_ACC);
+MCN_DECLARE(SENSOR_FILTER_MAG);
+MCN_DECLARE(SENSOR_BARO);
+MCN_DECLARE(BARO_POSITION);
+MCN_DECLARE(GPS_POSITION);
+MCN_DECLARE(GPS_STATUS);
+MCN_DECLARE(ATT_QUATERNION);
+MCN_DECLARE(ATT_EULER);
+MCN_DECLARE(ALT_INFO);
+MCN_DECLARE(POS_KF);
+
+extern VEHICLE_STATE FrameType _frame_type;
+
+enum{
+	EST_AHRS = 0,
+	EST_MAHONY,
+	EST_MARG,
+	EST_EKF,
+	EST_NUM
+};
+
+/* -e names, as att_estimator.c and copter_main.c select them */
+static const char* _est_name[EST_NUM] = {"ahrs", "mahony", "marg", "ekf"};
+
+typedef struct
+{
+	uint32_t seed;
+	float noise;			/* sensor noise scale */
+	float wind[2];			/* m/s, north east */
+	float gyr_bias[3];		/* rad/s */
+	float acc_bias[3];		/* m/s^2 */
+	Est_Sample* sample;
+	uint32_t num;
+	uint8_t* gps;			/* GPS_POSITION reports */
+	uint32_t gps_num;
+	int fail;
+}Dataset;
+
+typedef struct
+{
+	double tilt_sq, tilt_max;	/* rad */
+	double yaw_sq;
+	double alt_sq, vz_sq;		/* m, m/s */
+	double hor_sq;
+	uint32_t num;
+	double att_ns;				/* summed update time */
+	uint32_t att_num;
+	double pos_ns;
+	uint32_t pos_num;
+	double flight_s;
+	double conv_s, conv_max;	/* s from power on to converged */
+	uint32_t run_num;
+}Est_Error;
+
+typedef struct
+{
+	int est;
+	uint32_t period;		/* ms */
+	Est_Error sum;			/* over the datasets */
+	Est_Error warm_sum;
+}Config;
+
+typedef struct
+{
+	int config;
+	int dataset;
+	Est_Error err;
+	Est_Error warm_err;
+	Est_State state;		/* learned in the cold run */
+	int warm;				/* this pass is the warm one */
+}Run;
+
+/* set by the options */
+static float _flight_s = 60.0f;
+static float _eval_s = T_UNLOCK;
+static int _warm_start;
+
+static Dataset* _data;
+static int _data_num;
+static Config* _config;
+static Run* _run;
+static int _run_num;
+static int _next_job;
+static int _job_num;
+static void* (*_job_func)(void*);
+static pthread_mutex_t _job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* the cost of reading the clock twice, taken off each timed update */
+static double _clock_ns;
+
+static uint64_t _rng;
+
+static double rand_uniform(uint64_t* rng)
+{
+	*rng ^= *rng << 13;
+	*rng ^= *rng >> 7;
+	*rng ^= *rng << 17;
+	return (*rng >> 11) * (1.0/9007199254740992.0);
+}
+
+static double rand_range(uint64_t* rng, double lo, double hi)
+{
+	return lo + (hi-lo)*rand_uniform(rng);
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static float wrap_pi(float a)
+{
+	while(a > PI) a -= 2.0f*PI;
+	while(a < -PI) a += 2.0f*PI;
+	return a;
+}
+
+/************************** datasets **************************/
+static VEHICLE_STATE int _motor_enable;
+
+static rt_err_t _motor_control(rt_device_t dev, rt_uint8_t cmd, void* args)
+{
+	if(cmd == PWM_CMD_ENABLE){
+		_motor_enable = *(int*)args;
+	}
+	return RT_EOK;
+}
+
+static VEHICLE_STATE struct rt_device _motor_device = {
+	.control = _motor_control,
+};
+
+static void rc_input(float roll, float pitch, float throttle, float yaw)
+{
+	float chan[CHAN_NUM];
+
+	chan[CHAN_ROLL] = roll;
+	chan[CHAN_PITCH] = pitch;
+	chan[CHAN_THROTTLE] = throttle;
+	chan[CHAN_YAW] = yaw;
+	chan[CHAN_CTRL_MODE] = 0.5f;		/* altitude hold */
+	chan[CHAN_THROTTLE_SWITCH] = 1.0f;
+
+	rc_handle_ppm_signal(chan);
+}
+
+/* the sticks at t s: unlock, climb and then segments of 1~2 s with a
+ * random roll, pitch, yaw or climb offset, each followed by 1~3 s with the
+ * sticks centred */
+static void flight_stick(uint64_t* rng, float t, float* seg_end, int* seg, float stick[4])
+{
+	if(t < T_UNLOCK){
+		stick[0] = stick[1] = stick[3] = 0.5f;
+		stick[2] = 0.0f;
+	}else if(t < T_UNLOCK+0.5f){
+		/* throttle low, pitch up unlocks */
+		stick[1] = 1.0f;
+	}else if(t < T_CLIMB){
+		stick[1] = 0.5f;
+	}else if(t < T_MANEUVER){
+		stick[2] = 0.75f;
+	}else if(t >= *seg_end){
+		stick[0] = stick[1] = stick[2] = stick[3] = 0.5f;
+		if((*seg)++ % 2 == 0){
+			int axis = (int)rand_range(rng, 0.0, 4.0);
+			double off = (rand_uniform(rng) < 0.5 ? -1.0 : 1.0) * rand_range(rng, 0.1, 0.3);
+
+			stick[axis] += axis == 2 ? 0.5f*off : off;
+			*seg_end = t + rand_range(rng, 1.0, 2.0);
+		}else{
+			*seg_end = t + rand_range(rng, 1.0, 3.0);
+		}
+	}
+}
+
+/* fly the firmware through one dataset and record it, all of the flight
+ * state is in VEHICLE_STATE variables of the calling thread */
+static void* record(void* parameter)
+{
+	Dataset* ds = (Dataset*)parameter;
+	SITL_Param_Def param;
+	uint64_t rng = ((uint64_t)ds->seed << 32) ^ 0x9E3779B97F4A7C15ULL;
+	float stick[4] = {0.5f, 0.5f, 0.0f, 0.5f}, seg_end = 0.0f;
+	int seg = 0;
+	uint32_t steps = (uint32_t)(_flight_s*1e3f);
+
+	ds->fail = 1;
+	device_delay_init();
+	host_sensor_init();
+	host_mavlink_init();
+	rt_device_register(&_motor_device, "motor", RT_DEVICE_FLAG_RDWR);
+	if(param_vehicle_init()){
+		return NULL;
+	}
+
+	sitl_model_default_param(&param);
+	param.gyr_noise *= ds->noise;
+	param.acc_noise *= ds->noise;
+	param.mag_noise *= ds->noise;
+	param.baro_noise *= ds->noise;
+	param.gps_noise *= ds->noise;
+	param.gps_vel_noise *= ds->noise;
+	memcpy(param.gyr_bias, ds->gyr_bias, sizeof(param.gyr_bias));
+	memcpy(param.acc_bias, ds->acc_bias, sizeof(param.acc_bias));
+
+	copter_init();
+	if(sitl_interface_init(&param, _frame_type, ds->seed)){
+		param_vehicle_release();
+		return NULL;
+	}
+	SITL_Model_Def* model = sitl_interface_get_model();
+	McnNode_t baro_node = mcn_subscribe(MCN_ID(BARO_POSITION), NULL);
+	McnNode_t report_node = mcn_subscribe(MCN_ID(SENSOR_BARO), NULL);
+	McnNode_t gps_node = mcn_subscribe(MCN_ID(GPS_POSITION), NULL);
+	McnNode_t status_node = mcn_subscribe(MCN_ID(GPS_STATUS), NULL);
+
+	uint32_t att_period = copter_get_event_period(AHRS_Period);
+	uint32_t pos_period = copter_get_event_period(Pos_Period);
+	uint32_t ctrl_period = copter_get_event_period(Control_Period);
+
+	ds->sample = malloc(steps*sizeof(Est_Sample));
+	/* the model reports gps every SITL_GPS_PERIOD ms */
+	uint32_t gps_size = MCN_ID(GPS_POSITION)->obj_size;
+	ds->gps = malloc((steps/SITL_GPS_PERIOD + 1)*gps_size);
+	ds->num = ds->gps_num = 0;
+	if(ds->sample == NULL || ds->gps == NULL || baro_node == NULL || report_node == NULL
+			|| gps_node == NULL || status_node == NULL){
+		param_vehicle_release();
+		return NULL;
+	}
+
+	int fail = 0;
+	for(uint32_t k = 0 ; k < steps ; k++){
+		float t = 1e-3f*(k+1);
+		Est_Sample* s = &ds->sample[k];
+
+		time_sim_step(1000);
+		if(k % RC_PERIOD == 0){
+			flight_stick(&rng, t, &seg_end, &seg, stick);
+			rc_input(stick[0], stick[1], stick[2], stick[3]);
+		}
+		if(t >= T_CLIMB){
+			model->wind[0] = ds->wind[0];
+			model->wind[1] = ds->wind[1];
+		}
+
+		fast_loop();
+		copter_main_loop(att_period, pos_period, ctrl_period);
+
+		s->time_us = time_nowUs();
+		mcn_copy_from_hub(MCN_ID(SENSOR_GYR), s->gyr);
+		mcn_copy_from_hub(MCN_ID(SENSOR_ACC), s->acc);
+		mcn_copy_from_hub(MCN_ID(SENSOR_MAG), s->mag);
+		mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_GYR), s->gyr_f);
+		mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_ACC), s->acc_f);
+		mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_MAG), s->mag_f);
+		s->baro_new = mcn_poll(baro_node);
+		if(s->baro_new)
+			mcn_copy(MCN_ID(BARO_POSITION), baro_node, &s->baro);
+		s->baro_report_new = mcn_poll(report_node);
+		if(s->baro_report_new)
+			mcn_copy(MCN_ID(SENSOR_BARO), report_node, &s->baro_report);
+		s->status_new = mcn_poll(status_node);
+		if(s->status_new)
+			mcn_copy(MCN_ID(GPS_STATUS), status_node, &s->gps_status);
+		s->gps = -1;
+		if(mcn_poll(gps_node) && ds->gps_num <= steps/SITL_GPS_PERIOD){
+			mcn_copy(MCN_ID(GPS_POSITION), gps_node, &ds->gps[ds->gps_num*gps_size]);
+			s->gps = ds->gps_num++;
+		}
+		memcpy(s->pos, model->state.pos, sizeof(s->pos));
+		memcpy(s->vel, model->state.vel, sizeof(s->vel));
+		s->att = model->state.att;
+		ds->num++;
+
+		if(t > T_CLIMB+1.0f){
+			Euler e;
+
+			quaternion_toEuler(&s->att, &e);
+			if(!_motor_enable || model->state.on_ground || isnan(s->pos[2])
+					|| fabsf(Rad2Deg(e.roll)) > FAIL_TILT || fabsf(Rad2Deg(e.pitch)) > FAIL_TILT){
+				fail = 1;
+				break;
+			}
+		}
+	}
+	param_vehicle_release();
+	ds->fail = fail;
+
+	return NULL;
+}
+
+/************************** estimators **************************/
+static VEHICLE_STATE quaternion _att_q;
+static VEHICLE_STATE uint8_t _warm_pending;
+
+/* attitude_est_run with the AHRS of the config */
+static void ahrs_run(int est, const IMU_Delta* imu_delta)
+{
+	float gyr_t[3], acc_t[3], mag_t[3];
+	float dT = imu_delta->dt;
+
+	for(int i = 0 ; i < 3 ; i++){
+		gyr_t[i] = imu_delta->delta_ang[i] / dT;
+		acc_t[i] = imu_delta->delta_vel[i] / dT;
+	}
+	sensor_get_mag(mag_t);
+
+	/* as attitude_est_run, only AHRS_update keeps a bias to restore */
+	if(_warm_pending){
+		Est_State warm;
+		int res = est_store_take(&warm);
+		if(res != EST_STORE_WAIT){
+			_warm_pending = 0;
+			if(res == EST_STORE_OK && est == EST_AHRS)
+				attitude_est_store_apply(&warm);
+		}
+	}
+
+	switch(est)
+	{
+		case EST_AHRS:
+			AHRS_update(&_att_q, gyr_t, acc_t, mag_t, dT);
+			break;
+		case EST_MAHONY:
+			MahonyAHRS_update(&_att_q, gyr_t, acc_t, mag_t, dT);
+			break;
+		case EST_MARG:
+			MARG_AHRS_update(&_att_q, gyr_t[0], gyr_t[1], gyr_t[2], -acc_t[0], -acc_t[1], -acc_t[2], mag_t[0], mag_t[1], mag_t[2], dT);
+			break;
+	}
+
+	mcn_publish(MCN_ID(ATT_QUATERNION), &_att_q);
+}
+
+/* tilt: the angle between the estimated and the true body z axis, and
+ * the heading error, rad */
+static void attitude_error(const Est_Sample* s, double* tilt, double* yaw)
+{
+	const float z[3] = {0.0f, 0.0f, 1.0f};
+	quaternion q;
+	float z_est[3], z_true[3];
+	Euler e_est, e_true;
+
+	mcn_copy_from_hub(MCN_ID(ATT_QUATERNION), &q);
+	quaternion_rotateVector(&q, z, z_est);
+	quaternion_rotateVector((quaternion*)&s->att, z, z_true);
+	float c = z_est[0]*z_true[0] + z_est[1]*z_true[1] + z_est[2]*z_true[2];
+	*tilt = acos(constrain_float(c, -1.0f, 1.0f));
+	quaternion_toEuler(&q, &e_est);
+	quaternion_toEuler((quaternion*)&s->att, &e_true);
+	*yaw = wrap_pi(e_est.yaw - e_true.yaw);
+}
+
+/* the ekf is not fed gps here, state_est zeroes its horizontal position,
+ * so there is no horizontal error to report for it */
+static int hor_estimated(int est)
+{
+	return est != EST_EKF;
+}
+
+static void accumulate_error(Est_Error* err, const Est_Sample* s, int est)
+{
+	Altitude_Info alt_info;
+	float x, y;
+	double tilt, yaw;
+
+	attitude_error(s, &tilt, &yaw);
+	mcn_copy_from_hub(MCN_ID(ALT_INFO), &alt_info);
+	/* pos_est_update only logs the horizontal position */
+	if(hor_estimated(est)){
+		POS_KF_Log pos_kf;
+		mcn_copy_from_hub(MCN_ID(POS_KF), &pos_kf);
+		x = pos_kf.est_x;
+		y = pos_kf.est_y;
+	}else{
+		x = s->pos[0];
+		y = s->pos[1];
+	}
+
+	double alt = alt_info.relative_alt + s->pos[2];
+	double vz = alt_info.vz + s->vel[2];
+	double dx = x - s->pos[0], dy = y - s->pos[1];
+
+	err->tilt_sq += tilt*tilt;
+	if(tilt > err->tilt_max)
+		err->tilt_max = tilt;
+	err->yaw_sq += yaw*yaw;
+	err->alt_sq += alt*alt;
+	err->vz_sq += vz*vz;
+	err->hor_sq += dx*dx + dy*dy;
+	err->num++;
+}
+
+/* est_store_save without the card */
+static void collect_state(Est_State* state, int est)
+{
+	memset(state, 0, sizeof(Est_State));
+	if(est == EST_EKF)
+		state_est_store_collect(state);
+	else
+		attitude_est_store_collect(state);
+	state->temperature = NAN;
+	if(MCN_ID(SENSOR_BARO)->published){
+		MS5611_REPORT_Def baro;
+
+		mcn_copy_from_hub(MCN_ID(SENSOR_BARO), &baro);
+		state->temperature = baro.temperature;
+	}
+}
+
+/* run one estimator at one period over one dataset, copter_main_loop
+ * without the controller */
+static void* estimate(void* parameter)
+{
+	Run* run = (Run*)parameter;
+	const Config* cfg = &_config[run->config];
+	const Dataset* ds = &_data[run->dataset];
+	Est_Error* err = run->warm ? &run->warm_err : &run->err;
+	uint32_t pos_time = 0;
+	uint32_t conv_k = 0;
+	McnNode_t delta_node;
+
+	memset(err, 0, sizeof(Est_Error));
+	device_delay_init();
+	est_sensor_init();
+	/* the attitude runs on each delta the sensors close, every period */
+	sensor_imu_delta_set_interval(cfg->period);
+	delta_node = mcn_subscribe(MCN_ID(SENSOR_IMU_DELTA), NULL);
+	/* the state instead of the card, the estimators take it as on a boot */
+	if(run->warm)
+		est_store_set(&run->state);
+
+	/* in the order copter_init initialises them, as HIL_SIMULATION does */
+	if(cfg->est == EST_EKF){
+		state_est_init(1e-3f*cfg->period);
+	}else{
+		float acc[3] = {0.0, 0.0, -9.8};
+		float mag[3] = {1.0, 0.0, 0.0};
+
+		AHRS_reset(&_att_q, acc, mag);
+		_warm_pending = (est_store_load() == 0);
+		mcn_advertise(MCN_ID(ATT_QUATERNION));
+		mcn_advertise_derived(MCN_ID(ATT_EULER), MCN_ID(ATT_QUATERNION), attitude_est_quaternion_to_euler);
+	}
+	if(pos_est_init(1e-3f*POS_EST_PERIOD) != RT_EOK){
+		fprintf(stderr, "pos estimator init fail\n");
+		exit(1);
+	}
+
+	for(uint32_t k = 0 ; k < ds->num ; k++){
+		const Est_Sample* s = &ds->sample[k];
+		double t0;
+
+		time_sim_set(s->time_us);
+		est_sensor_publish(s, s->gps >= 0 ? &ds->gps[s->gps*MCN_ID(GPS_POSITION)->obj_size] : NULL);
+
+		uint32_t now = time_nowMs();
+		if(mcn_poll(delta_node)){
+			IMU_Delta imu_delta;
+
+			t0 = now_ns();
+			/* state_est_update takes the delta itself */
+			if(cfg->est == EST_EKF)
+				state_est_update();
+			else if(sensor_imu_delta_take(&imu_delta))
+				ahrs_run(cfg->est, &imu_delta);
+			err->att_ns += now_ns() - t0 - _clock_ns;
+			err->att_num++;
+		}
+		/* pos_est rotates with the attitude, so not before it ran */
+		if(cfg->est != EST_EKF && err->att_num && TIME_GAP(pos_time, now) >= POS_EST_PERIOD){
+			pos_time = now;
+			t0 = now_ns();
+			pos_est_update(0.001f*POS_EST_PERIOD);
+			err->pos_ns += now_ns() - t0 - _clock_ns;
+			err->pos_num++;
+		}
+
+		if(1e-3f*(k+1) < T_UNLOCK){
+			double tilt, yaw;
+
+			/* no estimate before the first update */
+			if(!MCN_ID(ATT_QUATERNION)->published){
+				conv_k = k+1;
+			}else{
+				attitude_error(s, &tilt, &yaw);
+				if(Rad2Deg(tilt) > CONV_TILT || fabs(Rad2Deg(yaw)) > CONV_YAW)
+					conv_k = k+1;
+			}
+		}
+		/* what a disarm at rest would store, taken just before the unlock */
+		if(!run->warm && _warm_start && k+1 == (uint32_t)(T_UNLOCK*1e3f))
+			collect_state(&run->state, cfg->est);
+		if(1e-3f*(k+1) >= _eval_s)
+			accumulate_error(err, s, cfg->est);
+	}
+	err->flight_s = 1e-3*ds->num;
+	err->conv_s = err->conv_max = 1e-3*conv_k;
+	err->run_num = 1;
+
+	return NULL;
+}
+
+/************************** main **************************/
+/* takes the jobs one by one, each in a fresh thread so it starts from the
+ * initial VEHICLE_STATE */
+static void* worker(void* parameter)
+{
+	while(1){
+		pthread_t thread;
+		void* job;
+		int i;
+
+		pthread_mutex_lock(&_job_lock);
+		i = _next_job++;
+		pthread_mutex_unlock(&_job_lock);
+		if(i >= _job_num)
+			break;
+		job = _job_func == record ? (void*)&_data[i] : (void*)&_run[i];
+		if(pthread_create(&thread, NULL, _job_func, job) != 0){
+			fprintf(stderr, "can't create thread\n");
+			break;
+		}
+		pthread_join(thread, NULL);
+	}
+	return NULL;
+}
+
+static int run_jobs(void* (*func)(void*), int num, int jobs)
+{
+	pthread_t thread[jobs];
+
+	_job_func = func;
+	_job_num = num;
+	_next_job = 0;
+	for(int i = 0 ; i < jobs ; i++){
+		if(pthread_create(&thread[i], NULL, worker, NULL) != 0){
+			fprintf(stderr, "can't create thread\n");
+			return -1;
+		}
+	}
+	for(int i = 0 ; i < jobs ; i++)
+		pthread_join(thread[i], NULL);
+	return 0;
+}
+
+static void calibrate_clock(void)
+{
+	double min = 1e9;
+
+	for(int i = 0 ; i < 10000 ; i++){
+		double t0 = now_ns();
+		double dt = now_ns() - t0;
+		if(dt < min)
+			min = dt;
+	}
+	_clock_ns = min;
+}
+
+static int parse_est(const char* s)
+{
+	int mask = 0;
+	char buf[64];
+
+	snprintf(buf, sizeof(buf), "%s", s);
+	for(char* tok = strtok(buf, ",") ; tok ; tok = strtok(NULL, ",")){
+		int i;
+		for(i = 0 ; i < EST_NUM ; i++){
+			if(strcmp(tok, _est_name[i]) == 0)
+				break;
+		}
+		if(i == EST_NUM)
+			return 0;
+		mask |= 1 << i;
+	}
+	return mask;
+}
+
+static int parse_period(const char* s, uint32_t* period)
+{
+	int num = 0;
+	char buf[64];
+
+	snprintf(buf, sizeof(buf), "%s", s);
+	for(char* tok = strtok(buf, ",") ; tok ; tok = strtok(NULL, ",")){
+		int p = atoi(tok);
+		if(p <= 0 || p > 100 || num >= MAX_PERIOD)
+			return 0;
+		period[num++] = p;
+	}
+	return num;
+}
+
+static void add_error(Est_Error* sum, const Est_Error* e)
+{
+	sum->tilt_sq += e->tilt_sq;
+	if(e->tilt_max > sum->tilt_max)
+		sum->tilt_max = e->tilt_max;
+	sum->yaw_sq += e->yaw_sq;
+	sum->alt_sq += e->alt_sq;
+	sum->vz_sq += e->vz_sq;
+	sum->hor_sq += e->hor_sq;
+	sum->num += e->num;
+	sum->att_ns += e->att_ns;
+	sum->att_num += e->att_num;
+	sum->pos_ns += e->pos_ns;
+	sum->pos_num += e->pos_num;
+	sum->flight_s += e->flight_s;
+	sum->conv_s += e->conv_s;
+	if(e->conv_max > sum->conv_max)
+		sum->conv_max = e->conv_max;
+	sum->run_num += e->run_num;
+}
+
+/* mahony and marg keep no bias, they start the same warm or cold */
+static int warm_started(int est)
+{
+	return est == EST_AHRS || est == EST_EKF;
+}
+
+static void print_table(FILE* fp, int num)
+{
+	fprintf(fp, "%-7s %6s %8s %8s %8s %7s %7s %7s %8s %8s %8s\n", "est", "period", "tilt", "tilt_max",
+		"yaw", "alt", "vz", "hor", "att_ns", "pos_ns", "us/s");
+	for(int i = 0 ; i < num ; i++){
+		const Config* c = &_config[i];
+		const Est_Error* e = &c->sum;
+		double n = e->num ? e->num : 1;
+
+		fprintf(fp, "%-7s %4ums %8.3f %8.3f %8.3f %7.3f %7.3f", _est_name[c->est], c->period,
+			Rad2Deg(sqrt(e->tilt_sq/n)), Rad2Deg(e->tilt_max), Rad2Deg(sqrt(e->yaw_sq/n)),
+			sqrt(e->alt_sq/n), sqrt(e->vz_sq/n));
+		if(hor_estimated(c->est))
+			fprintf(fp, " %7.3f", sqrt(e->hor_sq/n));
+		else
+			fprintf(fp, " %7s", "n/a");
+		fprintf(fp, " %8.0f", e->att_num ? e->att_ns/e->att_num : 0.0);
+		if(e->pos_num)
+			fprintf(fp, " %8.0f", e->pos_ns/e->pos_num);
+		else
+			fprintf(fp, " %8s", "-");
+		fprintf(fp, " %8.1f\n", e->flight_s > 0.0 ? 1e-3*(e->att_ns + e->pos_ns)/e->flight_s : 0.0);
+	}
+}
+
+static void print_warm_table(FILE* fp, int num)
+{
+	fprintf(fp, "%-7s %6s %8s %8s %8s %8s %8s %8s\n", "est", "period", "conv", "conv_max",
+		"w_conv", "w_max", "tilt", "w_tilt");
+	for(int i = 0 ; i < num ; i++){
+		const Config* c = &_config[i];
+		const Est_Error* e = &c->sum;
+		const Est_Error* w = &c->warm_sum;
+		double n = e->num ? e->num : 1, wn = w->num ? w->num : 1;
+		double rn = e->run_num ? e->run_num : 1, wrn = w->run_num ? w->run_num : 1;
+
+		fprintf(fp, "%-7s %4ums %8.3f %8.3f", _est_name[c->est], c->period, e->conv_s/rn, e->conv_max);
+		if(warm_started(c->est))
+			fprintf(fp, " %8.3f %8.3f %8.3f %8.3f\n", w->conv_s/wrn, w->conv_max,
+				Rad2Deg(sqrt(e->tilt_sq/n)), Rad2Deg(sqrt(w->tilt_sq/wn)));
+		else
+			fprintf(fp, " %8s %8s %8.3f %8s\n", "-", "-", Rad2Deg(sqrt(e->tilt_sq/n)), "-");
+	}
+}
+
+static int write_csv(const char* name, int num)
+{
+	FILE* fp = strcmp(name, "-") == 0 ? stdout : fopen(name, "w");
+
+	if(fp == NULL){
+		perror(name);
+		return -1;
+	}
+	fprintf(fp, "est,period_ms,tilt_rms_deg,tilt_max_deg,yaw_rms_deg,alt_rms_m,vz_rms_mps,hor_rms_m,att_ns,pos_ns,load_us_per_s,conv_s");
+	fprintf(fp, _warm_start ? ",warm_conv_s,warm_tilt_rms_deg\n" : "\n");
+	for(int i = 0 ; i < num ; i++){
+		const Config* c = &_config[i];
+		const Est_Error* e = &c->sum;
+		const Est_Error* w = &c->warm_sum;
+		double n = e->num ? e->num : 1;
+
+		fprintf(fp, "%s,%u,%.4f,%.4f,%.4f,%.4f,%.4f,", _est_name[c->est], c->period,
+			Rad2Deg(sqrt(e->tilt_sq/n)), Rad2Deg(e->tilt_max), Rad2Deg(sqrt(e->yaw_sq/n)),
+			sqrt(e->alt_sq/n), sqrt(e->vz_sq/n));
+		if(hor_estimated(c->est))
+			fprintf(fp, "%.4f", sqrt(e->hor_sq/n));
+		fprintf(fp, ",%.1f,%.1f,%.2f,%.3f", e->att_num ? e->att_ns/e->att_num : 0.0, e->pos_num ? e->pos_ns/e->pos_num : 0.0,
+			e->flight_s > 0.0 ? 1e-3*(e->att_ns + e->pos_ns)/e->flight_s : 0.0,
+			e->run_num ? e->conv_s/e->run_num : 0.0);
+		if(_warm_start && warm_started(c->est))
+			fprintf(fp, ",%.3f,%.4f\n", w->run_num ? w->conv_s/w->run_num : 0.0,
+				Rad2Deg(sqrt(w->tilt_sq/(w->num ? w->num : 1))));
+		else
+			fprintf(fp, _warm_start ? ",,\n" : "\n");
+	}
+	if(fp != stdout)
+		fclose(fp);
+	return 0;
+}
+
+static void usage(FILE* fp)
+{
+	fprintf(fp, "usage: est_bench [-e ahrs,mahony,marg,ekf] [-p ms,...] [-n datasets] [-t sec] [-w sec] [-s seed] [-j jobs] [-W] [-o out.csv]\n");
+}
+
+int main(int argc, char** argv)
+{
+	int est_mask = (1 << EST_NUM) - 1;
+	uint32_t period[MAX_PERIOD] = {2, 4, 8};
+	int period_num = 3;
+	int jobs = 1;
+	uint32_t seed = 0;
+	const char* out_name = NULL;
+	int opt;
+
+	_data_num = 4;
+	while((opt = getopt(argc, argv, "e:p:n:t:w:s:j:Wo:h")) != -1){
+		switch(opt)
+		{
+			case 'e':
+				est_mask = parse_est(optarg);
+				if(est_mask == 0){
+					fprintf(stderr, "bad estimators %s, give ahrs, mahony, marg and/or ekf\n", optarg);
+					return 2;
+				}
+				break;
+			case 'p':
+				period_num = parse_period(optarg, period);
+				if(period_num == 0){
+					fprintf(stderr, "bad periods %s, give up to %d periods of 1~100 ms\n", optarg, MAX_PERIOD);
+					return 2;
+				}
+				break;
+			case 'n': _data_num = atoi(optarg); break;
+			case 't': _flight_s = atof(optarg); break;
+			case 'w': _eval_s = atof(optarg); break;
+			case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'j': jobs = atoi(optarg); break;
+			case 'W': _warm_start = 1; break;
+			case 'o': out_name = optarg; break;
+			default:
+				usage(opt == 'h' ? stdout : stderr);
+				return opt == 'h' ? 0 : 2;
+		}
+	}
+	if(optind != argc || _data_num <= 0 || _flight_s < T_MANEUVER || _eval_s < 0.0f || _eval_s >= _flight_s){
+		usage(stderr);
+		return 2;
+	}
+	if(jobs <= 0)
+		jobs = 1;
+
+	host_port_init();
+	host_console_level(1);
+	calibrate_clock();
+
+	int config_num = 0;
+	_config = calloc(EST_NUM*MAX_PERIOD, sizeof(Config));
+	_data = calloc(_data_num, sizeof(Dataset));
+	if(_config == NULL || _data == NULL){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for(int e = 0 ; e < EST_NUM ; e++){
+		if(!(est_mask & (1 << e)))
+			continue;
+		for(int p = 0 ; p < period_num ; p++){
+			_config[config_num].est = e;
+			_config[config_num].period = period[p];
+			config_num++;
+		}
+	}
+
+	_rng = ((uint64_t)seed << 32) ^ 0x2545F4914F6CDD1DULL;
+	for(int d = 0 ; d < _data_num ; d++){
+		Dataset* ds = &_data[d];
+		double dir = rand_range(&_rng, 0.0, 2.0*PI);
+		double wind = rand_range(&_rng, 0.0, 5.0);
+
+		ds->seed = seed + d;
+		ds->noise = exp(rand_range(&_rng, log(0.5), log(2.0)));
+		ds->wind[0] = wind*cos(dir);
+		ds->wind[1] = wind*sin(dir);
+		for(int i = 0 ; i < 3 ; i++){
+			ds->gyr_bias[i] = rand_range(&_rng, -0.01, 0.01);
+			ds->acc_bias[i] = rand_range(&_rng, -0.1, 0.1);
+		}
+	}
+
+	double wall0 = now_ns();
+	if(run_jobs(record, _data_num, jobs))
+		return 1;
+	int ok = 0;
+	for(int d = 0 ; d < _data_num ; d++){
+		if(_data[d].fail)
+			fprintf(stderr, "dataset %d (seed %u) crashed after %.1f s, left out\n", d, _data[d].seed, 1e-3*_data[d].num);
+		else
+			ok++;
+	}
+	if(ok == 0){
+		fprintf(stderr, "no dataset\n");
+		return 1;
+	}
+
+	_run = calloc(config_num*_data_num, sizeof(Run));
+	if(_run == NULL){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	_run_num = 0;
+	for(int c = 0 ; c < config_num ; c++){
+		for(int d = 0 ; d < _data_num ; d++){
+			if(_data[d].fail)
+				continue;
+			_run[_run_num].config = c;
+			_run[_run_num].dataset = d;
+			_run_num++;
+		}
+	}
+	if(run_jobs(estimate, _run_num, jobs))
+		return 1;
+	if(_warm_start){
+		for(int i = 0 ; i < _run_num ; i++)
+			_run[i].warm = 1;
+		if(run_jobs(estimate, _run_num, jobs))
+			return 1;
+	}
+	double wall = (now_ns() - wall0)*1e-9;
+
+	for(int i = 0 ; i < _run_num ; i++){
+		add_error(&_config[_run[i].config].sum, &_run[i].err);
+		if(_warm_start)
+			add_error(&_config[_run[i].config].warm_sum, &_run[i].warm_err);
+	}
+
+	printf("%d datasets of %.0f s, errors from %.0f s on, %d runs in %.2f s on %d jobs\n", ok, _flight_s,
+		_eval_s, _run_num, wall, jobs);
+	print_table(stdout, config_num);
+	printf("rms errors (tilt, yaw deg; alt, hor m; vz m/s), host ns per update, host us per flight s\n");
+	if(_warm_start){
+		printf("\n");
+		print_warm_table(stdout, config_num);
+		printf("s from power on until tilt < %.1f deg and yaw < %.1f deg, mean and max, cold and warm (w_) start\n",
+			CONV_TILT, CONV_YAW);
+	}
+	if(out_name && write_csv(out_name, config_num))
+		return 1;
+
+	for(int d = 0 ; d < _data_num ; d++){
+		free(_data[d].sample);
+		free(_data[d].gps);
+	}
+	free(_run);
+	free(_data);
+	free(_config);
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * File      : est_sensor.c
+ *
+ * The gps velocity follows sensor_collect() of sensor_manager.c, keep it
+ * in step when that changes.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include "global.h"
+#include "uMCN.h"
+#include "gps.h"
+#include "host_sensor.h"
+#include "pos_estimator.h"
+#include "est_sensor.h"
+
+MCN_DECLARE(SENSOR_GYR);
+MCN_DECLARE(SENSOR_ACC);
+MCN_DECLARE(SENSOR_MAG);
+MCN_DECLARE(SENSOR_FILTER_GYR);
+MCN_DECLARE(SENSOR_FILTER_ACC);
+MCN_DECLARE(SENSOR_FILTER_MAG);
+MCN_DECLARE(SENSOR_BARO);
+MCN_DECLARE(BARO_POSITION);
+MCN_DECLARE(GPS_STATUS);
+MCN_DECLARE(GPS_POSITION);
+
+void est_sensor_publish(const Est_Sample* s, const void* gps)
+{
+	mcn_publish(MCN_ID(SENSOR_GYR), s->gyr);
+	mcn_publish(MCN_ID(SENSOR_ACC), s->acc);
+	mcn_publish(MCN_ID(SENSOR_MAG), s->mag);
+	mcn_publish(MCN_ID(SENSOR_FILTER_GYR), s->gyr_f);
+	mcn_publish(MCN_ID(SENSOR_FILTER_ACC), s->acc_f);
+	mcn_publish(MCN_ID(SENSOR_FILTER_MAG), s->mag_f);
+	sensor_imu_delta_update(s->gyr_f, s->acc_f);
+	if(s->baro_report_new)
+		mcn_publish(MCN_ID(SENSOR_BARO), &s->baro_report);
+	if(s->baro_new)
+		mcn_publish(MCN_ID(BARO_POSITION), &s->baro);
+	if(s->status_new)
+		mcn_publish(MCN_ID(GPS_STATUS), &s->gps_status);
+
+	if(s->gps >= 0){
+		struct vehicle_gps_position_s gps_pos_t;
+
+		memcpy(&gps_pos_t, gps, sizeof(gps_pos_t));
+		mcn_publish(MCN_ID(GPS_POSITION), &gps_pos_t);
+
+		/* HIL leaves the derived velocity alone, the target flies with it */
+		HOME_Pos home = pos_home_get();
+		Vector3f_t pos;
+		if(home.gps_coordinate_set == true && gps_get_position(&pos, gps_pos_t) == 0){
+
+			host_gps_driv_vel.velocity.x = (pos.x - host_gps_driv_vel.last_pos.x) / 0.1f;	// the gps update interval is 100ms
+			host_gps_driv_vel.velocity.y = (pos.y - host_gps_driv_vel.last_pos.y) / 0.1f;
+			host_gps_driv_vel.velocity.z = (pos.z - host_gps_driv_vel.last_pos.z) / 0.1f;
+
+			host_gps_driv_vel.last_pos = pos;
+		}
+	}
+}
+
+void est_sensor_init(void)
+{
+	host_sensor_init();
+	memset(&host_gps_driv_vel, 0, sizeof(host_gps_driv_vel));
+}
@@ -0,0 +1,42 @@
+/*
+ * File      : est_sensor.h
+ *
+ * One ms of a dataset: the sensor topics the flight published in it and
+ * the true state of the model. The gps reports are kept apart, as raw
+ * GPS_POSITION topic data, since gps.h does not build next to <time.h>.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __EST_SENSOR_H__
+#define __EST_SENSOR_H__
+
+#include <stdint.h>
+#include "sensor_manager.h"
+#include "quaternion.h"
+
+typedef struct
+{
+	uint64_t time_us;
+	float gyr[3], acc[3], mag[3];
+	float gyr_f[3], acc_f[3], mag_f[3];
+	BaroPosition baro;
+	MS5611_REPORT_Def baro_report;	/* SENSOR_BARO, for its temperature */
+	GPS_Status gps_status;
+	int32_t gps;			/* index of a new gps report, -1 if none */
+	uint8_t baro_new;
+	uint8_t baro_report_new;
+	uint8_t status_new;
+	float pos[3];			/* m, NED from home */
+	float vel[3];			/* m/s, NED */
+	quaternion att;
+}Est_Sample;
+
+void est_sensor_init(void);
+/* publish the topics the flight published in this ms, gps is the report
+ * of s->gps */
+void est_sensor_publish(const Est_Sample* s, const void* gps);
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * File      : fast_math_check.c
+ *
+ * Host check of the fast_math.h approximations: the largest error over
+ * every float argument against double precision libm, then the time per
+ * call against single precision libm.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "fast_math.h"
+
+/* the bounds documented in fast_math.h */
+#define BOUND_ATAN2		4e-7
+#define BOUND_ASIN		4e-7
+#define BOUND_RSQRT		5e-6
+
+#define CHECK(_cond, ...)	do{ if(!(_cond)){ printf(__VA_ARGS__); fail = 1; } }while(0)
+
+static uint32_t _stride = 1;
+volatile float sink;
+
+static float from_bits(uint32_t i)
+{
+	float f;
+	memcpy(&f, &i, sizeof(f));
+	return f;
+}
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+static void track(double err, double* max_err, float* worst, float arg)
+{
+	if(err > *max_err){
+		*max_err = err;
+		*worst = arg;
+	}
+}
+
+static int check_atan2(void)
+{
+	double max_err = 0.0;
+	float worst = 0.0f;
+	int fail = 0;
+
+	/* every z in 0~1 in all eight octants, the division of a general
+	 * argument pair only rounds z */
+	for(uint32_t i = 0 ; i <= 0x3F800000 ; i += _stride){
+		float z = from_bits(i);
+		double a = atan((double)z);
+
+		track(fabs(fast_atan2f(z, 1.0f) - a), &max_err, &worst, z);
+		track(fabs(fast_atan2f(1.0f, z) - (M_PI_2 - a)), &max_err, &worst, z);
+		track(fabs(fast_atan2f(-z, -1.0f) + (M_PI - a)), &max_err, &worst, z);
+		track(fabs(fast_atan2f(-1.0f, -z) + (M_PI_2 + a)), &max_err, &worst, z);
+	}
+	/* argument pairs over the whole range of magnitudes */
+	srand(1);
+	for(int n = 0 ; n < 10000000 ; n++){
+		float y = ldexpf((float)rand()/RAND_MAX - 0.5f, rand() % 120 - 60);
+		float x = ldexpf((float)rand()/RAND_MAX - 0.5f, rand() % 120 - 60);
+
+		track(fabs(fast_atan2f(y, x) - atan2((double)y, (double)x)), &max_err, &worst, y/x);
+	}
+	CHECK(fast_atan2f(0.0f, 0.0f) == 0.0f, "atan2(0, 0) is not 0\n");
+	CHECK(fast_atan2f(0.0f, -1.0f) == (float)M_PI, "atan2(0, -1) is not pi\n");
+	CHECK(max_err < BOUND_ATAN2, "fast_atan2f over its bound\n");
+
+	printf("fast_atan2f  max error %.3e rad (at y/x %g)  bound %.0e  %s\n", max_err, worst, BOUND_ATAN2,
+			max_err < BOUND_ATAN2 ? "ok" : "FAIL");
+
+	return fail;
+}
+
+static int check_asin(void)
+{
+	double max_err = 0.0;
+	float worst = 0.0f;
+	int fail = 0;
+
+	/* every x in -1~1 */
+	for(uint32_t i = 0 ; i <= 0x3F800000 ; i += _stride){
+		float x = from_bits(i);
+		double a = asin((double)x);
+
+		track(fabs(fast_asinf(x) - a), &max_err, &worst, x);
+		track(fabs(fast_asinf(-x) + a), &max_err, &worst, -x);
+	}
+	CHECK(fast_asinf(0.0f) == 0.0f, "asin(0) is not 0\n");
+	CHECK(fast_asinf(1.0f) == (float)M_PI_2 && fast_asinf(-1.0f) == -(float)M_PI_2, "asin(+-1) is not +-pi/2\n");
+	CHECK(max_err < BOUND_ASIN, "fast_asinf over its bound\n");
+
+	printf("fast_asinf   max error %.3e rad (at x %g)  bound %.0e  %s\n", max_err, worst, BOUND_ASIN,
+			max_err < BOUND_ASIN ? "ok" : "FAIL");
+
+	return fail;
+}
+
+static int check_rsqrt(void)
+{
+	double max_err = 0.0;
+	float worst = 0.0f;
+	int fail = 0;
+
+	/* every positive normal float */
+	for(uint32_t i = 0x00800000 ; i < 0x7F800000 ; i += _stride){
+		float x = from_bits(i);
+		double r = 1.0 / sqrt((double)x);
+
+		track(fabs(math_rsqrt(x) - r) / r, &max_err, &worst, x);
+	}
+	CHECK(max_err < BOUND_RSQRT, "math_rsqrt over its bound\n");
+
+	printf("math_rsqrt   max error %.3e relative (at x %g)  bound %.0e  %s\n", max_err, worst, BOUND_RSQRT,
+			max_err < BOUND_RSQRT ? "ok" : "FAIL");
+
+	return fail;
+}
+
+/* ns per call over a ring of arguments as the attitude paths see them */
+#define RING	256
+#define CALLS	20000000
+
+static void speed(void)
+{
+	float a[RING], b[RING];
+	double t, t_fast, t_libm;
+
+	for(int i = 0 ; i < RING ; i++){
+		a[i] = sinf(i*0.37f);
+		b[i] = cosf(i*0.11f) + 0.01f;
+	}
+
+	t = now();
+	for(int k = 0 ; k < CALLS ; k++)
+		sink = fast_atan2f(a[k & (RING-1)], b[k & (RING-1)]);
+	t_fast = now() - t;
+	t = now();
+	for(int k = 0 ; k < CALLS ; k++)
+		sink = atan2f(a[k & (RING-1)], b[k & (RING-1)]);
+	t_libm = now() - t;
+	printf("atan2   fast %5.2f ns  libm %5.2f ns\n", t_fast/CALLS*1e9, t_libm/CALLS*1e9);
+
+	t = now();
+	for(int k = 0 ; k < CALLS ; k++)
+		sink = fast_asinf(a[k & (RING-1)]);
+	t_fast = now() - t;
+	t = now();
+	for(int k = 0 ; k < CALLS ; k++)
+		sink = asinf(a[k & (RING-1)]);
+	t_libm = now() - t;
+	printf("asin    fast %5.2f ns  libm %5.2f ns\n", t_fast/CALLS*1e9, t_libm/CALLS*1e9);
+
+	t = now();
+	for(int k = 0 ; k < CALLS ; k++)
+		sink = math_rsqrt(b[k & (RING-1)] + 1.0f);
+	t_fast = now() - t;
+	t = now();
+	for(int k = 0 ; k < CALLS ; k++)
+		sink = 1.0f/sqrtf(b[k & (RING-1)] + 1.0f);
+	t_libm = now() - t;
+	printf("rsqrt   fast %5.2f ns  libm %5.2f ns\n", t_fast/CALLS*1e9, t_libm/CALLS*1e9);
+}
+
+int main(int argc, char** argv)
+{
+	int fail = 0;
+
+	/* a stride > 1 checks every stride-th float only, for a quick run */
+	if(argc > 1)
+		_stride = (uint32_t)atoi(argv[1]) > 0 ? (uint32_t)atoi(argv[1]) : 1;
+
+	fail |= check_atan2();
+	fail |= check_asin();
+	fail |= check_rsqrt();
+	speed();
+
+	printf("%s\n", fail ? "FAIL" : "all ok");
+	return fail;
+}
@@ -0,0 +1,177 @@
+/*
+ * File      : geo_proj_check.c
+ *
+ * Host check of the local tangent plane projection (geo_proj.c) against
+ * the azimuthal equidistant projection used by gps_calc_geometry_distance2.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "geo_proj.h"
+
+#define DEG2RAD		(3.14159265358979323846 / 180.0)
+
+typedef struct
+{
+	double range;	/* m */
+	double bound;	/* m, documented in geo_proj.h */
+	double max_err;
+	double max_err_old;
+}band_t;
+
+static band_t _band[] = {
+	{1000.0,	0.001,	0.0, 0.0},
+	{5000.0,	0.01,	0.0, 0.0},
+	{10000.0,	0.05,	0.0, 0.0},
+	{50000.0,	10.0,	0.0, 0.0},
+};
+
+/* gps_calc_geometry_distance2 of sensor_manager.c with an exact deg to rad */
+static void aeqd(double ref_lat, double ref_lon, double lat, double lon, double* x, double* y)
+{
+	double lat_rad = lat * DEG2RAD;
+	double ref_rad = ref_lat * DEG2RAD;
+	double d_lon = (lon - ref_lon) * DEG2RAD;
+	double arg = sin(ref_rad) * sin(lat_rad) + cos(ref_rad) * cos(lat_rad) * cos(d_lon);
+	double c, k = 1.0;
+
+	if(arg > 1.0) arg = 1.0;
+	if(arg < -1.0) arg = -1.0;
+	c = acos(arg);
+	if(fabs(c) > 0){
+		k = c / sin(c);
+	}
+	*x = k * (cos(ref_rad) * sin(lat_rad) - sin(ref_rad) * cos(lat_rad) * cos(d_lon)) * GEO_EARTH_RADIUS;
+	*y = k * cos(lat_rad) * sin(d_lon) * GEO_EARTH_RADIUS;
+}
+
+/* gps_calc_geometry_distance of sensor_manager.c as it was, cos() fed with degree */
+static void old_flat(double ref_lat, double ref_lon, double lat, double lon, float* x, float* y)
+{
+	double d_lat = (lat - ref_lat) * 0.0174533f;
+	double d_lon = (lon - ref_lon) * 0.0174533f;
+
+	*x = (float)(d_lat * GEO_EARTH_RADIUS);
+	*y = (float)(d_lon * GEO_EARTH_RADIUS * cosf((float)lat));
+}
+
+static double rnd(double lo, double hi)
+{
+	return lo + (hi - lo) * ((double)rand() / RAND_MAX);
+}
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	int nband = sizeof(_band) / sizeof(_band[0]);
+	int fail = 0;
+	int i, b;
+
+	srand(1);
+
+	for(i = 0 ; i < n ; i++){
+		GeoProj_Def proj;
+		/* reference anywhere up to 70 deg, including near the antimeridian */
+		int32_t ref_lat = (int32_t)(rnd(-70.0, 70.0) * 1e7);
+		int32_t ref_lon = (int32_t)(rnd(-180.0, 180.0) * 1e7);
+		double dist = rnd(0.0, _band[nband - 1].range);
+		double brg = rnd(0.0, 2 * 3.14159265358979323846);
+		double rlat = ref_lat * 1e-7, rlon = ref_lon * 1e-7;
+		double lat_d = rlat + dist * cos(brg) / GEO_EARTH_RADIUS / DEG2RAD;
+		double lon_d = rlon + dist * sin(brg) / (GEO_EARTH_RADIUS * cos(rlat * DEG2RAD)) / DEG2RAD;
+		int32_t lat, lon;
+		double ex, ey, err, err_old;
+		float x, y;
+
+		if(lon_d > 180.0) lon_d -= 360.0;
+		if(lon_d < -180.0) lon_d += 360.0;
+		lat = (int32_t)lround(lat_d * 1e7);
+		lon = (int32_t)lround(lon_d * 1e7);
+
+		aeqd(rlat, rlon, lat * 1e-7, lon * 1e-7, &ex, &ey);
+		/* the reference does not wrap, compare near the antimeridian only with geo_proj */
+		geo_proj_init(&proj, ref_lat, ref_lon);
+		geo_proj_project(&proj, lat, lon, &x, &y);
+		err = hypot(x - ex, y - ey);
+
+		old_flat(rlat, rlon, lat * 1e-7, lon * 1e-7, &x, &y);
+		err_old = fabs(rlon - lon * 1e-7) < 180.0 ? hypot(x - ex, y - ey) : 0.0;
+
+		dist = hypot(ex, ey);
+		for(b = 0 ; b < nband ; b++){
+			if(dist <= _band[b].range){
+				if(err > _band[b].max_err) _band[b].max_err = err;
+				if(err_old > _band[b].max_err_old) _band[b].max_err_old = err_old;
+			}
+		}
+	}
+
+	/* no reference or not a coordinate: -1 and x/y untouched */
+	{
+		static const int32_t bad[][2] = {
+			{900000001, 0}, {-900000001, 0}, {0, 1800000001}, {0, -1800000001}, {INT32_MAX, INT32_MIN},
+		};
+		GeoProj_Def proj = {0};
+		float x = 1.0f, y = 2.0f;
+		int res = geo_proj_project(&proj, 0, 0, &x, &y) != -1;
+
+		geo_proj_init(&proj, 473977420, 85455940);
+		for(i = 0 ; i < (int)(sizeof(bad) / sizeof(bad[0])) ; i++){
+			res |= geo_proj_project(&proj, bad[i][0], bad[i][1], &x, &y) != -1;
+		}
+		res |= x != 1.0f || y != 2.0f;
+		res |= geo_proj_project(&proj, 900000000, -1800000000, &x, &y) != 0;
+		printf("invalid reference and coordinates rejected: %s\n", res ? "FAIL" : "OK");
+		fail |= res;
+	}
+
+	printf("%d points, |ref lat| <= 70 deg\n", n);
+	printf("range(m)  bound(m)  geo_proj max err(m)  old flat max err(m)\n");
+	for(b = 0 ; b < nband ; b++){
+		int ok = _band[b].max_err <= _band[b].bound;
+		printf("%8.0f  %8.3f  %19.4f  %19.2f  %s\n", _band[b].range, _band[b].bound,
+			_band[b].max_err, _band[b].max_err_old, ok ? "OK" : "FAIL");
+		fail |= !ok;
+	}
+
+	/* cost of a projection, reference fixed as on the fmu */
+	{
+		GeoProj_Def proj;
+		volatile float sink = 0.0f;
+		double t0, t1, t2;
+		double sx, sy;
+		int m = 10000000;
+		float x, y;
+
+		geo_proj_init(&proj, 473977420, 85455940);
+		t0 = now_sec();
+		for(i = 0 ; i < m ; i++){
+			geo_proj_project(&proj, 473977420 + (i & 0xffff), 85455940 - (i & 0x7fff), &x, &y);
+			sink += x + y;
+		}
+		t1 = now_sec();
+		for(i = 0 ; i < m / 10 ; i++){
+			aeqd(47.3977420, 8.5455940, 47.3977420 + (i & 0xffff) * 1e-7, 8.5455940 - (i & 0x7fff) * 1e-7, &sx, &sy);
+			sink += (float)(sx + sy);
+		}
+		t2 = now_sec();
+		printf("geo_proj %.1f ns/point, double aeqd %.1f ns/point (host)\n",
+			(t1 - t0) * 1e9 / m, (t2 - t1) * 1e9 / (m / 10));
+	}
+
+	return fail;
+}
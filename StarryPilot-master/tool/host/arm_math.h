@@ -0,0 +1,74 @@
+/*
+ * File      : arm_math.h
+ *
+ * Host stand-in for the CMSIS DSP header. It declares only what the
+ * Framework uses, the functions themselves are built from the CMSIS
+ * sources in starry_fmu/Library (see README.txt), so the host runs the
+ * same matrix and sin/cos code as the target.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+typedef int8_t		q7_t;
+typedef int16_t		q15_t;
+typedef int32_t		q31_t;
+typedef int64_t		q63_t;
+typedef float		float32_t;
+typedef double		float64_t;
+
+#define PI					3.14159265358979f
+#define TABLE_SIZE			256
+
+#define __INLINE			inline
+#define ALIGN4				__attribute__((aligned(4)))
+
+typedef enum
+{
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_LENGTH_ERROR = -2,
+	ARM_MATH_SIZE_MISMATCH = -3,
+	ARM_MATH_NANINF = -4,
+	ARM_MATH_SINGULAR = -5,
+	ARM_MATH_TEST_FAILURE = -6
+}arm_status;
+
+typedef struct
+{
+	uint16_t numRows;
+	uint16_t numCols;
+	float32_t *pData;
+}arm_matrix_instance_f32;
+
+void arm_mat_init_f32(arm_matrix_instance_f32 * S, uint16_t nRows, uint16_t nColumns, float32_t * pData);
+arm_status arm_mat_add_f32(const arm_matrix_instance_f32 * pSrcA, const arm_matrix_instance_f32 * pSrcB, arm_matrix_instance_f32 * pDst);
+arm_status arm_mat_sub_f32(const arm_matrix_instance_f32 * pSrcA, const arm_matrix_instance_f32 * pSrcB, arm_matrix_instance_f32 * pDst);
+arm_status arm_mat_mult_f32(const arm_matrix_instance_f32 * pSrcA, const arm_matrix_instance_f32 * pSrcB, arm_matrix_instance_f32 * pDst);
+arm_status arm_mat_scale_f32(const arm_matrix_instance_f32 * pSrc, float32_t scale, arm_matrix_instance_f32 * pDst);
+arm_status arm_mat_trans_f32(const arm_matrix_instance_f32 * pSrc, arm_matrix_instance_f32 * pDst);
+arm_status arm_mat_inverse_f32(const arm_matrix_instance_f32 * src, arm_matrix_instance_f32 * dst);
+
+float32_t arm_sin_f32(float32_t x);
+float32_t arm_cos_f32(float32_t x);
+
+static __INLINE arm_status arm_sqrt_f32(float32_t in, float32_t * pOut)
+{
+	if(in > 0){
+		*pOut = sqrtf(in);
+	}else{
+		*pOut = 0.0f;
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	return ARM_MATH_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * File      : host_ff.c
+ *
+ * FatFs calls and the file manager state for the host builds. There is no
+ * SD card, so every file is missing and param.c falls back to the defaults
+ * as it does on a board without card. Build with -I.../Library/Fatfs.
+ * There is no logger thread either, a save request is served at once.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <rtthread.h>
+#include "ff.h"
+#include "file_manager.h"
+#include "logger.h"
+#include "est_store.h"
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode)
+{
+	(void)fp;
+	(void)path;
+	(void)mode;
+	return FR_NO_FILE;
+}
+
+FRESULT f_close(FIL* fp)
+{
+	(void)fp;
+	return FR_INVALID_OBJECT;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br)
+{
+	(void)fp;
+	(void)buff;
+	(void)btr;
+	*br = 0;
+	return FR_INVALID_OBJECT;
+}
+
+FRESULT f_write(FIL* fp, const void* buff, UINT btw, UINT* bw)
+{
+	(void)fp;
+	(void)buff;
+	(void)btw;
+	*bw = 0;
+	return FR_INVALID_OBJECT;
+}
+
+int f_printf(FIL* fp, const TCHAR* str, ...)
+{
+	(void)fp;
+	(void)str;
+	return EOF;
+}
+
+uint8_t fm_init_complete(void)
+{
+	return 0;
+}
+
+void logger_request_est_store(void)
+{
+	est_store_flush();
+}
@@ -0,0 +1,257 @@
+/*
+ * File      : host_mavlink.c
+ *
+ * The HIL decoding follows mavproxy_rx_entry in mavproxy.c, keep them in
+ * step when that changes.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "global.h"
+#include "console.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "gps.h"
+#include "host_mavlink.h"
+
+#define RX_BUFF_SIZE		2048
+
+static char *TAG = "MAV_Dev";
+
+mavlink_system_t mavlink_system = {1, 1};
+
+/* mavproxy.c defines these on target */
+MCN_DEFINE(HIL_STATE_Q, sizeof(mavlink_hil_state_quaternion_t));
+MCN_DEFINE(HIL_SENSOR, sizeof(mavlink_hil_sensor_t));
+MCN_DEFINE(HIL_GPS, sizeof(mavlink_hil_gps_t));
+
+MCN_DECLARE(GPS_POSITION);
+
+static VEHICLE_STATE int _sock = -1;
+static VEHICLE_STATE struct sockaddr_in _peer;
+static VEHICLE_STATE uint8_t _peer_valid;
+static VEHICLE_STATE uint8_t _peer_fixed;
+
+/* the datagram being read */
+static VEHICLE_STATE uint8_t _rx_buff[RX_BUFF_SIZE];
+static VEHICLE_STATE int _rx_len;
+static VEHICLE_STATE int _rx_pos;
+
+/* parser state of this link, mavlink_parse_char would share the one of
+ * channel 0 between the vehicles */
+static VEHICLE_STATE mavlink_message_t _rx_msg;
+static VEHICLE_STATE mavlink_status_t _rx_status;
+
+/* time.h would clash with the struct tm of gps_ubx.h */
+static double wall_ms(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec*1e3 + tv.tv_usec*1e-3;
+}
+
+int host_mavlink_open(uint16_t port, const char* peer, uint16_t peer_port)
+{
+	struct sockaddr_in addr;
+
+	host_mavlink_close();
+
+	_sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if(_sock < 0){
+		Console.e(TAG, "can't create udp socket\n");
+		return 1;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	if(bind(_sock, (struct sockaddr*)&addr, sizeof(addr)) < 0){
+		Console.e(TAG, "can't bind udp port %u\n", port);
+		host_mavlink_close();
+		return 1;
+	}
+
+	_peer_valid = _peer_fixed = 0;
+	if(peer){
+		struct addrinfo hints, *res;
+
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_DGRAM;
+		if(getaddrinfo(peer, NULL, &hints, &res) != 0){
+			Console.e(TAG, "unknown host %s\n", peer);
+			host_mavlink_close();
+			return 1;
+		}
+		memcpy(&_peer, res->ai_addr, sizeof(_peer));
+		_peer.sin_port = htons(peer_port);
+		freeaddrinfo(res);
+		_peer_valid = _peer_fixed = 1;
+	}
+	_rx_len = _rx_pos = 0;
+	memset(&_rx_status, 0, sizeof(_rx_status));
+
+	return 0;
+}
+
+void host_mavlink_close(void)
+{
+	if(_sock >= 0){
+		close(_sock);
+		_sock = -1;
+	}
+}
+
+uint16_t host_mavlink_port(void)
+{
+	struct sockaddr_in addr;
+	socklen_t len = sizeof(addr);
+
+	if(_sock < 0 || getsockname(_sock, (struct sockaddr*)&addr, &len) < 0){
+		return 0;
+	}
+	return ntohs(addr.sin_port);
+}
+
+uint8_t mavlink_lowlevel_write(uint8_t* buff, uint16_t len)
+{
+	if(_sock < 0 || !_peer_valid){
+		return 1;
+	}
+	if(sendto(_sock, buff, len, 0, (struct sockaddr*)&_peer, sizeof(_peer)) != len){
+		return 1;
+	}
+	return 0;
+}
+
+int mavlink_lowlevel_read(uint8_t* buff, uint16_t len)
+{
+	if(_sock < 0){
+		return 0;
+	}
+	if(_rx_pos >= _rx_len){
+		struct pollfd pfd = {_sock, POLLIN, 0};
+		struct sockaddr_in from;
+		socklen_t from_len = sizeof(from);
+		ssize_t size;
+
+		if(poll(&pfd, 1, HOST_MAVLINK_READ_TIMEOUT) <= 0){
+			return 0;
+		}
+		size = recvfrom(_sock, _rx_buff, sizeof(_rx_buff), 0, (struct sockaddr*)&from, &from_len);
+		if(size <= 0){
+			return 0;
+		}
+		if(!_peer_fixed){
+			_peer = from;
+			_peer_valid = 1;
+		}
+		_rx_len = (int)size;
+		_rx_pos = 0;
+	}
+	if(len > _rx_len - _rx_pos){
+		len = _rx_len - _rx_pos;
+	}
+	memcpy(buff, &_rx_buff[_rx_pos], len);
+	_rx_pos += len;
+
+	return len;
+}
+
+int host_mavlink_recv(mavlink_message_t* msg, int timeout)
+{
+	double deadline = wall_ms() + timeout;
+	mavlink_status_t status;
+	uint8_t byte;
+
+	while(1){
+		if(mavlink_lowlevel_read(&byte, 1) <= 0){
+			if(timeout >= 0 && wall_ms() >= deadline){
+				return 0;
+			}
+			continue;
+		}
+		/* a bad crc is dropped, the parser starts over by itself */
+		if(mavlink_frame_char_buffer(&_rx_msg, &_rx_status, byte, msg, &status) == MAVLINK_FRAMING_OK){
+			return 1;
+		}
+	}
+}
+
+void host_mavlink_handle(const mavlink_message_t* msg)
+{
+	switch(msg->msgid){
+		case MAVLINK_MSG_ID_HIL_SENSOR:
+		{
+			mavlink_hil_sensor_t hil_sensor;
+			mavlink_msg_hil_sensor_decode(msg, &hil_sensor);
+			/* publish */
+			mcn_publish(MCN_ID(HIL_SENSOR), &hil_sensor);
+		}break;
+		case MAVLINK_MSG_ID_HIL_GPS:
+		{
+			mavlink_hil_gps_t hil_gps;
+			mavlink_msg_hil_gps_decode(msg, &hil_gps);
+
+			struct vehicle_gps_position_s gps_position;
+			memset(&gps_position, 0, sizeof(gps_position));
+			gps_position.lat = hil_gps.lat;
+			gps_position.lon = hil_gps.lon;
+			gps_position.alt = hil_gps.alt;
+			gps_position.eph = (float)hil_gps.eph*1e-2;
+			gps_position.epv = (float)hil_gps.epv*1e-2;
+			gps_position.vel_m_s = (float)hil_gps.vel*1e-2;
+			gps_position.vel_n_m_s = (float)hil_gps.vn*1e-2;
+			gps_position.vel_e_m_s = (float)hil_gps.ve*1e-2;
+			gps_position.vel_d_m_s = (float)hil_gps.vd*1e-2;
+			gps_position.fix_type = hil_gps.fix_type;
+			gps_position.satellites_used = hil_gps.satellites_visible;
+			uint32_t now = time_nowMs();
+			gps_position.timestamp_position = gps_position.timestamp_velocity = now;
+
+			mcn_publish(MCN_ID(GPS_POSITION), &gps_position);
+		}break;
+		case MAVLINK_MSG_ID_HIL_STATE_QUATERNION:
+		{
+			mavlink_hil_state_quaternion_t hil_state_q;
+			mavlink_msg_hil_state_quaternion_decode(msg, &hil_state_q);
+			/* publish */
+			mcn_publish(MCN_ID(HIL_STATE_Q), &hil_state_q);
+		}break;
+		default:
+			break;
+	}
+}
+
+/* as in mavproxy.c, the link is the only transport */
+uint8_t mavlink_send_hil_actuator_control(float control[16], int motor_num)
+{
+	mavlink_message_t msg;
+	uint8_t buff[MAVLINK_MAX_PACKET_LEN];
+	uint16_t len;
+
+	mavlink_msg_hil_actuator_controls_pack(mavlink_system.sysid, mavlink_system.compid, &msg,
+							time_nowUs(), control, 0, motor_num);
+
+	len = mavlink_msg_to_send_buffer(buff, &msg);
+	return mavlink_lowlevel_write(buff, len);
+}
+
+void host_mavlink_init(void)
+{
+	mcn_advertise(MCN_ID(HIL_STATE_Q));
+	mcn_advertise(MCN_ID(HIL_SENSOR));
+	mcn_advertise(MCN_ID(HIL_GPS));
+}
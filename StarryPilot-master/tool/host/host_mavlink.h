@@ -0,0 +1,47 @@
+/*
+ * File      : host_mavlink.h
+ *
+ * Host stand-in for mavproxy_rtt.c and the HIL half of mavproxy.c: the
+ * MAVLink link is a UDP socket instead of the "usb"/"uart2" device.
+ * mavlink_lowlevel_write sends one datagram per call, mavlink_lowlevel_read
+ * hands out the bytes of the datagrams received, so the MAVLink code above
+ * works on it as on the serial stream.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __HOST_MAVLINK_H__
+#define __HOST_MAVLINK_H__
+
+#include <stdint.h>
+#include "mavproxy.h"
+
+extern mavlink_system_t mavlink_system;
+
+/* the wait of mavlink_lowlevel_read, as MAVLINK_DEV_TIMEOUT on target */
+#define HOST_MAVLINK_READ_TIMEOUT	15
+
+/* Bind the link to the udp port (0: any free port). With peer NULL the
+ * link answers whoever sent the last datagram, as a vehicle waiting for a
+ * simulator or a ground station does. */
+int host_mavlink_open(uint16_t port, const char* peer, uint16_t peer_port);
+void host_mavlink_close(void);
+/* the port the link is bound to */
+uint16_t host_mavlink_port(void);
+
+uint8_t mavlink_lowlevel_write(uint8_t* buff, uint16_t len);
+int mavlink_lowlevel_read(uint8_t* buff, uint16_t len);
+
+/* Parse the link until a message is complete. 1: got msg, 0: nothing
+ * within timeout ms (< 0 waits forever). */
+int host_mavlink_recv(mavlink_message_t* msg, int timeout);
+/* publish HIL_SENSOR, HIL_GPS and HIL_STATE_QUATERNION as
+ * mavproxy_rx_entry does, other messages are ignored */
+void host_mavlink_handle(const mavlink_message_t* msg);
+
+/* advertise the HIL topics as mavproxy_entry does */
+void host_mavlink_init(void);
+
+#endif
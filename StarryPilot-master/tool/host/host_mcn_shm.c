@@ -0,0 +1,160 @@
+/*
+ * File      : host_mcn_shm.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "global.h"
+#include "console.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "host_mcn_shm.h"
+
+#define ALIGN8(_x)		(((_x) + 7u) & ~7u)
+
+static char *TAG = "MCN_Shm";
+
+static VEHICLE_STATE McnShm_Header* _shm;
+static VEHICLE_STATE char _shm_name[64];
+static VEHICLE_STATE McnHub* _hub[MCN_SHM_MAX_TOPIC];
+
+static void _write(McnShm_Topic* t, const void* data)
+{
+	uint32_t seq = t->seq;
+
+	__atomic_store_n(&t->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	t->time_us = time_nowUs();
+	memcpy((uint8_t*)_shm + t->offset, data, t->size);
+	__atomic_store_n(&t->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/* subscriber callback of every mirrored topic, parameter is its pdata */
+static void _mirror(void* parameter)
+{
+	if(_shm == NULL)
+		return;
+	for(uint32_t i = 0 ; i < _shm->topic_num ; i++){
+		if(_hub[i]->pdata == parameter){
+			_write(&_shm->topic[i], parameter);
+			break;
+		}
+	}
+}
+
+static int _add(McnHub** hub, int num, McnHub* h)
+{
+	if(num >= MCN_SHM_MAX_TOPIC){
+		Console.e(TAG, "more than %d topics, %s left out\n", MCN_SHM_MAX_TOPIC, h->obj_name);
+		return num;
+	}
+	if(strlen(h->obj_name) >= MCN_SHM_NAME_LEN){
+		Console.e(TAG, "topic name %s too long\n", h->obj_name);
+		return num;
+	}
+	hub[num] = h;
+	return num + 1;
+}
+
+int host_mcn_shm_open(const char* name, const char* topics)
+{
+	McnHub* hub[MCN_SHM_MAX_TOPIC];
+	int num = 0;
+	uint32_t size;
+
+	if(_shm != NULL){
+		Console.e(TAG, "%s is open already\n", _shm_name);
+		return -1;
+	}
+	if(strcmp(topics, "all") == 0){
+		for(McnHub* h = mcn_next_hub(NULL) ; h != NULL ; h = mcn_next_hub(h))
+			num = _add(hub, num, h);
+	}else{
+		char buf[512];
+
+		snprintf(buf, sizeof(buf), "%s", topics);
+		for(char* tok = strtok(buf, ",") ; tok ; tok = strtok(NULL, ",")){
+			McnHub* h = mcn_find_hub(tok);
+			if(h == NULL){
+				Console.e(TAG, "no topic %s\n", tok);
+				return -1;
+			}
+			num = _add(hub, num, h);
+		}
+	}
+
+	size = ALIGN8(sizeof(McnShm_Header));
+	for(int i = 0 ; i < num ; i++)
+		size += ALIGN8(hub[i]->obj_size);
+
+	int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+	if(fd < 0){
+		perror(name);
+		return -1;
+	}
+	if(ftruncate(fd, size) != 0){
+		perror(name);
+		close(fd);
+		shm_unlink(name);
+		return -1;
+	}
+	McnShm_Header* shm = (McnShm_Header*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(shm == MAP_FAILED){
+		perror(name);
+		shm_unlink(name);
+		return -1;
+	}
+
+	/* ftruncate gave zeros, seq starts even */
+	shm->version = MCN_SHM_VERSION;
+	shm->size = size;
+	shm->topic_num = num;
+	shm->state = MCN_SHM_STATE_LIVE;
+	size = ALIGN8(sizeof(McnShm_Header));
+	for(int i = 0 ; i < num ; i++){
+		McnShm_Topic* t = &shm->topic[i];
+
+		snprintf(t->name, sizeof(t->name), "%s", hub[i]->obj_name);
+		t->size = hub[i]->obj_size;
+		t->offset = size;
+		size += ALIGN8(hub[i]->obj_size);
+		_hub[i] = hub[i];
+	}
+	_shm = shm;
+	snprintf(_shm_name, sizeof(_shm_name), "%s", name);
+
+	for(int i = 0 ; i < num ; i++){
+		/* the data published before the bridge came up is the first write */
+		if(hub[i]->published){
+			uint8_t data[hub[i]->obj_size];
+			mcn_copy_from_hub(hub[i], data);
+			_write(&shm->topic[i], data);
+		}
+		if(mcn_subscribe(hub[i], _mirror) == NULL){
+			Console.e(TAG, "%s subscribe fail\n", hub[i]->obj_name);
+		}
+	}
+	__atomic_store_n(&shm->magic, MCN_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+void host_mcn_shm_close(void)
+{
+	if(_shm == NULL)
+		return;
+
+	/* uMCN has no unsubscribe, _mirror does nothing from here on */
+	__atomic_store_n(&_shm->state, MCN_SHM_STATE_CLOSED, __ATOMIC_RELEASE);
+	munmap(_shm, _shm->size);
+	shm_unlink(_shm_name);
+	_shm = NULL;
+}
@@ -0,0 +1,26 @@
+/*
+ * File      : host_mcn_shm.h
+ *
+ * Bridge of uMCN topics into POSIX shared memory (layout in mcn_shm.h),
+ * so another process sees them at full rate while the flight code runs on
+ * the host. Each mirrored topic gets a subscriber callback that copies
+ * every publish into its seqlock slot; nothing else of uMCN changes.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __HOST_MCN_SHM_H__
+#define __HOST_MCN_SHM_H__
+
+#include "mcn_shm.h"
+
+/* Create the segment name (e.g. MCN_SHM_DEFAULT_NAME) and mirror the comma
+ * separated topics, or every advertised topic for "all". The topics must
+ * be advertised already, call it after copter_init(). 0: ok. */
+int host_mcn_shm_open(const char* name, const char* topics);
+/* mark the segment closed and remove it, readers keep what they mapped */
+void host_mcn_shm_close(void);
+
+#endif
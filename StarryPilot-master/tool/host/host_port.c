@@ -0,0 +1,261 @@
+/*
+ * File      : host_port.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <rtthread.h>
+#include "console.h"
+#include "delay.h"
+#include "host_port.h"
+
+CONSOLE_Typedef Console;
+
+static int _console_level;
+
+/************************** Time **************************/
+/* time_nowUs/time_nowMs come from delay.c on the simulated time source */
+rt_tick_t rt_tick_get(void)
+{
+	return (rt_tick_t)(time_nowUs() * RT_TICK_PER_SECOND / 1000000);
+}
+
+/* The caller is the only thread, there is nothing to wait for. The clock
+ * is left alone so the driving program keeps control of time. */
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+	(void)tick;
+	return RT_EOK;
+}
+
+/************************** Timer and Event **************************/
+void rt_timer_init(rt_timer_t timer, const char *name, void (*timeout)(void *parameter),
+					void *parameter, rt_tick_t time, rt_uint8_t flag)
+{
+	snprintf(timer->name, RT_NAME_MAX, "%s", name);
+	timer->timeout = timeout;
+	timer->parameter = parameter;
+	timer->init_tick = time;
+	timer->flag = flag;
+}
+
+rt_err_t rt_timer_start(rt_timer_t timer)
+{
+	(void)timer;
+	return RT_EOK;
+}
+
+rt_err_t rt_timer_stop(rt_timer_t timer)
+{
+	(void)timer;
+	return RT_EOK;
+}
+
+rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag)
+{
+	(void)flag;
+	snprintf(event->name, RT_NAME_MAX, "%s", name);
+	event->set = 0;
+	return RT_EOK;
+}
+
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
+{
+	event->set |= set;
+	return RT_EOK;
+}
+
+/* never blocks, there is no other thread to send the event */
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+						rt_int32_t timeout, rt_uint32_t *recved)
+{
+	rt_uint32_t got = event->set & set;
+
+	(void)timeout;
+	if((opt & RT_EVENT_FLAG_AND) ? got != set : got == 0){
+		return RT_ETIMEOUT;
+	}
+	if(recved){
+		*recved = got;
+	}
+	if(opt & RT_EVENT_FLAG_CLEAR){
+		event->set &= ~got;
+	}
+	return RT_EOK;
+}
+
+/************************** Device **************************/
+static VEHICLE_STATE rt_device_t _device_list;
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+	if(dev == RT_NULL || rt_device_find(name) != RT_NULL){
+		return -RT_ERROR;
+	}
+	snprintf(dev->name, RT_NAME_MAX, "%s", name);
+	dev->flag = flags;
+	dev->open_flag = RT_DEVICE_OFLAG_CLOSE;
+	dev->next = _device_list;
+	_device_list = dev;
+
+	return RT_EOK;
+}
+
+rt_device_t rt_device_find(const char *name)
+{
+	for(rt_device_t dev = _device_list ; dev != RT_NULL ; dev = dev->next){
+		if(strncmp(dev->name, name, RT_NAME_MAX) == 0){
+			return dev;
+		}
+	}
+	return RT_NULL;
+}
+
+rt_err_t rt_device_open(rt_device_t dev, rt_uint16_t oflag)
+{
+	rt_err_t res = RT_EOK;
+
+	if(dev == RT_NULL){
+		return -RT_ERROR;
+	}
+	if(dev->open){
+		res = dev->open(dev, oflag);
+	}
+	if(res == RT_EOK){
+		dev->open_flag = oflag | RT_DEVICE_OFLAG_OPEN;
+	}
+	return res;
+}
+
+rt_err_t rt_device_close(rt_device_t dev)
+{
+	if(dev == RT_NULL){
+		return -RT_ERROR;
+	}
+	dev->open_flag = RT_DEVICE_OFLAG_CLOSE;
+	return dev->close ? dev->close(dev) : RT_EOK;
+}
+
+rt_size_t rt_device_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+	if(dev == RT_NULL || dev->read == RT_NULL){
+		return 0;
+	}
+	return dev->read(dev, pos, buffer, size);
+}
+
+rt_size_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+	if(dev == RT_NULL || dev->write == RT_NULL){
+		return 0;
+	}
+	return dev->write(dev, pos, buffer, size);
+}
+
+rt_err_t rt_device_control(rt_device_t dev, rt_uint8_t cmd, void *arg)
+{
+	if(dev == RT_NULL){
+		return -RT_ERROR;
+	}
+	return dev->control ? dev->control(dev, cmd, arg) : RT_EOK;
+}
+
+/************************** Console **************************/
+static void _console_vprint(int level, char* tag, const char *fmt, va_list args)
+{
+	if(level < _console_level){
+		return;
+	}
+	if(tag != NULL){
+		fprintf(stderr, "[%s] ", tag);
+	}
+	vfprintf(stderr, fmt, args);
+}
+
+static void console_error(char* tag, const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	_console_vprint(1, tag, fmt, args);
+	va_end(args);
+}
+
+static void console_warning(char* tag, const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	_console_vprint(0, tag, fmt, args);
+	va_end(args);
+}
+
+static void console_print(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	_console_vprint(0, NULL, fmt, args);
+	va_end(args);
+}
+
+static void console_print2dev(CONSOLE_INTERFACE_Typedef dev, const char *fmt, ...)
+{
+	va_list args;
+
+	(void)dev;
+	va_start(args, fmt);
+	_console_vprint(0, NULL, fmt, args);
+	va_end(args);
+}
+
+static void console_print_eachtime(uint32_t *time_stamp, uint32_t time_ms, const char *fmt, ...)
+{
+	uint32_t now = time_nowMs();
+	va_list args;
+
+	if(now - *time_stamp > time_ms){
+		*time_stamp = now;
+		va_start(args, fmt);
+		_console_vprint(0, NULL, fmt, args);
+		va_end(args);
+	}
+}
+
+static void console_write(char* content, uint32_t len)
+{
+	if(_console_level == 0){
+		fwrite(content, 1, len, stderr);
+	}
+}
+
+void rt_kprintf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	_console_vprint(0, NULL, fmt, args);
+	va_end(args);
+}
+
+void host_console_level(int level)
+{
+	_console_level = level;
+}
+
+void host_port_init(void)
+{
+	Console.e = console_error;
+	Console.w = console_warning;
+	Console.print = console_print;
+	Console.print2dev = console_print2dev;
+	Console.print_eachtime = console_print_eachtime;
+	Console.write = console_write;
+
+	device_delay_init();
+}
@@ -0,0 +1,24 @@
+/*
+ * File      : host_port.h
+ *
+ * What the host port adds on top of the RT-Thread and console stand-ins:
+ * the console setup and a switch for its output. The clock is delay.c on
+ * its simulated time source, the program driving the flight code moves it
+ * with time_sim_set/time_sim_step.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __HOST_PORT_H__
+#define __HOST_PORT_H__
+
+#include <stdint.h>
+
+void host_port_init(void);
+
+/* 0: console output to stderr (default), 1: errors only, 2: nothing */
+void host_console_level(int level);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * File      : host_sensor.c
+ *
+ * The topics and the gps api follow sensor_manager.c, keep them in step
+ * when those change.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include "global.h"
+#include "console.h"
+#include "uMCN.h"
+#include "gps.h"
+#include "ms5611.h"
+#include "pos_estimator.h"
+#include "delay.h"
+#include "copter_main.h"
+#include "imu_integrator.h"
+#include "host_sensor.h"
+
+static char *TAG = "Sensor";
+
+VEHICLE_STATE GPS_Driv_Vel host_gps_driv_vel;
+static VEHICLE_STATE IMU_Integrator _imu_integrator;
+
+MCN_DEFINE(SENSOR_GYR, 12);
+MCN_DEFINE(SENSOR_ACC, 12);
+MCN_DEFINE(SENSOR_MAG, 12);
+MCN_DEFINE(SENSOR_FILTER_GYR, 12);
+MCN_DEFINE(SENSOR_FILTER_ACC, 12);
+MCN_DEFINE(SENSOR_FILTER_MAG, 12);
+MCN_DEFINE(SENSOR_BARO, sizeof(MS5611_REPORT_Def));
+MCN_DEFINE(BARO_POSITION, sizeof(BaroPosition));
+MCN_DEFINE(GPS_STATUS, sizeof(GPS_Status));
+MCN_DEFINE(SENSOR_IMU_DELTA, sizeof(IMU_Delta));
+/* defined by gps.c on target */
+MCN_DEFINE(GPS_POSITION, sizeof(struct vehicle_gps_position_s));
+
+/************************** sensor api **************************/
+rt_err_t sensor_gyr_get_calibrated_data(float gyr[3])
+{
+	return mcn_copy_from_hub(MCN_ID(SENSOR_GYR), gyr) ? RT_ERROR : RT_EOK;
+}
+
+rt_err_t sensor_acc_get_calibrated_data(float acc[3])
+{
+	return mcn_copy_from_hub(MCN_ID(SENSOR_ACC), acc) ? RT_ERROR : RT_EOK;
+}
+
+rt_err_t sensor_mag_get_calibrated_data(float mag[3])
+{
+	return mcn_copy_from_hub(MCN_ID(SENSOR_MAG), mag) ? RT_ERROR : RT_EOK;
+}
+
+void sensor_get_gyr(float gyr[3])
+{
+	mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_GYR), gyr);
+}
+
+void sensor_get_acc(float acc[3])
+{
+	mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_ACC), acc);
+}
+
+void sensor_get_mag(float mag[3])
+{
+	mcn_copy_from_hub(MCN_ID(SENSOR_FILTER_MAG), mag);
+}
+
+/************************** imu delta api **************************/
+void sensor_imu_delta_set_interval(uint32_t interval_ms)
+{
+	if(_imu_integrator.interval_us != interval_ms*1000)
+		imu_integrator_reset(&_imu_integrator, interval_ms);
+}
+
+/* integrate a gyr and acc sample, publish SENSOR_IMU_DELTA once the interval
+ * is full; the samples after it are added until the estimator takes the delta */
+void sensor_imu_delta_update(const float gyr[3], const float acc[3])
+{
+	IMU_Delta imu_delta;
+	bool full;
+
+	OS_ENTER_CRITICAL;
+	full = imu_integrator_input(&_imu_integrator, gyr, acc, time_nowUs());
+	if(full)
+		imu_integrator_peek(&_imu_integrator, &imu_delta);
+	OS_EXIT_CRITICAL;
+
+	if(full)
+		mcn_publish(MCN_ID(SENSOR_IMU_DELTA), &imu_delta);
+}
+
+/* everything integrated since the last take, so an estimator running late
+ * loses no samples; false if not a whole interval is integrated yet */
+bool sensor_imu_delta_take(IMU_Delta* imu_delta)
+{
+	bool full;
+
+	OS_ENTER_CRITICAL;
+	full = imu_integrator_full(&_imu_integrator);
+	if(full)
+		imu_integrator_output(&_imu_integrator, imu_delta);
+	OS_EXIT_CRITICAL;
+
+	return full;
+}
+
+/************************** gps api **************************/
+struct vehicle_gps_position_s gps_get_report(void)
+{
+	struct vehicle_gps_position_s gps_pos_t;
+
+	mcn_copy_from_hub(MCN_ID(GPS_POSITION), &gps_pos_t);
+
+	return gps_pos_t;
+}
+
+int gps_get_position(Vector3f_t* gps_pos, struct vehicle_gps_position_s gps_report)
+{
+	HOME_Pos home = pos_home_get();
+	if(home.gps_coordinate_set == false){
+		// gps home have not set yet
+		return -1;
+	}
+
+	if(geo_proj_project(&home.proj, gps_report.lat, gps_report.lon, &gps_pos->x, &gps_pos->y) != 0){
+		// no projection or not a coordinate
+		return -1;
+	}
+	gps_pos->z = (float)gps_report.alt*1e-3f;
+
+	return 0;
+}
+
+int gps_get_velocity(Vector3f_t* gps_vel, struct vehicle_gps_position_s gps_report)
+{
+#ifdef USE_GPS_VEL
+	gps_vel->x = gps_report.vel_n_m_s;
+	gps_vel->y = gps_report.vel_e_m_s;
+	gps_vel->z = gps_report.vel_d_m_s;
+#else
+	*gps_vel = host_gps_driv_vel.velocity;
+#endif
+
+	return 0;
+}
+
+void gps_get_status(GPS_Status* gps_sta)
+{
+	mcn_copy_from_hub(MCN_ID(GPS_STATUS), gps_sta);
+}
+
+void sensor_manager_init(void)
+{
+	// do something here
+}
+
+/************************** init **************************/
+void host_sensor_init(void)
+{
+	McnHub* hubs[] = {
+		MCN_ID(SENSOR_GYR), MCN_ID(SENSOR_ACC), MCN_ID(SENSOR_MAG),
+		MCN_ID(SENSOR_FILTER_GYR), MCN_ID(SENSOR_FILTER_ACC), MCN_ID(SENSOR_FILTER_MAG),
+		MCN_ID(SENSOR_BARO), MCN_ID(BARO_POSITION), MCN_ID(GPS_STATUS), MCN_ID(GPS_POSITION),
+		MCN_ID(SENSOR_IMU_DELTA)
+	};
+	float null_data[3] = {0, 0, 0};
+	GPS_Status gps_status = {GPS_UNDETECTED, 0};
+
+	for(uint8_t i = 0 ; i < sizeof(hubs)/sizeof(hubs[0]) ; i++){
+		if(mcn_advertise(hubs[i]) != 0){
+			Console.e(TAG, "%s advertise fail\n", hubs[i]->obj_name);
+		}
+	}
+	mcn_publish(MCN_ID(SENSOR_FILTER_GYR), &null_data);
+	mcn_publish(MCN_ID(SENSOR_FILTER_ACC), &null_data);
+	mcn_publish(MCN_ID(SENSOR_FILTER_MAG), &null_data);
+	mcn_publish(MCN_ID(GPS_STATUS), &gps_status);
+
+	memset(&host_gps_driv_vel, 0, sizeof(host_gps_driv_vel));
+	imu_integrator_reset(&_imu_integrator, AHRS_PERIOD);
+}
@@ -0,0 +1,25 @@
+/*
+ * File      : host_sensor.h
+ *
+ * Host stand-in for the topic and api half of sensor_manager.c, whose
+ * device half needs the drivers. The sensor topics are advertised here and
+ * published by the program driving the flight code (a log, a model).
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __HOST_SENSOR_H__
+#define __HOST_SENSOR_H__
+
+#include "sensor_manager.h"
+
+/* what gps_get_velocity returns unless USE_GPS_VEL, sensor_collect()
+ * derives it from consecutive fixes */
+extern VEHICLE_STATE GPS_Driv_Vel host_gps_driv_vel;
+
+/* advertise the topics as device_sensor_init does */
+void host_sensor_init(void);
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * File      : mcn_shm.h
+ *
+ * Layout of the POSIX shared memory segment host_mcn_shm.c mirrors uMCN
+ * topics into, shared with the reader library of ../mcn_shm. Plain C and
+ * fixed size types only, the reader does not need the Framework.
+ *
+ * The segment starts with McnShm_Header and its topic table, the data of
+ * the topics follows, each 8 byte aligned at McnShm_Topic.offset. Every
+ * topic is a seqlock of its own: the writer makes seq odd, writes time_us
+ * and the data, then makes seq even again. A reader copies time_us and the
+ * data between two reads of an even seq and takes the copy if seq did not
+ * change, otherwise it copies again. seq/2 is the number of publishes.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __MCN_SHM_H__
+#define __MCN_SHM_H__
+
+#include <stdint.h>
+
+#define MCN_SHM_MAGIC			0x534E434D	/* "MCNS" */
+#define MCN_SHM_VERSION			1
+#define MCN_SHM_MAX_TOPIC		32
+#define MCN_SHM_NAME_LEN		32
+/* segment of vehicle 0, vehicle i of a multi vehicle run uses
+ * MCN_SHM_DEFAULT_NAME "_i" */
+#define MCN_SHM_DEFAULT_NAME	"/starry_mcn"
+
+/* McnShm_Header.state */
+#define MCN_SHM_STATE_LIVE		1
+#define MCN_SHM_STATE_CLOSED	2
+
+typedef struct
+{
+	char name[MCN_SHM_NAME_LEN];	/* uMCN obj_name */
+	uint32_t size;					/* bytes of data */
+	uint32_t offset;				/* of the data from the segment start */
+	volatile uint32_t seq;			/* odd while written */
+	uint32_t reserved;
+	volatile uint64_t time_us;		/* simulated time of the publish */
+}McnShm_Topic;
+
+typedef struct
+{
+	volatile uint32_t magic;		/* set once the table is complete */
+	uint32_t version;
+	uint32_t size;					/* of the whole segment */
+	uint32_t topic_num;
+	volatile uint32_t state;
+	uint32_t reserved;
+	McnShm_Topic topic[MCN_SHM_MAX_TOPIC];
+}McnShm_Header;
+
+#endif
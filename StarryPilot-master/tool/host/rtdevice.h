@@ -0,0 +1,7 @@
+/* host stand-in, see rtthread.h */
+#ifndef __RT_DEVICE_H__
+#define __RT_DEVICE_H__
+
+#include <rtthread.h>
+
+#endif
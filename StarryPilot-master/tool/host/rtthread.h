@@ -0,0 +1,158 @@
+/*
+ * File      : rtthread.h
+ *
+ * Host stand-in for the parts of RT-Thread the portable Framework modules
+ * use, so they can be built with gcc on Linux (see README.txt).
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __RT_THREAD_H__
+#define __RT_THREAD_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef int8_t		rt_int8_t;
+typedef int16_t		rt_int16_t;
+typedef int32_t		rt_int32_t;
+typedef uint8_t		rt_uint8_t;
+typedef uint16_t	rt_uint16_t;
+typedef uint32_t	rt_uint32_t;
+typedef int			rt_bool_t;
+typedef long		rt_base_t;
+typedef unsigned long	rt_ubase_t;
+typedef rt_base_t	rt_err_t;
+typedef rt_uint32_t	rt_time_t;
+typedef rt_uint32_t	rt_tick_t;
+typedef rt_base_t	rt_flag_t;
+typedef rt_ubase_t	rt_size_t;
+typedef rt_base_t	rt_off_t;
+
+#define RT_TRUE			1
+#define RT_FALSE		0
+#define RT_NULL			((void*)0)
+
+#define RT_EOK			0
+#define RT_ERROR		1
+#define RT_ETIMEOUT		2
+#define RT_EFULL		3
+#define RT_EEMPTY		4
+#define RT_ENOMEM		5
+#define RT_ENOSYS		6
+#define RT_EBUSY		7
+#define RT_EIO			8
+
+#define RT_TICK_PER_SECOND		1000
+#define RT_WAITING_FOREVER		-1
+#define RT_WAITING_NO			0
+
+/* the host builds run the flight code on one thread, there is nothing
+ * to lock against */
+#define rt_enter_critical()
+#define rt_exit_critical()
+#define rt_hw_interrupt_disable()	0
+#define rt_hw_interrupt_enable(level)	((void)(level))
+
+#define rt_malloc(size)			malloc(size)
+#define rt_calloc(n, size)		calloc(n, size)
+#define rt_realloc(ptr, size)	realloc(ptr, size)
+#define rt_free(ptr)			free(ptr)
+#define rt_memset				memset
+#define rt_memcpy				memcpy
+#define rt_strncpy				strncpy
+#define rt_strcmp				strcmp
+
+#define RT_NAME_MAX				8
+
+#define RT_TIMER_FLAG_ONE_SHOT		0x0
+#define RT_TIMER_FLAG_PERIODIC		0x2
+#define RT_TIMER_FLAG_SOFT_TIMER	0x4
+
+#define RT_IPC_FLAG_FIFO		0x00
+#define RT_IPC_FLAG_PRIO		0x01
+
+#define RT_EVENT_FLAG_AND		0x01
+#define RT_EVENT_FLAG_OR		0x02
+#define RT_EVENT_FLAG_CLEAR		0x04
+
+#define RT_DEVICE_FLAG_RDONLY		0x001
+#define RT_DEVICE_FLAG_WRONLY		0x002
+#define RT_DEVICE_FLAG_RDWR			0x003
+
+#define RT_DEVICE_OFLAG_CLOSE		0x000
+#define RT_DEVICE_OFLAG_RDONLY		0x001
+#define RT_DEVICE_OFLAG_WRONLY		0x002
+#define RT_DEVICE_OFLAG_RDWR		0x003
+#define RT_DEVICE_OFLAG_OPEN		0x008
+
+#define RT_DEVICE_CTRL_RTC_GET_TIME	0x10
+
+typedef struct rt_device*	rt_device_t;
+typedef struct rt_timer*	rt_timer_t;
+typedef struct rt_event*	rt_event_t;
+typedef struct rt_mutex*	rt_mutex_t;
+
+/* Timers and events are kept so the thread entries compile, nothing runs
+ * them on the host: the driving program calls the loops itself. */
+struct rt_timer
+{
+	char name[RT_NAME_MAX];
+	void (*timeout)(void *parameter);
+	void *parameter;
+	rt_tick_t init_tick;
+	rt_uint8_t flag;
+};
+
+struct rt_event
+{
+	char name[RT_NAME_MAX];
+	rt_uint32_t set;
+};
+
+/* the interface part of struct rt_device, devices are registered by the
+ * host program (e.g. a simulated motor) and found by name */
+struct rt_device
+{
+	char name[RT_NAME_MAX];
+	rt_uint16_t flag;
+	rt_uint16_t open_flag;
+
+	rt_err_t  (*init)   (rt_device_t dev);
+	rt_err_t  (*open)   (rt_device_t dev, rt_uint16_t oflag);
+	rt_err_t  (*close)  (rt_device_t dev);
+	rt_size_t (*read)   (rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size);
+	rt_size_t (*write)  (rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size);
+	rt_err_t  (*control)(rt_device_t dev, rt_uint8_t cmd, void *args);
+
+	void *user_data;
+	rt_device_t next;
+};
+
+void rt_kprintf(const char *fmt, ...);
+rt_err_t rt_thread_delay(rt_tick_t tick);
+rt_tick_t rt_tick_get(void);
+
+void rt_timer_init(rt_timer_t timer, const char *name, void (*timeout)(void *parameter),
+					void *parameter, rt_tick_t time, rt_uint8_t flag);
+rt_err_t rt_timer_start(rt_timer_t timer);
+rt_err_t rt_timer_stop(rt_timer_t timer);
+
+rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag);
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set);
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+						rt_int32_t timeout, rt_uint32_t *recved);
+
+rt_device_t rt_device_find(const char *name);
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags);
+rt_err_t rt_device_open(rt_device_t dev, rt_uint16_t oflag);
+rt_err_t rt_device_close(rt_device_t dev);
+rt_size_t rt_device_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size);
+rt_size_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size);
+rt_err_t rt_device_control(rt_device_t dev, rt_uint8_t cmd, void *arg);
+
+#endif
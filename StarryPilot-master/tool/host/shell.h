@@ -0,0 +1,18 @@
+/*
+ * File      : shell.h
+ *
+ * Host stand-in for the finsh shell header, there is no shell on the host.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __SHELL_H__
+#define __SHELL_H__
+
+#include <rtthread.h>
+
+char shell_wait_ch(void);
+
+#endif
@@ -0,0 +1,17 @@
+/* host stand-in, only the integer types the driver headers use */
+#ifndef __STM32F4xx_H
+#define __STM32F4xx_H
+
+#include <stdint.h>
+
+/* no cycle counter on the host, delay.c runs on simulated time */
+#define TIME_SOURCE_SIM
+
+typedef int32_t		s32;
+typedef int16_t		s16;
+typedef int8_t		s8;
+typedef uint32_t	u32;
+typedef uint16_t	u16;
+typedef uint8_t		u8;
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * File      : log_export.c
+ *
+ * Slice a .LOG file by time and export selected elements column by column,
+ * as csv or as one contiguous raw/npy array per element.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include "log_file.h"
+
+enum { FMT_CSV = 0, FMT_BIN, FMT_NPY };
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void usage(void)
+{
+	printf("usage: log_export [-l] [-t from:to] [-c NAME,NAME..] [-f csv|bin|npy] [-o out] [-v] file.LOG\n");
+	printf("  -l  list header and elements\n");
+	printf("  -t  time range in s from the start of the log, either side may be empty\n");
+	printf("  -c  elements to export, default all\n");
+	printf("  -f  csv: one file (default stdout), bin/npy: <out>_<NAME>.bin|.npy per element\n");
+	printf("  -o  output file (csv) or prefix (bin/npy), default the log name\n");
+	printf("  -v  print timing\n");
+}
+
+static void list(const log_file_t* log)
+{
+	printf("Start Time: %u ms\n", log->header.start_time);
+	printf("Log Period: %u ms%s\n", log->header.log_period, log->header.log_period ? "" : " (taken as 1 ms)");
+	printf("Element Number: %u\n", log->header.element_num);
+	printf("Header Size: %u byte\n", log->header.header_size);
+	printf("Field Size: %u byte\n", log->header.field_size);
+	printf("Records: %llu (%.1f s)\n", (unsigned long long)log->records,
+		log->records * log->period * 1e-3);
+	printf("%-20s %-10s %s\n", "Name", "Type", "Offset");
+	for(uint32_t i = 0 ; i < log->header.element_num ; i++){
+		printf("%-20s %-10s %u\n", log->info[i].name, log_type_name(log->info[i].type), log->offset[i]);
+	}
+}
+
+static int write_npy(const char* path, const char* descr, uint64_t n, const void* data, size_t bytes)
+{
+	FILE* fp = fopen(path, "wb");
+	char hdr[128];
+	int len;
+
+	if(fp == NULL){
+		return -1;
+	}
+	if(descr){
+		/* npy 1.0: magic, version, header length, dict padded to 64 bytes with '\n' */
+		len = snprintf(hdr, sizeof(hdr), "{'descr': '%s', 'fortran_order': False, 'shape': (%llu,), }",
+			descr, (unsigned long long)n);
+		while((10 + len + 1) % 64) hdr[len++] = ' ';
+		hdr[len++] = '\n';
+		fwrite("\x93NUMPY\x01\x00", 1, 8, fp);
+		fputc(len & 0xff, fp);
+		fputc(len >> 8, fp);
+		fwrite(hdr, 1, len, fp);
+	}
+	fwrite(data, 1, bytes, fp);
+	return fclose(fp);
+}
+
+int main(int argc, char** argv)
+{
+	log_file_t log;
+	char err[128];
+	const char* out = NULL;
+	char* cols = NULL;
+	double from = 0.0, to = -1.0;
+	int fmt = FMT_CSV, do_list = 0, verbose = 0;
+	int sel[LOG_MAX_ELEMENT_NUM], nsel = 0;
+	uint64_t first, last, n;
+	double t0, t1, t2;
+	int opt;
+
+	while((opt = getopt(argc, argv, "lt:c:f:o:vh")) != -1){
+		switch(opt){
+			case 'l': do_list = 1; break;
+			case 't':{
+				char* colon = strchr(optarg, ':');
+				if(colon == NULL){ usage(); return 1; }
+				*colon = '\0';
+				if(*optarg) from = atof(optarg);
+				if(colon[1]) to = atof(colon + 1);
+			}break;
+			case 'c': cols = optarg; break;
+			case 'f':
+				if(strcmp(optarg, "csv") == 0) fmt = FMT_CSV;
+				else if(strcmp(optarg, "bin") == 0) fmt = FMT_BIN;
+				else if(strcmp(optarg, "npy") == 0) fmt = FMT_NPY;
+				else { usage(); return 1; }
+				break;
+			case 'o': out = optarg; break;
+			case 'v': verbose = 1; break;
+			default: usage(); return opt != 'h';
+		}
+	}
+	if(optind >= argc){
+		usage();
+		return 1;
+	}
+
+	t0 = now_ms();
+	if(log_open(&log, argv[optind], err, sizeof(err))){
+		fprintf(stderr, "%s: %s\n", argv[optind], err);
+		return 1;
+	}
+	if(do_list){
+		list(&log);
+		log_close(&log);
+		return 0;
+	}
+
+	if(cols){
+		for(char* tok = strtok(cols, ",") ; tok ; tok = strtok(NULL, ",")){
+			int e = log_find(&log, tok);
+			if(e < 0){
+				fprintf(stderr, "no element %s\n", tok);
+				log_close(&log);
+				return 1;
+			}
+			sel[nsel++] = e;
+		}
+	}else{
+		for(uint32_t i = 0 ; i < log.header.element_num ; i++) sel[nsel++] = i;
+	}
+
+	/* records are periodic, the time index is the record number */
+	first = log_record_at(&log, from * 1e3);
+	last = to < 0.0 ? log.records : log_record_at(&log, to * 1e3);
+	n = last > first ? last - first : 0;
+	log_prefetch(&log, first, n);
+
+	/* gather each element into its own array, csv takes them as float */
+	void* data[LOG_MAX_ELEMENT_NUM];
+	for(int i = 0 ; i < nsel ; i++){
+		uint32_t sz = fmt == FMT_CSV ? sizeof(float) : log_type_size(log.info[sel[i]].type);
+		data[i] = malloc(n * sz + 1);
+		if(data[i] == NULL){
+			fprintf(stderr, "out of memory\n");
+			return 1;
+		}
+		if(fmt == FMT_CSV){
+			log_column_float(&log, sel[i], first, n, data[i]);
+		}else{
+			log_column_raw(&log, sel[i], first, n, data[i]);
+		}
+	}
+	t1 = now_ms();
+
+	if(fmt == FMT_CSV){
+		FILE* fp = out ? fopen(out, "w") : stdout;
+		static char buf[1 << 20];
+		if(fp == NULL){
+			fprintf(stderr, "can not create %s\n", out);
+			return 1;
+		}
+		setvbuf(fp, buf, _IOFBF, sizeof(buf));
+		fprintf(fp, "TIME_MS");
+		for(int i = 0 ; i < nsel ; i++) fprintf(fp, ",%s", log.info[sel[i]].name);
+		fputc('\n', fp);
+		for(uint64_t r = 0 ; r < n ; r++){
+			fprintf(fp, "%llu", (unsigned long long)(log.header.start_time + (first + r) * log.period));
+			for(int i = 0 ; i < nsel ; i++){
+				fprintf(fp, ",%.7g", ((float*)data[i])[r]);
+			}
+			fputc('\n', fp);
+		}
+		if(fp != stdout) fclose(fp);
+		else fflush(fp);
+	}else{
+		const char* ext = fmt == FMT_NPY ? "npy" : "bin";
+		char prefix[512], path[600];
+		uint32_t* tms = malloc(n * sizeof(uint32_t) + 1);
+
+		if(out){
+			snprintf(prefix, sizeof(prefix), "%s", out);
+		}else{
+			char* dot;
+			snprintf(prefix, sizeof(prefix), "%s", argv[optind]);
+			dot = strrchr(prefix, '.');
+			if(dot) *dot = '\0';
+		}
+		for(uint64_t r = 0 ; r < n ; r++){
+			tms[r] = log.header.start_time + (uint32_t)((first + r) * log.period);
+		}
+		snprintf(path, sizeof(path), "%s_TIME_MS.%s", prefix, ext);
+		if(write_npy(path, fmt == FMT_NPY ? "<u4" : NULL, n, tms, n * sizeof(uint32_t))){
+			fprintf(stderr, "can not write %s\n", path);
+			return 1;
+		}
+		for(int i = 0 ; i < nsel ; i++){
+			uint32_t type = log.info[sel[i]].type;
+			snprintf(path, sizeof(path), "%s_%s.%s", prefix, log.info[sel[i]].name, ext);
+			if(write_npy(path, fmt == FMT_NPY ? log_type_npy(type) : NULL, n, data[i], n * log_type_size(type))){
+				fprintf(stderr, "can not write %s\n", path);
+				return 1;
+			}
+		}
+		free(tms);
+	}
+	t2 = now_ms();
+
+	if(verbose){
+		fprintf(stderr, "%llu records x %d elements from record %llu: open+slice %.2f ms, write %.2f ms\n",
+			(unsigned long long)n, nsel, (unsigned long long)first, t1 - t0, t2 - t1);
+	}
+	for(int i = 0 ; i < nsel ; i++) free(data[i]);
+	log_close(&log);
+
+	return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * File      : log_file.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "log_file.h"
+
+uint32_t log_type_size(uint32_t type)
+{
+	switch(type){
+		case LOG_INT8:
+		case LOG_UINT8:		return 1;
+		case LOG_INT16:
+		case LOG_UINT16:	return 2;
+		case LOG_INT32:
+		case LOG_UINT32:
+		case LOG_FLOAT:		return 4;
+		case LOG_DOUBLE:	return 8;
+		default:			return 0;
+	}
+}
+
+const char* log_type_name(uint32_t type)
+{
+	static const char* name[] = {"INT8", "UINT8", "INT16", "UINT16", "INT32", "UINT32", "FLOAT", "DOUBLE"};
+	return type <= LOG_DOUBLE ? name[type] : "?";
+}
+
+const char* log_type_npy(uint32_t type)
+{
+	static const char* descr[] = {"|i1", "|u1", "<i2", "<u2", "<i4", "<u4", "<f4", "<f8"};
+	return type <= LOG_DOUBLE ? descr[type] : NULL;
+}
+
+int log_open(log_file_t* log, const char* path, char* err, size_t err_len)
+{
+	struct stat st;
+	uint32_t off = 0;
+
+	memset(log, 0, sizeof(log_file_t));
+	log->fd = open(path, O_RDONLY);
+	if(log->fd < 0){
+		snprintf(err, err_len, "can not open");
+		return -1;
+	}
+	if(fstat(log->fd, &st) || st.st_size < (off_t)sizeof(LOG_FileHeaderDef)){
+		snprintf(err, err_len, "too short for a log header");
+		goto fail;
+	}
+	log->size = st.st_size;
+	log->base = mmap(NULL, log->size, PROT_READ, MAP_PRIVATE, log->fd, 0);
+	if(log->base == MAP_FAILED){
+		log->base = NULL;
+		snprintf(err, err_len, "mmap failed");
+		goto fail;
+	}
+
+	memcpy(&log->header, log->base, sizeof(LOG_FileHeaderDef));
+	if(log->header.element_num == 0 || log->header.element_num > LOG_MAX_ELEMENT_NUM
+		|| log->header.header_size != sizeof(LOG_FileHeaderDef) + log->header.element_num*sizeof(LOG_ElementInfoDef)
+		|| log->header.header_size > log->size || log->header.field_size == 0){
+		snprintf(err, err_len, "bad header");
+		goto fail;
+	}
+	memcpy(log->info, log->base + sizeof(LOG_FileHeaderDef), log->header.element_num*sizeof(LOG_ElementInfoDef));
+
+	/* elements are members of LOG_FieldDef, laid out with natural alignment */
+	for(uint32_t i = 0 ; i < log->header.element_num ; i++){
+		uint32_t sz = log_type_size(log->info[i].type);
+		log->info[i].name[LOG_MAX_NAME_LENGTH-1] = '\0';
+		if(sz == 0){
+			snprintf(err, err_len, "unknown type %u of %s", log->info[i].type, log->info[i].name);
+			goto fail;
+		}
+		off = (off + sz - 1) / sz * sz;
+		log->offset[i] = off;
+		off += sz;
+	}
+	if(off > log->header.field_size){
+		snprintf(err, err_len, "elements take %u bytes, field size is %u", off, log->header.field_size);
+		goto fail;
+	}
+	log->records = (log->size - log->header.header_size) / log->header.field_size;
+	log->period = log->header.log_period ? log->header.log_period : 1;
+	madvise((void*)log->base, log->size, MADV_RANDOM);
+
+	return 0;
+
+fail:
+	log_close(log);
+	return -1;
+}
+
+void log_close(log_file_t* log)
+{
+	if(log->base){
+		munmap((void*)log->base, log->size);
+		log->base = NULL;
+	}
+	if(log->fd >= 0){
+		close(log->fd);
+	}
+	log->fd = -1;
+}
+
+int log_find(const log_file_t* log, const char* name)
+{
+	for(uint32_t i = 0 ; i < log->header.element_num ; i++){
+		if(strcmp(log->info[i].name, name) == 0){
+			return i;
+		}
+	}
+	return -1;
+}
+
+uint64_t log_record_at(const log_file_t* log, double t_ms)
+{
+	double n;
+
+	if(!(t_ms > 0.0)){
+		return 0;
+	}
+	n = ceil(t_ms / log->period);
+	return n < (double)log->records ? (uint64_t)n : log->records;
+}
+
+void log_prefetch(const log_file_t* log, uint64_t first, uint64_t n)
+{
+	uintptr_t page = sysconf(_SC_PAGESIZE);
+	uintptr_t begin = (uintptr_t)log_record(log, first) & ~(page - 1);
+	uintptr_t end = (uintptr_t)log_record(log, first + n);
+
+	if(n){
+		madvise((void*)begin, end - begin, MADV_SEQUENTIAL);
+		madvise((void*)begin, end - begin, MADV_WILLNEED);
+	}
+}
+
+void log_column_raw(const log_file_t* log, int elem, uint64_t first, uint64_t n, void* out)
+{
+	uint32_t sz = log_type_size(log->info[elem].type);
+	uint32_t stride = log->header.field_size;
+	const uint8_t* src = log_record(log, first) + log->offset[elem];
+	uint8_t* dst = out;
+
+	/* fixed size copies so the compiler turns them into single loads */
+	switch(sz){
+		case 4:
+			for(uint64_t i = 0 ; i < n ; i++, src += stride, dst += 4) memcpy(dst, src, 4);
+			break;
+		case 8:
+			for(uint64_t i = 0 ; i < n ; i++, src += stride, dst += 8) memcpy(dst, src, 8);
+			break;
+		default:
+			for(uint64_t i = 0 ; i < n ; i++, src += stride, dst += sz) memcpy(dst, src, sz);
+			break;
+	}
+}
+
+void log_column_float(const log_file_t* log, int elem, uint64_t first, uint64_t n, float* out)
+{
+	uint32_t type = log->info[elem].type;
+	uint32_t stride = log->header.field_size;
+	const uint8_t* src = log_record(log, first) + log->offset[elem];
+
+	if(type == LOG_FLOAT){
+		log_column_raw(log, elem, first, n, out);
+		return;
+	}
+	for(uint64_t i = 0 ; i < n ; i++, src += stride){
+		union { int8_t i8; uint8_t u8; int16_t i16; uint16_t u16; int32_t i32; uint32_t u32; double d; } v;
+		memcpy(&v, src, log_type_size(type));
+		switch(type){
+			case LOG_INT8:		out[i] = v.i8; break;
+			case LOG_UINT8:		out[i] = v.u8; break;
+			case LOG_INT16:		out[i] = v.i16; break;
+			case LOG_UINT16:	out[i] = v.u16; break;
+			case LOG_INT32:		out[i] = v.i32; break;
+			case LOG_UINT32:	out[i] = v.u32; break;
+			default:			out[i] = (float)v.d; break;
+		}
+	}
+}
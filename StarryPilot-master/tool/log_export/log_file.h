@@ -0,0 +1,86 @@
+/*
+ * File      : log_file.h
+ *
+ * Read only access to the .LOG files written by logger.c, through mmap.
+ * A log is a header (LOG_HeaderDef without the pointer, followed by
+ * element_num LOG_ElementInfoDef) and then fixed size records every
+ * log_period ms, so record n is at header_size + n*field_size and was
+ * taken at start_time + n*log_period.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __LOG_FILE_H__
+#define __LOG_FILE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* must match starry_fmu/Framework/include/logger.h */
+#define LOG_MAX_NAME_LENGTH		20
+#define LOG_MAX_ELEMENT_NUM		100
+
+enum
+{
+	LOG_INT8 = 0,
+	LOG_UINT8,
+	LOG_INT16,
+	LOG_UINT16,
+	LOG_INT32,
+	LOG_UINT32,
+	LOG_FLOAT,
+	LOG_DOUBLE,
+};
+
+typedef struct
+{
+	char name[LOG_MAX_NAME_LENGTH];
+	uint32_t type;
+}LOG_ElementInfoDef;
+
+typedef struct
+{
+	uint32_t start_time;
+	uint32_t log_period;
+	uint32_t element_num;
+	uint32_t header_size;
+	uint32_t field_size;
+}LOG_FileHeaderDef;
+
+typedef struct
+{
+	const uint8_t* base;		/* whole file, mapped */
+	size_t size;
+	LOG_FileHeaderDef header;
+	LOG_ElementInfoDef info[LOG_MAX_ELEMENT_NUM];	/* names are 0 terminated */
+	uint32_t offset[LOG_MAX_ELEMENT_NUM];			/* of each element in a record */
+	uint64_t records;			/* complete records, a torn last one is ignored */
+	uint32_t period;			/* log_period, 1 if the header has 0 (old logs) */
+	int fd;
+}log_file_t;
+
+int log_open(log_file_t* log, const char* path, char* err, size_t err_len);
+void log_close(log_file_t* log);
+
+int log_find(const log_file_t* log, const char* name);
+uint32_t log_type_size(uint32_t type);
+const char* log_type_name(uint32_t type);
+const char* log_type_npy(uint32_t type);
+
+/* first record taken at or after t ms from the start of the log */
+uint64_t log_record_at(const log_file_t* log, double t_ms);
+static inline const uint8_t* log_record(const log_file_t* log, uint64_t n)
+{
+	return log->base + log->header.header_size + n * log->header.field_size;
+}
+
+/* tell the kernel records [first, first+n) will be read in order */
+void log_prefetch(const log_file_t* log, uint64_t first, uint64_t n);
+
+/* gather records [first, first+n) of one element into a contiguous array */
+void log_column_raw(const log_file_t* log, int elem, uint64_t first, uint64_t n, void* out);
+void log_column_float(const log_file_t* log, int elem, uint64_t first, uint64_t n, float* out);
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * File      : log_gen.c
+ *
+ * Write a synthetic .LOG with the header and elements of logger.c, to try
+ * log_export and log_fleet on long or many logs.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "log_file.h"
+
+/* element_info_list of starry_fmu/Framework/source/Logger/logger.c */
+static const char* _elem[] = {
+	"QUATERNION_W", "QUATERNION_X", "QUATERNION_Y", "QUATERNION_Z",
+	"ROLL", "PITCH", "YAW", "X", "Y", "Z", "VX", "VY", "VZ",
+	"GYR_X", "GYR_Y", "GYR_Z", "GYR_FILTER_X", "GYR_FILTER_Y", "GYR_FILTER_Z",
+	"ACC_X", "ACC_Y", "ACC_Z", "ACC_FILTER_X", "ACC_FILTER_Y", "ACC_FILTER_Z",
+	"MAG_X", "MAG_Y", "MAG_Z", "MAG_FILTER_X", "MAG_FILTER_Y", "MAG_FILTER_Z",
+	"MOTOR_1", "MOTOR_2", "MOTOR_3", "MOTOR_4",
+	"ADRC_PITCH_SP_RATE", "ADRC_PITCH_V", "ADRC_PITCH_V1", "ADRC_PITCH_V2", "ADRC_PITCH_Z1", "ADRC_PITCH_Z2",
+	"GPS_LAT", "GPS_LON", "GPS_X", "GPS_Y", "GPS_Z", "GPS_VN", "GPS_VE", "GPS_VD", "GPS_HDOP",
+	"BARO_ALT", "BARO_VEL", "ROLL_SP", "PITCH_SP",
+};
+#define ELEM_NUM	(sizeof(_elem)/sizeof(_elem[0]))
+
+static float noise(void)
+{
+	return (float)rand() / RAND_MAX - 0.5f;
+}
+
+int main(int argc, char** argv)
+{
+	LOG_FileHeaderDef hdr;
+	LOG_ElementInfoDef info[ELEM_NUM];
+	float rec[ELEM_NUM];
+	double seconds, vib;
+	uint32_t period;
+	uint64_t n;
+	FILE* fp;
+
+	if(argc < 3){
+		printf("usage: log_gen out.LOG seconds [period_ms=1] [seed=1]\n");
+		return 1;
+	}
+	seconds = atof(argv[2]);
+	period = argc > 3 ? atoi(argv[3]) : 1;
+	srand(argc > 4 ? atoi(argv[4]) : 1);
+	vib = 0.5 + 2.0 * rand() / RAND_MAX;
+
+	hdr.start_time = 1000 + rand() % 5000;
+	hdr.log_period = period;
+	hdr.element_num = ELEM_NUM;
+	hdr.header_size = sizeof(hdr) + sizeof(info);
+	hdr.field_size = sizeof(rec);
+	memset(info, 0, sizeof(info));
+	for(uint32_t i = 0 ; i < ELEM_NUM ; i++){
+		strncpy(info[i].name, _elem[i], LOG_MAX_NAME_LENGTH - 1);
+		info[i].type = LOG_FLOAT;
+	}
+
+	fp = fopen(argv[1], "wb");
+	if(fp == NULL){
+		printf("can not create %s\n", argv[1]);
+		return 1;
+	}
+	fwrite(&hdr, sizeof(hdr), 1, fp);
+	fwrite(info, sizeof(info), 1, fp);
+
+	n = (uint64_t)(seconds * 1000.0 / period);
+	for(uint64_t k = 0 ; k < n ; k++){
+		double t = k * period * 1e-3;
+		float thr = 0.55f + 0.3f * (float)sin(t * 0.3) + 0.05f * noise();
+
+		memset(rec, 0, sizeof(rec));
+		rec[0] = 1.0f;
+		rec[52] = 10.0f * (float)sin(t * 0.5);				/* ROLL_SP */
+		rec[53] = 8.0f * (float)cos(t * 0.4);				/* PITCH_SP */
+		rec[4] = rec[52] + noise();							/* ROLL */
+		rec[5] = rec[53] + noise();							/* PITCH */
+		rec[6] = (float)fmod(t * 5.0, 360.0) - 180.0f;		/* YAW */
+		rec[19] = (float)vib * noise();						/* ACC */
+		rec[20] = (float)vib * noise();
+		rec[21] = -9.8f + (float)vib * noise();
+		for(int m = 0 ; m < 4 ; m++){
+			float o = thr + 0.1f * noise();
+			rec[31 + m] = o > 1.0f ? 1.0f : o;				/* MOTOR_1..4 */
+		}
+		rec[41] = 31.2304f;
+		rec[42] = 121.4737f;
+		rec[49] = 0.8f + 0.4f * (float)sin(t * 0.01) + 0.1f * noise();	/* GPS_HDOP */
+		rec[50] = 10.0f + (float)t * 0.01f;
+		fwrite(rec, sizeof(rec), 1, fp);
+	}
+	fclose(fp);
+
+	return 0;
+}
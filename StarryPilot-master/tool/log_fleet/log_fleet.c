@@ -0,0 +1,310 @@
+/*
+ * File      : log_fleet.c
+ *
+ * Summarise every .LOG below one or more directories on a pool of worker
+ * threads and print one report: vibration, attitude tracking, gps hdop and
+ * motor saturation per flight, followed by the fleet totals.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <ftw.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "log_file.h"
+
+#define BLOCK_RECORDS		4096
+#define VIB_TAU_S			0.5		/* high pass for the vibration, removes attitude and gravity */
+#define HDOP_BAD			2.0f
+
+/* elements read from a log, -1 if a log does not have it */
+enum
+{
+	E_ACC_X = 0, E_ACC_Y, E_ACC_Z,
+	E_ROLL, E_PITCH, E_ROLL_SP, E_PITCH_SP,
+	E_PITCH_SP_RATE, E_GYR_Y,
+	E_HDOP,
+	E_MOTOR_1, E_MOTOR_2, E_MOTOR_3, E_MOTOR_4,
+	E_NUM
+};
+
+static const char* _elem_name[E_NUM] = {
+	"ACC_X", "ACC_Y", "ACC_Z",
+	"ROLL", "PITCH", "ROLL_SP", "PITCH_SP",
+	"ADRC_PITCH_SP_RATE", "GYR_FILTER_Y",
+	"GPS_HDOP",
+	"MOTOR_1", "MOTOR_2", "MOTOR_3", "MOTOR_4",
+};
+
+typedef struct
+{
+	double sum_sq;
+	double max;
+	uint64_t n;
+}rms_t;
+
+typedef struct
+{
+	char* path;
+	char err[96];
+	int ok;
+	double duration;		/* s */
+	rms_t vib[3];			/* m/s/s, high passed */
+	rms_t roll_err;			/* deg */
+	rms_t pitch_err;		/* deg */
+	rms_t pitch_rate_err;	/* rad/s */
+	double hdop_sum, hdop_max;
+	uint64_t hdop_n, hdop_bad;
+	uint64_t motor_sat;		/* records with a motor at the limit */
+	uint64_t records;
+	double period;			/* s */
+}flight_t;
+
+static flight_t* _flight;
+static int _flight_num, _flight_cap;
+static atomic_int _next;
+static float _motor_limit = 0.9f;
+
+static void rms_add(rms_t* r, double v)
+{
+	if(!isfinite(v)){
+		return;
+	}
+	r->sum_sq += v*v;
+	if(fabs(v) > r->max) r->max = fabs(v);
+	r->n++;
+}
+
+static double rms(const rms_t* r)
+{
+	return r->n ? sqrt(r->sum_sq / r->n) : NAN;
+}
+
+static void analyse(flight_t* f)
+{
+	log_file_t log;
+	int e[E_NUM];
+	float* col[E_NUM];
+	double lp[3] = {0, 0, 0}, alpha;
+	int lp_init = 0;
+
+	if(log_open(&log, f->path, f->err, sizeof(f->err))){
+		return;
+	}
+	for(int i = 0 ; i < E_NUM ; i++){
+		e[i] = log_find(&log, _elem_name[i]);
+		col[i] = malloc(BLOCK_RECORDS * sizeof(float));
+	}
+	f->period = log.period * 1e-3;
+	f->records = log.records;
+	f->duration = log.records * f->period;
+	alpha = f->period / (VIB_TAU_S + f->period);
+	log_prefetch(&log, 0, log.records);
+
+	/* go through the log in blocks, each element gathered into a short array */
+	for(uint64_t first = 0 ; first < log.records ; first += BLOCK_RECORDS){
+		uint64_t n = log.records - first < BLOCK_RECORDS ? log.records - first : BLOCK_RECORDS;
+
+		for(int i = 0 ; i < E_NUM ; i++){
+			if(e[i] >= 0) log_column_float(&log, e[i], first, n, col[i]);
+		}
+		for(uint64_t k = 0 ; k < n ; k++){
+			if(e[E_ACC_X] >= 0 && e[E_ACC_Y] >= 0 && e[E_ACC_Z] >= 0){
+				for(int a = 0 ; a < 3 ; a++){
+					double v = col[E_ACC_X + a][k];
+					if(!isfinite(v)) continue;
+					if(!lp_init) lp[a] = v;
+					lp[a] += alpha * (v - lp[a]);
+					rms_add(&f->vib[a], v - lp[a]);
+				}
+				lp_init = 1;
+			}
+			if(e[E_ROLL] >= 0 && e[E_ROLL_SP] >= 0){
+				rms_add(&f->roll_err, col[E_ROLL_SP][k] - col[E_ROLL][k]);
+			}
+			if(e[E_PITCH] >= 0 && e[E_PITCH_SP] >= 0){
+				rms_add(&f->pitch_err, col[E_PITCH_SP][k] - col[E_PITCH][k]);
+			}
+			if(e[E_PITCH_SP_RATE] >= 0 && e[E_GYR_Y] >= 0){
+				rms_add(&f->pitch_rate_err, col[E_PITCH_SP_RATE][k] - col[E_GYR_Y][k]);
+			}
+			if(e[E_HDOP] >= 0 && col[E_HDOP][k] > 0.0f){
+				/* 0 until the gps has a fix */
+				f->hdop_sum += col[E_HDOP][k];
+				if(col[E_HDOP][k] > f->hdop_max) f->hdop_max = col[E_HDOP][k];
+				f->hdop_bad += col[E_HDOP][k] > HDOP_BAD;
+				f->hdop_n++;
+			}
+			for(int m = E_MOTOR_1 ; m <= E_MOTOR_4 ; m++){
+				if(e[m] >= 0 && col[m][k] >= _motor_limit - 1e-4f){
+					f->motor_sat++;
+					break;
+				}
+			}
+		}
+	}
+
+	for(int i = 0 ; i < E_NUM ; i++) free(col[i]);
+	log_close(&log);
+	f->ok = 1;
+}
+
+static void* worker(void* arg)
+{
+	int i;
+
+	(void)arg;
+	while((i = atomic_fetch_add(&_next, 1)) < _flight_num){
+		analyse(&_flight[i]);
+	}
+	return NULL;
+}
+
+static int collect(const char* path, const struct stat* st, int type, struct FTW* ftw)
+{
+	size_t len = strlen(path);
+
+	(void)st; (void)ftw;
+	if(type == FTW_F && len > 4 && strcasecmp(path + len - 4, ".log") == 0){
+		if(_flight_num == _flight_cap){
+			_flight_cap = _flight_cap ? _flight_cap * 2 : 64;
+			_flight = realloc(_flight, _flight_cap * sizeof(flight_t));
+		}
+		memset(&_flight[_flight_num], 0, sizeof(flight_t));
+		_flight[_flight_num++].path = strdup(path);
+	}
+	return 0;
+}
+
+static int by_path(const void* a, const void* b)
+{
+	return strcmp(((const flight_t*)a)->path, ((const flight_t*)b)->path);
+}
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* the attitude errors need a setpoint in the log, n/a without one */
+static const char* err_str(char* buf, size_t size, const rms_t* r, double v)
+{
+	if(!r->n){
+		return "n/a";
+	}
+	snprintf(buf, size, "%.3f", v);
+	return buf;
+}
+
+static void report(FILE* fp)
+{
+	double hours = 0, vib_worst = 0, sat_time = 0, hdop_sum = 0;
+	uint64_t hdop_n = 0, records = 0;
+	int ok = 0;
+	const char* worst = "-";
+
+	fprintf(fp, "path,duration_s,vib_rms_x,vib_rms_y,vib_rms_z,vib_max,roll_err_rms_deg,pitch_err_rms_deg,pitch_err_max_deg,"
+				"pitch_rate_err_rms,hdop_mean,hdop_max,hdop_bad_pct,motor_sat_s,motor_sat_pct\n");
+	for(int i = 0 ; i < _flight_num ; i++){
+		flight_t* f = &_flight[i];
+		double vib_max, sat;
+		char roll_rms[32], pitch_rms[32], pitch_max[32];
+
+		if(!f->ok){
+			fprintf(fp, "%s,error: %s\n", f->path, f->err);
+			continue;
+		}
+		vib_max = fmax(f->vib[0].max, fmax(f->vib[1].max, f->vib[2].max));
+		sat = f->motor_sat * f->period;
+		fprintf(fp, "%s,%.1f,%.3f,%.3f,%.3f,%.3f,%s,%s,%s,%.4f,%.2f,%.2f,%.1f,%.1f,%.2f\n",
+			f->path, f->duration, rms(&f->vib[0]), rms(&f->vib[1]), rms(&f->vib[2]), vib_max,
+			err_str(roll_rms, sizeof(roll_rms), &f->roll_err, rms(&f->roll_err)),
+			err_str(pitch_rms, sizeof(pitch_rms), &f->pitch_err, rms(&f->pitch_err)),
+			err_str(pitch_max, sizeof(pitch_max), &f->pitch_err, f->pitch_err.max), rms(&f->pitch_rate_err),
+			f->hdop_n ? f->hdop_sum / f->hdop_n : NAN, f->hdop_n ? f->hdop_max : NAN,
+			f->hdop_n ? 100.0 * f->hdop_bad / f->hdop_n : NAN,
+			sat, f->records ? 100.0 * f->motor_sat / f->records : NAN);
+
+		ok++;
+		hours += f->duration / 3600.0;
+		sat_time += sat;
+		hdop_sum += f->hdop_sum;
+		hdop_n += f->hdop_n;
+		records += f->records;
+		for(int a = 0 ; a < 3 ; a++){
+			if(rms(&f->vib[a]) > vib_worst){
+				vib_worst = rms(&f->vib[a]);
+				worst = f->path;
+			}
+		}
+	}
+	fprintf(fp, "\n# fleet: %d flights (%d unreadable), %.2f h, %llu records\n", ok, _flight_num - ok,
+		hours, (unsigned long long)records);
+	fprintf(fp, "# worst vibration rms %.3f m/s/s in %s\n", vib_worst, worst);
+	fprintf(fp, "# mean hdop %.2f, motor saturation %.1f s (%.2f%% of flight time)\n",
+		hdop_n ? hdop_sum / hdop_n : NAN, sat_time, hours > 0 ? 100.0 * sat_time / (hours * 3600.0) : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+	int jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	const char* out = NULL;
+	pthread_t* tid;
+	double t0, t1;
+	int opt;
+
+	while((opt = getopt(argc, argv, "j:o:s:h")) != -1){
+		switch(opt){
+			case 'j': jobs = atoi(optarg); break;
+			case 'o': out = optarg; break;
+			case 's': _motor_limit = atof(optarg); break;
+			default:
+				printf("usage: log_fleet [-j threads] [-s motor_limit=0.9] [-o report.csv] dir [dir..]\n");
+				return opt != 'h';
+		}
+	}
+	if(optind >= argc || jobs < 1){
+		printf("usage: log_fleet [-j threads] [-s motor_limit=0.9] [-o report.csv] dir [dir..]\n");
+		return 1;
+	}
+	for(int i = optind ; i < argc ; i++){
+		if(nftw(argv[i], collect, 16, FTW_PHYS)){
+			fprintf(stderr, "can not walk %s\n", argv[i]);
+			return 1;
+		}
+	}
+	/* sorted so the report does not depend on the thread timing */
+	qsort(_flight, _flight_num, sizeof(flight_t), by_path);
+
+	t0 = now_sec();
+	if(jobs > _flight_num) jobs = _flight_num > 0 ? _flight_num : 1;
+	tid = malloc(jobs * sizeof(pthread_t));
+	for(int i = 0 ; i < jobs ; i++) pthread_create(&tid[i], NULL, worker, NULL);
+	for(int i = 0 ; i < jobs ; i++) pthread_join(tid[i], NULL);
+	t1 = now_sec();
+
+	{
+		FILE* fp = out ? fopen(out, "w") : stdout;
+		if(fp == NULL){
+			fprintf(stderr, "can not create %s\n", out);
+			return 1;
+		}
+		report(fp);
+		if(fp != stdout) fclose(fp);
+	}
+	fprintf(stderr, "%d logs on %d threads in %.2f s\n", _flight_num, jobs, t1 - t0);
+
+	return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * File      : mcn_shm_check.c
+ *
+ * Host check of the shared memory bridge: a forked writer publishes two
+ * topics through uMCN with host_mcn_shm.c mirroring them, the reader
+ * copies them as fast as it can and checks that no copy is torn.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+#include "global.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "host_port.h"
+#include "host_mcn_shm.h"
+#include "mcn_shm_reader.h"
+
+#define SHM_NAME		"/starry_mcn_check"
+#define BIG_WORDS		256
+#define SMALL_WORDS		4
+
+MCN_DEFINE(SHM_CHECK_BIG, BIG_WORDS*4);
+MCN_DEFINE(SHM_CHECK_SMALL, SMALL_WORDS*4);
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/* every word of publish i is i, the simulated clock is at i us */
+static int writer(uint32_t num, int ready_fd)
+{
+	uint32_t big[BIG_WORDS], small[SMALL_WORDS];
+	char c;
+
+	host_port_init();
+	host_console_level(1);
+	mcn_advertise(MCN_ID(SHM_CHECK_BIG));
+	mcn_advertise(MCN_ID(SHM_CHECK_SMALL));
+	/* published before the bridge is up, it must show as the first write */
+	memset(small, 0, sizeof(small));
+	mcn_publish(MCN_ID(SHM_CHECK_SMALL), small);
+
+	if(host_mcn_shm_open(SHM_NAME, "SHM_CHECK_BIG,SHM_CHECK_SMALL") != 0)
+		return 1;
+	/* wait for the reader to map the segment */
+	if(read(ready_fd, &c, 1) != 1)
+		return 1;
+
+	double t0 = now();
+	for(uint32_t i = 1 ; i <= num ; i++){
+		time_sim_step(1);
+		for(int k = 0 ; k < BIG_WORDS ; k++)
+			big[k] = i;
+		for(int k = 0 ; k < SMALL_WORDS ; k++)
+			small[k] = i;
+		mcn_publish(MCN_ID(SHM_CHECK_BIG), big);
+		mcn_publish(MCN_ID(SHM_CHECK_SMALL), small);
+	}
+	double t1 = now();
+	printf("writer: %u publishes of each topic, %.0f ns per publish\n", num, (t1 - t0)*1e9 / (2.0*num));
+
+	host_mcn_shm_close();
+	return 0;
+}
+
+/* a copy is good if all words are the same and agree with the count and
+ * the time; offset is the count of the publishes before the bridge */
+static int check_copy(const uint32_t* buf, int words, uint32_t cnt, uint64_t time_us, uint32_t offset)
+{
+	uint32_t v = cnt - offset;
+
+	for(int k = 0 ; k < words ; k++){
+		if(buf[k] != v)
+			return 0;
+	}
+	return cnt == offset || time_us == v;
+}
+
+static int reader(uint32_t num, int ready_fd)
+{
+	McnShm_Reader r;
+	uint32_t big[BIG_WORDS], small[SMALL_WORDS];
+	uint32_t cnt, last_big = 0, last_small = 0;
+	uint64_t time_us;
+	long copies = 0, torn = 0, seen_big = 0, back = 0;
+	int fail = 0;
+
+	if(mcn_shm_reader_open(&r, SHM_NAME, 5000) != 0){
+		printf("can not open %s\n", SHM_NAME);
+		return 1;
+	}
+	int i_big = mcn_shm_reader_find(&r, "SHM_CHECK_BIG");
+	int i_small = mcn_shm_reader_find(&r, "SHM_CHECK_SMALL");
+	if(mcn_shm_reader_topic_num(&r) != 2 || i_big < 0 || i_small < 0
+		|| mcn_shm_reader_topic(&r, i_big)->size != BIG_WORDS*4
+		|| mcn_shm_reader_topic(&r, i_small)->size != SMALL_WORDS*4){
+		printf("topic table wrong\n");
+		mcn_shm_reader_close(&r);
+		return 1;
+	}
+	/* the publish before the bridge, before the writer goes on */
+	mcn_shm_reader_copy(&r, i_small, small, &cnt, &time_us);
+	if(cnt != 1 || small[0] != 0){
+		printf("the publish before the bridge is missing, count %u\n", cnt);
+		fail = 1;
+	}
+	if(write(ready_fd, "r", 1) != 1){
+		mcn_shm_reader_close(&r);
+		return 1;
+	}
+
+	double t0 = now();
+	for(;;){
+		/* closed is read first, the copies after it see the last write */
+		int closed = mcn_shm_reader_closed(&r);
+
+		mcn_shm_reader_copy(&r, i_big, big, &cnt, &time_us);
+		if(!check_copy(big, BIG_WORDS, cnt, time_us, 0))
+			torn++;
+		if(cnt < last_big)
+			back++;
+		if(cnt != last_big)
+			seen_big++;
+		last_big = cnt;
+
+		mcn_shm_reader_copy(&r, i_small, small, &cnt, &time_us);
+		if(!check_copy(small, SMALL_WORDS, cnt, time_us, 1))
+			torn++;
+		if(cnt < last_small)
+			back++;
+		last_small = cnt;
+
+		copies += 2;
+		if(closed)
+			break;
+	}
+	double t1 = now();
+
+	printf("reader: %ld copies, %.0f ns per copy, %ld of %u publishes of the big topic seen\n",
+		copies, (t1 - t0)*1e9 / copies, seen_big, num);
+	if(torn){
+		printf("%ld copies torn or inconsistent\n", torn);
+		fail = 1;
+	}
+	if(back){
+		printf("the count went back %ld times\n", back);
+		fail = 1;
+	}
+	if(last_big != num || last_small != num + 1){
+		printf("last counts %u %u, expected %u %u\n", last_big, last_small, num, num + 1);
+		fail = 1;
+	}
+
+	mcn_shm_reader_close(&r);
+	return fail;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t num = argc > 1 ? (uint32_t)atol(argv[1]) : 1000000;
+	int fd[2];
+	int status;
+
+	if(pipe(fd) != 0){
+		perror("pipe");
+		return 1;
+	}
+	pid_t pid = fork();
+	if(pid < 0){
+		perror("fork");
+		return 1;
+	}
+	if(pid == 0){
+		close(fd[1]);
+		int ret = writer(num, fd[0]);
+		fflush(stdout);
+		_exit(ret);
+	}
+	close(fd[0]);
+
+	int fail = reader(num, fd[1]);
+	close(fd[1]);
+	waitpid(pid, &status, 0);
+	if(!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+		printf("writer failed\n");
+		fail = 1;
+	}
+
+	printf("%s\n", fail ? "FAIL" : "OK");
+	return fail;
+}
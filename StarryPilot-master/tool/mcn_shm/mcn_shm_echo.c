@@ -0,0 +1,148 @@
+/*
+ * File      : mcn_shm_echo.c
+ *
+ * Lists the uMCN topics a host run mirrors into shared memory, or prints
+ * one of them on every publish, as floats or as hex words.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include "mcn_shm_reader.h"
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+static void usage(void)
+{
+	printf("usage: mcn_shm_echo [-n segment] [-w wait ms] [-x] [-c count] [topic]\n");
+	printf("  without a topic the mirrored topics are listed with their rate\n");
+	printf("  -n    segment name, default %s\n", MCN_SHM_DEFAULT_NAME);
+	printf("  -w    time to wait for the segment, default 5000, -1 forever\n");
+	printf("  -x    print the data as hex words instead of floats\n");
+	printf("  -c    exit after count publishes\n");
+}
+
+static void list(McnShm_Reader* r)
+{
+	int num = mcn_shm_reader_topic_num(r);
+	uint32_t cnt0[MCN_SHM_MAX_TOPIC], cnt1[MCN_SHM_MAX_TOPIC];
+	uint64_t time0[MCN_SHM_MAX_TOPIC], time1[MCN_SHM_MAX_TOPIC];
+	uint32_t size = 8;
+	double t0, t1;
+
+	for(int i = 0 ; i < num ; i++){
+		if(mcn_shm_reader_topic(r, i)->size > size)
+			size = mcn_shm_reader_topic(r, i)->size;
+	}
+	uint64_t buf[size / 8 + 1];
+
+	/* the rate over a second of wall time and of simulated time, they
+	 * differ unless the run is in real time */
+	t0 = now();
+	for(int i = 0 ; i < num ; i++)
+		mcn_shm_reader_copy(r, i, buf, &cnt0[i], &time0[i]);
+	usleep(1000000);
+	t1 = now();
+	for(int i = 0 ; i < num ; i++)
+		mcn_shm_reader_copy(r, i, buf, &cnt1[i], &time1[i]);
+
+	printf("%-24s %6s %10s %10s %10s\n", "topic", "size", "count", "hz(wall)", "hz(sim)");
+	for(int i = 0 ; i < num ; i++){
+		const McnShm_Topic* t = mcn_shm_reader_topic(r, i);
+		uint32_t d = cnt1[i] - cnt0[i];
+		double sim = d > 1 && time1[i] > time0[i] ? d / ((time1[i] - time0[i])*1e-6) : 0.0;
+
+		printf("%-24s %6u %10u %10.1f %10.1f\n", t->name, t->size, cnt1[i], d / (t1 - t0), sim);
+	}
+	if(mcn_shm_reader_closed(r))
+		printf("the writer has closed the segment\n");
+}
+
+int main(int argc, char** argv)
+{
+	const char* name = MCN_SHM_DEFAULT_NAME;
+	int wait_ms = 5000;
+	int hex = 0;
+	long count = -1;
+	int opt;
+
+	while((opt = getopt(argc, argv, "n:w:xc:h")) != -1){
+		switch(opt){
+		case 'n': name = optarg; break;
+		case 'w': wait_ms = atoi(optarg); break;
+		case 'x': hex = 1; break;
+		case 'c': count = atol(optarg); break;
+		default: usage(); return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	McnShm_Reader r;
+	if(mcn_shm_reader_open(&r, name, wait_ms) != 0){
+		printf("can not open %s\n", name);
+		return 1;
+	}
+
+	if(optind >= argc){
+		list(&r);
+		mcn_shm_reader_close(&r);
+		return 0;
+	}
+
+	int topic = mcn_shm_reader_find(&r, argv[optind]);
+	if(topic < 0){
+		printf("%s is not mirrored in %s\n", argv[optind], name);
+		mcn_shm_reader_close(&r);
+		return 1;
+	}
+
+	const McnShm_Topic* t = mcn_shm_reader_topic(&r, topic);
+	uint32_t words = t->size / 4;
+	uint32_t buf[t->size / 4 + 1];
+	uint32_t cnt = 0, last = 0;
+	uint64_t time_us;
+
+	/* the latest publish first, if there is one */
+	mcn_shm_reader_copy(&r, topic, buf, &cnt, &time_us);
+	if(cnt == 0 && !mcn_shm_reader_wait(&r, topic, 0, -1))
+		count = 0;
+	while(count != 0){
+		mcn_shm_reader_copy(&r, topic, buf, &cnt, &time_us);
+		/* a reader slower than the writer sees only the latest publish */
+		if(last != 0 && cnt - last > 1)
+			printf("(%u skipped)\n", cnt - last - 1);
+		last = cnt;
+
+		printf("%u %.6f:", cnt, time_us*1e-6);
+		for(uint32_t i = 0 ; i < words ; i++){
+			if(hex){
+				printf(" %08x", buf[i]);
+			}else{
+				float f;
+				memcpy(&f, &buf[i], sizeof(f));
+				printf(" %g", f);
+			}
+		}
+		printf("\n");
+		fflush(stdout);
+
+		if(count > 0)
+			count--;
+		if(count != 0 && !mcn_shm_reader_wait(&r, topic, cnt, -1))
+			break;
+	}
+
+	mcn_shm_reader_close(&r);
+	return 0;
+}
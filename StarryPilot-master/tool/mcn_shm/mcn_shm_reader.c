@@ -0,0 +1,156 @@
+/*
+ * File      : mcn_shm_reader.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mcn_shm_reader.h"
+
+static double _now_ms(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1e3 + t.tv_nsec*1e-6;
+}
+
+static void _sleep_us(long us)
+{
+	struct timespec t = {us / 1000000, (us % 1000000) * 1000};
+
+	nanosleep(&t, NULL);
+}
+
+static int _map(McnShm_Reader* reader, const char* name)
+{
+	struct stat st;
+	int fd = shm_open(name, O_RDONLY, 0);
+
+	if(fd < 0)
+		return -1;
+	/* the writer sizes the segment right after creating it */
+	if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(McnShm_Header)){
+		close(fd);
+		return -1;
+	}
+	void* p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED)
+		return -1;
+
+	reader->shm = (const McnShm_Header*)p;
+	reader->size = st.st_size;
+	return 0;
+}
+
+int mcn_shm_reader_open(McnShm_Reader* reader, const char* name, int timeout_ms)
+{
+	double start = _now_ms();
+
+	reader->shm = NULL;
+	reader->size = 0;
+	for(;;){
+		if(reader->shm == NULL)
+			_map(reader, name);
+		/* the table is complete once magic is set */
+		if(reader->shm != NULL && __atomic_load_n(&reader->shm->magic, __ATOMIC_ACQUIRE) == MCN_SHM_MAGIC){
+			if(reader->shm->version != MCN_SHM_VERSION || reader->shm->size > reader->size){
+				mcn_shm_reader_close(reader);
+				return -1;
+			}
+			return 0;
+		}
+		if(timeout_ms >= 0 && _now_ms() - start > timeout_ms){
+			mcn_shm_reader_close(reader);
+			return -1;
+		}
+		_sleep_us(10000);
+	}
+}
+
+void mcn_shm_reader_close(McnShm_Reader* reader)
+{
+	if(reader->shm != NULL)
+		munmap((void*)reader->shm, reader->size);
+	reader->shm = NULL;
+	reader->size = 0;
+}
+
+int mcn_shm_reader_topic_num(const McnShm_Reader* reader)
+{
+	return reader->shm->topic_num;
+}
+
+const McnShm_Topic* mcn_shm_reader_topic(const McnShm_Reader* reader, int topic)
+{
+	if(topic < 0 || (uint32_t)topic >= reader->shm->topic_num)
+		return NULL;
+	return &reader->shm->topic[topic];
+}
+
+int mcn_shm_reader_find(const McnShm_Reader* reader, const char* name)
+{
+	for(uint32_t i = 0 ; i < reader->shm->topic_num ; i++){
+		if(strncmp(reader->shm->topic[i].name, name, MCN_SHM_NAME_LEN) == 0)
+			return i;
+	}
+	return -1;
+}
+
+int mcn_shm_reader_closed(const McnShm_Reader* reader)
+{
+	return __atomic_load_n(&reader->shm->state, __ATOMIC_ACQUIRE) == MCN_SHM_STATE_CLOSED;
+}
+
+int mcn_shm_reader_copy(const McnShm_Reader* reader, int topic, void* buffer, uint32_t* cnt, uint64_t* time_us)
+{
+	const McnShm_Topic* t = mcn_shm_reader_topic(reader, topic);
+	uint32_t s1, s2;
+	uint64_t time;
+
+	if(t == NULL)
+		return -1;
+	do{
+		s1 = __atomic_load_n(&t->seq, __ATOMIC_ACQUIRE);
+		if(s1 & 1){
+			/* being written, it takes a memcpy */
+			continue;
+		}
+		time = t->time_us;
+		memcpy(buffer, (const uint8_t*)reader->shm + t->offset, t->size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		s2 = __atomic_load_n(&t->seq, __ATOMIC_RELAXED);
+	}while((s1 & 1) || s1 != s2);
+
+	if(cnt)
+		*cnt = s1 / 2;
+	if(time_us)
+		*time_us = time;
+	return 0;
+}
+
+int mcn_shm_reader_wait(const McnShm_Reader* reader, int topic, uint32_t cnt, int timeout_ms)
+{
+	const McnShm_Topic* t = mcn_shm_reader_topic(reader, topic);
+	double start = _now_ms();
+
+	if(t == NULL)
+		return 0;
+	for(;;){
+		if(__atomic_load_n(&t->seq, __ATOMIC_ACQUIRE) / 2 > cnt)
+			return 1;
+		if(mcn_shm_reader_closed(reader))
+			return 0;
+		if(timeout_ms >= 0 && _now_ms() - start > timeout_ms)
+			return 0;
+		_sleep_us(100);
+	}
+}
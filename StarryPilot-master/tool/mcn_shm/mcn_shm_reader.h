@@ -0,0 +1,49 @@
+/*
+ * File      : mcn_shm_reader.h
+ *
+ * Reader of the uMCN topics a host build of the flight code mirrors into
+ * shared memory (../host/host_mcn_shm.c, layout in ../host/mcn_shm.h).
+ * Needs neither the Framework nor any lock: every copy is checked against
+ * the seqlock of its topic and taken again if the writer was in between.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __MCN_SHM_READER_H__
+#define __MCN_SHM_READER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mcn_shm.h"
+
+typedef struct
+{
+	const McnShm_Header* shm;
+	size_t size;
+}McnShm_Reader;
+
+/* Map the segment name (e.g. MCN_SHM_DEFAULT_NAME), waiting up to
+ * timeout_ms for the writer to create it. 0: ok. */
+int mcn_shm_reader_open(McnShm_Reader* reader, const char* name, int timeout_ms);
+void mcn_shm_reader_close(McnShm_Reader* reader);
+
+int mcn_shm_reader_topic_num(const McnShm_Reader* reader);
+/* the topic table entry, or NULL */
+const McnShm_Topic* mcn_shm_reader_topic(const McnShm_Reader* reader, int topic);
+/* index of the topic, -1 if it is not mirrored */
+int mcn_shm_reader_find(const McnShm_Reader* reader, const char* name);
+/* whether the writer has closed the segment */
+int mcn_shm_reader_closed(const McnShm_Reader* reader);
+
+/* Copy the latest data of the topic into buffer (its size bytes). cnt gets
+ * the number of writes so far, 0 if none yet, time_us the time of the last
+ * one; either may be NULL. 0: ok. */
+int mcn_shm_reader_copy(const McnShm_Reader* reader, int topic, void* buffer, uint32_t* cnt, uint64_t* time_us);
+/* Wait until the topic has more than cnt writes, polling every 100 us.
+ * 1: there is a newer write, 0: timeout or the writer closed. timeout_ms
+ * < 0 waits forever. */
+int mcn_shm_reader_wait(const McnShm_Reader* reader, int topic, uint32_t cnt, int timeout_ms);
+
+#endif
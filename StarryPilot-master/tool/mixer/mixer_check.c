@@ -0,0 +1,254 @@
+/*
+ * File      : mixer_check.c
+ *
+ * Host check of the table driven mixer (mixer.c) on every built-in frame
+ * type, against the hand written mixing and clipping it replaces.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mixer.h"
+
+#define OUT_MIN		0.0f
+#define OUT_MAX		0.9f
+/* rounding of the table against the hand written sums */
+#define TOL_EXACT	1e-5f
+/* outputs and recovered commands after a desaturation */
+#define TOL_DESAT	1e-4f
+
+#define CHECK(_cond, ...)	do{ if(!(_cond)){ printf(__VA_ARGS__); fail = 1; } }while(0)
+
+static const char* _frame_name[] = {"x", "plus", "hex", "bluejay"};
+static const char* _desat_name[] = {"clip", "yaw", "airmode"};
+
+/* _ctrl_mix_throttle_out of control_main.c as it was, then ctrl_constrain_throttle */
+static void old_mix(FrameType frame, float* out, const float* in, float base_throttle)
+{
+	if(frame == frame_type_1){
+		out[0] = base_throttle - in[0] + in[1] + in[2];
+		out[1] = base_throttle + in[0] - in[1] + in[2];
+		out[2] = base_throttle + in[0] + in[1] - in[2];
+		out[3] = base_throttle - in[0] - in[1] - in[2];
+	}else if(frame == frame_type_2){
+		out[0] = base_throttle - 1.414f*in[0]          			+ 1.414f*in[2];
+		out[1] = base_throttle + 1.414f*in[0]          			+ 1.414f*in[2];
+		out[2] = base_throttle          		+ 1.414f*in[1] 	- 1.414f*in[2];
+		out[3] = base_throttle          		- 1.414f*in[1] 	- 1.414f*in[2];
+	}else if(frame == frame_type_3){
+		out[0] = base_throttle                 +      in[1]  - in[2];
+		out[1] = base_throttle                 -      in[1]  + in[2];
+		out[2] = base_throttle + 0.866f*in[0]  - 0.5f*in[1]  - in[2];
+		out[3] = base_throttle - 0.866f*in[0]  + 0.5f*in[1]  + in[2];
+		out[4] = base_throttle + 0.866f*in[0]  + 0.5f*in[1]  + in[2];
+		out[5] = base_throttle - 0.866f*in[0]  - 0.5f*in[1]  - in[2];
+	}else{
+		out[0] = base_throttle+ 1.414f*(-      in[0]                )  - in[2];
+		out[1] = base_throttle+ 1.414f*(+      in[0]                )  + in[2];
+		out[2] = base_throttle+ 1.414f*(+ 0.5f*in[0]  + 0.866f*in[1])  - in[2];
+		out[3] = base_throttle+ 1.414f*(- 0.5f*in[0]  - 0.866f*in[1])  + in[2];
+		out[4] = base_throttle+ 1.414f*(- 0.5f*in[0]  + 0.866f*in[1])  + in[2];
+		out[5] = base_throttle+ 1.414f*(+ 0.5f*in[0]  - 0.866f*in[1])  - in[2];
+	}
+	for(int i = 0 ; i < mixer_frame_motor_num(frame) ; i++){
+		if(out[i] < 0.0f)
+			out[i] = 0.0f;
+		if(out[i] > 0.9f)
+			out[i] = 0.9f;
+	}
+}
+
+static float urand(float lo, float hi)
+{
+	return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+/* the commands the outputs actually give, the columns of all built-in
+ * frames are orthogonal */
+static void recover(const Mixer_Def* mixer, const float* out, float* ctrl)
+{
+	for(int j = 0 ; j < MIXER_AXIS_NUM ; j++){
+		float num = 0.0f, den = 0.0f;
+		for(int i = 0 ; i < mixer->motor_num ; i++){
+			num += mixer->mix[i][j]*out[i];
+			den += mixer->mix[i][j]*mixer->mix[i][j];
+		}
+		ctrl[j] = num/den;
+	}
+}
+
+/* the common scale of the recovered axes, fitted on the largest command,
+ * and how far the axes are off that scale */
+static float common_scale(const float* got, const float* want, int axis_num, float* off)
+{
+	int big = 0;
+	float s;
+
+	for(int j = 1 ; j < axis_num ; j++){
+		if(fabsf(want[j]) > fabsf(want[big]))
+			big = j;
+	}
+	s = fabsf(want[big]) > 1e-6f ? got[big]/want[big] : 1.0f;
+	*off = 0.0f;
+	for(int j = 0 ; j < axis_num ; j++){
+		float e = fabsf(got[j] - s*want[j]);
+		if(e > *off)
+			*off = e;
+	}
+
+	return s;
+}
+
+/* whether some thrust no larger than t_max puts t*h + c*ctrl within the range */
+static int feasible(const Mixer_Def* mixer, const float* ctrl, float t_max)
+{
+	for(float t = -0.5f ; t <= t_max && t <= 1.5f ; t += 0.0005f){
+		int ok = 1;
+		for(int i = 0 ; i < mixer->motor_num && ok ; i++){
+			float o = mixer->mix[i][MIXER_THRUST]*t;
+			for(int j = 0 ; j < MIXER_THRUST ; j++)
+				o += mixer->mix[i][j]*ctrl[j];
+			ok = (o >= OUT_MIN - 1e-6f) && (o <= OUT_MAX + 1e-6f);
+		}
+		if(ok)
+			return 1;
+	}
+	return 0;
+}
+
+static int check_frame(FrameType frame, int samples)
+{
+	Mixer_Def mixer[MIXER_DESAT_NUM];
+	uint8_t motor_num = mixer_frame_motor_num(frame);
+	float max_diff = 0.0f, max_range = 0.0f;
+	float att_err[MIXER_DESAT_NUM] = {0.0f};
+	int fail = 0, saturated = 0;
+
+	for(int d = 0 ; d < MIXER_DESAT_NUM ; d++){
+		if(mixer_init(&mixer[d], mixer_frame_geometry(frame), motor_num, OUT_MIN, OUT_MAX, (Mixer_Desat)d)){
+			printf("%s: mixer_init failed\n", _frame_name[frame]);
+			return 1;
+		}
+	}
+
+	for(int n = 0 ; n < samples ; n++){
+		/* a quarter small commands, the rest large enough to saturate often */
+		float amp = (n & 3) ? 0.4f : 0.05f;
+		float ctrl[MIXER_AXIS_NUM] = {urand(-amp, amp), urand(-amp, amp), urand(-amp, amp), urand(0.0f, 1.0f)};
+		float ref[MIXER_MAX_MOTOR], out[MIXER_MAX_MOTOR], got[MIXER_AXIS_NUM];
+		int sat = 0;
+
+		old_mix(frame, ref, ctrl, ctrl[MIXER_THRUST]);
+		for(int d = 0 ; d < MIXER_DESAT_NUM ; d++){
+			mixer_run(&mixer[d], ctrl, out);
+			for(int i = 0 ; i < motor_num ; i++){
+				float diff = fabsf(out[i] - ref[i]);
+				if(out[i] < OUT_MIN - 1e-6f || out[i] > OUT_MAX + 1e-6f){
+					float r = out[i] < OUT_MIN ? OUT_MIN - out[i] : out[i] - OUT_MAX;
+					if(r > max_range)
+						max_range = r;
+				}
+				if(d == MIXER_DESAT_CLIP && diff > max_diff)
+					max_diff = diff;
+				if(ref[i] <= OUT_MIN || ref[i] >= OUT_MAX)
+					sat = 1;
+			}
+			recover(&mixer[d], out, got);
+			for(int j = 0 ; j < MIXER_THRUST ; j++)
+				att_err[d] += (got[j] - ctrl[j])*(got[j] - ctrl[j]);
+
+			if(d == MIXER_DESAT_YAW){
+				float off;
+				float s = common_scale(got, ctrl, 2, &off);
+				float sy = fabsf(ctrl[2]) > 1e-6f ? got[2]/ctrl[2] : 1.0f;
+				float rp_more[3] = {ctrl[0]*(s+0.01f), ctrl[1]*(s+0.01f), 0.0f};
+				float yaw_more[3] = {ctrl[0]*s, ctrl[1]*s, ctrl[2]*(sy+0.01f)};
+
+				/* roll and pitch scaled alike, thrust never raised */
+				CHECK(off <= TOL_DESAT,
+						"%s yaw: roll and pitch scaled apart by %f\n", _frame_name[frame], off);
+				CHECK(got[MIXER_THRUST] <= ctrl[MIXER_THRUST] + TOL_DESAT,
+						"%s yaw: thrust raised %f -> %f\n", _frame_name[frame], ctrl[MIXER_THRUST], got[MIXER_THRUST]);
+				/* roll and pitch cut only as far as needed, without yaw */
+				CHECK(s >= 1.0f - 0.01f || !feasible(&mixer[d], rp_more, ctrl[MIXER_THRUST]),
+						"%s yaw: roll and pitch cut to %f, more would fit\n", _frame_name[frame], s);
+				/* yaw takes what room they leave */
+				CHECK(sy >= 1.0f - 0.01f || !feasible(&mixer[d], yaw_more, ctrl[MIXER_THRUST]),
+						"%s yaw: yaw cut to %f, more would fit\n", _frame_name[frame], sy);
+			}
+			if(d == MIXER_DESAT_AIRMODE){
+				float off;
+				float s = common_scale(got, ctrl, 3, &off);
+				float all_more[3] = {ctrl[0]*(s+0.01f), ctrl[1]*(s+0.01f), ctrl[2]*(s+0.01f)};
+
+				/* the three scaled alike, in full whenever they fit at some thrust */
+				CHECK(off <= TOL_DESAT,
+						"%s airmode: scaled apart by %f\n", _frame_name[frame], off);
+				CHECK(s >= 1.0f - 0.01f || !feasible(&mixer[d], all_more, 1.5f),
+						"%s airmode: cut to %f, more would fit\n", _frame_name[frame], s);
+			}
+		}
+		saturated += sat;
+	}
+
+	if(max_diff > TOL_EXACT){
+		printf("%s: clip differs from the former mixing by %g\n", _frame_name[frame], max_diff);
+		fail = 1;
+	}
+	if(max_range > 0.0f){
+		printf("%s: output off the range by %g\n", _frame_name[frame], max_range);
+		fail = 1;
+	}
+
+	printf("%-8s %d motors  clip max diff %.2e  saturated %5.1f%%  rms attitude error", _frame_name[frame],
+			motor_num, max_diff, 100.0f*saturated/samples);
+	for(int d = 0 ; d < MIXER_DESAT_NUM ; d++)
+		printf("  %s %.4f", _desat_name[d], sqrtf(att_err[d]/(3.0f*samples)));
+	printf("  %s\n", fail ? "FAIL" : "ok");
+
+	return fail;
+}
+
+static int check_init(void)
+{
+	Mixer_Def mixer;
+	float mix[MIXER_MAX_MOTOR][MIXER_AXIS_NUM];
+	int fail = 0;
+
+	memcpy(mix, mixer_frame_geometry(frame_type_3), sizeof(mix));
+	if(mixer_init(&mixer, (const float (*)[MIXER_AXIS_NUM])mix, MIXER_MAX_MOTOR+1, OUT_MIN, OUT_MAX, MIXER_DESAT_CLIP) != 1){
+		printf("init: too many motors accepted\n");
+		fail = 1;
+	}
+	mix[5][MIXER_THRUST] = 0.0f;
+	if(mixer_init(&mixer, (const float (*)[MIXER_AXIS_NUM])mix, 6, OUT_MIN, OUT_MAX, MIXER_DESAT_CLIP) != 2){
+		printf("init: zero thrust accepted\n");
+		fail = 1;
+	}
+	if(mixer_frame_geometry((FrameType)4) != NULL || mixer_frame_motor_num((FrameType)4) != 0){
+		printf("init: unknown frame type has a geometry\n");
+		fail = 1;
+	}
+
+	return fail;
+}
+
+int main(int argc, char** argv)
+{
+	int samples = argc > 1 ? atoi(argv[1]) : 20000;
+	int fail = 0;
+
+	srand(1);
+	fail |= check_init();
+	for(int f = frame_type_1 ; f <= frame_type_4 ; f++){
+		fail |= check_frame((FrameType)f, samples);
+	}
+
+	printf("%s\n", fail ? "FAIL" : "all frames ok");
+	return fail;
+}
@@ -0,0 +1,513 @@
+/*
+ * File      : replay.c
+ *
+ * Feed the sensor data of a .LOG back through the estimators of the
+ * Framework on the host and compare their output with what was logged.
+ * Sensor topics are republished with mcn_publish in record order, the
+ * estimators are scheduled as copter_main_loop schedules them on a 1ms
+ * simulated clock, either as fast as possible or at a multiple of real
+ * time. The output is written as a .LOG with the logger.c element names,
+ * so log_export and log_fleet read it like a flight log.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "log_file.h"
+#include "host_port.h"
+#include "global.h"
+#include "uMCN.h"
+#include "quaternion.h"
+#include "att_estimator.h"
+#include "state_est.h"
+#include "pos_estimator.h"
+#include "copter_main.h"
+#include "sensor_manager.h"
+#include "delay.h"
+#include "replay_sensor.h"
+
+#define BLOCK_RECORDS		4096
+
+MCN_DECLARE(ATT_QUATERNION);
+MCN_DECLARE(ATT_EULER);
+MCN_DECLARE(ALT_INFO);
+MCN_DECLARE(POS_INFO);
+MCN_DECLARE(POS_KF);
+
+/* log elements the sensor topics are made of */
+enum
+{
+	I_GYR_X = 0, I_GYR_Y, I_GYR_Z,
+	I_ACC_X, I_ACC_Y, I_ACC_Z,
+	I_MAG_X, I_MAG_Y, I_MAG_Z,
+	I_GYR_FILTER_X, I_GYR_FILTER_Y, I_GYR_FILTER_Z,
+	I_ACC_FILTER_X, I_ACC_FILTER_Y, I_ACC_FILTER_Z,
+	I_MAG_FILTER_X, I_MAG_FILTER_Y, I_MAG_FILTER_Z,
+	I_BARO_ALT, I_BARO_VEL,
+	I_GPS_LAT, I_GPS_LON, I_GPS_Z, I_GPS_VN, I_GPS_VE, I_GPS_VD, I_GPS_HDOP,
+	I_NUM
+};
+
+static const char* _in_name[I_NUM] = {
+	"GYR_X", "GYR_Y", "GYR_Z",
+	"ACC_X", "ACC_Y", "ACC_Z",
+	"MAG_X", "MAG_Y", "MAG_Z",
+	"GYR_FILTER_X", "GYR_FILTER_Y", "GYR_FILTER_Z",
+	"ACC_FILTER_X", "ACC_FILTER_Y", "ACC_FILTER_Z",
+	"MAG_FILTER_X", "MAG_FILTER_Y", "MAG_FILTER_Z",
+	"BARO_ALT", "BARO_VEL",
+	"GPS_LAT", "GPS_LON", "GPS_Z", "GPS_VN", "GPS_VE", "GPS_VD", "GPS_HDOP",
+};
+
+/* estimator output, filled as logger.c fills the elements of the same name */
+enum
+{
+	O_QUATERNION_W = 0, O_QUATERNION_X, O_QUATERNION_Y, O_QUATERNION_Z,
+	O_ROLL, O_PITCH, O_YAW,
+	O_X, O_Y, O_Z, O_VX, O_VY, O_VZ,
+	O_KF_U_X, O_KF_U_Y, O_KF_U_Z,
+	O_KF_X, O_KF_Y, O_KF_Z, O_KF_VX, O_KF_VY, O_KF_VZ,
+	O_KF_Z_X, O_KF_Z_Y, O_KF_Z_Z, O_KF_Z_VX, O_KF_Z_VY, O_KF_Z_VZ,
+	O_NUM
+};
+
+static const char* _out_name[O_NUM] = {
+	"QUATERNION_W", "QUATERNION_X", "QUATERNION_Y", "QUATERNION_Z",
+	"ROLL", "PITCH", "YAW",
+	"X", "Y", "Z", "VX", "VY", "VZ",
+	"KF_U_X", "KF_U_Y", "KF_U_Z",
+	"KF_X", "KF_Y", "KF_Z", "KF_VX", "KF_VY", "KF_VZ",
+	"KF_Z_X", "KF_Z_Y", "KF_Z_Z", "KF_Z_VX", "KF_Z_VY", "KF_Z_VZ",
+};
+
+typedef struct
+{
+	double sum_sq;
+	double max;
+	uint64_t n;
+	int64_t first_over;		/* first record off by more than the tolerance, -1 if none */
+	int elem;				/* in the input log, -1 if not logged */
+}diff_t;
+
+static int _use_ekf;
+static int _in_elem[I_NUM];
+static float _in_col[I_NUM][BLOCK_RECORDS];
+static float _out_col[O_NUM][BLOCK_RECORDS];
+static diff_t _diff[O_NUM];
+
+static double wall_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e3 + ts.tv_nsec*1e-6;
+}
+
+static void sleep_until_ms(double t)
+{
+	struct timespec ts;
+
+	ts.tv_sec = (time_t)(t / 1e3);
+	ts.tv_nsec = (long)((t - ts.tv_sec*1e3) * 1e6);
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0);
+}
+
+static void sample_from_block(ReplaySample* s, uint32_t k)
+{
+	float v[I_NUM];
+
+	for(int i = 0 ; i < I_NUM ; i++){
+		v[i] = _in_elem[i] >= 0 ? _in_col[i][k] : 0.0f;
+	}
+	for(int i = 0 ; i < 3 ; i++){
+		s->gyr[i] = v[I_GYR_X+i];
+		s->acc[i] = v[I_ACC_X+i];
+		s->mag[i] = v[I_MAG_X+i];
+		s->gyr_filter[i] = v[I_GYR_FILTER_X+i];
+		s->acc_filter[i] = v[I_ACC_FILTER_X+i];
+		s->mag_filter[i] = v[I_MAG_FILTER_X+i];
+		s->gps_vel[i] = v[I_GPS_VN+i];
+	}
+	s->baro_alt = v[I_BARO_ALT];
+	s->baro_vel = v[I_BARO_VEL];
+	s->gps_lat = v[I_GPS_LAT];
+	s->gps_lon = v[I_GPS_LON];
+	s->gps_alt = v[I_GPS_Z];
+	s->gps_hdop = v[I_GPS_HDOP];
+}
+
+/* copter_main_loop without the controller, called every ms */
+static void estimator_tick(void)
+{
+	static uint32_t pos_est_time = 0;
+	uint32_t now = time_nowMs();
+
+	if(_use_ekf){
+		sensor_imu_delta_set_interval(EKF_PERIOD);
+		state_est_update();
+	}else{
+		sensor_imu_delta_set_interval(AHRS_PERIOD);
+		attitude_est_run();
+		if(TIME_GAP(pos_est_time, now) >= POS_EST_PERIOD){
+			pos_est_time = now;
+			pos_est_update(0.001f*POS_EST_PERIOD);
+		}
+	}
+}
+
+static void output_to_block(uint32_t k)
+{
+	quaternion quat;
+	Euler euler;
+	Altitude_Info alt_info;
+	Position_Info pos_info;
+	POS_KF_Log kf;
+
+	/* topics not published in this mode are logged as 0 */
+	memset(&quat, 0, sizeof(quat));
+	memset(&euler, 0, sizeof(euler));
+	memset(&alt_info, 0, sizeof(alt_info));
+	memset(&pos_info, 0, sizeof(pos_info));
+	memset(&kf, 0, sizeof(kf));
+	mcn_copy_from_hub(MCN_ID(ATT_QUATERNION), &quat);
+	mcn_copy_from_hub(MCN_ID(ATT_EULER), &euler);
+	mcn_copy_from_hub(MCN_ID(ALT_INFO), &alt_info);
+	mcn_copy_from_hub(MCN_ID(POS_INFO), &pos_info);
+	mcn_copy_from_hub(MCN_ID(POS_KF), &kf);
+
+	_out_col[O_QUATERNION_W][k] = quat.w;
+	_out_col[O_QUATERNION_X][k] = quat.x;
+	_out_col[O_QUATERNION_Y][k] = quat.y;
+	_out_col[O_QUATERNION_Z][k] = quat.z;
+	_out_col[O_ROLL][k] = Rad2Deg(euler.roll);
+	_out_col[O_PITCH][k] = Rad2Deg(euler.pitch);
+	_out_col[O_YAW][k] = Rad2Deg(euler.yaw);
+	_out_col[O_X][k] = pos_info.x;
+	_out_col[O_Y][k] = pos_info.y;
+	_out_col[O_Z][k] = alt_info.alt;
+	_out_col[O_VX][k] = pos_info.vx;
+	_out_col[O_VY][k] = pos_info.vy;
+	_out_col[O_VZ][k] = alt_info.vz;
+	_out_col[O_KF_U_X][k] = kf.u_x;
+	_out_col[O_KF_U_Y][k] = kf.u_y;
+	_out_col[O_KF_U_Z][k] = kf.u_z;
+	_out_col[O_KF_X][k] = kf.est_x;
+	_out_col[O_KF_Y][k] = kf.est_y;
+	_out_col[O_KF_Z][k] = kf.est_z;
+	_out_col[O_KF_VX][k] = kf.est_vx;
+	_out_col[O_KF_VY][k] = kf.est_vy;
+	_out_col[O_KF_VZ][k] = kf.est_vz;
+	_out_col[O_KF_Z_X][k] = kf.obs_x;
+	_out_col[O_KF_Z_Y][k] = kf.obs_y;
+	_out_col[O_KF_Z_Z][k] = kf.obs_z;
+	_out_col[O_KF_Z_VX][k] = kf.obs_vx;
+	_out_col[O_KF_Z_VY][k] = kf.obs_vy;
+	_out_col[O_KF_Z_VZ][k] = kf.obs_vz;
+}
+
+/* compare records [first, first+n) with the reference, ref_first is the
+ * reference record taken at the same time as first */
+static void diff_block(const log_file_t* ref, int64_t ref_first, uint64_t first, uint32_t n, double tol)
+{
+	static float logged[O_NUM][BLOCK_RECORDS];
+	uint32_t k0 = 0;
+
+	/* only the records both logs have */
+	if(ref_first < 0){
+		if((uint64_t)-ref_first >= n){
+			return;
+		}
+		k0 = -ref_first;
+		ref_first = 0;
+	}
+	if((uint64_t)ref_first >= ref->records){
+		return;
+	}
+	if(ref_first + (n - k0) > ref->records){
+		n = k0 + (ref->records - ref_first);
+	}
+	for(int o = 0 ; o < O_NUM ; o++){
+		if(_diff[o].elem >= 0){
+			log_column_float(ref, _diff[o].elem, ref_first, n - k0, logged[o] + k0);
+		}
+	}
+	/* q and -q are the same attitude, compare with the sign of the reference */
+	if(_diff[O_QUATERNION_W].elem >= 0 && _diff[O_QUATERNION_X].elem >= 0
+		&& _diff[O_QUATERNION_Y].elem >= 0 && _diff[O_QUATERNION_Z].elem >= 0){
+		for(uint32_t k = k0 ; k < n ; k++){
+			float dot = 0.0f;
+
+			for(int o = O_QUATERNION_W ; o <= O_QUATERNION_Z ; o++){
+				dot += _out_col[o][k] * logged[o][k];
+			}
+			if(dot < 0.0f){
+				for(int o = O_QUATERNION_W ; o <= O_QUATERNION_Z ; o++){
+					logged[o][k] = -logged[o][k];
+				}
+			}
+		}
+	}
+
+	for(int o = 0 ; o < O_NUM ; o++){
+		diff_t* d = &_diff[o];
+
+		if(d->elem < 0){
+			continue;
+		}
+		for(uint32_t k = k0 ; k < n ; k++){
+			double e = (double)_out_col[o][k] - logged[o][k];
+
+			if(o == O_YAW){
+				e = remainder(e, 360.0);
+			}
+			if(!isfinite(e)){
+				continue;
+			}
+			e = fabs(e);
+			d->sum_sq += e*e;
+			d->n++;
+			if(e > d->max){
+				d->max = e;
+			}
+			if(tol > 0.0 && e > tol && d->first_over < 0){
+				d->first_over = first + k;
+			}
+		}
+	}
+}
+
+static int write_header(FILE* fp, uint32_t start_time, uint32_t period)
+{
+	LOG_FileHeaderDef header;
+	LOG_ElementInfoDef info[O_NUM];
+
+	header.start_time = start_time;
+	header.log_period = period;
+	header.element_num = O_NUM;
+	header.header_size = sizeof(header) + sizeof(info);
+	header.field_size = O_NUM*sizeof(float);
+	memset(info, 0, sizeof(info));
+	for(int o = 0 ; o < O_NUM ; o++){
+		strncpy(info[o].name, _out_name[o], LOG_MAX_NAME_LENGTH-1);
+		info[o].type = LOG_FLOAT;
+	}
+
+	return fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(info, sizeof(info), 1, fp) == 1 ? 0 : -1;
+}
+
+static int write_block(FILE* fp, uint32_t n)
+{
+	float field[O_NUM];
+
+	for(uint32_t k = 0 ; k < n ; k++){
+		for(int o = 0 ; o < O_NUM ; o++){
+			field[o] = _out_col[o][k];
+		}
+		if(fwrite(field, sizeof(field), 1, fp) != 1){
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void usage(FILE* fp)
+{
+	fprintf(fp, "usage: replay [-m ahrs|ekf] [-f] [-x speed] [-t from:to] [-r ref.LOG] [-e tol] [-o out.LOG] [-q] file.LOG\n");
+}
+
+int main(int argc, char** argv)
+{
+	log_file_t log, ref_log;
+	log_file_t* ref = &log;
+	char err[128];
+	const char* out_path = NULL;
+	const char* ref_path = NULL;
+	int64_t ref_shift = 0;
+	double speed = 0.0, tol = 0.0, t_from = 0.0, t_to = -1.0;
+	int refilter = 0, quiet = 0, opt, fail = 0;
+	uint64_t first, last, rec;
+	FILE* out = NULL;
+	double wall0, sim_ms;
+
+	while((opt = getopt(argc, argv, "m:fx:t:r:e:o:qh")) != -1){
+		switch(opt){
+			case 'm':
+				if(strcmp(optarg, "ekf") == 0){
+					_use_ekf = 1;
+				}else if(strcmp(optarg, "ahrs") != 0){
+					usage(stderr);
+					return 1;
+				}
+				break;
+			case 'f': refilter = 1; break;
+			case 'x': speed = atof(optarg); break;
+			case 't':
+				t_from = atof(optarg);
+				if(strchr(optarg, ':') && strchr(optarg, ':')[1] != '\0'){
+					t_to = atof(strchr(optarg, ':') + 1);
+				}
+				break;
+			case 'r': ref_path = optarg; break;
+			case 'e': tol = atof(optarg); break;
+			case 'o': out_path = optarg; break;
+			case 'q': quiet = 1; break;
+			default:
+				usage(opt == 'h' ? stdout : stderr);
+				return opt != 'h';
+		}
+	}
+	if(optind != argc-1){
+		usage(stderr);
+		return 1;
+	}
+
+	if(log_open(&log, argv[optind], err, sizeof(err))){
+		fprintf(stderr, "%s: %s\n", argv[optind], err);
+		return 1;
+	}
+	for(int i = 0 ; i < I_NUM ; i++){
+		_in_elem[i] = log_find(&log, _in_name[i]);
+		if(_in_elem[i] < 0 && !quiet){
+			fprintf(stderr, "%s not logged, published as 0\n", _in_name[i]);
+		}
+	}
+	/* by default the replay is compared with what the log recorded */
+	if(ref_path){
+		if(log_open(&ref_log, ref_path, err, sizeof(err))){
+			fprintf(stderr, "%s: %s\n", ref_path, err);
+			log_close(&log);
+			return 1;
+		}
+		if(ref_log.period != log.period){
+			fprintf(stderr, "%s: log period %u ms, replayed log has %u ms\n", ref_path, ref_log.period, log.period);
+			log_close(&ref_log);
+			log_close(&log);
+			return 1;
+		}
+		ref = &ref_log;
+		ref_shift = ((int64_t)log.header.start_time - (int64_t)ref->header.start_time) / (int64_t)log.period;
+	}
+	for(int o = 0 ; o < O_NUM ; o++){
+		_diff[o].elem = log_find(ref, _out_name[o]);
+		_diff[o].first_over = -1;
+	}
+
+	first = log_record_at(&log, t_from*1e3);
+	last = t_to >= 0.0 ? log_record_at(&log, t_to*1e3) : log.records;
+	if(first >= last){
+		fprintf(stderr, "nothing to replay\n");
+		log_close(&log);
+		return 1;
+	}
+
+	if(out_path){
+		out = fopen(out_path, "wb");
+		if(out == NULL || write_header(out, log.header.start_time + first*log.period, log.header.log_period)){
+			fprintf(stderr, "can not write %s\n", out_path);
+			log_close(&log);
+			return 1;
+		}
+	}
+
+	host_port_init();
+	host_console_level(quiet ? 2 : 0);
+
+	/* the estimators take their initial attitude from the first sample,
+	 * initialise them in the order copter_entry does */
+	{
+		ReplaySample s;
+
+		log_prefetch(&log, first, last - first);
+		for(int i = 0 ; i < I_NUM ; i++){
+			if(_in_elem[i] >= 0){
+				log_column_float(&log, _in_elem[i], first, 1, _in_col[i]);
+			}
+		}
+		sample_from_block(&s, 0);
+		time_sim_set((uint64_t)(log.header.start_time + first*log.period) * 1000);
+		replay_sensor_init(refilter);
+		replay_sensor_publish(&s);
+		attitude_est_init();
+		state_est_init(1e-3f*EKF_PERIOD);
+		if(pos_est_init(1e-3f*POS_EST_PERIOD) != RT_EOK){
+			fprintf(stderr, "pos estimator init fail\n");
+			return 1;
+		}
+	}
+
+	wall0 = wall_ms();
+	for(rec = first ; rec < last ; ){
+		uint32_t n = last - rec < BLOCK_RECORDS ? last - rec : BLOCK_RECORDS;
+
+		for(int i = 0 ; i < I_NUM ; i++){
+			if(_in_elem[i] >= 0){
+				log_column_float(&log, _in_elem[i], rec, n, _in_col[i]);
+			}
+		}
+		for(uint32_t k = 0 ; k < n ; k++){
+			uint64_t t_ms = log.header.start_time + (rec + k)*log.period;
+			ReplaySample s;
+
+			sample_from_block(&s, k);
+			/* the topics change once per record, the estimators see every ms */
+			for(uint32_t ms = 0 ; ms < log.period ; ms++){
+				time_sim_set((t_ms + ms) * 1000);
+				if(ms == 0){
+					replay_sensor_publish(&s);
+				}
+				estimator_tick();
+				if(ms == 0){
+					output_to_block(k);
+				}
+			}
+			if(speed > 0.0){
+				sleep_until_ms(wall0 + (double)(rec + k + 1 - first)*log.period / speed);
+			}
+		}
+		diff_block(ref, (int64_t)rec + ref_shift, rec, n, tol);
+		if(out && write_block(out, n)){
+			fprintf(stderr, "can not write %s\n", out_path);
+			fail = 1;
+			break;
+		}
+		rec += n;
+	}
+	wall0 = wall_ms() - wall0;
+	sim_ms = (double)(rec - first)*log.period;
+
+	printf("%s: %llu records, %.1f s replayed in %.3f s (%.0fx real time), %s\n", argv[optind],
+		(unsigned long long)(rec - first), sim_ms*1e-3, wall0*1e-3, wall0 > 0 ? sim_ms / wall0 : 0.0,
+		_use_ekf ? "ekf" : "ahrs + pos kf");
+	printf("%-14s %12s %12s %10s\n", "element", "max_diff", "rms_diff", tol > 0 ? "first>tol" : "");
+	for(int o = 0 ; o < O_NUM ; o++){
+		diff_t* d = &_diff[o];
+
+		if(d->elem < 0 || d->n == 0){
+			continue;
+		}
+		printf("%-14s %12.6g %12.6g", _out_name[o], d->max, sqrt(d->sum_sq / d->n));
+		if(d->first_over >= 0){
+			printf(" %9.3fs", (double)d->first_over*log.period*1e-3);
+			fail = 1;
+		}
+		printf("\n");
+	}
+
+	if(out){
+		fclose(out);
+	}
+	if(ref != &log){
+		log_close(ref);
+	}
+	log_close(&log);
+
+	return fail;
+}
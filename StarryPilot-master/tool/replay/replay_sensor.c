@@ -0,0 +1,159 @@
+/*
+ * File      : replay_sensor.c
+ *
+ * The gps legality check follows sensor_collect() of sensor_manager.c,
+ * keep it in step when that changes.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <math.h>
+#include <string.h>
+#include "global.h"
+#include "console.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "filter.h"
+#include "gps.h"
+#include "host_sensor.h"
+#include "pos_estimator.h"
+#include "replay_sensor.h"
+
+static char *TAG = "Replay";
+
+static int _refilter;
+static ReplaySample _last;
+static int _have_last;
+static GPS_Status _gps_status;
+static McnNode_t gps_node_t;
+
+MCN_DECLARE(SENSOR_GYR);
+MCN_DECLARE(SENSOR_ACC);
+MCN_DECLARE(SENSOR_MAG);
+MCN_DECLARE(SENSOR_FILTER_GYR);
+MCN_DECLARE(SENSOR_FILTER_ACC);
+MCN_DECLARE(SENSOR_FILTER_MAG);
+MCN_DECLARE(BARO_POSITION);
+MCN_DECLARE(GPS_STATUS);
+MCN_DECLARE(GPS_POSITION);
+
+/************************** publish **************************/
+/* the driver publishes a new report at 10Hz and the logger repeats the last
+ * one, so a report is new when any of its logged fields changed */
+static int _gps_changed(const ReplaySample* s)
+{
+	return !_have_last || s->gps_lat != _last.gps_lat || s->gps_lon != _last.gps_lon
+		|| s->gps_alt != _last.gps_alt || s->gps_hdop != _last.gps_hdop
+		|| memcmp(s->gps_vel, _last.gps_vel, sizeof(s->gps_vel)) != 0;
+}
+
+static void _gps_publish(const ReplaySample* s)
+{
+	struct vehicle_gps_position_s gps_pos_t;
+	int fix = s->gps_lat != 0.0 || s->gps_lon != 0.0;
+
+	memset(&gps_pos_t, 0, sizeof(gps_pos_t));
+	gps_pos_t.timestamp_position = time_nowUs();
+	gps_pos_t.timestamp_velocity = gps_pos_t.timestamp_position;
+	gps_pos_t.lat = (int32_t)lround(s->gps_lat*1e7);
+	gps_pos_t.lon = (int32_t)lround(s->gps_lon*1e7);
+	gps_pos_t.alt = (int32_t)lroundf(s->gps_alt*1e3f);
+	gps_pos_t.fix_type = fix ? 3 : 0;
+	/* the log has neither hAcc nor the satellite count, hdop stands in for
+	 * eph and a fix counts as enough satellites */
+	gps_pos_t.eph = s->gps_hdop;
+	gps_pos_t.hdop = s->gps_hdop;
+	gps_pos_t.satellites_used = fix ? 10 : 0;
+	gps_pos_t.vel_n_m_s = s->gps_vel[0];
+	gps_pos_t.vel_e_m_s = s->gps_vel[1];
+	gps_pos_t.vel_d_m_s = s->gps_vel[2];
+	gps_pos_t.vel_m_s = sqrtf(s->gps_vel[0]*s->gps_vel[0] + s->gps_vel[1]*s->gps_vel[1]);
+	gps_pos_t.vel_ned_valid = fix;
+
+	mcn_publish(MCN_ID(GPS_POSITION), &gps_pos_t);
+}
+
+/* what sensor_collect() does with a new gps report */
+static void _gps_update(void)
+{
+	struct vehicle_gps_position_s gps_pos_t;
+
+	mcn_copy(MCN_ID(GPS_POSITION), gps_node_t, &gps_pos_t);
+
+	HOME_Pos home = pos_home_get();
+	Vector3f_t pos;
+	if(home.gps_coordinate_set == true && gps_get_position(&pos, gps_pos_t) == 0){
+
+		host_gps_driv_vel.velocity.x = (pos.x - host_gps_driv_vel.last_pos.x) / 0.1f;	// the gps update interval is 100ms
+		host_gps_driv_vel.velocity.y = (pos.y - host_gps_driv_vel.last_pos.y) / 0.1f;
+		host_gps_driv_vel.velocity.z = (pos.z - host_gps_driv_vel.last_pos.z) / 0.1f;
+
+		host_gps_driv_vel.last_pos = pos;
+	}
+
+	// check legality, shared with sensor_collect()
+	if(gps_status_update(&_gps_status, &gps_pos_t)){
+		mcn_publish(MCN_ID(GPS_STATUS), &_gps_status);
+	}
+}
+
+void replay_sensor_publish(const ReplaySample* s)
+{
+	mcn_publish(MCN_ID(SENSOR_GYR), s->gyr);
+	mcn_publish(MCN_ID(SENSOR_ACC), s->acc);
+	mcn_publish(MCN_ID(SENSOR_MAG), s->mag);
+	if(_refilter){
+		/* the filters run at the log rate here, not at 1kHz as on target */
+		gyrfilter_input(s->gyr);
+		accfilter_input(s->acc);
+		magfilter_input(s->mag);
+		mcn_publish(MCN_ID(SENSOR_FILTER_GYR), gyrfilter_current());
+		mcn_publish(MCN_ID(SENSOR_FILTER_ACC), accfilter_current());
+		mcn_publish(MCN_ID(SENSOR_FILTER_MAG), magfilter_current());
+		sensor_imu_delta_update(gyrfilter_current(), accfilter_current());
+	}else{
+		mcn_publish(MCN_ID(SENSOR_FILTER_GYR), s->gyr_filter);
+		mcn_publish(MCN_ID(SENSOR_FILTER_ACC), s->acc_filter);
+		mcn_publish(MCN_ID(SENSOR_FILTER_MAG), s->mag_filter);
+		sensor_imu_delta_update(s->gyr_filter, s->acc_filter);
+	}
+
+	if(!_have_last || s->baro_alt != _last.baro_alt || s->baro_vel != _last.baro_vel){
+		BaroPosition baro_pos;
+
+		baro_pos.altitude = s->baro_alt;
+		baro_pos.velocity = s->baro_vel;
+		baro_pos.time_stamp = time_nowMs();
+		mcn_publish(MCN_ID(BARO_POSITION), &baro_pos);
+	}
+
+	if(_gps_changed(s)){
+		_gps_publish(s);
+	}
+	if(mcn_poll(gps_node_t)){
+		_gps_update();
+	}
+
+	_last = *s;
+	_have_last = 1;
+}
+
+void replay_sensor_init(int refilter)
+{
+	host_sensor_init();
+
+	gps_node_t = mcn_subscribe(MCN_ID(GPS_POSITION), NULL);
+	if(gps_node_t == NULL)
+		Console.e(TAG, "gps_node_t subscribe err\n");
+
+	_gps_status.status = GPS_UNDETECTED;
+	_gps_status.fix_cnt = 0;
+
+	_refilter = refilter;
+	_have_last = 0;
+	if(_refilter){
+		filter_init();
+	}
+}
@@ -0,0 +1,39 @@
+/*
+ * File      : replay_sensor.h
+ *
+ * Publishes the sensor topics of ../host/host_sensor.c from a log, as
+ * sensor_collect() would have published them from the drivers.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __REPLAY_SENSOR_H__
+#define __REPLAY_SENSOR_H__
+
+#include <stdint.h>
+
+/* one record worth of sensor data, as logged by logger.c */
+typedef struct
+{
+	float gyr[3];
+	float acc[3];
+	float mag[3];
+	float gyr_filter[3];
+	float acc_filter[3];
+	float mag_filter[3];
+	float baro_alt;			/* BaroPosition.altitude, NED */
+	float baro_vel;
+	double gps_lat;			/* degree, 0 if no fix */
+	double gps_lon;
+	float gps_alt;			/* m */
+	float gps_vel[3];		/* NED */
+	float gps_hdop;
+}ReplaySample;
+
+void replay_sensor_init(int refilter);
+/* publish the topics sensor_collect would have published for this sample */
+void replay_sensor_publish(const ReplaySample* s);
+
+#endif
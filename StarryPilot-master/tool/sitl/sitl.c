@@ -0,0 +1,569 @@
+/*
+ * File      : sitl.c
+ *
+ * Fly the firmware on the host against the built-in vehicle model: the
+ * Framework is built with HIL_SIMULATION and HIL_USE_MODEL, so fast_loop()
+ * steps sitl_model.c and copter_main_loop() runs the estimators and the
+ * controller on what it senses. The pilot is a stick script fed through
+ * rc_handle_ppm_signal(), the clock is the simulated one of the host port,
+ * one fast loop and one copter loop per ms as the two threads run on the
+ * target.
+ *
+ * With -u the vehicle takes its steps from a simulator over udp instead
+ * and with -U this program is that simulator, see sitl_link.h.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "host_port.h"
+#include "host_sensor.h"
+#include "global.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "quaternion.h"
+#include "motor.h"
+#include "rc.h"
+#include "control_main.h"
+#include "copter_main.h"
+#include "fast_loop.h"
+#include "pos_estimator.h"
+#include "sitl_interface.h"
+#include "host_mavlink.h"
+#include "sitl_link.h"
+#include "host_mcn_shm.h"
+
+#define MAX_STICK			64
+/* the receiver delivers a ppm frame every 20ms */
+#define RC_PERIOD			20
+
+MCN_DECLARE(ATT_EULER);
+MCN_DECLARE(ALT_INFO);
+MCN_DECLARE(MOTOR_THROTTLE);
+
+extern VEHICLE_STATE FrameType _frame_type;
+extern VEHICLE_STATE RC_STATUS _rc_status;
+
+/* stick positions from time t on, 0~1 as rc_handle_ppm_signal takes them */
+typedef struct
+{
+	float t;
+	float roll;
+	float pitch;
+	float throttle;
+	float yaw;
+}Stick;
+
+/* idle while the estimators settle, unlock (throttle low, pitch up, then
+ * back to centre), take off in altitude hold, hold, roll and yaw steps,
+ * then land */
+static const Stick _default_script[] = {
+	{ 0.0f, 0.5f, 0.5f, 0.0f, 0.5f},
+	{10.0f, 0.5f, 1.0f, 0.0f, 0.5f},
+	{10.5f, 0.5f, 0.5f, 0.0f, 0.5f},
+	{11.0f, 0.5f, 0.5f, 0.5f, 0.5f},
+	{12.0f, 0.5f, 0.5f, 0.8f, 0.5f},
+	{16.0f, 0.5f, 0.5f, 0.5f, 0.5f},
+	{22.0f, 0.7f, 0.5f, 0.5f, 0.5f},
+	{24.0f, 0.5f, 0.5f, 0.5f, 0.5f},
+	{30.0f, 0.5f, 0.5f, 0.5f, 0.8f},
+	{34.0f, 0.5f, 0.5f, 0.5f, 0.5f},
+	{40.0f, 0.5f, 0.5f, 0.2f, 0.5f},
+};
+
+static Stick _script[MAX_STICK];
+static int _script_num;
+
+/* set by the options, the same for all vehicles */
+static float _mode = 0.5f;
+static double _duration = 50.0, _speed = 0.0;
+static int _rate = 50;
+/* -u: udp port of vehicle 0, -U: the vehicles to simulate for */
+static uint16_t _link_port;
+static char _sim_host[256];
+/* -M: the topics to mirror into shared memory */
+static const char* _shm_topics;
+
+typedef struct
+{
+	/* in */
+	FrameType frame;
+	uint32_t seed;
+	int index;
+	char out_name[256];
+	/* out */
+	int res;
+	SITL_Link_Stat link;
+	double wall;
+	float pos[3];
+	float max_alt;
+	int motor_enable;
+	float att_err_rms;
+	float att_err_max;
+	float alt_err_rms;
+	uint32_t err_num;
+}Vehicle;
+
+static VEHICLE_STATE int _motor_enable;
+
+static rt_err_t _motor_control(rt_device_t dev, rt_uint8_t cmd, void* args)
+{
+	if(cmd == PWM_CMD_ENABLE){
+		_motor_enable = *(int*)args;
+	}
+	return RT_EOK;
+}
+
+static VEHICLE_STATE struct rt_device _motor_device = {
+	.control = _motor_control,
+};
+
+static double wall_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e3 + ts.tv_nsec*1e-6;
+}
+
+static void sleep_until_ms(double t)
+{
+	struct timespec ts;
+
+	ts.tv_sec = (time_t)(t / 1e3);
+	ts.tv_nsec = (long)((t - ts.tv_sec*1e3) * 1e6);
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0);
+}
+
+/* -f names, in the order of FrameType */
+static const char* _frame_name[] = {"x", "plus", "hex", "bluejay"};
+
+static int parse_frame(const char* s, FrameType* frame)
+{
+	for(int i = 0 ; i < sizeof(_frame_name)/sizeof(_frame_name[0]) ; i++){
+		if(strcmp(s, _frame_name[i]) == 0){
+			*frame = (FrameType)i;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* t:roll,pitch,throttle,yaw */
+static int parse_stick(const char* s, Stick* stick)
+{
+	return sscanf(s, "%f:%f,%f,%f,%f", &stick->t, &stick->roll, &stick->pitch,
+			&stick->throttle, &stick->yaw) == 5 ? 0 : 1;
+}
+
+static const Stick* stick_at(float t)
+{
+	const Stick* stick = &_script[0];
+
+	for(int i = 1 ; i < _script_num ; i++){
+		if(_script[i].t <= t)
+			stick = &_script[i];
+	}
+	return stick;
+}
+
+static void rc_input(const Stick* stick, float mode)
+{
+	float chan[CHAN_NUM];
+
+	chan[CHAN_ROLL] = stick->roll;
+	chan[CHAN_PITCH] = stick->pitch;
+	chan[CHAN_THROTTLE] = stick->throttle;
+	chan[CHAN_YAW] = stick->yaw;
+	chan[CHAN_CTRL_MODE] = mode;
+	chan[CHAN_THROTTLE_SWITCH] = 1.0f;
+
+	rc_handle_ppm_signal(chan);
+}
+
+static float wrap_pi(float a)
+{
+	while(a > PI) a -= 2.0f*PI;
+	while(a < -PI) a += 2.0f*PI;
+	return a;
+}
+
+static void usage(FILE* fp)
+{
+	fprintf(fp, "usage: sitl [-f x|plus|hex|bluejay] [-m att|alt] [-t sec] [-s seed] [-x speed] [-c t:r,p,th,y]... [-o out.csv] [-r hz] [-n vehicles] [-j jobs] [-u port | -U host:port] [-M topic,...|all] [-q]\n");
+}
+
+/* fly one vehicle, all of its state is in VEHICLE_STATE variables of the
+ * calling thread */
+static void* fly(void* parameter)
+{
+	Vehicle* v = (Vehicle*)parameter;
+	FILE* out = NULL;
+
+	v->res = 1;
+	if(v->out_name[0]){
+		out = fopen(v->out_name, "w");
+		if(out == NULL){
+			perror(v->out_name);
+			return NULL;
+		}
+	}
+
+	device_delay_init();
+	host_sensor_init();
+	host_mavlink_init();
+	rt_device_register(&_motor_device, "motor", RT_DEVICE_FLAG_RDWR);
+
+	_frame_type = v->frame;
+	/* copter_init() brings the model up with the default seed, on the link
+	 * the model is left alone and the simulator sends the sensors */
+	copter_init();
+	if(_link_port ? sitl_link_vehicle_open(_link_port + v->index)
+			: sitl_interface_init(NULL, v->frame, v->seed)){
+		if(out)
+			fclose(out);
+		return NULL;
+	}
+	SITL_Model_Def* model = sitl_interface_get_model();
+	if(_shm_topics){
+		char shm_name[64];
+
+		if(v->index)
+			snprintf(shm_name, sizeof(shm_name), "%s_%d", MCN_SHM_DEFAULT_NAME, v->index);
+		else
+			snprintf(shm_name, sizeof(shm_name), "%s", MCN_SHM_DEFAULT_NAME);
+		if(host_mcn_shm_open(shm_name, _shm_topics)){
+			if(out)
+				fclose(out);
+			return NULL;
+		}
+	}
+
+	uint32_t att_period = copter_get_event_period(AHRS_Period);
+	uint32_t pos_period = copter_get_event_period(Pos_Period);
+	uint32_t ctrl_period = copter_get_event_period(Control_Period);
+	uint32_t steps = (uint32_t)(_duration*1e3);
+	uint32_t out_period = 1000/_rate;
+	uint8_t motor_num = sitl_model_motor_num(v->frame);
+
+	if(out){
+		fprintf(out, "t,rc,n,e,d,vn,ve,vd,roll,pitch,yaw,est_roll,est_pitch,est_yaw,est_alt");
+		for(int i = 0 ; i < motor_num ; i++)
+			fprintf(out, ",m%d", i+1);
+		fprintf(out, "\n");
+	}
+
+	double att_err_sq = 0.0, alt_err_sq = 0.0;
+	double wall0 = wall_ms();
+
+	v->max_alt = 0.0f;
+	v->att_err_max = 0.0f;
+	v->err_num = 0;
+	for(uint32_t k = 0 ; k < steps ; k++){
+		if(_link_port){
+			if(sitl_link_vehicle_wait(&v->link)){
+				sitl_link_vehicle_close(&v->link);
+				host_mcn_shm_close();
+				return NULL;
+			}
+			/* the simulator may leave steps out */
+			k = time_nowMs() - 1;
+		}else{
+			time_sim_step(1000);
+		}
+		float t = 1e-3f*(k+1);
+
+		if(k % RC_PERIOD == 0){
+			rc_input(stick_at(t), _mode);
+		}
+		fast_loop();
+		copter_main_loop(att_period, pos_period, ctrl_period);
+
+		/* the truth is on the simulator side */
+		if(_link_port){
+			sitl_link_vehicle_reply();
+			continue;
+		}
+		if((k+1) % out_period){
+			continue;
+		}
+		SITL_State_Def* s = &model->state;
+		Euler e, est;
+		Altitude_Info alt_info;
+		float throttle[MOTOR_NUM];
+
+		quaternion_toEuler(&s->att, &e);
+		mcn_copy_from_hub(MCN_ID(ATT_EULER), &est);
+		mcn_copy_from_hub(MCN_ID(ALT_INFO), &alt_info);
+		mcn_copy_from_hub(MCN_ID(MOTOR_THROTTLE), throttle);
+
+		/* home is set on unlock, score the estimates from then on */
+		if(_motor_enable){
+			float err = fmaxf(fabsf(est.roll-e.roll), fabsf(est.pitch-e.pitch));
+			err = fmaxf(err, fabsf(wrap_pi(est.yaw-e.yaw)));
+			att_err_sq += (double)err*err;
+			alt_err_sq += (double)(alt_info.relative_alt+s->pos[2])*(alt_info.relative_alt+s->pos[2]);
+			v->att_err_max = fmaxf(v->att_err_max, err);
+			v->err_num++;
+		}
+		if(-s->pos[2] > v->max_alt)
+			v->max_alt = -s->pos[2];
+
+		if(out){
+			fprintf(out, "%.3f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f",
+				t, (int)_rc_status, s->pos[0], s->pos[1], s->pos[2], s->vel[0], s->vel[1], s->vel[2],
+				Rad2Deg(e.roll), Rad2Deg(e.pitch), Rad2Deg(e.yaw),
+				Rad2Deg(est.roll), Rad2Deg(est.pitch), Rad2Deg(est.yaw), alt_info.relative_alt);
+			for(int i = 0 ; i < motor_num ; i++)
+				fprintf(out, ",%.3f", throttle[i]);
+			fprintf(out, "\n");
+		}
+		if(_speed > 0.0){
+			sleep_until_ms(wall0 + (k+1) / _speed);
+		}
+	}
+	v->wall = wall_ms() - wall0;
+
+	host_mcn_shm_close();
+	if(out){
+		fclose(out);
+	}
+	if(_link_port){
+		sitl_link_vehicle_close(&v->link);
+		v->motor_enable = _motor_enable;
+		v->res = 0;
+		return NULL;
+	}
+
+	memcpy(v->pos, model->state.pos, sizeof(v->pos));
+	v->motor_enable = _motor_enable;
+	if(v->err_num){
+		v->att_err_rms = sqrt(att_err_sq/v->err_num);
+		v->alt_err_rms = sqrt(alt_err_sq/v->err_num);
+	}
+	v->res = 0;
+
+	return NULL;
+}
+
+/* -U: the built-in model for the vehicle listening on port+index */
+static void* simulate(void* parameter)
+{
+	Vehicle* v = (Vehicle*)parameter;
+	SITL_Sim_Def sim;
+	FILE* out = NULL;
+
+	v->res = 1;
+	if(v->out_name[0]){
+		out = fopen(v->out_name, "w");
+		if(out == NULL){
+			perror(v->out_name);
+			return NULL;
+		}
+	}
+	sim.host = _sim_host;
+	sim.port = _link_port + v->index;
+	sim.frame = v->frame;
+	sim.seed = v->seed;
+	sim.duration = _duration;
+	sim.speed = _speed;
+	sim.out = out;
+	sim.rate = _rate;
+
+	v->res = sitl_link_sim_run(&sim, &v->link);
+	v->wall = v->link.wall;
+
+	if(out){
+		fclose(out);
+	}
+	return NULL;
+}
+
+/* out.csv -> out_3.csv for vehicle 3 */
+static void vehicle_out_name(char* buf, size_t len, const char* name, int index, int num)
+{
+	const char* ext = strrchr(name, '.');
+
+	if(num == 1){
+		snprintf(buf, len, "%s", name);
+	}else if(ext){
+		snprintf(buf, len, "%.*s_%d%s", (int)(ext-name), name, index, ext);
+	}else{
+		snprintf(buf, len, "%s_%d", name, index);
+	}
+}
+
+static void print_vehicle(const Vehicle* v, int index, int num, int role)
+{
+	if(num > 1)
+		printf("[%d] seed %u: ", index, v->seed);
+	if(v->res){
+		printf("failed\n");
+		return;
+	}
+	if(role){
+		if(role == 'u')
+			printf("motors %s, ", v->motor_enable ? "enabled" : "disabled");
+		sitl_link_print(&v->link, num > 1 ? "    " : "");
+		return;
+	}
+	printf("final position n:%.2f e:%.2f d:%.2f m, max altitude %.2f m, motors %s\n",
+		v->pos[0], v->pos[1], v->pos[2], v->max_alt, v->motor_enable ? "enabled" : "disabled");
+	if(v->err_num){
+		printf("%sattitude estimate error rms %.2f deg max %.2f deg, altitude estimate error rms %.2f m\n",
+			num > 1 ? "    " : "", Rad2Deg(v->att_err_rms), Rad2Deg(v->att_err_max), v->alt_err_rms);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FrameType frame = _frame_type;
+	uint32_t seed = 0;
+	int num = 1, jobs = (int)sysconf(_SC_NPROCESSORS_ONLN), quiet = 0;
+	const char* out_name = NULL;
+	int role = 0;
+	int opt;
+
+	_script_num = 0;
+	while((opt = getopt(argc, argv, "f:m:t:s:x:c:o:r:n:j:u:U:M:qh")) != -1){
+		switch(opt)
+		{
+			case 'f':
+				if(parse_frame(optarg, &frame)){
+					fprintf(stderr, "unknown frame %s\n", optarg);
+					return 2;
+				}
+				break;
+			case 'm':
+				if(strcmp(optarg, "att") == 0){
+					_mode = 0.0f;
+				}else if(strcmp(optarg, "alt") == 0){
+					_mode = 0.5f;
+				}else{
+					usage(stderr);
+					return 2;
+				}
+				break;
+			case 't': _duration = atof(optarg); break;
+			case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'x': _speed = atof(optarg); break;
+			case 'c':
+				if(_script_num >= MAX_STICK || parse_stick(optarg, &_script[_script_num])){
+					fprintf(stderr, "bad stick %s\n", optarg);
+					return 2;
+				}
+				_script_num++;
+				break;
+			case 'o': out_name = optarg; break;
+			case 'r': _rate = atoi(optarg); break;
+			case 'n': num = atoi(optarg); break;
+			case 'j': jobs = atoi(optarg); break;
+			case 'u':
+				role = 'u';
+				_link_port = (uint16_t)atoi(optarg);
+				break;
+			case 'U':
+			{
+				const char* colon = strrchr(optarg, ':');
+				if(colon == NULL || colon == optarg || colon-optarg >= sizeof(_sim_host)){
+					fprintf(stderr, "bad vehicle %s, give host:port\n", optarg);
+					return 2;
+				}
+				role = 'U';
+				snprintf(_sim_host, sizeof(_sim_host), "%.*s", (int)(colon-optarg), optarg);
+				_link_port = (uint16_t)atoi(colon+1);
+			}break;
+			case 'M': _shm_topics = optarg; break;
+			case 'q': quiet = 1; break;
+			default:
+				usage(opt == 'h' ? stdout : stderr);
+				return opt == 'h' ? 0 : 2;
+		}
+	}
+	if(optind != argc || _duration <= 0.0 || _rate <= 0 || _rate > 1000 || num <= 0 || (role && _link_port == 0)){
+		usage(stderr);
+		return 2;
+	}
+	if(role == 'u' && out_name){
+		fprintf(stderr, "the truth is with the simulator, give -o to sitl -U\n");
+		return 2;
+	}
+	if(_script_num == 0){
+		_script_num = sizeof(_default_script)/sizeof(Stick);
+		memcpy(_script, _default_script, sizeof(_default_script));
+	}
+	if(sitl_model_motor_num(frame) > MOTOR_NUM){
+		fprintf(stderr, "frame needs %d motors, build with -DBLUEJAY for the hexrotor frames\n", sitl_model_motor_num(frame));
+		return 2;
+	}
+#ifndef MULTI_VEHICLE
+	if(num > 1){
+		fprintf(stderr, "build with -DMULTI_VEHICLE to fly more than one vehicle\n");
+		return 2;
+	}
+#endif
+	if(jobs <= 0)
+		jobs = 1;
+
+	host_port_init();
+	host_console_level(quiet ? 1 : 0);
+
+	Vehicle* vehicle = calloc(num, sizeof(Vehicle));
+	pthread_t* thread = calloc(num, sizeof(pthread_t));
+	if(vehicle == NULL || thread == NULL){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for(int i = 0 ; i < num ; i++){
+		vehicle[i].frame = frame;
+		vehicle[i].seed = seed + i;
+		vehicle[i].index = i;
+		if(out_name)
+			vehicle_out_name(vehicle[i].out_name, sizeof(vehicle[i].out_name), out_name, i, num);
+	}
+
+	void* (*run)(void*) = role == 'U' ? simulate : fly;
+
+	double wall0 = wall_ms();
+	if(num == 1){
+		run(&vehicle[0]);
+	}else{
+		/* one thread per vehicle, at most jobs at a time */
+		for(int i = 0 ; i < num ; i += jobs){
+			int n = num-i < jobs ? num-i : jobs;
+			for(int k = 0 ; k < n ; k++){
+				if(pthread_create(&thread[i+k], NULL, run, &vehicle[i+k]) != 0){
+					fprintf(stderr, "can't create thread\n");
+					return 1;
+				}
+			}
+			for(int k = 0 ; k < n ; k++)
+				pthread_join(thread[i+k], NULL);
+		}
+	}
+	double wall = wall_ms() - wall0;
+
+	int res = 0;
+	double sim_ms = _duration*1e3*num;
+	printf("%s frame, %d vehicle%s, %.0f ms simulated in %.1f ms (%.0fx real time)%s\n", _frame_name[frame],
+		num, num > 1 ? "s" : "", sim_ms, wall, sim_ms/wall,
+		role == 'u' ? ", sensors over udp" : role == 'U' ? ", simulating over udp" : "");
+	for(int i = 0 ; i < num ; i++){
+		print_vehicle(&vehicle[i], i, num, role);
+		res |= vehicle[i].res;
+	}
+
+	free(vehicle);
+	free(thread);
+
+	return res;
+}
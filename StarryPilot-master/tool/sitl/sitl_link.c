@@ -0,0 +1,326 @@
+/*
+ * File      : sitl_link.c
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "global.h"
+#include "console.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "motor.h"
+#include "host_mavlink.h"
+#include "sitl_interface.h"
+#include "sitl_link.h"
+
+/* system and component id of the messages of the simulator */
+#define SIM_SYSID			1
+#define SIM_COMPID			MAV_COMP_ID_ALL
+
+static char* TAG = "SITL_Link";
+
+MCN_DECLARE(MOTOR_THROTTLE);
+
+/* time_usec of the last step flown, the clock runs from the first step
+ * on, whatever the epoch of the simulator */
+static VEHICLE_STATE uint64_t _step_us;
+static VEHICLE_STATE uint64_t _base_us;
+static VEHICLE_STATE uint8_t _link_up;
+static VEHICLE_STATE float _control[16];
+
+static double wall_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e3 + ts.tv_nsec*1e-6;
+}
+
+static void sleep_until_ms(double t)
+{
+	struct timespec ts;
+
+	ts.tv_sec = (time_t)(t / 1e3);
+	ts.tv_nsec = (long)((t - ts.tv_sec*1e3) * 1e6);
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0);
+}
+
+/************************** vehicle **************************/
+/* the answer carries the time_usec of the step it answers */
+static void send_control(void)
+{
+	mavlink_message_t msg;
+	uint8_t buff[MAVLINK_MAX_PACKET_LEN];
+	uint16_t len;
+
+	mavlink_msg_hil_actuator_controls_pack(mavlink_system.sysid, mavlink_system.compid, &msg,
+							_step_us, _control, 0, MOTOR_NUM);
+	len = mavlink_msg_to_send_buffer(buff, &msg);
+	mavlink_lowlevel_write(buff, len);
+}
+
+int sitl_link_vehicle_open(uint16_t port)
+{
+	if(host_mavlink_open(port, NULL, 0)){
+		return 1;
+	}
+	_step_us = 0;
+	_link_up = 0;
+	memset(_control, 0, sizeof(_control));
+
+	return 0;
+}
+
+int sitl_link_vehicle_wait(SITL_Link_Stat* stat)
+{
+	mavlink_message_t msg;
+	uint64_t t;
+
+	if(!_link_up){
+		Console.print("waiting for the simulator on udp port %u\n", host_mavlink_port());
+	}
+	while(1){
+		if(!host_mavlink_recv(&msg, _link_up ? SITL_LINK_TIMEOUT : -1)){
+			Console.e(TAG, "no step from the simulator for %d ms\n", SITL_LINK_TIMEOUT);
+			return 1;
+		}
+		if(msg.msgid == MAVLINK_MSG_ID_HIL_SENSOR){
+			t = mavlink_msg_hil_sensor_get_time_usec(&msg);
+		}else if(msg.msgid == MAVLINK_MSG_ID_HIL_GPS){
+			t = mavlink_msg_hil_gps_get_time_usec(&msg);
+		}else{
+			host_mavlink_handle(&msg);
+			continue;
+		}
+
+		if(_link_up && t <= _step_us){
+			/* flown already, the simulator lost the answer */
+			if(msg.msgid == MAVLINK_MSG_ID_HIL_SENSOR){
+				send_control();
+				stat->resend++;
+			}
+			continue;
+		}
+		if(!_link_up){
+			_base_us = t - 1000*SITL_STEP_MS;
+		}
+		/* the gps of a step comes before its sensors */
+		time_sim_set(t - _base_us);
+		host_mavlink_handle(&msg);
+
+		if(msg.msgid == MAVLINK_MSG_ID_HIL_SENSOR){
+			if(!_link_up){
+				_link_up = 1;
+				stat->wall = wall_ms();
+			}else if(t - _step_us > 1000*SITL_STEP_MS){
+				stat->gap += (uint32_t)((t - _step_us) / (1000*SITL_STEP_MS)) - 1;
+			}
+			_step_us = t;
+			stat->steps++;
+			return 0;
+		}
+	}
+}
+
+void sitl_link_vehicle_reply(void)
+{
+	float throttle[MOTOR_NUM];
+
+	if(mcn_copy_from_hub(MCN_ID(MOTOR_THROTTLE), throttle)){
+		memset(throttle, 0, sizeof(throttle));
+	}
+	for(int i = 0 ; i < MOTOR_NUM ; i++){
+		_control[i] = throttle[i];
+	}
+	send_control();
+}
+
+void sitl_link_vehicle_close(SITL_Link_Stat* stat)
+{
+	mavlink_message_t msg;
+
+	if(_link_up){
+		stat->wall = wall_ms() - stat->wall;
+	}
+	/* the last answer may be lost as well */
+	while(_link_up && host_mavlink_recv(&msg, 3*SITL_LINK_RESEND)){
+		if(msg.msgid == MAVLINK_MSG_ID_HIL_SENSOR
+			&& mavlink_msg_hil_sensor_get_time_usec(&msg) <= _step_us){
+			send_control();
+			stat->resend++;
+		}
+	}
+	host_mavlink_close();
+}
+
+/************************** simulator **************************/
+/* the step of sitl_interface_step, over the link */
+static uint16_t pack_step(SITL_Model_Def* model, int gps, uint8_t* buff)
+{
+	mavlink_message_t msg;
+	float gyr[3], acc[3], mag[3], alt, pressure, temperature;
+	uint16_t len = 0;
+
+	sitl_model_imu(model, gyr, acc, mag);
+	sitl_model_baro(model, &alt, &pressure, &temperature);
+
+	if(gps){
+		SITL_GPS_Def g;
+
+		sitl_model_gps(model, 1e-3f*SITL_GPS_PERIOD, &g);
+		mavlink_msg_hil_gps_pack(SIM_SYSID, SIM_COMPID, &msg, model->time_us, 3, g.lat, g.lon, g.alt,
+			(uint16_t)(g.eph*100.0f+0.5f), (uint16_t)(g.eph*100.0f+0.5f),
+			(uint16_t)(sqrtf(g.vel[0]*g.vel[0] + g.vel[1]*g.vel[1])*100.0f+0.5f),
+			(int16_t)lroundf(g.vel[0]*100.0f), (int16_t)lroundf(g.vel[1]*100.0f), (int16_t)lroundf(g.vel[2]*100.0f),
+			UINT16_MAX, g.satellites);
+		len += mavlink_msg_to_send_buffer(&buff[len], &msg);
+	}
+	/* all but diff_pressure */
+	mavlink_msg_hil_sensor_pack(SIM_SYSID, SIM_COMPID, &msg, model->time_us, acc[0], acc[1], acc[2],
+		gyr[0], gyr[1], gyr[2], mag[0], mag[1], mag[2], pressure, 0.0f, alt, temperature, 0x1BFF);
+	len += mavlink_msg_to_send_buffer(&buff[len], &msg);
+
+	return len;
+}
+
+static void rtt_add(SITL_Link_Stat* stat, float rtt)
+{
+	int bin = (int)(rtt / SITL_LINK_RTT_BIN);
+
+	if(stat->steps == 0 || rtt < stat->rtt_min)
+		stat->rtt_min = rtt;
+	if(rtt > stat->rtt_max)
+		stat->rtt_max = rtt;
+	stat->rtt_sum += rtt;
+	stat->rtt_hist[bin < SITL_LINK_RTT_BINS ? bin : SITL_LINK_RTT_BINS]++;
+}
+
+static float rtt_percentile(const SITL_Link_Stat* stat, float p)
+{
+	uint32_t n = 0, target = (uint32_t)ceilf(p*stat->steps);
+
+	for(int i = 0 ; i <= SITL_LINK_RTT_BINS ; i++){
+		n += stat->rtt_hist[i];
+		if(n >= target && n)
+			return i < SITL_LINK_RTT_BINS ? (i+1)*SITL_LINK_RTT_BIN : stat->rtt_max;
+	}
+	return stat->rtt_max;
+}
+
+/* wait for the answer to step t, sending the step again if it is lost */
+static int wait_answer(SITL_Link_Stat* stat, uint64_t t, uint8_t* buff, uint16_t len,
+						double* sent, float control[16])
+{
+	mavlink_message_t msg;
+	double start = *sent;
+
+	while(1){
+		double now = wall_ms();
+		int timeout = (int)ceil(*sent + SITL_LINK_RESEND - now);
+
+		if(timeout <= 0){
+			if(now - start >= SITL_LINK_TIMEOUT){
+				Console.e(TAG, "no answer from the vehicle for %d ms\n", SITL_LINK_TIMEOUT);
+				return 1;
+			}
+			mavlink_lowlevel_write(buff, len);
+			*sent = wall_ms();
+			stat->resend++;
+			continue;
+		}
+		if(!host_mavlink_recv(&msg, timeout) || msg.msgid != MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS){
+			continue;
+		}
+		if(mavlink_msg_hil_actuator_controls_get_time_usec(&msg) != t){
+			stat->stale++;
+			continue;
+		}
+		mavlink_msg_hil_actuator_controls_get_controls(&msg, control);
+		return 0;
+	}
+}
+
+int sitl_link_sim_run(const SITL_Sim_Def* sim, SITL_Link_Stat* stat)
+{
+	SITL_Model_Def model;
+	SITL_Param_Def param;
+	uint8_t buff[2*MAVLINK_MAX_PACKET_LEN];
+	float control[16] = {0.0f};
+	uint32_t steps = (uint32_t)(sim->duration*1e3/SITL_STEP_MS);
+	uint32_t out_period = 1000/sim->rate;
+	uint8_t motor_num = sitl_model_motor_num(sim->frame);
+	int res = 0;
+
+	sitl_model_default_param(&param);
+	if(sitl_model_init(&model, &param, sim->frame, sim->seed)){
+		Console.e(TAG, "err, unknow frame type:%d\n", sim->frame);
+		return 1;
+	}
+	if(host_mavlink_open(0, sim->host, sim->port)){
+		return 1;
+	}
+	if(sim->out){
+		fprintf(sim->out, "t,n,e,d,vn,ve,vd,roll,pitch,yaw");
+		for(int i = 0 ; i < motor_num ; i++)
+			fprintf(sim->out, ",m%d", i+1);
+		fprintf(sim->out, "\n");
+	}
+
+	double wall0 = wall_ms();
+	for(uint32_t k = 0 ; k < steps ; k++){
+		sitl_model_step(&model, control, 1e-3f*SITL_STEP_MS);
+
+		int gps = (k+1) % (SITL_GPS_PERIOD/SITL_STEP_MS) == 0;
+		uint16_t len = pack_step(&model, gps, buff);
+		double sent = wall_ms();
+
+		mavlink_lowlevel_write(buff, len);
+		if(wait_answer(stat, model.time_us, buff, len, &sent, control)){
+			res = 1;
+			break;
+		}
+		rtt_add(stat, (float)((wall_ms() - sent)*1e3));
+		stat->steps++;
+
+		if(sim->out && (k+1) % out_period == 0){
+			SITL_State_Def* s = &model.state;
+			Euler e;
+
+			quaternion_toEuler(&s->att, &e);
+			fprintf(sim->out, "%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f",
+				1e-6*model.time_us, s->pos[0], s->pos[1], s->pos[2], s->vel[0], s->vel[1], s->vel[2],
+				Rad2Deg(e.roll), Rad2Deg(e.pitch), Rad2Deg(e.yaw));
+			for(int i = 0 ; i < motor_num ; i++)
+				fprintf(sim->out, ",%.3f", control[i]);
+			fprintf(sim->out, "\n");
+		}
+		if(sim->speed > 0.0){
+			sleep_until_ms(wall0 + (k+1)*SITL_STEP_MS / sim->speed);
+		}
+	}
+	stat->wall = wall_ms() - wall0;
+	host_mavlink_close();
+
+	return res;
+}
+
+void sitl_link_print(const SITL_Link_Stat* stat, const char* indent)
+{
+	printf("%u steps in %.1f ms, %.0f steps/s", stat->steps, stat->wall,
+		stat->wall > 0.0 ? stat->steps*1e3/stat->wall : 0.0);
+	if(stat->resend || stat->stale || stat->gap){
+		printf(", %u sent again, %u stale, %u left out", stat->resend, stat->stale, stat->gap);
+	}
+	printf("\n");
+	if(stat->rtt_sum > 0.0){
+		printf("%sround trip min %.0f us, mean %.0f us, p50 %.0f us, p99 %.0f us, max %.0f us\n", indent,
+			stat->rtt_min, stat->rtt_sum/stat->steps, rtt_percentile(stat, 0.5f),
+			rtt_percentile(stat, 0.99f), stat->rtt_max);
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * File      : sitl_link.h
+ *
+ * Lockstep HIL over the MAVLink link of ../host/host_mavlink.c. The
+ * simulator owns the time: it steps the model, sends the step as
+ * HIL_SENSOR (with the HIL_GPS due at that step in the same datagram) and
+ * waits for the HIL_ACTUATOR_CONTROLS stamped with the same time_usec
+ * before it steps again. The vehicle sets its clock to the time_usec of
+ * each HIL_SENSOR, runs one ms of flight code and answers with
+ * MOTOR_THROTTLE. Neither side runs ahead of the other, whatever the load
+ * of the host.
+ *
+ * A datagram lost on the way is sent again after SITL_LINK_RESEND ms; the
+ * vehicle recognises a step it has flown by its time_usec and only answers
+ * it again, so no step is dropped or flown twice.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __SITL_LINK_H__
+#define __SITL_LINK_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "control_main.h"
+
+/* ms without an answer before a step is sent again */
+#define SITL_LINK_RESEND		100
+/* ms without an answer before the other side is given up */
+#define SITL_LINK_TIMEOUT		5000
+/* round trip histogram, 10us per bin */
+#define SITL_LINK_RTT_BIN		10
+#define SITL_LINK_RTT_BINS		2000
+
+typedef struct
+{
+	uint32_t steps;
+	double wall;			/* ms from the first to the last step */
+	uint32_t resend;		/* simulator: steps sent again, vehicle: answers sent again */
+	uint32_t stale;			/* simulator: answers to a step already done */
+	uint32_t gap;			/* vehicle: steps the simulator left out */
+	/* simulator: HIL_SENSOR out to HIL_ACTUATOR_CONTROLS in, us */
+	double rtt_sum;
+	float rtt_min;
+	float rtt_max;
+	uint32_t rtt_hist[SITL_LINK_RTT_BINS+1];
+}SITL_Link_Stat;
+
+typedef struct
+{
+	const char* host;		/* vehicle to drive */
+	uint16_t port;
+	FrameType frame;
+	uint32_t seed;
+	double duration;		/* s */
+	double speed;			/* 0: as fast as the vehicle answers, else x real time */
+	FILE* out;				/* truth and motor commands as csv, may be NULL */
+	int rate;				/* csv rate, Hz */
+}SITL_Sim_Def;
+
+/* vehicle side */
+int sitl_link_vehicle_open(uint16_t port);
+/* wait for the next step and set the clock to it, 0: step, 1: link lost */
+int sitl_link_vehicle_wait(SITL_Link_Stat* stat);
+/* answer the step with MOTOR_THROTTLE */
+void sitl_link_vehicle_reply(void);
+/* answer steps sent again until the simulator is quiet, then close */
+void sitl_link_vehicle_close(SITL_Link_Stat* stat);
+
+/* simulator side, flies the built-in model on the vehicle at host:port */
+int sitl_link_sim_run(const SITL_Sim_Def* sim, SITL_Link_Stat* stat);
+
+/* steps, step rate and losses, the round trips on a second line */
+void sitl_link_print(const SITL_Link_Stat* stat, const char* indent);
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * File      : bl_stub.c
+ *
+ * Stand-in for the StarryIO bootloader, used to run the uploader protocol
+ * on a host. It speaks the same command set as the IO bootloader over a
+ * file descriptor, keeps the flash image in memory and emulates the link
+ * round-trip latency and the flash write time of each PROG_MULTI frame.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include "starryio_upload_proto.h"
+#include "bl_stub.h"
+
+#define REPLY_QUEUE_SIZE	64
+#define REPLY_MAX_LEN		8
+
+typedef struct
+{
+	uint64_t due_us;
+	uint8_t len;
+	uint8_t data[REPLY_MAX_LEN];
+}reply_t;
+
+static reply_t _reply[REPLY_QUEUE_SIZE];
+static uint32_t _reply_head, _reply_tail;
+
+static uint64_t now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sleep_us(uint32_t us)
+{
+	struct timespec ts = {us / 1000000, (us % 1000000) * 1000};
+
+	nanosleep(&ts, NULL);
+}
+
+/* replies leave the stub 'latency_us' after the command was processed */
+static void queue_reply(const bl_stub_cfg* cfg, const uint8_t* data, uint8_t len)
+{
+	reply_t* r = &_reply[_reply_head % REPLY_QUEUE_SIZE];
+
+	r->due_us = now_us() + cfg->latency_us;
+	r->len = len;
+	memcpy(r->data, data, len);
+	_reply_head++;
+}
+
+static void queue_sync(const bl_stub_cfg* cfg, uint8_t status)
+{
+	uint8_t sync[2] = {PROTO_INSYNC, status};
+
+	queue_reply(cfg, sync, 2);
+}
+
+static int flush_reply(int fd)
+{
+	uint64_t now = now_us();
+
+	while (_reply_tail != _reply_head) {
+		reply_t* r = &_reply[_reply_tail % REPLY_QUEUE_SIZE];
+
+		if (r->due_us > now) {
+			break;
+		}
+		if (write(fd, r->data, r->len) != r->len) {
+			return -1;
+		}
+		_reply_tail++;
+	}
+
+	return 0;
+}
+
+/* read one byte, sending the due replies while waiting */
+static int read_byte(int fd, uint8_t* c)
+{
+	for (;;) {
+		struct pollfd pfd = {fd, POLLIN, 0};
+		int timeout = -1;
+
+		if (flush_reply(fd) < 0) {
+			return -1;
+		}
+
+		if (_reply_tail != _reply_head) {
+			uint64_t due = _reply[_reply_tail % REPLY_QUEUE_SIZE].due_us;
+			uint64_t now = now_us();
+
+			timeout = due > now ? (int)((due - now + 999) / 1000) : 0;
+		}
+
+		if (poll(&pfd, 1, timeout) < 0) {
+			return -1;
+		}
+
+		if (pfd.revents & (POLLIN | POLLHUP)) {
+			return read(fd, c, 1) == 1 ? 0 : -1;
+		}
+	}
+}
+
+static int expect_eoc(int fd)
+{
+	uint8_t c;
+
+	if (read_byte(fd, &c) < 0) {
+		return -1;
+	}
+
+	return c == PROTO_EOC ? 1 : 0;
+}
+
+int bl_stub_run(int fd, const bl_stub_cfg* cfg)
+{
+	uint8_t* flash = (uint8_t*)malloc(cfg->flash_size);
+	uint32_t address = 0;
+	uint8_t buff[256];
+	uint8_t cmd, arg;
+	int eoc;
+
+	if (flash == NULL) {
+		return -1;
+	}
+	memset(flash, 0xff, cfg->flash_size);
+	_reply_head = _reply_tail = 0;
+
+	while (read_byte(fd, &cmd) == 0) {
+		switch (cmd) {
+		case PROTO_GET_SYNC:
+			if ((eoc = expect_eoc(fd)) < 0)
+				goto out;
+			queue_sync(cfg, eoc ? PROTO_OK : PROTO_INVALID);
+			break;
+
+		case PROTO_GET_DEVICE: {
+			uint32_t val = 0;
+
+			if (read_byte(fd, &arg) < 0 || (eoc = expect_eoc(fd)) < 0)
+				goto out;
+			if (!eoc) {
+				queue_sync(cfg, PROTO_INVALID);
+				break;
+			}
+			if (arg == INFO_BL_REV) {
+				val = BL_REV;
+			} else if (arg == INFO_FLASH_SIZE) {
+				val = cfg->flash_size;
+			} else if (arg == INFO_BOARD_ID || arg == INFO_BOARD_REV) {
+				val = 0;
+			} else {
+				queue_sync(cfg, PROTO_INVALID);
+				break;
+			}
+			queue_reply(cfg, (uint8_t*)&val, sizeof(val));
+			queue_sync(cfg, PROTO_OK);
+			break;
+		}
+
+		case PROTO_CHIP_ERASE:
+			if ((eoc = expect_eoc(fd)) < 0)
+				goto out;
+			if (!eoc) {
+				queue_sync(cfg, PROTO_INVALID);
+				break;
+			}
+			if (cfg->erase_fail) {
+				queue_sync(cfg, PROTO_FAILED);
+				break;
+			}
+			memset(flash, 0xff, cfg->flash_size);
+			address = 0;
+			queue_sync(cfg, PROTO_OK);
+			break;
+
+		case PROTO_PROG_MULTI:
+			if (read_byte(fd, &arg) < 0)
+				goto out;
+			for (uint32_t i = 0; i < arg; i++) {
+				if (read_byte(fd, &buff[i]) < 0)
+					goto out;
+			}
+			if ((eoc = expect_eoc(fd)) < 0)
+				goto out;
+			if (!eoc || (arg & 3) || address + arg > cfg->flash_size) {
+				queue_sync(cfg, PROTO_INVALID);
+				break;
+			}
+			/* the bootloader does not read the link while it writes flash */
+			if (cfg->flash_us) {
+				sleep_us(cfg->flash_us);
+			}
+			memcpy(&flash[address], buff, arg);
+			address += arg;
+			queue_sync(cfg, PROTO_OK);
+			break;
+
+		case PROTO_GET_CRC: {
+			uint32_t crc;
+
+			if ((eoc = expect_eoc(fd)) < 0)
+				goto out;
+			crc = crc32part(flash, cfg->flash_size, 0);
+			queue_reply(cfg, (uint8_t*)&crc, sizeof(crc));
+			queue_sync(cfg, PROTO_OK);
+			break;
+		}
+
+		case PROTO_REBOOT:
+			expect_eoc(fd);
+			/* let the last replies go out before leaving */
+			while (_reply_tail != _reply_head && flush_reply(fd) == 0)
+				sleep_us(100);
+			goto out;
+
+		default:
+			/* PROTO_EOC and NOP padding between commands are ignored */
+			break;
+		}
+	}
+
+out:
+	free(flash);
+	return 0;
+}
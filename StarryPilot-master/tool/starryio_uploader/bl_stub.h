@@ -0,0 +1,24 @@
+/*
+ * File      : bl_stub.h
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#ifndef __BL_STUB_H__
+#define __BL_STUB_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+	uint32_t flash_size;	/* bytes of application flash */
+	uint32_t latency_us;	/* link round-trip latency */
+	uint32_t flash_us;		/* time to write one PROG_MULTI frame */
+	uint8_t erase_fail;		/* answer PROTO_FAILED to PROTO_CHIP_ERASE */
+}bl_stub_cfg;
+
+int bl_stub_run(int fd, const bl_stub_cfg* cfg);
+
+#endif
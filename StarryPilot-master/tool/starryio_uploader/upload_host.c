@@ -0,0 +1,182 @@
+/*
+ * File      : upload_host.c
+ *
+ * Runs the fmu uploader protocol (starryio_upload_proto.c) on a host
+ * against the stand-in bootloader in a child process and reports the
+ * achieved throughput.
+ *
+ * Usage: upload_host [-w window] [-l latency_us] [-f flash_us] [-s size] [image.bin]
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "starryio_upload_proto.h"
+#include "bl_stub.h"
+
+typedef struct
+{
+	const uint8_t* buff;
+	uint32_t offset;
+}mem_src;
+
+static int host_send(void* ctx, const uint8_t* buff, uint32_t size)
+{
+	int fd = *(int*)ctx;
+
+	while (size) {
+		ssize_t n = write(fd, buff, size);
+
+		if (n <= 0) {
+			return -1;
+		}
+		buff += n;
+		size -= n;
+	}
+
+	return 0;
+}
+
+static int host_recv(void* ctx, uint8_t* c, uint32_t timeout)
+{
+	struct pollfd pfd = {*(int*)ctx, POLLIN, 0};
+
+	if (poll(&pfd, 1, timeout) <= 0) {
+		return -1;
+	}
+
+	return read(pfd.fd, c, 1) == 1 ? 0 : -1;
+}
+
+static uint32_t host_now_ms(void* ctx)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static uint32_t read_mem(void* src, uint8_t* buff, uint32_t size)
+{
+	mem_src* mem = (mem_src*)src;
+
+	memcpy(buff, &mem->buff[mem->offset], size);
+	mem->offset += size;
+
+	return size;
+}
+
+int main(int argc, char** argv)
+{
+	bl_stub_cfg cfg = {61440, 2000, 0, 0};
+	uint8_t window = UPLOADER_DEFAULT_WINDOW;
+	uint32_t size = 50000;
+	const char* file = NULL;
+	uint8_t* image;
+	uploader_stat stat;
+	UPLOADER_Result res;
+	uint32_t bl_rev = 0;
+	mem_src mem;
+	int sv[2];
+	int opt;
+	pid_t pid;
+
+	while ((opt = getopt(argc, argv, "w:l:f:s:e")) != -1) {
+		switch (opt) {
+		case 'w': window = atoi(optarg); break;
+		case 'l': cfg.latency_us = atoi(optarg); break;
+		case 'f': cfg.flash_us = atoi(optarg); break;
+		case 's': size = atoi(optarg); break;
+		case 'e': cfg.erase_fail = 1; break;
+		default:
+			fprintf(stderr, "usage: %s [-w window] [-l latency_us] [-f flash_us] [-s size] [-e] [image.bin]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind < argc) {
+		file = argv[optind];
+	}
+
+	if (file) {
+		FILE* fp = fopen(file, "rb");
+
+		if (fp == NULL) {
+			fprintf(stderr, "can not open %s\n", file);
+			return 1;
+		}
+		fseek(fp, 0, SEEK_END);
+		size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		image = (uint8_t*)malloc(size);
+		if (image == NULL || fread(image, 1, size, fp) != size) {
+			fprintf(stderr, "read %s fail\n", file);
+			return 1;
+		}
+		fclose(fp);
+	} else {
+		image = (uint8_t*)malloc(size);
+		srand(1);
+		for (uint32_t i = 0; i < size; i++) {
+			image[i] = rand();
+		}
+	}
+
+	if (size > cfg.flash_size) {
+		fprintf(stderr, "image %u bytes exceeds flash %u bytes\n", size, cfg.flash_size);
+		return 1;
+	}
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+		perror("socketpair");
+		return 1;
+	}
+
+	pid = fork();
+	if (pid == 0) {
+		close(sv[0]);
+		return bl_stub_run(sv[1], &cfg);
+	}
+	close(sv[1]);
+
+	uploader_port port = {host_send, host_recv, host_now_ms, &sv[0]};
+
+	if (uploader_proto_sync(&port) != UPLOADER_OK) {
+		fprintf(stderr, "sync fail\n");
+		return 1;
+	}
+	uploader_proto_get_info(&port, INFO_BL_REV, (uint8_t*)&bl_rev, sizeof(bl_rev));
+	res = uploader_proto_erase(&port);
+	if (res != UPLOADER_OK) {
+		fprintf(stderr, "erase fail, err:%d\n", res);
+		uploader_proto_reboot(&port);
+		close(sv[0]);
+		waitpid(pid, NULL, 0);
+		free(image);
+		return 1;
+	}
+
+	mem.buff = image;
+	mem.offset = 0;
+	res = uploader_proto_program(&port, read_mem, &mem, size, window, &stat);
+	uploader_proto_reboot(&port);
+
+	close(sv[0]);
+	waitpid(pid, NULL, 0);
+	free(image);
+
+	printf("bl_rev:%u window:%u latency:%uus flash:%uus\n", bl_rev, window, cfg.latency_us, cfg.flash_us);
+	printf("%u bytes, %u frames, program %u ms, total %u ms, %u bytes/s\n", stat.fw_size, stat.frames,
+		   stat.prog_ms, stat.total_ms, stat.bytes_per_sec);
+	printf("crc received:%08x expected:%08x %s\n", stat.crc, stat.crc_expected, res == UPLOADER_OK ? "OK" : "FAIL");
+
+	return res == UPLOADER_OK ? 0 : 1;
+}
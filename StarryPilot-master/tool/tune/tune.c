@@ -0,0 +1,719 @@
+/*
+ * File      : tune.c
+ *
+ * Monte Carlo tuning of the attitude (ATT_CONTROLLER, ADRC_ATT) and
+ * altitude (ALT_CONTROLLER) gains on the built-in vehicle model. Every
+ * candidate parameter set flies the same trials, each trial with its own
+ * sensor noise, hover throttle, wind, gust and stick steps, and is scored on
+ * how well the controller tracks its targets. The flights are those of
+ * ../sitl: one fast loop and one copter loop per simulated ms, every flight
+ * in a thread of its own (MULTI_VEHICLE) with its own copy of the params.
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "host_port.h"
+#include "host_sensor.h"
+#include "host_mavlink.h"
+#include "global.h"
+#include "uMCN.h"
+#include "delay.h"
+#include "quaternion.h"
+#include "motor.h"
+#include "rc.h"
+#include "param.h"
+#include "control_main.h"
+#include "copter_main.h"
+#include "fast_loop.h"
+#include "pos_estimator.h"
+#include "sitl_interface.h"
+
+#ifndef MULTI_VEHICLE
+#error "tune flies one vehicle per thread, build with -DMULTI_VEHICLE"
+#endif
+
+#define MAX_TUNE			40
+#define MAX_FIX				16
+/* the receiver delivers a ppm frame every 20ms */
+#define RC_PERIOD			20
+/* as ctrl_constrain_throttle */
+#define THROTTLE_LIMIT		0.9f
+
+/* the trial, s: idle while the estimators settle, unlock, climb, hold */
+#define T_UNLOCK			10.0f
+#define T_CLIMB				12.0f
+#define T_HOLD				15.0f
+/* tracking is scored from here on, overshoot from the first hold */
+#define T_SCORE				17.0f
+#define T_ROLL				18.0f
+#define T_PITCH				21.0f
+#define T_STEP_LEN			1.5f
+#define T_ALT				24.0f
+#define T_GUST				27.0f
+#define T_GUST_LEN			0.2f
+#define T_END				29.0f
+
+/* a flight beyond these is a crash */
+#define FAIL_TILT			60.0f		/* deg */
+#define FAIL_ALT_ERR		5.0f		/* m */
+#define FAIL_SCORE			1000.0f
+
+MCN_DECLARE(ATT_EULER);
+MCN_DECLARE(ALT_INFO);
+MCN_DECLARE(MOTOR_THROTTLE);
+
+extern VEHICLE_STATE FrameType _frame_type;
+
+enum{
+	TUNE_ATT = 1,
+	TUNE_ALT = 2,
+	TUNE_ADRC = 4,
+};
+
+typedef struct
+{
+	int group;
+	const char* name;
+}Tunable;
+
+/* the gains, limits and switches are left alone */
+static const Tunable _tunable[] = {
+	{TUNE_ATT, "ATT_ROLL_P"},
+	{TUNE_ATT, "ATT_ROLL_RATE_P"},
+	{TUNE_ATT, "ATT_ROLL_RATE_I"},
+	{TUNE_ATT, "ATT_ROLL_RATE_D"},
+	{TUNE_ATT, "ATT_PITCH_P"},
+	{TUNE_ATT, "ATT_PITCH_RATE_P"},
+	{TUNE_ATT, "ATT_PITCH_RATE_I"},
+	{TUNE_ATT, "ATT_PITCH_RATE_D"},
+	{TUNE_ATT, "ATT_YAW_P"},
+	{TUNE_ATT, "ATT_YAW_RATE_P"},
+	{TUNE_ATT, "ATT_YAW_RATE_I"},
+	{TUNE_ATT, "ATT_YAW_RATE_D"},
+	{TUNE_ALT, "ALT_P"},
+	{TUNE_ALT, "ALT_RATE_P"},
+	{TUNE_ALT, "ALT_ACC_P"},
+	{TUNE_ALT, "ALT_ACC_I"},
+	{TUNE_ALT, "ALT_ACC_D"},
+	{TUNE_ADRC, "TD_CONTROL_R2"},
+	{TUNE_ADRC, "TD_CONTROL_H2F"},
+	{TUNE_ADRC, "TD_R0"},
+	{TUNE_ADRC, "NLSEF_R1"},
+	{TUNE_ADRC, "NLSEF_H1F"},
+	{TUNE_ADRC, "NLSEF_C"},
+	{TUNE_ADRC, "NLSEF_KI"},
+	{TUNE_ADRC, "LESO_W"},
+	{TUNE_ADRC, "GAMMA"},
+	{TUNE_ADRC, "B0"},
+};
+
+/* what the trial does to the vehicle, the same for every candidate */
+typedef struct
+{
+	uint32_t seed;
+	float noise;			/* sensor noise scale */
+	float hover;			/* hover throttle */
+	float wind[2];			/* m/s, north east */
+	float gust[3];			/* N*m, body */
+	float roll;				/* stick offsets of the steps */
+	float pitch;
+	float climb;			/* throttle stick of the altitude step */
+}Trial;
+
+typedef struct
+{
+	double att_rms;			/* deg */
+	double att_os;			/* % of the step */
+	double alt_rms;			/* m */
+	double alt_os;			/* m */
+	double sat;				/* % of the control steps */
+	double score;
+	int fail;
+}Score;
+
+typedef struct
+{
+	float val[MAX_TUNE];
+	Score sum;				/* over the trials */
+	int trials;
+}Candidate;
+
+typedef struct
+{
+	int cand;
+	int trial;
+	Score score;
+	double sim_s;
+}Run;
+
+/* set by the options */
+static FrameType _frame;
+static int _tune_num;
+static int _tune_idx[MAX_TUNE];
+static const char* _fix_name[MAX_FIX];
+static param_value_t _fix_val[MAX_FIX];
+static int _fix_num;
+static float _weight[5] = {1.0f, 0.05f, 10.0f, 5.0f, 0.2f};
+
+static Candidate* _cand;
+static Trial* _trial;
+static Run* _run;
+static int _run_num;
+static int _next_run;
+static pthread_mutex_t _run_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t _rng;
+
+static double rand_uniform(void)
+{
+	_rng ^= _rng << 13;
+	_rng ^= _rng >> 7;
+	_rng ^= _rng << 17;
+	return (_rng >> 11) * (1.0/9007199254740992.0);
+}
+
+static double rand_range(double lo, double hi)
+{
+	return lo + (hi-lo)*rand_uniform();
+}
+
+static double rand_sign(void)
+{
+	return rand_uniform() < 0.5 ? -1.0 : 1.0;
+}
+
+static double wall_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e3 + ts.tv_nsec*1e-6;
+}
+
+static VEHICLE_STATE int _motor_enable;
+
+static rt_err_t _motor_control(rt_device_t dev, rt_uint8_t cmd, void* args)
+{
+	if(cmd == PWM_CMD_ENABLE){
+		_motor_enable = *(int*)args;
+	}
+	return RT_EOK;
+}
+
+static VEHICLE_STATE struct rt_device _motor_device = {
+	.control = _motor_control,
+};
+
+static void rc_input(float roll, float pitch, float throttle)
+{
+	float chan[CHAN_NUM];
+
+	chan[CHAN_ROLL] = roll;
+	chan[CHAN_PITCH] = pitch;
+	chan[CHAN_THROTTLE] = throttle;
+	chan[CHAN_YAW] = 0.5f;
+	chan[CHAN_CTRL_MODE] = 0.5f;		/* altitude hold */
+	chan[CHAN_THROTTLE_SWITCH] = 1.0f;
+
+	rc_handle_ppm_signal(chan);
+}
+
+/* the sticks of the trial at t s */
+static void trial_stick(const Trial* trial, float t)
+{
+	float roll = 0.5f, pitch = 0.5f, throttle = 0.5f;
+
+	if(t < T_UNLOCK){
+		throttle = 0.0f;
+	}else if(t < T_UNLOCK+0.5f){
+		/* throttle low, pitch up unlocks */
+		pitch = 1.0f;
+		throttle = 0.0f;
+	}else if(t < T_UNLOCK+1.0f){
+		throttle = 0.0f;
+	}else if(t >= T_CLIMB && t < T_HOLD){
+		throttle = 0.8f;
+	}else if(t >= T_ROLL && t < T_ROLL+T_STEP_LEN){
+		roll += trial->roll;
+	}else if(t >= T_PITCH && t < T_PITCH+T_STEP_LEN){
+		pitch += trial->pitch;
+	}else if(t >= T_ALT && t < T_ALT+1.0f){
+		throttle = trial->climb;
+	}
+	rc_input(roll, pitch, throttle);
+}
+
+static float wrap_pi(float a)
+{
+	while(a > PI) a -= 2.0f*PI;
+	while(a < -PI) a += 2.0f*PI;
+	return a;
+}
+
+/* step response of one axis: overshoot past each new target, in % of the
+ * step */
+typedef struct
+{
+	float target;
+	float step;
+	float dir;
+	float os;
+}Step_Track;
+
+static void step_track(Step_Track* st, float target, float val)
+{
+	float d = target - st->target;
+
+	if(fabsf(d) > Deg2Rad(1.0f)){
+		st->step = fabsf(d);
+		st->dir = d > 0.0f ? 1.0f : -1.0f;
+	}
+	st->target = target;
+	if(st->step > 0.0f){
+		float os = 100.0f * st->dir * (val - target) / st->step;
+		if(os > st->os)
+			st->os = os;
+	}
+}
+
+/* fly one candidate through one trial, all of the flight state is in
+ * VEHICLE_STATE variables of the calling thread */
+static void* fly(void* parameter)
+{
+	Run* run = (Run*)parameter;
+	const Trial* trial = &_trial[run->trial];
+	const Candidate* cand = &_cand[run->cand];
+	Score* sc = &run->score;
+	SITL_Param_Def param;
+
+	memset(sc, 0, sizeof(Score));
+	sc->fail = 1;
+	sc->score = FAIL_SCORE;
+
+	device_delay_init();
+	host_sensor_init();
+	host_mavlink_init();
+	rt_device_register(&_motor_device, "motor", RT_DEVICE_FLAG_RDWR);
+
+	/* the controllers take their gains at init */
+	if(param_vehicle_init()){
+		return NULL;
+	}
+	for(int i = 0 ; i < _fix_num ; i++){
+		param_get_by_name((char*)_fix_name[i])->val = _fix_val[i];
+	}
+	for(int i = 0 ; i < _tune_num ; i++){
+		param_get_by_name((char*)_tunable[_tune_idx[i]].name)->val.f = cand->val[i];
+	}
+
+	sitl_model_default_param(&param);
+	param.hover_throttle = trial->hover;
+	param.gyr_noise *= trial->noise;
+	param.acc_noise *= trial->noise;
+	param.mag_noise *= trial->noise;
+	param.baro_noise *= trial->noise;
+	param.gps_noise *= trial->noise;
+	param.gps_vel_noise *= trial->noise;
+
+	_frame_type = _frame;
+	copter_init();
+	if(sitl_interface_init(&param, _frame, trial->seed)){
+		param_vehicle_release();
+		return NULL;
+	}
+	SITL_Model_Def* model = sitl_interface_get_model();
+
+	uint32_t att_period = copter_get_event_period(AHRS_Period);
+	uint32_t pos_period = copter_get_event_period(Pos_Period);
+	uint32_t ctrl_period = copter_get_event_period(Control_Period);
+	uint32_t steps = (uint32_t)(T_END*1e3f);
+	uint8_t motor_num = sitl_model_motor_num(_frame);
+
+	double att_sq = 0.0, alt_sq = 0.0;
+	uint32_t num = 0, sat = 0;
+	Step_Track roll_st = {0}, pitch_st = {0};
+	uint8_t holding = 0;
+	float alt_sp = 0.0f, alt_dir = 0.0f, alt_os = 0.0f;
+	int fail = 0;
+	uint32_t k;
+
+	for(k = 0 ; k < steps && !fail ; k++){
+		float t = 1e-3f*(k+1);
+
+		time_sim_step(1000);
+		if(k % RC_PERIOD == 0){
+			trial_stick(trial, t);
+		}
+		if(t >= T_SCORE){
+			model->wind[0] = trial->wind[0];
+			model->wind[1] = trial->wind[1];
+		}
+		for(int i = 0 ; i < 3 ; i++)
+			model->ext_torque[i] = (t >= T_GUST && t < T_GUST+T_GUST_LEN) ? trial->gust[i] : 0.0f;
+
+		fast_loop();
+		copter_main_loop(att_period, pos_period, ctrl_period);
+
+		if(t < T_HOLD){
+			continue;
+		}
+		SITL_State_Def* s = &model->state;
+		Euler truth, e, et = ctrl_get_target_euler();
+		Altitude_Info alt_info;
+		float throttle[MOTOR_NUM];
+		float alt, sp;
+
+		quaternion_toEuler(&s->att, &truth);
+		if(!_motor_enable || s->on_ground || isnan(s->pos[2])
+				|| fabsf(Rad2Deg(truth.roll)) > FAIL_TILT || fabsf(Rad2Deg(truth.pitch)) > FAIL_TILT){
+			fail = 1;
+			break;
+		}
+		/* the controller tracks the estimates, what they are off from the
+		 * truth is the business of the estimators */
+		mcn_copy_from_hub(MCN_ID(ATT_EULER), &e);
+		mcn_copy_from_hub(MCN_ID(ALT_INFO), &alt_info);
+		mcn_copy_from_hub(MCN_ID(MOTOR_THROTTLE), throttle);
+		alt = alt_info.relative_alt;
+
+		/* altitude: a hold latches the altitude it starts at, what it
+		 * swings past that in the direction it was moving is overshoot */
+		if(ctrl_get_alt_setpoint(&sp)){
+			if(!holding){
+				alt_sp = sp;
+				alt_dir = s->vel[2] < 0.0f ? 1.0f : -1.0f;
+			}
+			if(alt_dir*(alt - alt_sp) > alt_os)
+				alt_os = alt_dir*(alt - alt_sp);
+		}
+		holding = ctrl_get_alt_setpoint(&sp);
+
+		step_track(&roll_st, et.roll, e.roll);
+		step_track(&pitch_st, et.pitch, e.pitch);
+
+		if(t < T_SCORE){
+			continue;
+		}
+		float de[3] = {et.roll - e.roll, et.pitch - e.pitch, wrap_pi(et.yaw - e.yaw)};
+		att_sq += de[0]*de[0] + de[1]*de[1] + de[2]*de[2];
+		if(holding){
+			if(fabsf(sp - alt) > FAIL_ALT_ERR){
+				fail = 1;
+				break;
+			}
+			alt_sq += (sp - alt)*(sp - alt);
+		}
+		for(int i = 0 ; i < motor_num ; i++){
+			if(throttle[i] >= THROTTLE_LIMIT-1e-3f || throttle[i] <= 1e-3f){
+				sat++;
+				break;
+			}
+		}
+		num++;
+	}
+	run->sim_s = 1e-3*k;
+	param_vehicle_release();
+
+	if(fail || num == 0){
+		return NULL;
+	}
+	sc->att_rms = Rad2Deg(sqrt(att_sq/num));
+	sc->att_os = fmaxf(roll_st.os, pitch_st.os);
+	sc->alt_rms = sqrt(alt_sq/num);
+	sc->alt_os = alt_os;
+	sc->sat = 100.0*sat/num;
+	sc->score = _weight[0]*sc->att_rms + _weight[1]*sc->att_os + _weight[2]*sc->alt_rms
+				+ _weight[3]*sc->alt_os + _weight[4]*sc->sat;
+	sc->fail = 0;
+
+	return NULL;
+}
+
+/* takes the runs one by one, each in a fresh thread so it starts from the
+ * initial VEHICLE_STATE */
+static void* worker(void* parameter)
+{
+	while(1){
+		pthread_t thread;
+		int i;
+
+		pthread_mutex_lock(&_run_lock);
+		i = _next_run++;
+		pthread_mutex_unlock(&_run_lock);
+		if(i >= _run_num)
+			break;
+		if(pthread_create(&thread, NULL, fly, &_run[i]) != 0){
+			fprintf(stderr, "can't create thread\n");
+			break;
+		}
+		pthread_join(thread, NULL);
+	}
+	return NULL;
+}
+
+static int parse_groups(const char* s)
+{
+	int groups = 0;
+	char buf[64];
+
+	snprintf(buf, sizeof(buf), "%s", s);
+	for(char* tok = strtok(buf, ",") ; tok ; tok = strtok(NULL, ",")){
+		if(strcmp(tok, "att") == 0) groups |= TUNE_ATT;
+		else if(strcmp(tok, "alt") == 0) groups |= TUNE_ALT;
+		else if(strcmp(tok, "adrc") == 0) groups |= TUNE_ADRC;
+		else return 0;
+	}
+	return groups;
+}
+
+static int cmp_cand(const void* a, const void* b)
+{
+	const Candidate* ca = *(const Candidate**)a;
+	const Candidate* cb = *(const Candidate**)b;
+	double sa = ca->sum.score/ca->trials, sb = cb->sum.score/cb->trials;
+
+	return sa < sb ? -1 : sa > sb ? 1 : (int)(ca - cb);
+}
+
+static void print_table(FILE* fp, Candidate** rank, int num)
+{
+	fprintf(fp, "%4s %5s %8s %7s %7s %7s %7s %6s %4s", "rank", "cand", "score", "att", "att_os",
+		"alt", "alt_os", "sat", "fail");
+	for(int i = 0 ; i < _tune_num ; i++)
+		fprintf(fp, " %16s", _tunable[_tune_idx[i]].name);
+	fprintf(fp, "\n");
+	for(int r = 0 ; r < num ; r++){
+		const Candidate* c = rank[r];
+		int ok = c->trials - c->sum.fail;
+
+		fprintf(fp, "%4d %5d %8.3f", r+1, (int)(c - _cand), c->sum.score/c->trials);
+		if(ok){
+			fprintf(fp, " %7.3f %7.1f %7.3f %7.3f %6.2f", c->sum.att_rms/ok, c->sum.att_os/ok,
+				c->sum.alt_rms/ok, c->sum.alt_os/ok, c->sum.sat/ok);
+		}else{
+			fprintf(fp, " %7s %7s %7s %7s %6s", "-", "-", "-", "-", "-");
+		}
+		fprintf(fp, " %4d", c->sum.fail);
+		for(int i = 0 ; i < _tune_num ; i++)
+			fprintf(fp, " %16g", c->val[i]);
+		fprintf(fp, "\n");
+	}
+}
+
+static void usage(FILE* fp)
+{
+	fprintf(fp, "usage: tune [-f x|plus|hex|bluejay] [-g att,alt,adrc] [-n candidates] [-m trials] [-k spread] [-d disturbance] [-p NAME=val]... [-w a,b,c,d,e] [-s seed] [-j jobs] [-o table.txt] [-l lines]\n");
+}
+
+/* -f names, in the order of FrameType */
+static const char* _frame_name[] = {"x", "plus", "hex", "bluejay"};
+
+int main(int argc, char** argv)
+{
+	int groups = TUNE_ATT | TUNE_ALT | TUNE_ADRC;
+	int cand_num = 64, trial_num = 8, lines = 10;
+	int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	double spread = 2.0, dist = 1.0;
+	uint32_t seed = 0;
+	const char* out_name = NULL;
+	int opt;
+
+	_frame = _frame_type;
+	while((opt = getopt(argc, argv, "f:g:n:m:k:d:p:w:s:j:o:l:h")) != -1){
+		switch(opt)
+		{
+			case 'f':
+			{
+				int i;
+				for(i = 0 ; i < sizeof(_frame_name)/sizeof(_frame_name[0]) ; i++){
+					if(strcmp(optarg, _frame_name[i]) == 0)
+						break;
+				}
+				if(i == sizeof(_frame_name)/sizeof(_frame_name[0])){
+					fprintf(stderr, "unknown frame %s\n", optarg);
+					return 2;
+				}
+				_frame = (FrameType)i;
+			}break;
+			case 'g':
+				groups = parse_groups(optarg);
+				if(groups == 0){
+					fprintf(stderr, "bad groups %s, give att, alt and/or adrc\n", optarg);
+					return 2;
+				}
+				break;
+			case 'n': cand_num = atoi(optarg); break;
+			case 'm': trial_num = atoi(optarg); break;
+			case 'k': spread = atof(optarg); break;
+			case 'd': dist = atof(optarg); break;
+			case 'p':
+			{
+				static char name[MAX_FIX][32];
+				if(_fix_num >= MAX_FIX || sscanf(optarg, "%31[^=]=%f", name[_fix_num], &_fix_val[_fix_num].f) != 2){
+					fprintf(stderr, "bad param %s\n", optarg);
+					return 2;
+				}
+				_fix_name[_fix_num] = name[_fix_num];
+				_fix_num++;
+			}break;
+			case 'w':
+				if(sscanf(optarg, "%f,%f,%f,%f,%f", &_weight[0], &_weight[1], &_weight[2],
+						&_weight[3], &_weight[4]) != 5){
+					fprintf(stderr, "bad weights %s\n", optarg);
+					return 2;
+				}
+				break;
+			case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'j': jobs = atoi(optarg); break;
+			case 'o': out_name = optarg; break;
+			case 'l': lines = atoi(optarg); break;
+			default:
+				usage(opt == 'h' ? stdout : stderr);
+				return opt == 'h' ? 0 : 2;
+		}
+	}
+	if(optind != argc || cand_num <= 0 || trial_num <= 0 || spread < 1.0 || dist < 0.0){
+		usage(stderr);
+		return 2;
+	}
+	if(sitl_model_motor_num(_frame) > MOTOR_NUM){
+		fprintf(stderr, "frame needs %d motors, build with -DBLUEJAY for the hexrotor frames\n", sitl_model_motor_num(_frame));
+		return 2;
+	}
+	if(jobs <= 0)
+		jobs = 1;
+
+	host_port_init();
+	host_console_level(1);
+
+	/* the defaults are those of the shared groups, the main thread never
+	 * takes a copy */
+	for(int i = 0 ; i < _fix_num ; i++){
+		param_info_t* p = param_get_by_name((char*)_fix_name[i]);
+		if(p == NULL){
+			fprintf(stderr, "unknown param %s\n", _fix_name[i]);
+			return 2;
+		}
+		/* -p gives a number, the flight code reads it by type */
+		if(p->type == PARAM_TYPE_INT32)
+			_fix_val[i].i = (int32_t)_fix_val[i].f;
+		else if(p->type == PARAM_TYPE_UINT32)
+			_fix_val[i].u = (uint32_t)_fix_val[i].f;
+	}
+	_tune_num = 0;
+	for(int i = 0 ; i < sizeof(_tunable)/sizeof(Tunable) ; i++){
+		if(_tunable[i].group & groups)
+			_tune_idx[_tune_num++] = i;
+	}
+
+	_cand = calloc(cand_num, sizeof(Candidate));
+	_trial = calloc(trial_num, sizeof(Trial));
+	_run_num = cand_num*trial_num;
+	_run = calloc(_run_num, sizeof(Run));
+	Candidate** rank = calloc(cand_num, sizeof(Candidate*));
+	pthread_t* thread = calloc(jobs, sizeof(pthread_t));
+	if(_cand == NULL || _trial == NULL || _run == NULL || rank == NULL || thread == NULL){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	_rng = ((uint64_t)seed << 32) ^ 0x2545F4914F6CDD1DULL;
+	/* candidate 0 is the defaults, the others log-uniform within
+	 * default/spread ~ default*spread */
+	for(int c = 0 ; c < cand_num ; c++){
+		for(int i = 0 ; i < _tune_num ; i++){
+			float def = param_get_by_name((char*)_tunable[_tune_idx[i]].name)->val.f;
+			_cand[c].val[i] = c ? def * exp(rand_range(-log(spread), log(spread))) : def;
+		}
+	}
+	for(int k = 0 ; k < trial_num ; k++){
+		Trial* tr = &_trial[k];
+		double dir = rand_range(0.0, 2.0*PI);
+		double wind = dist * rand_range(0.0, 5.0);
+
+		tr->seed = seed + k;
+		tr->noise = exp(rand_range(log(0.5), log(2.0)));
+		tr->hover = rand_range(0.45, 0.6);
+		tr->wind[0] = wind*cos(dir);
+		tr->wind[1] = wind*sin(dir);
+		for(int i = 0 ; i < 3 ; i++)
+			tr->gust[i] = dist * rand_sign() * rand_range(0.02, i == 2 ? 0.05 : 0.15);
+		tr->roll = rand_sign() * rand_range(0.15, 0.3);
+		tr->pitch = rand_sign() * rand_range(0.15, 0.3);
+		tr->climb = rand_range(0.6, 0.8);
+	}
+	for(int i = 0 ; i < _run_num ; i++){
+		_run[i].cand = i / trial_num;
+		_run[i].trial = i % trial_num;
+	}
+
+	double wall0 = wall_ms();
+	for(int i = 0 ; i < jobs ; i++){
+		if(pthread_create(&thread[i], NULL, worker, NULL) != 0){
+			fprintf(stderr, "can't create thread\n");
+			return 1;
+		}
+	}
+	for(int i = 0 ; i < jobs ; i++)
+		pthread_join(thread[i], NULL);
+	double wall = wall_ms() - wall0;
+
+	double sim_s = 0.0;
+	for(int i = 0 ; i < _run_num ; i++){
+		Candidate* c = &_cand[_run[i].cand];
+		const Score* s = &_run[i].score;
+
+		sim_s += _run[i].sim_s;
+		c->trials++;
+		c->sum.score += s->score;
+		c->sum.fail += s->fail;
+		if(!s->fail){
+			c->sum.att_rms += s->att_rms;
+			c->sum.att_os += s->att_os;
+			c->sum.alt_rms += s->alt_rms;
+			c->sum.alt_os += s->alt_os;
+			c->sum.sat += s->sat;
+		}
+	}
+	for(int c = 0 ; c < cand_num ; c++)
+		rank[c] = &_cand[c];
+	qsort(rank, cand_num, sizeof(Candidate*), cmp_cand);
+
+	printf("%s frame, %d candidates x %d trials, %d params, %.0f s simulated in %.2f s: %.0f sim s/s, %.1f runs/s on %d jobs\n",
+		_frame_name[_frame], cand_num, trial_num, _tune_num, sim_s, wall*1e-3, sim_s/(wall*1e-3),
+		_run_num/(wall*1e-3), jobs);
+	print_table(stdout, rank, lines < cand_num ? lines : cand_num);
+	for(int r = 0 ; r < cand_num ; r++){
+		if(rank[r] == &_cand[0]){
+			printf("defaults (cand 0) rank %d, score %.3f\n", r+1, _cand[0].sum.score/_cand[0].trials);
+			break;
+		}
+	}
+	if(out_name){
+		FILE* fp = fopen(out_name, "w");
+		if(fp == NULL){
+			perror(out_name);
+			return 1;
+		}
+		print_table(fp, rank, cand_num);
+		fclose(fp);
+	}
+
+	free(_cand);
+	free(_trial);
+	free(_run);
+	free(rank);
+	free(thread);
+
+	return 0;
+}
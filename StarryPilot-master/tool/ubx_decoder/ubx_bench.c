@@ -0,0 +1,417 @@
+/*
+ * File      : ubx_bench.c
+ *
+ * Host check of the block UBX decoder (Driver/gps/ubx_decoder.c) against
+ * the per-byte state machine of the former gps_serial_rx_ind path. Both
+ * decoders are fed the same stream, the block decoder in random block
+ * sizes; every frame found by the byte parser has to be found by the block
+ * decoder with identical payload. A crafted stream of frames each behind a
+ * stray 0xB5 checks the block decoder resyncs where the byte parser loses
+ * the frame. Then the throughput of both is measured.
+ *
+ * Usage: ubx_bench [-n frames] [-r repeat] [capture.ubx]
+ *
+ * Change Logs:
+ * Date           Author       	Notes
+ * 2026-10-18     agent       	the first version
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ubx_decoder.h"
+
+#define MSG(cls, id)	((cls) | (id) << 8)
+
+typedef struct
+{
+	uint16_t msg;
+	uint16_t len;
+	uint32_t hash;
+}frame_rec;
+
+typedef struct
+{
+	frame_rec* rec;
+	uint32_t cnt;
+	uint32_t cap;
+}frame_list;
+
+/* message set and length checks of _payload_rx_init() in gps.c */
+static int accept_msg(uint16_t msg, uint16_t len)
+{
+	switch (msg) {
+	case MSG(0x01, 0x07): return len == 84 || len == 92;		/* NAV-PVT */
+	case MSG(0x01, 0x02): return len == 28;						/* NAV-POSLLH */
+	case MSG(0x01, 0x06): return len == 52;						/* NAV-SOL */
+	case MSG(0x01, 0x04): return len == 18;						/* NAV-DOP */
+	case MSG(0x01, 0x21): return len == 20;						/* NAV-TIMEUTC */
+	case MSG(0x01, 0x12): return len == 36;						/* NAV-VELNED */
+	case MSG(0x01, 0x30): return 1;								/* NAV-SVINFO */
+	case MSG(0x0A, 0x04): return 1;								/* MON-VER */
+	case MSG(0x0A, 0x09): return len == 68 || len == 60;		/* MON-HW */
+	case MSG(0x05, 0x01):
+	case MSG(0x05, 0x00): return len == 2;						/* ACK */
+	default: return 0;
+	}
+}
+
+static uint32_t fnv1(const uint8_t* p, uint32_t len)
+{
+	uint32_t h = 0x811c9dc5;
+
+	while (len--) {
+		h = (h * 0x01000193) ^ *p++;
+	}
+	return h;
+}
+
+static void record(frame_list* list, uint16_t msg, const uint8_t* payload, uint16_t len)
+{
+	if (list == NULL) {
+		return;
+	}
+	if (list->cnt == list->cap) {
+		list->cap = list->cap ? list->cap * 2 : 1024;
+		list->rec = (frame_rec*)realloc(list->rec, list->cap * sizeof(frame_rec));
+	}
+	list->rec[list->cnt].msg = msg;
+	list->rec[list->cnt].len = len;
+	list->rec[list->cnt].hash = fnv1(payload, len);
+	list->cnt++;
+}
+
+/**************************** byte parser ****************************/
+/* framing of the former _parse_ubx_char(), one call per byte */
+typedef struct
+{
+	int state;
+	uint8_t ck_a, ck_b;
+	uint16_t msg, len, index;
+	uint8_t payload[65536];
+	frame_list* out;
+}byte_parser;
+
+static void byte_parser_init(byte_parser* bp)
+{
+	bp->state = 0;
+	bp->ck_a = bp->ck_b = 0;
+	bp->len = bp->index = 0;
+}
+
+static void byte_parser_char(byte_parser* bp, uint8_t c)
+{
+	switch (bp->state) {
+	case 0:
+		if (c == 0xB5) bp->state = 1;
+		break;
+	case 1:
+		if (c == 0x62) bp->state = 2;
+		else byte_parser_init(bp);
+		break;
+	case 2:
+	case 3:
+	case 4:
+	case 5:
+		bp->ck_a += c;
+		bp->ck_b += bp->ck_a;
+		if (bp->state == 2) bp->msg = c;
+		if (bp->state == 3) bp->msg |= c << 8;
+		if (bp->state == 4) bp->len = c;
+		if (bp->state == 5) {
+			bp->len |= c << 8;
+			if (!accept_msg(bp->msg, bp->len)) {
+				byte_parser_init(bp);
+				break;
+			}
+			bp->state = bp->len ? 6 : 7;
+			break;
+		}
+		bp->state++;
+		break;
+	case 6:
+		bp->ck_a += c;
+		bp->ck_b += bp->ck_a;
+		bp->payload[bp->index] = c;
+		if (++bp->index >= bp->len) bp->state = 7;
+		break;
+	case 7:
+		if (bp->ck_a != c) byte_parser_init(bp);
+		else bp->state = 8;
+		break;
+	case 8:
+		if (bp->ck_b == c) record(bp->out, bp->msg, bp->payload, bp->len);
+		byte_parser_init(bp);
+		break;
+	}
+}
+
+/**************************** block decoder ****************************/
+static int block_accept(void* ctx, uint16_t msg, uint16_t len)
+{
+	return accept_msg(msg, len);
+}
+
+static void block_handle(void* ctx, uint16_t msg, const uint8_t* payload, uint16_t len)
+{
+	record((frame_list*)ctx, msg, payload, len);
+}
+
+/**************************** stream ****************************/
+static void put_frame(uint8_t** p, uint16_t msg, uint16_t len, int corrupt)
+{
+	uint8_t* f = *p;
+	uint8_t ck_a = 0, ck_b = 0;
+
+	f[0] = 0xB5;
+	f[1] = 0x62;
+	f[2] = msg & 0xff;
+	f[3] = msg >> 8;
+	f[4] = len & 0xff;
+	f[5] = len >> 8;
+	for (uint32_t i = 0; i < len; i++) {
+		f[6 + i] = rand();
+	}
+	for (uint32_t i = 2; i < 6u + len; i++) {
+		ck_a += f[i];
+		ck_b += ck_a;
+	}
+	f[6 + len] = ck_a;
+	f[7 + len] = ck_b ^ (corrupt ? 0x5a : 0);
+	*p += len + 8;
+}
+
+/* frame mix of a configured module at 5Hz plus noise and rejected messages */
+static uint8_t* make_stream(uint32_t frames, uint32_t* size)
+{
+	static const uint16_t msg[] = {
+		MSG(0x01, 0x07), MSG(0x01, 0x04), MSG(0x0A, 0x09), MSG(0x01, 0x30),
+		MSG(0x01, 0x02), MSG(0x01, 0x12), MSG(0x01, 0x22), MSG(0x02, 0x10)
+	};
+	static const uint16_t len[] = {92, 18, 68, 0, 28, 36, 20, 400};
+	uint8_t* buf = (uint8_t*)malloc(frames * 600);
+	uint8_t* p = buf;
+
+	srand(1);
+	for (uint32_t i = 0; i < frames; i++) {
+		uint32_t k = rand() % 8;
+		uint16_t l = len[k] ? len[k] : 8 + 12 * (rand() % 40);
+
+		/* some line noise and partial sync patterns */
+		if (rand() % 8 == 0) {
+			uint32_t n = rand() % 16;
+			for (uint32_t j = 0; j < n; j++) {
+				*p++ = rand() % 4 == 0 ? 0xB5 : rand();
+			}
+		}
+		put_frame(&p, msg[k], l, rand() % 50 == 0);
+	}
+	*size = p - buf;
+
+	return buf;
+}
+
+static double now_sec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int same(const frame_rec* a, const frame_rec* b)
+{
+	return a->msg == b->msg && a->len == b->len && a->hash == b->hash;
+}
+
+/* every frame behind a stray 0xB5: the byte parser drops the 0x62 after
+ * 0xB5 0xB5 and finds none of them, the block decoder has to find all.
+ * No payload or checksum byte is 0xB5, so the byte parser is idle at each
+ * stray one */
+static int check_stray_sync(uint32_t frames)
+{
+	static const uint16_t msg[] = {MSG(0x01, 0x07), MSG(0x01, 0x04), MSG(0x01, 0x02), MSG(0x01, 0x12)};
+	static const uint16_t len[] = {92, 18, 28, 36};
+	static byte_parser bp;
+	static ubx_decoder_t dec;
+	frame_list exp = {0}, ref = {0}, blk = {0};
+	uint8_t* buf = (uint8_t*)malloc(frames * 101);
+	uint8_t* p = buf;
+	uint32_t size, bad = 0;
+
+	srand(3);
+	for (uint32_t i = 0; i < frames; i++) {
+		uint32_t k = i % 4;
+
+		uint8_t* f = p + 1;
+		uint8_t ck_a, ck_b;
+
+		*p++ = 0xB5;
+		do {
+			p = f;
+			put_frame(&p, msg[k], len[k], 0);
+			ck_a = ck_b = 0;
+			for (uint32_t j = 2; j < 6u + len[k]; j++) {
+				if (f[j] == 0xB5) {
+					f[j] = 0;
+				}
+				ck_a += f[j];
+				ck_b += ck_a;
+			}
+		} while (ck_a == 0xB5 || ck_b == 0xB5);
+		f[6 + len[k]] = ck_a;
+		f[7 + len[k]] = ck_b;
+		record(&exp, msg[k], &f[6], len[k]);
+	}
+	size = p - buf;
+
+	byte_parser_init(&bp);
+	bp.out = &ref;
+	for (uint32_t i = 0; i < size; i++) {
+		byte_parser_char(&bp, buf[i]);
+	}
+
+	ubx_decoder_init(&dec, block_accept, block_handle, &blk);
+	for (uint32_t pos = 0; pos < size;) {
+		uint32_t n = 1 + rand() % 300;
+
+		if (n > size - pos) {
+			n = size - pos;
+		}
+		ubx_decoder_feed(&dec, &buf[pos], n);
+		pos += n;
+	}
+
+	for (uint32_t i = 0; i < exp.cnt; i++) {
+		if (i >= blk.cnt || !same(&exp.rec[i], &blk.rec[i])) {
+			bad++;
+		}
+	}
+	printf("stray sync: %u frames, byte parser %u, block decoder %u, wrong %u\n",
+		   frames, ref.cnt, blk.cnt, bad);
+
+	free(buf);
+	free(exp.rec);
+	free(ref.rec);
+	free(blk.rec);
+
+	return bad || blk.cnt != frames || ref.cnt != 0;
+}
+
+int main(int argc, char** argv)
+{
+	static byte_parser bp;
+	static ubx_decoder_t dec;
+	frame_list ref = {0}, blk = {0};
+	uint32_t frames = 20000, repeat = 20;
+	uint32_t size, missing = 0, extra;
+	uint8_t* stream;
+	double t0, t_byte, t_block;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:r:")) != -1) {
+		switch (opt) {
+		case 'n': frames = atoi(optarg); break;
+		case 'r': repeat = atoi(optarg); break;
+		default:
+			fprintf(stderr, "usage: %s [-n frames] [-r repeat] [capture.ubx]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind < argc) {
+		FILE* fp = fopen(argv[optind], "rb");
+
+		if (fp == NULL) {
+			fprintf(stderr, "can not open %s\n", argv[optind]);
+			return 1;
+		}
+		fseek(fp, 0, SEEK_END);
+		size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		stream = (uint8_t*)malloc(size);
+		if (fread(stream, 1, size, fp) != size) {
+			fprintf(stderr, "read %s fail\n", argv[optind]);
+			return 1;
+		}
+		fclose(fp);
+	} else {
+		stream = make_stream(frames, &size);
+	}
+
+	/* correctness: byte parser vs block decoder with random block sizes */
+	byte_parser_init(&bp);
+	bp.out = &ref;
+	for (uint32_t i = 0; i < size; i++) {
+		byte_parser_char(&bp, stream[i]);
+	}
+
+	ubx_decoder_init(&dec, block_accept, block_handle, &blk);
+	srand(2);
+	for (uint32_t pos = 0; pos < size;) {
+		uint32_t n = 1 + rand() % 300;
+
+		if (n > size - pos) {
+			n = size - pos;
+		}
+		ubx_decoder_feed(&dec, &stream[pos], n);
+		pos += n;
+	}
+
+	/* both lists are in stream order, the block decoder may only add frames
+	 * the byte parser lost on a 0xB5 0xB5 0x62 sequence */
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < ref.cnt; i++) {
+		uint32_t k = j;
+
+		while (k < blk.cnt && !same(&ref.rec[i], &blk.rec[k])) {
+			k++;
+		}
+		if (k == blk.cnt) {
+			missing++;
+		} else {
+			j = k + 1;
+		}
+	}
+	extra = blk.cnt - (ref.cnt - missing);
+
+	printf("stream: %u bytes\n", size);
+	printf("byte parser : %u frames\n", ref.cnt);
+	printf("block decoder: %u frames, %u skipped, %u checksum errors, %u oversize\n",
+		   dec.stat.frames, dec.stat.skipped, dec.stat.chksum_err, dec.stat.oversize);
+	printf("missing in block decoder: %u, recovered by block decoder: %u\n", missing, extra);
+
+	if (check_stray_sync(1000)) {
+		missing++;
+	}
+
+	/* throughput, 128 byte blocks as read by the gps thread */
+	bp.out = NULL;
+	t0 = now_sec();
+	for (uint32_t r = 0; r < repeat; r++) {
+		for (uint32_t i = 0; i < size; i++) {
+			byte_parser_char(&bp, stream[i]);
+		}
+	}
+	t_byte = now_sec() - t0;
+
+	ubx_decoder_init(&dec, block_accept, block_handle, NULL);
+	t0 = now_sec();
+	for (uint32_t r = 0; r < repeat; r++) {
+		for (uint32_t pos = 0; pos < size; pos += 128) {
+			ubx_decoder_feed(&dec, &stream[pos], size - pos < 128 ? size - pos : 128);
+		}
+	}
+	t_block = now_sec() - t0;
+
+	printf("byte parser : %.1f MB/s\n", (double)size * repeat / t_byte / 1e6);
+	printf("block decoder: %.1f MB/s (%.1fx)\n", (double)size * repeat / t_block / 1e6, t_byte / t_block);
+
+	free(stream);
+	free(ref.rec);
+	free(blk.rec);
+
+	return missing ? 1 : 0;
+}